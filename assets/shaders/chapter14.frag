@@ -1,3 +1,11 @@
+// BLINN_PHONG selects the specular term (1: Blinn-Phong, 0: Phong, as in chapter13.frag). It is a
+// specialization (see Base::ShaderSpecialization), so toggling it swaps programs, not a branch.
+#ifdef GL_SPIRV
+layout(constant_id = 0) const int BLINN_PHONG = 1;
+#elif !defined(BLINN_PHONG)
+#define BLINN_PHONG 1
+#endif
+
 out vec4 FragColor;
 
 in vec3 v_FragPos;
@@ -34,10 +42,16 @@ void main()
     float diff = max(dot(norm, lightDir), 0.0);
     vec3 diffuse = diff * u_LightColor.rgb;
 
-    // Specular (Blinn-Phong) lighting
+    // Specular lighting
     float specularStrength = 0.5;
-    vec3 halfwayDir = normalize(lightDir + viewDir);
-    float spec = pow(max(dot(norm, halfwayDir), 0.0), 32.0);
+    float spec;
+    if (BLINN_PHONG != 0) {
+        vec3 halfwayDir = normalize(lightDir + viewDir);
+        spec = pow(max(dot(norm, halfwayDir), 0.0), 32.0);
+    } else {
+        vec3 reflectDir = reflect(-lightDir, norm);
+        spec = pow(max(dot(viewDir, reflectDir), 0.0), 32.0);
+    }
     vec3 specular = specularStrength * spec * u_LightColor.rgb;
 
     // Combine lighting components
@@ -19,7 +19,9 @@ in vec3 v_FragPos;
 in vec3 v_Normal;
 in vec2 v_TexCoord;
 
-uniform Light light;
+layout (std140) uniform LightUBO {
+    Light light;
+};
 uniform Material material;
 uniform vec3 u_ViewPos;
 uniform sampler2D u_Texture;
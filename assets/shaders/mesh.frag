@@ -0,0 +1,24 @@
+
+out vec4 FragColor;
+
+in vec3 v_FragPos;
+in vec3 v_Normal;
+in vec2 v_TexCoord;
+in vec4 v_Tangent;
+
+uniform vec3 u_Color;
+uniform vec3 u_LightDirection; // Towards the light
+uniform vec3 u_ViewPos;
+
+void main()
+{
+    vec3 norm = normalize(v_Normal);
+    vec3 lightDir = normalize(u_LightDirection);
+    vec3 viewDir = normalize(u_ViewPos - v_FragPos);
+    vec3 halfwayDir = normalize(lightDir + viewDir);
+
+    float diff = max(dot(norm, lightDir), 0.0);
+    float spec = pow(max(dot(norm, halfwayDir), 0.0), 32.0);
+    vec3 result = u_Color * (0.15 + 0.85 * diff) + vec3(0.25 * spec);
+    FragColor = vec4(result, 1.0);
+}
@@ -0,0 +1,58 @@
+// Generic mesh shader for Base::Mesh data in any Base::VertexFormat. Positions are decoded with
+// u_PositionScale/u_PositionOffset (Base::MeshQuantizer::getPositionDecode; 1 and 0 for float and
+// half positions), normals and tangents according to the specializations from
+// Base::MeshQuantizer::getShaderSpecializations.
+
+#ifdef GL_SPIRV
+layout(constant_id = 0) const int NORMAL_ENCODING = 0;
+layout(constant_id = 1) const int TANGENT_ENCODING = 0;
+#else
+#ifndef NORMAL_ENCODING
+#define NORMAL_ENCODING 0
+#endif
+#ifndef TANGENT_ENCODING
+#define TANGENT_ENCODING 0
+#endif
+#endif
+
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;   // xy only when octahedral
+layout (location = 2) in vec2 aTexCoord;
+layout (location = 3) in vec4 aTangent;  // Octahedral: xy direction, z handedness
+
+out vec3 v_FragPos;
+out vec3 v_Normal;
+out vec2 v_TexCoord;
+out vec4 v_Tangent;
+
+layout (std140) uniform CameraUBO {
+    mat4 view;
+    mat4 projection;
+};
+uniform mat4 model;
+uniform mat3 u_NormalMatrix;
+uniform vec3 u_PositionScale;
+uniform vec3 u_PositionOffset;
+
+vec3 octDecode(vec2 e)
+{
+    vec3 v = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-v.z, 0.0);
+    v.x += v.x >= 0.0 ? -t : t;
+    v.y += v.y >= 0.0 ? -t : t;
+    return normalize(v);
+}
+
+void main()
+{
+    vec3 position = u_PositionOffset + aPos * u_PositionScale;
+    vec3 normal = NORMAL_ENCODING != 0 ? octDecode(aNormal.xy) : aNormal;
+    vec4 tangent = TANGENT_ENCODING != 0 ? vec4(octDecode(aTangent.xy), aTangent.z) : aTangent;
+
+    gl_Position = projection * view * model * vec4(position, 1.0);
+
+    v_FragPos = vec3(model * vec4(position, 1.0));
+    v_Normal = u_NormalMatrix * normal;
+    v_TexCoord = aTexCoord;
+    v_Tangent = vec4(mat3(model) * tangent.xyz, tangent.w < 0.0 ? -1.0 : 1.0);
+}
@@ -38,20 +38,43 @@
 
 #include "Application.hpp"
 #include "Shader.hpp"
+#include "ShaderHotReload.hpp"
+#include "TextureLoader.hpp"
+#include "TextureCache.hpp"
+#include "SamplerCache.hpp"
+#include "TextureStreamer.hpp"
+#include "MeshCache.hpp"
 #include "Input.hpp"
 #include "Debug.hpp"
 #include "Log.hpp"
 #include "PathUtils.hpp"
+#include "Vfs.hpp"
+#include "AssetManager.hpp"
 // clang-format on
 
 namespace Base
 {
     Application *Base::Application::s_Instance = nullptr;
 
+    namespace
+    {
+        size_t workerThreadCount(int requested)
+        {
+            if (requested > 0)
+            {
+                return static_cast<size_t>(requested);
+            }
+            const unsigned cores = std::thread::hardware_concurrency();
+            return cores > 2 ? cores - 1 : 2;
+        }
+    } // namespace
+
     Application::Application(std::string title, int width, int height, int numOfThreads)
-        : m_Title(std::move(title)), m_Width(width), m_Height(height), m_EventBus(numOfThreads)
+        : m_Title(std::move(title)), m_Width(width), m_Height(height), m_Workers(workerThreadCount(numOfThreads)),
+          m_EventBus(m_Workers)
     {
         s_Instance = this;
+        m_Workers.Start();
     }
 
     Application::~Application()
@@ -234,6 +257,17 @@ namespace Base
 #if PLATFORM_DESKTOP
         glGenQueries(2, m_GpuTimeQueries);
 #endif
+        m_UniformRing.init();
+        m_Geometry.init(VertexLayout::standard(), sizeof(uint16_t));
+        // Built next to the assets directory by the CopyAssets step; it shadows the loose files,
+        // which still serve whatever it lacks.
+        Vfs::mountPak("", "assets.pak");
+        Vfs::mountPrefPath("pref/");
+        ShaderHotReload::Get().initialize();
+        Vfs::setThreadPool(&m_Workers);
+        TextureLoader::Get().initialize(m_Workers);
+        TextureStreamer::Get().initialize(m_Workers);
+        AssetManager::Get().initialize(m_Workers);
         initImGui();
         setup();
     }
@@ -394,6 +428,12 @@ namespace Base
 
         float deltaTime = (float)((double)(frameStartTimeCounter - m_LastFrameTimeCounter) / m_PerfCounterFreq);
         m_LastFrameTimeCounter = frameStartTimeCounter;
+        ShaderHotReload::Get().update();
+        TextureLoader::Get().update();
+        AssetManager::Get().update();
+        TextureCache::Get().update();
+        TextureStreamer::Get().update();
+        m_UniformRing.beginFrame();
         update(deltaTime);
 
 #if PLATFORM_DESKTOP
@@ -428,6 +468,7 @@ namespace Base
         glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
         endImGuiFrame();
+        m_UniformRing.endFrame();
 
 #if PLATFORM_DESKTOP
         glQueryCounter(m_GpuTimeQueries[1], GL_TIMESTAMP);
@@ -471,6 +512,17 @@ namespace Base
         }
 
         cleanupFramebuffer();
+        m_UniformRing.shutdown();
+        m_Geometry.shutdown();
+        ShaderHotReload::Get().shutdown();
+        AssetManager::Get().shutdown();
+        TextureCache::Get().clear();
+        TextureStreamer::Get().shutdown();
+        TextureLoader::Get().shutdown();
+        SamplerCache::Get().clear();
+        Vfs::shutdown();
+        Vfs::setThreadPool(nullptr);
+        Vfs::reset();
 
         ImGui_ImplOpenGL3_Shutdown();
         ImGui_ImplSDL3_Shutdown();
@@ -705,6 +757,89 @@ namespace Base
                 ImGui::Text("FPS: %.1f", io.Framerate);
                 ImGui::Text("CPU Time: %.3f ms", m_CpuTime_ms);
                 ImGui::Text("GPU Time: %.3f ms", m_GpuTime_ms);
+                const UniformBufferRing::Stats &uboStats = m_UniformRing.getStats();
+                ImGui::Text("UBO Ring: %zu / %zu bytes (%u allocs, peak %zu)", uboStats.usedLastFrame, uboStats.bytesPerFrame,
+                            uboStats.allocationsLastFrame, uboStats.peakUsage);
+                const GeometryBuffer::Stats geometryStats = m_Geometry.getStats();
+                ImGui::Text("Geometry: %u ranges, %u / %u vertices, %u / %u indices, %.1f KB%s",
+                            geometryStats.vertices.allocations, geometryStats.vertices.used, geometryStats.vertices.capacity,
+                            geometryStats.indices.used, geometryStats.indices.capacity, geometryStats.bytes / 1024.0,
+                            geometryStats.baseVertex ? "" : " (indices rebased)");
+                TextureLoader &textureLoader = TextureLoader::Get();
+                int uploadBudgetKb = static_cast<int>(textureLoader.getUploadBudget() / 1024);
+                if (ImGui::SliderInt("Texture Upload (KB/frame)", &uploadBudgetKb, 64, 32768))
+                {
+                    textureLoader.setUploadBudget(static_cast<size_t>(uploadBudgetKb) * 1024);
+                }
+                ImGui::Text("Textures loading: %zu  Uploaded: %zu KB", textureLoader.getPendingCount(),
+                            textureLoader.getUploadedLastFrame() / 1024);
+                const TextureCache::Stats &cacheStats = TextureCache::Get().getStats();
+                ImGui::Text("Texture Cache: %zu entries, %zu hits / %zu misses, %.1f MB resident (%.1f MB idle)",
+                            cacheStats.entries, cacheStats.hits, cacheStats.misses,
+                            cacheStats.residentBytes / (1024.0 * 1024.0), cacheStats.idleBytes / (1024.0 * 1024.0));
+                ImGui::Text("Samplers: %zu", SamplerCache::Get().getSamplerCount());
+                const Vfs::Stats vfsStats = Vfs::getStats();
+                ImGui::Text("VFS (%s): %zu async reads, %.1f MB, %zu in flight", Vfs::getAsyncBackendName(),
+                            vfsStats.asyncReads, vfsStats.asyncBytes / (1024.0 * 1024.0), vfsStats.inFlight);
+                const AssetManager::Stats assetStats = AssetManager::Get().getStats();
+                ImGui::Text("Assets: %zu pending, %.2f ms GL work last frame", AssetManager::Get().getPendingCount(),
+                            assetStats.gpuMsLastFrame);
+                for (size_t i = 0; i < assetStats.types.size(); ++i)
+                {
+                    const AssetManager::TypeStats &type = assetStats.types[i];
+                    if (type.requested == 0)
+                    {
+                        continue;
+                    }
+                    ImGui::Text("  %s: %zu loaded, %zu failed, %zu pending, avg %.1f ms, max %.1f ms",
+                                toString(static_cast<AssetType>(i)), type.loaded, type.failed, type.pending,
+                                type.loaded ? type.totalMs / type.loaded : 0.0, type.maxMs);
+                }
+                TextureStreamer &streamer = TextureStreamer::Get();
+                int streamingBudgetMb = static_cast<int>(streamer.getBudget() / (1024 * 1024));
+                if (ImGui::SliderInt("Streaming Budget (MB)", &streamingBudgetMb, 16, 2048))
+                {
+                    streamer.setBudget(static_cast<size_t>(streamingBudgetMb) * 1024 * 1024);
+                }
+                float mipBias = streamer.getMipBias();
+                if (ImGui::SliderFloat("Streaming Mip Bias", &mipBias, -2.0f, 2.0f, "%.1f"))
+                {
+                    streamer.setMipBias(mipBias);
+                }
+                const TextureStreamer::Stats &streamStats = streamer.getStats();
+                ImGui::Text("Streaming: %zu textures, %.1f / %.1f MB, %zu loading, %zu streamed in, %zu evicted",
+                            streamStats.textures, streamStats.residentBytes / (1024.0 * 1024.0),
+                            streamer.getBudget() / (1024.0 * 1024.0), streamStats.pendingLoads, streamStats.streamedIn,
+                            streamStats.evictions);
+                if (streamStats.textures > 0 && ImGui::TreeNode("Streamed Textures"))
+                {
+                    for (const TextureStreamer::TextureInfo &info : streamer.getTextureInfo())
+                    {
+                        ImGui::Text("%s: %dx%d, mip %d/%d (wants %d), %.1f KB%s", info.path.c_str(), info.width, info.height,
+                                    info.residentMip, info.mipCount, info.desiredMip, info.bytes / 1024.0,
+                                    info.loading ? ", loading" : "");
+                    }
+                    ImGui::TreePop();
+                }
+                const MeshCache::Stats meshCacheStats = MeshCache::Get().getStats();
+                ImGui::Text("Mesh Cache: %zu hits (%.1f ms) / %zu imports (%.1f ms)", meshCacheStats.hits,
+                            meshCacheStats.hitMs, meshCacheStats.misses, meshCacheStats.missMs);
+#if PLATFORM_DESKTOP
+                ImGui::Separator();
+                ShaderHotReload &hotReload = ShaderHotReload::Get();
+                bool hotReloadEnabled = hotReload.isEnabled();
+                if (ImGui::Checkbox("Shader Hot Reload", &hotReloadEnabled))
+                {
+                    hotReload.setEnabled(hotReloadEnabled);
+                }
+                float reloadBudget = hotReload.getFrameBudget();
+                if (ImGui::SliderFloat("Reload Budget (ms)", &reloadBudget, 0.5f, 16.0f, "%.1f"))
+                {
+                    hotReload.setFrameBudget(reloadBudget);
+                }
+                ImGui::Text("Watched: %zu  Pending: %zu  Reloaded: %u  Failed: %u", hotReload.getWatchedShaderCount(),
+                            hotReload.getPendingCount(), hotReload.getReloadCount(), hotReload.getFailureCount());
+#endif
                 ImGui::Separator();
 
                 ImGui::Text("UI Scale");
@@ -12,6 +12,8 @@
 
 #include "Camera.hpp"
 #include "EventBus.hpp"
+#include "UniformBufferRing.hpp"
+#include "GeometryBuffer.hpp"
 
 namespace Base
 {
@@ -24,7 +26,8 @@ namespace Base
             SDL_GLContext glcontext;
         };
 
-        Application(std::string title="", int width = 1280, int height = 720, int numOfThreads = 4);
+        // `numOfThreads` sizes the shared worker pool; 0 leaves one core to the main thread.
+        Application(std::string title="", int width = 1280, int height = 720, int numOfThreads = 0);
         Application(const Application &) = delete;
         Application &operator=(const Application &) = delete;
         virtual ~Application();
@@ -43,6 +46,11 @@ namespace Base
         virtual Camera* getActiveCamera() { return nullptr; }
         ParallelEventBus &getEventBus() { return m_EventBus; }
         const ParallelEventBus &getEventBus() const { return m_EventBus; }
+        // Workers shared by the event bus, the texture loader/streamer, the asset manager and the Vfs.
+        ThreadPool &getWorkers() { return m_Workers; }
+        UniformBufferRing &getUniformRing() { return m_UniformRing; }
+        // Shared buffers for small meshes in the MeshVertex layout, with 16-bit indices.
+        GeometryBuffer &getGeometryBuffer() { return m_Geometry; }
         bool isViewportHovered() const { return m_ViewportHovered; }
 
         template <typename EventType>
@@ -102,7 +110,10 @@ namespace Base
         void cleanupFramebuffer();
 
         AppContext appContext;
+        ThreadPool m_Workers; // Before m_EventBus, which queues on it
         ParallelEventBus m_EventBus;
+        UniformBufferRing m_UniformRing;
+        GeometryBuffer m_Geometry;
 
         SubscriptionHandle m_KeySub;
         SubscriptionHandle m_MouseSub;
@@ -0,0 +1,87 @@
+#include "AssetFile.hpp"
+#include "Vfs.hpp"
+
+#include <utility>
+
+namespace Base
+{
+    AssetFile::AssetFile(AssetFile &&other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    AssetFile &AssetFile::operator=(AssetFile &&other) noexcept
+    {
+        if (this != &other)
+        {
+            // Moving the vector and the mapping keeps their addresses, so m_Data stays valid.
+            m_Pak = std::move(other.m_Pak);
+            m_File = std::move(other.m_File);
+            m_Buffer = std::move(other.m_Buffer);
+            m_Data = std::exchange(other.m_Data, nullptr);
+            m_Size = std::exchange(other.m_Size, 0);
+            m_Open = std::exchange(other.m_Open, false);
+            other.close();
+        }
+        return *this;
+    }
+
+    bool AssetFile::open(const std::string &path)
+    {
+        return Vfs::open(path, *this);
+    }
+
+    void AssetFile::close()
+    {
+        m_File.close();
+        m_Pak.reset();
+        m_Buffer = std::vector<uint8_t>();
+        m_Data = nullptr;
+        m_Size = 0;
+        m_Open = false;
+    }
+
+    bool AssetFile::openEntry(std::shared_ptr<const PakFile> pak, const PakFile::Entry &entry)
+    {
+        close();
+        if (entry.compression == PakFile::Compression::None)
+        {
+            m_Data = entry.data;
+        }
+        else
+        {
+            if (!PakFile::read(entry, m_Buffer))
+            {
+                return false;
+            }
+            m_Data = m_Buffer.data();
+        }
+        m_Size = entry.size;
+        m_Pak = std::move(pak);
+        m_Open = true;
+        return true;
+    }
+
+    bool AssetFile::openNative(const std::string &nativePath)
+    {
+        close();
+        if (!m_File.open(nativePath, false))
+        {
+            return false;
+        }
+        m_Data = m_File.data();
+        m_Size = m_File.size();
+        m_Open = true;
+        return true;
+    }
+
+    void AssetFile::assign(std::vector<uint8_t> &&contents)
+    {
+        close();
+        m_Buffer = std::move(contents);
+        m_Data = m_Buffer.data();
+        m_Size = m_Buffer.size();
+        m_Open = true;
+    }
+
+} // namespace Base
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "MappedFile.hpp"
+#include "PakFile.hpp"
+
+namespace Base
+{
+    // Read-only contents of a file of the virtual filesystem (see Vfs), by virtual path
+    // ("shaders/mesh.vert"). Depending on where Vfs found it, the bytes are an uncompressed
+    // archive entry straight from the archive's mapping, an LZ4 entry decompressed into a buffer
+    // the AssetFile owns, a memory-mapped loose file, or a loose file Vfs::readAsync read into
+    // that buffer.
+    class AssetFile
+    {
+    public:
+        AssetFile() = default;
+
+        AssetFile(AssetFile &&other) noexcept;
+        AssetFile &operator=(AssetFile &&other) noexcept;
+        AssetFile(const AssetFile &) = delete;
+        AssetFile &operator=(const AssetFile &) = delete;
+
+        // Quietly false when the file exists nowhere, so that optional files can be probed;
+        // callers report the failures that matter.
+        bool open(const std::string &path);
+        void close();
+
+        // The ways Vfs fills an AssetFile. openNative uses `nativePath` as is; openEntry keeps
+        // `pak` alive while the data is in use; assign takes over bytes read elsewhere.
+        bool openNative(const std::string &nativePath);
+        bool openEntry(std::shared_ptr<const PakFile> pak, const PakFile::Entry &entry);
+        void assign(std::vector<uint8_t> &&contents);
+
+        bool isOpen() const { return m_Open; }
+        // True when the contents came from an archive.
+        bool isPacked() const { return m_Pak != nullptr; }
+        const uint8_t *data() const { return m_Data; }
+        size_t size() const { return m_Size; }
+
+    private:
+        std::shared_ptr<const PakFile> m_Pak; // Keeps the archive mapped while its bytes are in use
+        MappedFile m_File;
+        std::vector<uint8_t> m_Buffer;
+        const uint8_t *m_Data = nullptr;
+        size_t m_Size = 0;
+        bool m_Open = false;
+    };
+
+} // namespace Base
@@ -0,0 +1,634 @@
+#include "AssetManager.hpp"
+#include "AssetFile.hpp"
+#include "Log.hpp"
+#include "MeshCache.hpp"
+#include "TextureCache.hpp"
+#include "Vfs.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <sstream>
+
+namespace Base
+{
+    // State shared by the handles, the worker reading the files and the GL-thread step.
+    struct AssetRecord
+    {
+        AssetType type = AssetType::Mesh;
+        std::string path;
+        std::atomic<AssetState> state = AssetState::Loading;
+        std::chrono::steady_clock::time_point requested = std::chrono::steady_clock::now();
+        std::promise<void> readDone; // Fulfilled once the worker part is done (or there is none)
+        std::future<void> read = readDone.get_future();
+        bool readOk = false;
+        std::shared_ptr<void> object; // The Mesh, Shader or Material once ready
+
+        // Worker output, released once the GL step is done
+        MeshFile meshFile;
+        std::shared_ptr<Mesh> mesh; // While its upload is spread over frames
+        std::string vertexPath;
+        std::string fragmentPath;
+        std::vector<ShaderSpecialization> specializations;
+        ShaderFiles shaderFiles;
+        std::unique_ptr<Material> material;
+        bool dependenciesRequested = false;
+
+        TextureHandle texture; // Texture records only follow a TextureLoader request
+    };
+
+    namespace
+    {
+        size_t typeIndex(AssetType type)
+        {
+            return static_cast<size_t>(type);
+        }
+
+        bool isSettled(const AssetRecord &record)
+        {
+            return record.state == AssetState::Ready || record.state == AssetState::Failed;
+        }
+
+        bool readVector(std::istringstream &fields, int components, glm::vec4 &value)
+        {
+            for (int i = 0; i < components; ++i)
+            {
+                if (!(fields >> value[i]))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    } // namespace
+
+    const char *toString(AssetType type)
+    {
+        switch (type)
+        {
+        case AssetType::Mesh:
+            return "Mesh";
+        case AssetType::Texture:
+            return "Texture";
+        case AssetType::Shader:
+            return "Shader";
+        case AssetType::Material:
+            return "Material";
+        default:
+            return "?";
+        }
+    }
+
+    AssetState AssetHandleBase::getState() const
+    {
+        return m_Record ? m_Record->state.load() : AssetState::Failed;
+    }
+
+    const std::string &AssetHandleBase::getPath() const
+    {
+        static const std::string s_Empty;
+        return m_Record ? m_Record->path : s_Empty;
+    }
+
+    bool AssetHandleBase::wait() const
+    {
+        return m_Record && AssetManager::Get().completeNow(m_Record);
+    }
+
+    void *AssetHandleBase::getObject() const
+    {
+        return isReady() ? m_Record->object.get() : nullptr;
+    }
+
+    bool Material::parse(const char *data, size_t size, const std::string &name, Material &material)
+    {
+        material = Material();
+        std::istringstream stream(std::string(data, size));
+        std::string line;
+        bool hasShader = false;
+        for (int lineNumber = 1; std::getline(stream, line); ++lineNumber)
+        {
+            std::istringstream fields(line);
+            std::string keyword;
+            fields >> keyword;
+            if (keyword.empty() || keyword[0] == '#')
+            {
+                continue;
+            }
+
+            bool valid = false;
+            if (keyword == "shader")
+            {
+                valid = static_cast<bool>(fields >> material.m_VertexPath >> material.m_FragmentPath);
+                hasShader = valid;
+            }
+            else if (keyword == "texture")
+            {
+                // The path runs to the end of the line.
+                TextureSlot slot;
+                valid = static_cast<bool>(fields >> slot.unit >> slot.uniform >> std::ws) && std::getline(fields, slot.path) &&
+                        !slot.path.empty();
+                if (valid)
+                {
+                    material.m_Textures.push_back(std::move(slot));
+                }
+            }
+            else
+            {
+                Parameter parameter;
+                parameter.components = keyword == "float" ? 1 : keyword == "vec2" ? 2 : keyword == "vec3" ? 3 : keyword == "vec4" ? 4 : 0;
+                valid = parameter.components > 0 && static_cast<bool>(fields >> parameter.uniform) &&
+                        readVector(fields, parameter.components, parameter.value);
+                if (valid)
+                {
+                    material.m_Parameters.push_back(std::move(parameter));
+                }
+            }
+            if (!valid)
+            {
+                LOG_ERROR("Material: '{}' line {} is malformed: {}", name, lineNumber, line);
+                return false;
+            }
+        }
+        if (!hasShader)
+        {
+            LOG_ERROR("Material: '{}' has no shader line.", name);
+            return false;
+        }
+        return true;
+    }
+
+    void Material::apply() const
+    {
+        const Shader *shader = m_Shader.get();
+        if (!shader)
+        {
+            return;
+        }
+        shader->use();
+        for (const TextureSlot &slot : m_Textures)
+        {
+            slot.texture.bind(slot.unit);
+            shader->setInt(slot.uniform, static_cast<int>(slot.unit));
+        }
+        for (const Parameter &parameter : m_Parameters)
+        {
+            switch (parameter.components)
+            {
+            case 1:
+                shader->setFloat(parameter.uniform, parameter.value.x);
+                break;
+            case 2:
+                shader->setVec2(parameter.uniform, glm::vec2(parameter.value.x, parameter.value.y));
+                break;
+            case 3:
+                shader->setVec3(parameter.uniform, glm::vec3(parameter.value.x, parameter.value.y, parameter.value.z));
+                break;
+            default:
+                shader->setVec4(parameter.uniform, parameter.value);
+                break;
+            }
+        }
+    }
+
+    AssetManager &AssetManager::Get()
+    {
+        static std::unique_ptr<AssetManager> s_Instance(new AssetManager());
+        return *s_Instance;
+    }
+
+    AssetManager::~AssetManager()
+    {
+        shutdown();
+    }
+
+    void AssetManager::initialize(ThreadPool &workers)
+    {
+        if (m_Initialized)
+        {
+            return;
+        }
+        m_Workers.open(workers);
+        // Separate, so that an import on m_Workers can wait for the tasks it splits off.
+        m_ImportWorkers = std::make_shared<ThreadPool>(std::max(1u, std::thread::hardware_concurrency() / 2));
+        m_ImportWorkers->Start();
+        m_Initialized = true;
+    }
+
+    void AssetManager::shutdown()
+    {
+        if (!m_Initialized)
+        {
+            return;
+        }
+
+        // close() waits for the queued reads and Stop() lets the import workers drain theirs, so no
+        // worker touches a record after this.
+        m_Workers.close();
+        m_ImportWorkers->Stop();
+        m_ImportWorkers.reset();
+
+        {
+            std::lock_guard<std::mutex> lock(m_ReadMutex);
+            m_Pending.insert(m_Pending.end(), m_Read.begin(), m_Read.end());
+            m_Read.clear();
+        }
+        for (const std::shared_ptr<AssetRecord> &record : m_Pending)
+        {
+            record->state = AssetState::Failed;
+        }
+        m_Pending.clear();
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Records.clear();
+        m_Initialized = false;
+    }
+
+    std::shared_ptr<AssetRecord> AssetManager::findOrCreate(AssetType type, const std::string &key, const std::string &path, bool &created)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        std::weak_ptr<AssetRecord> &slot = m_Records[key];
+        if (std::shared_ptr<AssetRecord> existing = slot.lock())
+        {
+            created = false;
+            return existing;
+        }
+        auto record = std::make_shared<AssetRecord>();
+        record->type = type;
+        record->path = path;
+        slot = record;
+        m_Stats.types[typeIndex(type)].requested++;
+        created = true;
+        return record;
+    }
+
+    void AssetManager::startRead(const std::shared_ptr<AssetRecord> &record)
+    {
+        if (!m_Initialized)
+        {
+            LOG_ERROR("AssetManager: '{}' requested before initialize().", record->path);
+            record->readDone.set_value();
+            std::lock_guard<std::mutex> lock(m_ReadMutex);
+            m_Read.push_back(record);
+            return;
+        }
+        m_Workers.Enqueue([this, record]()
+                           {
+            readOnWorker(*record);
+            record->readDone.set_value();
+            std::lock_guard<std::mutex> lock(m_ReadMutex);
+            m_Read.push_back(record); });
+    }
+
+    void AssetManager::readOnWorker(AssetRecord &record)
+    {
+        switch (record.type)
+        {
+        case AssetType::Mesh:
+            record.readOk = MeshCache::Get().load(record.path, record.meshFile, m_ImportWorkers.get());
+            break;
+        case AssetType::Shader:
+            record.readOk = Shader::readFiles(record.vertexPath, record.fragmentPath, record.shaderFiles);
+            break;
+        case AssetType::Material:
+        {
+            AssetFile file;
+            if (!file.open(record.path))
+            {
+                LOG_ERROR("Material: could not open '{}'.", record.path);
+                break;
+            }
+            record.material = std::make_unique<Material>();
+            record.readOk = Material::parse(reinterpret_cast<const char *>(file.data()), file.size(), record.path, *record.material);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    MeshHandle AssetManager::loadMesh(const std::string &path)
+    {
+        const std::string normalized = Vfs::normalizePath(path);
+        bool created = false;
+        std::shared_ptr<AssetRecord> record = findOrCreate(AssetType::Mesh, "mesh|" + normalized, normalized, created);
+        if (created)
+        {
+            startRead(record);
+        }
+        return MeshHandle(record);
+    }
+
+    TextureHandle AssetManager::loadTexture(const std::string &path)
+    {
+        return loadTexture(path, TextureSettings());
+    }
+
+    TextureHandle AssetManager::loadTexture(const std::string &path, const TextureSettings &settings)
+    {
+        TextureCache &cache = TextureCache::Get();
+        const size_t misses = cache.getStats().misses;
+        TextureHandle handle = cache.acquire(path, settings);
+        if (cache.getStats().misses == misses || !m_Initialized)
+        {
+            return handle; // Shared with an earlier request; that one is tracked already
+        }
+
+        // TextureLoader does the work; the record only follows it for the statistics.
+        auto record = std::make_shared<AssetRecord>();
+        record->type = AssetType::Texture;
+        record->path = path;
+        record->texture = handle;
+        record->readOk = true;
+        record->readDone.set_value();
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stats.types[typeIndex(AssetType::Texture)].requested++;
+        }
+        m_Pending.push_back(std::move(record));
+        return handle;
+    }
+
+    ShaderHandle AssetManager::loadShader(const std::string &vertexPath, const std::string &fragmentPath)
+    {
+        return loadShader(vertexPath, fragmentPath, {});
+    }
+
+    ShaderHandle AssetManager::loadShader(const std::string &vertexPath, const std::string &fragmentPath,
+                                          const std::vector<ShaderSpecialization> &specializations)
+    {
+        std::string key = "shader|" + Vfs::normalizePath(vertexPath) + "|" + Vfs::normalizePath(fragmentPath);
+        for (const ShaderSpecialization &specialization : specializations)
+        {
+            key += "|" + specialization.name + "=" + std::to_string(specialization.value);
+        }
+        bool created = false;
+        std::shared_ptr<AssetRecord> record = findOrCreate(AssetType::Shader, key, vertexPath + " + " + fragmentPath, created);
+        if (created)
+        {
+            record->vertexPath = vertexPath;
+            record->fragmentPath = fragmentPath;
+            record->specializations = specializations;
+            startRead(record);
+        }
+        return ShaderHandle(record);
+    }
+
+    MaterialHandle AssetManager::loadMaterial(const std::string &path)
+    {
+        const std::string normalized = Vfs::normalizePath(path);
+        bool created = false;
+        std::shared_ptr<AssetRecord> record = findOrCreate(AssetType::Material, "material|" + normalized, normalized, created);
+        if (created)
+        {
+            startRead(record);
+        }
+        return MaterialHandle(record);
+    }
+
+    void AssetManager::update()
+    {
+        if (!m_Initialized)
+        {
+            return;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        auto elapsedMs = [&start]()
+        { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(); };
+
+        {
+            std::lock_guard<std::mutex> lock(m_ReadMutex);
+            for (std::shared_ptr<AssetRecord> &record : m_Read)
+            {
+                record->state = AssetState::Uploading;
+                m_Pending.push_back(std::move(record));
+            }
+            m_Read.clear();
+        }
+
+        // Everything in m_Pending costs little except mesh uploads and shader builds; those stop
+        // once the budget is used up (after at least one, so loading always makes progress).
+        bool didGpuWork = false;
+        for (size_t i = 0; i < m_Pending.size();)
+        {
+            AssetRecord &record = *m_Pending[i];
+            const bool gpuWork = (record.type == AssetType::Mesh || record.type == AssetType::Shader) && record.readOk;
+            if (gpuWork && didGpuWork && elapsedMs() >= m_FrameBudgetMs)
+            {
+                ++i;
+                continue;
+            }
+            didGpuWork |= gpuWork;
+            if (advance(record))
+            {
+                m_Pending.erase(m_Pending.begin() + static_cast<std::ptrdiff_t>(i));
+            }
+            else
+            {
+                ++i;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stats.gpuMsLastFrame = elapsedMs();
+    }
+
+    bool AssetManager::advance(AssetRecord &record)
+    {
+        if (!record.readOk)
+        {
+            settle(record, false);
+            return true;
+        }
+
+        switch (record.type)
+        {
+        case AssetType::Mesh:
+        {
+            // Meshes over the chunk size are copied a slice per update, so that a large model
+            // cannot stall a frame; smaller ones go straight into immutable buffers.
+            const MeshView &view = record.meshFile.getView();
+            const size_t bytes = static_cast<size_t>(view.vertexCount) * view.layout.stride +
+                                 static_cast<size_t>(view.indexCount) * view.indexSize;
+            bool loaded = true;
+            if (!record.mesh)
+            {
+                record.mesh = std::make_shared<Mesh>();
+                loaded = bytes <= m_UploadChunkBytes ? record.mesh->upload(view) : record.mesh->beginUpload(view);
+            }
+            if (loaded && record.mesh->isUploading() && !record.mesh->uploadChunk(view, m_UploadChunkBytes))
+            {
+                return false;
+            }
+            record.meshFile.close();
+            if (loaded)
+            {
+                record.object = std::move(record.mesh);
+            }
+            record.mesh.reset();
+            settle(record, loaded);
+            return true;
+        }
+        case AssetType::Shader:
+        {
+            auto shader = std::make_shared<Shader>();
+            const bool loaded = shader->load(record.shaderFiles, record.specializations);
+            record.shaderFiles = ShaderFiles();
+            if (loaded)
+            {
+                record.object = std::move(shader);
+            }
+            settle(record, loaded);
+            return true;
+        }
+        case AssetType::Texture:
+        {
+            const TextureLoadState state = record.texture.getState();
+            if (state != TextureLoadState::Ready && state != TextureLoadState::Failed)
+            {
+                return false;
+            }
+            settle(record, state == TextureLoadState::Ready);
+            record.texture = TextureHandle();
+            return true;
+        }
+        case AssetType::Material:
+            return resolveMaterial(record);
+        default:
+            settle(record, false);
+            return true;
+        }
+    }
+
+    bool AssetManager::resolveMaterial(AssetRecord &record)
+    {
+        Material &material = *record.material;
+        if (!record.dependenciesRequested)
+        {
+            // Requested from the GL thread, where the texture loader creates its objects.
+            material.m_Shader = loadShader(material.m_VertexPath, material.m_FragmentPath);
+            for (Material::TextureSlot &slot : material.m_Textures)
+            {
+                slot.texture = loadTexture(slot.path);
+            }
+            record.dependenciesRequested = true;
+            record.state = AssetState::Loading;
+        }
+
+        bool ready = material.m_Shader.isReady();
+        bool failed = material.m_Shader.isFailed();
+        for (const Material::TextureSlot &slot : material.m_Textures)
+        {
+            ready &= slot.texture.isReady();
+            failed |= slot.texture.isFailed();
+        }
+        if (failed)
+        {
+            LOG_ERROR("Material: '{}' failed, one of its shaders or textures did not load.", record.path);
+            record.material.reset();
+            settle(record, false);
+            return true;
+        }
+        if (!ready)
+        {
+            return false;
+        }
+        record.object = std::shared_ptr<Material>(std::move(record.material));
+        settle(record, true);
+        return true;
+    }
+
+    void AssetManager::settle(AssetRecord &record, bool loaded)
+    {
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - record.requested).count();
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            TypeStats &stats = m_Stats.types[typeIndex(record.type)];
+            if (loaded)
+            {
+                stats.loaded++;
+                stats.totalMs += ms;
+                stats.maxMs = std::max(stats.maxMs, ms);
+            }
+            else
+            {
+                stats.failed++;
+            }
+        }
+        if (loaded && record.type != AssetType::Texture)
+        {
+            LOG_DEBUG("AssetManager: {} '{}' ready after {:.1f} ms.", toString(record.type), record.path, ms);
+        }
+        record.state = loaded ? AssetState::Ready : AssetState::Failed;
+    }
+
+    bool AssetManager::completeNow(const std::shared_ptr<AssetRecord> &record)
+    {
+        if (isSettled(*record))
+        {
+            return record->state == AssetState::Ready;
+        }
+
+        record->read.wait();
+        {
+            std::lock_guard<std::mutex> lock(m_ReadMutex);
+            for (std::shared_ptr<AssetRecord> &read : m_Read)
+            {
+                read->state = AssetState::Uploading;
+                m_Pending.push_back(std::move(read));
+            }
+            m_Read.clear();
+        }
+        // Not in m_Pending when requested before initialize() and never updated; advance anyway.
+        if (record->type == AssetType::Material && record->readOk)
+        {
+            resolveMaterial(*record);
+            if (!isSettled(*record))
+            {
+                record->material->m_Shader.wait();
+                for (const Material::TextureSlot &slot : record->material->m_Textures)
+                {
+                    slot.texture.wait();
+                }
+                resolveMaterial(*record);
+            }
+        }
+        else
+        {
+            while (!advance(*record))
+            {
+            }
+        }
+
+        auto it = std::find(m_Pending.begin(), m_Pending.end(), record);
+        if (it != m_Pending.end())
+        {
+            m_Pending.erase(it);
+        }
+        return record->state == AssetState::Ready;
+    }
+
+    size_t AssetManager::getPendingCount() const
+    {
+        const Stats stats = getStats();
+        size_t pending = 0;
+        for (const TypeStats &type : stats.types)
+        {
+            pending += type.pending;
+        }
+        return pending;
+    }
+
+    AssetManager::Stats AssetManager::getStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        Stats stats = m_Stats;
+        for (TypeStats &type : stats.types)
+        {
+            type.pending = type.requested - type.loaded - type.failed;
+        }
+        return stats;
+    }
+
+} // namespace Base
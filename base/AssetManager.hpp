@@ -0,0 +1,220 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Mesh.hpp"
+#include "Shader.hpp"
+#include "TextureLoader.hpp"
+#include "ThreadPool.hpp"
+
+namespace Base
+{
+    enum class AssetType : uint8_t
+    {
+        Mesh,
+        Texture,
+        Shader,
+        Material,
+        Count
+    };
+
+    enum class AssetState : uint8_t
+    {
+        Loading,   // Reading/decoding on a worker thread, or waiting for its dependencies
+        Uploading, // Waiting for (or in the middle of) its part on the GL thread
+        Ready,
+        Failed
+    };
+
+    const char *toString(AssetType type);
+
+    struct AssetRecord;
+
+    // Untyped half of AssetHandle. Cheap to copy; the asset lives as long as any handle does.
+    class AssetHandleBase
+    {
+    public:
+        bool isValid() const { return m_Record != nullptr; }
+        AssetState getState() const;
+        bool isReady() const { return getState() == AssetState::Ready; }
+        bool isFailed() const { return getState() == AssetState::Failed; }
+        const std::string &getPath() const;
+
+        // Blocks until the asset (and everything it depends on) is loaded or has failed. GL
+        // thread only; for code that cannot go on without it.
+        bool wait() const;
+
+    protected:
+        friend class AssetManager;
+        AssetHandleBase() = default;
+        explicit AssetHandleBase(std::shared_ptr<AssetRecord> record) : m_Record(std::move(record)) {}
+        void *getObject() const;
+
+        std::shared_ptr<AssetRecord> m_Record;
+    };
+
+    // Typed reference to an asset loaded by AssetManager.
+    template <typename T>
+    class AssetHandle : public AssetHandleBase
+    {
+    public:
+        AssetHandle() = default;
+
+        // nullptr until the asset is ready.
+        T *get() const { return static_cast<T *>(getObject()); }
+
+    private:
+        friend class AssetManager;
+        explicit AssetHandle(std::shared_ptr<AssetRecord> record) : AssetHandleBase(std::move(record)) {}
+    };
+
+    class Material;
+    using MeshHandle = AssetHandle<Mesh>;
+    using ShaderHandle = AssetHandle<Shader>;
+    using MaterialHandle = AssetHandle<Material>;
+
+    // A shader plus the textures and uniform values it is drawn with, as read from a .mat file:
+    //
+    //   # comment
+    //   shader   shaders/chapter15.vert shaders/chapter15.frag
+    //   texture  <unit> <sampler uniform> <image path>
+    //   float    <uniform> <x>
+    //   vec2 / vec3 / vec4  <uniform> <x> <y> [<z> [<w>]]
+    //
+    // Texture and image paths are relative to the assets root, like every asset path.
+    class Material
+    {
+    public:
+        struct TextureSlot
+        {
+            GLuint unit = 0;
+            std::string uniform;
+            std::string path;
+            TextureHandle texture;
+        };
+
+        struct Parameter
+        {
+            std::string uniform;
+            int components = 1;
+            glm::vec4 value{0.0f};
+        };
+
+        static bool parse(const char *data, size_t size, const std::string &name, Material &material);
+
+        const ShaderHandle &getShader() const { return m_Shader; }
+        const std::vector<TextureSlot> &getTextures() const { return m_Textures; }
+        const std::vector<Parameter> &getParameters() const { return m_Parameters; }
+
+        // Uses the shader, binds the textures (or the loader's placeholder) to their units and
+        // sets the sampler and parameter uniforms.
+        void apply() const;
+
+    private:
+        friend class AssetManager;
+
+        std::string m_VertexPath;
+        std::string m_FragmentPath;
+        ShaderHandle m_Shader;
+        std::vector<TextureSlot> m_Textures;
+        std::vector<Parameter> m_Parameters;
+    };
+
+    // Loads meshes, textures, shaders and materials in the background and hands out typed handles
+    // right away, so setup code never waits for IO. File reading, decoding and mesh imports run
+    // on a thread pool; update() does the GL part on the GL thread, within a per-frame time
+    // budget, uploading large meshes a slice at a time. A material depends on its shader and
+    // textures: those are requested once its file is parsed, and it becomes ready when all of
+    // them are (or fails with the first that fails).
+    //
+    // Requests for an asset that is still referenced share it; textures go through
+    // TextureCache/TextureLoader, which already stream them in.
+    class AssetManager
+    {
+    public:
+        struct TypeStats
+        {
+            size_t requested = 0; // Loads started (shared requests not counted)
+            size_t loaded = 0;
+            size_t failed = 0;
+            size_t pending = 0;
+            double totalMs = 0.0; // Request to ready, summed over the loaded assets
+            double maxMs = 0.0;
+        };
+
+        struct Stats
+        {
+            std::array<TypeStats, static_cast<size_t>(AssetType::Count)> types{};
+            double gpuMsLastFrame = 0.0; // Spent in update() on GL work
+        };
+
+        static AssetManager &Get();
+
+        AssetManager() = default;
+        ~AssetManager();
+
+        AssetManager(const AssetManager &) = delete;
+        AssetManager &operator=(const AssetManager &) = delete;
+
+        // Reads run on `workers`, shared with the rest of the application; mesh imports split
+        // their work onto a pool of the manager's own.
+        void initialize(ThreadPool &workers);
+        void shutdown();
+
+        MeshHandle loadMesh(const std::string &path);
+        TextureHandle loadTexture(const std::string &path, const TextureSettings &settings);
+        TextureHandle loadTexture(const std::string &path);
+        ShaderHandle loadShader(const std::string &vertexPath, const std::string &fragmentPath,
+                                const std::vector<ShaderSpecialization> &specializations);
+        ShaderHandle loadShader(const std::string &vertexPath, const std::string &fragmentPath);
+        MaterialHandle loadMaterial(const std::string &path);
+
+        // Called once per frame on the GL thread, after TextureLoader::update().
+        void update();
+
+        void setFrameBudget(float milliseconds) { m_FrameBudgetMs = milliseconds; }
+        float getFrameBudget() const { return m_FrameBudgetMs; }
+        // Meshes larger than this are uploaded in slices of this size, one per update().
+        void setUploadChunkSize(size_t bytes) { m_UploadChunkBytes = bytes; }
+        size_t getUploadChunkSize() const { return m_UploadChunkBytes; }
+        size_t getPendingCount() const;
+        Stats getStats() const;
+
+    private:
+        friend class AssetHandleBase;
+
+        std::shared_ptr<AssetRecord> findOrCreate(AssetType type, const std::string &key, const std::string &path, bool &created);
+        void startRead(const std::shared_ptr<AssetRecord> &record);
+        void readOnWorker(AssetRecord &record);
+        // GL-thread step of a record whose worker part is done. Returns true once it is settled.
+        bool advance(AssetRecord &record);
+        bool resolveMaterial(AssetRecord &record);
+        void settle(AssetRecord &record, bool loaded);
+        bool completeNow(const std::shared_ptr<AssetRecord> &record);
+
+        TaskGroup m_Workers;
+        std::shared_ptr<ThreadPool> m_ImportWorkers; // Per-chunk/per-mesh tasks of the mesh importers
+
+        mutable std::mutex m_Mutex; // Guards m_Records and m_Stats (workers record failures)
+        std::unordered_map<std::string, std::weak_ptr<AssetRecord>> m_Records;
+        Stats m_Stats;
+
+        std::mutex m_ReadMutex;
+        std::vector<std::shared_ptr<AssetRecord>> m_Read; // Filled by workers
+        std::vector<std::shared_ptr<AssetRecord>> m_Pending; // GL thread only: read, or waiting on dependencies
+
+        float m_FrameBudgetMs = 4.0f;
+        size_t m_UploadChunkBytes = 4 * 1024 * 1024;
+        bool m_Initialized = false;
+    };
+
+} // namespace Base
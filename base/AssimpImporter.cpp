@@ -0,0 +1,244 @@
+#include "AssimpImporter.hpp"
+#include "AssetFile.hpp"
+#include "Log.hpp"
+
+#include <assimp/IOStream.hpp>
+#include <assimp/IOSystem.hpp>
+#include <assimp/config.h>
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+
+namespace Base
+{
+    namespace
+    {
+        double millisecondsSince(std::chrono::steady_clock::time_point start)
+        {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        // Read-only stream over an AssetFile.
+        class AssetStream : public Assimp::IOStream
+        {
+        public:
+            explicit AssetStream(AssetFile &&file) : m_File(std::move(file)) {}
+
+            size_t Read(void *buffer, size_t size, size_t count) override
+            {
+                if (size == 0)
+                {
+                    return 0;
+                }
+                count = std::min(count, (m_File.size() - m_Position) / size);
+                std::memcpy(buffer, m_File.data() + m_Position, size * count);
+                m_Position += size * count;
+                return count;
+            }
+
+            size_t Write(const void *, size_t, size_t) override { return 0; }
+
+            aiReturn Seek(size_t offset, aiOrigin origin) override
+            {
+                const size_t base = origin == aiOrigin_CUR ? m_Position : origin == aiOrigin_END ? m_File.size() : 0;
+                if (origin == aiOrigin_END ? offset > base : base + offset > m_File.size())
+                {
+                    return aiReturn_FAILURE;
+                }
+                m_Position = origin == aiOrigin_END ? base - offset : base + offset;
+                return aiReturn_SUCCESS;
+            }
+
+            size_t Tell() const override { return m_Position; }
+            size_t FileSize() const override { return m_File.size(); }
+            void Flush() override {}
+
+        private:
+            AssetFile m_File;
+            size_t m_Position = 0;
+        };
+
+        // Opens the files a model refers to relative to its directory: through the Vfs for asset
+        // paths, or as is for the tools' native paths.
+        class AssetIoSystem : public Assimp::IOSystem
+        {
+        public:
+            explicit AssetIoSystem(std::string directory) : m_Directory(std::move(directory)) {}
+
+            bool Exists(const char *path) const override
+            {
+                AssetFile file;
+                return open(path, file);
+            }
+
+            char getOsSeparator() const override { return '/'; }
+
+            Assimp::IOStream *Open(const char *path, const char *mode) override
+            {
+                AssetFile file;
+                if (std::strchr(mode, 'w') || std::strchr(mode, 'a') || !open(path, file))
+                {
+                    return nullptr;
+                }
+                return new AssetStream(std::move(file));
+            }
+
+            void Close(Assimp::IOStream *stream) override { delete stream; }
+
+        private:
+            bool open(const char *path, AssetFile &file) const
+            {
+                const std::string fullPath = (std::filesystem::path(m_Directory) / path).generic_string();
+                return file.open(fullPath) || file.openNative(fullPath);
+            }
+
+            std::string m_Directory;
+        };
+
+        struct MeshRange
+        {
+            const aiMesh *source = nullptr;
+            uint32_t firstVertex = 0;
+            uint32_t firstIndex = 0;
+        };
+
+        void convertMesh(const MeshRange &range, MeshData &mesh)
+        {
+            const aiMesh &source = *range.source;
+            MeshVertex *vertices = mesh.vertices.data() + range.firstVertex;
+            for (unsigned i = 0; i < source.mNumVertices; ++i)
+            {
+                const aiVector3D &position = source.mVertices[i];
+                vertices[i].position = glm::vec3(position.x, position.y, position.z);
+                if (source.mNormals)
+                {
+                    const aiVector3D &normal = source.mNormals[i];
+                    vertices[i].normal = glm::vec3(normal.x, normal.y, normal.z);
+                }
+                if (source.mTextureCoords[0])
+                {
+                    const aiVector3D &texCoord = source.mTextureCoords[0][i];
+                    vertices[i].texCoord = glm::vec2(texCoord.x, texCoord.y);
+                }
+            }
+
+            uint32_t *indices = mesh.indices.data() + range.firstIndex;
+            for (unsigned i = 0; i < source.mNumFaces; ++i)
+            {
+                const aiFace &face = source.mFaces[i];
+                for (unsigned corner = 0; corner < 3; ++corner)
+                {
+                    *indices++ = range.firstVertex + face.mIndices[corner];
+                }
+            }
+        }
+    } // namespace
+
+    bool AssimpImporter::supports(const std::string &extension)
+    {
+        Assimp::Importer importer;
+        return importer.IsExtensionSupported(extension);
+    }
+
+    bool AssimpImporter::parse(const uint8_t *data, size_t size, const std::string &name, MeshData &mesh, ThreadPool *pool,
+                               Stats *stats)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        Stats result;
+        mesh = MeshData();
+
+        Assimp::Importer importer;
+        importer.SetIOHandler(new AssetIoSystem(std::filesystem::path(name).parent_path().generic_string()));
+        // Only triangles are drawn; SortByPType moves points and lines into meshes of their own.
+        importer.SetPropertyInteger(AI_CONFIG_PP_SBP_REMOVE, aiPrimitiveType_POINT | aiPrimitiveType_LINE);
+        const std::string extension = std::filesystem::path(name).extension().string();
+        const aiScene *scene = importer.ReadFileFromMemory(
+            data, size,
+            aiProcess_Triangulate | aiProcess_SortByPType | aiProcess_JoinIdenticalVertices | aiProcess_GenSmoothNormals |
+                aiProcess_PreTransformVertices | aiProcess_ValidateDataStructure,
+            extension.empty() ? "" : extension.c_str() + 1);
+        if (!scene || (scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE))
+        {
+            LOG_ERROR("AssimpImporter: cannot import '{}': {}", name, importer.GetErrorString());
+            return false;
+        }
+        result.readMs = millisecondsSince(start);
+
+        // Offsets are assigned up front so that every mesh converts into its own slice.
+        const auto convertStart = std::chrono::steady_clock::now();
+        std::vector<MeshRange> ranges;
+        size_t vertexCount = 0;
+        size_t indexCount = 0;
+        for (unsigned i = 0; i < scene->mNumMeshes; ++i)
+        {
+            const aiMesh *source = scene->mMeshes[i];
+            if (source->mPrimitiveTypes != aiPrimitiveType_TRIANGLE || source->mNumFaces == 0)
+            {
+                result.skippedMeshes++;
+                continue;
+            }
+            ranges.push_back({source, static_cast<uint32_t>(vertexCount), static_cast<uint32_t>(indexCount)});
+            vertexCount += source->mNumVertices;
+            indexCount += static_cast<size_t>(source->mNumFaces) * 3;
+        }
+        if (ranges.empty() || vertexCount > UINT32_MAX || indexCount > UINT32_MAX)
+        {
+            LOG_ERROR("AssimpImporter: '{}' has {}.", name, ranges.empty() ? "no triangles" : "too many vertices");
+            return false;
+        }
+
+        mesh.vertices.resize(vertexCount);
+        mesh.indices.resize(indexCount);
+        for (const MeshRange &range : ranges)
+        {
+            SubMesh subMesh;
+            subMesh.name = range.source->mName.C_Str();
+            if (range.source->mMaterialIndex < scene->mNumMaterials)
+            {
+                subMesh.material = scene->mMaterials[range.source->mMaterialIndex]->GetName().C_Str();
+            }
+            subMesh.firstIndex = range.firstIndex;
+            subMesh.indexCount = range.source->mNumFaces * 3;
+            mesh.subMeshes.push_back(std::move(subMesh));
+        }
+
+        if (!pool || ranges.size() < 2)
+        {
+            for (const MeshRange &range : ranges)
+            {
+                convertMesh(range, mesh);
+            }
+        }
+        else
+        {
+            std::vector<std::future<void>> pending;
+            pending.reserve(ranges.size());
+            for (const MeshRange &range : ranges)
+            {
+                pending.push_back(pool->Enqueue([&range, &mesh]() { convertMesh(range, mesh); }));
+            }
+            for (std::future<void> &task : pending)
+            {
+                task.get();
+            }
+        }
+        mesh.computeBounds();
+        result.convertMs = millisecondsSince(convertStart);
+
+        result.meshes = ranges.size();
+        result.totalMs = millisecondsSince(start);
+        LOG_DEBUG("AssimpImporter: '{}': {} meshes, {} vertices, {} triangles; read {:.2f} ms, converted {:.2f} ms.", name,
+                  result.meshes, vertexCount, indexCount / 3, result.readMs, result.convertMs);
+        if (stats)
+        {
+            *stats = result;
+        }
+        return true;
+    }
+
+} // namespace Base
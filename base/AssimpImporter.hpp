@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "Mesh.hpp"
+#include "ThreadPool.hpp"
+
+namespace Base
+{
+    // Imports the model formats assimp is built with (glTF/GLB, FBX, Collada and STL, see the
+    // root CMakeLists; .obj goes through ObjLoader) into a MeshData. assimp reads the scene and
+    // runs its post-processing on the calling thread: triangulation, welding, smooth normals
+    // where the file has none, and node transforms baked into the vertices so that the scene
+    // collapses into one mesh per material. The meshes are then converted into the shared
+    // vertex and index arrays in parallel, one task per mesh, each becoming a SubMesh named after
+    // its material.
+    //
+    // Files the model refers to (a .gltf's buffers) are opened next to it, through the Vfs.
+    class AssimpImporter
+    {
+    public:
+        struct Stats
+        {
+            size_t meshes = 0;
+            size_t skippedMeshes = 0; // Points and lines
+            double readMs = 0.0;      // assimp, post-processing included
+            double convertMs = 0.0;
+            double totalMs = 0.0;
+        };
+
+        // True for an extension (".gltf") this build of assimp reads.
+        static bool supports(const std::string &extension);
+
+        // `name` is the model's path, used to find the files it refers to and in messages. With a
+        // started `pool`, the meshes are converted on its workers; do not call this from one of
+        // that pool's own tasks.
+        static bool parse(const uint8_t *data, size_t size, const std::string &name, MeshData &mesh,
+                          ThreadPool *pool = nullptr, Stats *stats = nullptr);
+    };
+
+} // namespace Base
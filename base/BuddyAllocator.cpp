@@ -0,0 +1,133 @@
+#include "BuddyAllocator.hpp"
+#include "Log.hpp"
+
+#include <algorithm>
+
+namespace Base
+{
+    void BuddyAllocator::reset(uint32_t capacity, uint32_t minBlock)
+    {
+        // Buddies are found by flipping one offset bit, so block sizes must be powers of two.
+        m_MinBlock = 1;
+        while (m_MinBlock < minBlock && m_MinBlock < (1u << 16))
+        {
+            m_MinBlock *= 2;
+        }
+        uint32_t order = 0;
+        while (blockSize(order) < capacity && blockSize(order) <= UINT32_MAX / 4)
+        {
+            ++order;
+        }
+        m_Capacity = blockSize(order);
+        m_Free.assign(order + 1, {});
+        m_Free[order].insert(0);
+        m_Allocations.clear();
+        m_Used = 0;
+        m_Reserved = 0;
+    }
+
+    uint32_t BuddyAllocator::allocate(uint32_t count)
+    {
+        if (count == 0 || count > m_Capacity)
+        {
+            return kInvalidOffset;
+        }
+        uint32_t order = 0;
+        while (blockSize(order) < count)
+        {
+            ++order;
+        }
+
+        uint32_t available = order;
+        while (available < m_Free.size() && m_Free[available].empty())
+        {
+            ++available;
+        }
+        if (available >= m_Free.size())
+        {
+            return kInvalidOffset;
+        }
+
+        // Lowest free block first keeps the used part of the range packed at its start.
+        const uint32_t offset = *m_Free[available].begin();
+        m_Free[available].erase(m_Free[available].begin());
+        while (available > order)
+        {
+            --available;
+            m_Free[available].insert(offset + blockSize(available));
+        }
+
+        m_Allocations[offset] = {count, static_cast<uint8_t>(order)};
+        m_Used += count;
+        m_Reserved += blockSize(order);
+        return offset;
+    }
+
+    void BuddyAllocator::free(uint32_t offset)
+    {
+        auto it = m_Allocations.find(offset);
+        if (it == m_Allocations.end())
+        {
+            LOG_ERROR("BuddyAllocator: {} is not an allocation.", offset);
+            return;
+        }
+        uint32_t order = it->second.order;
+        m_Used -= it->second.count;
+        m_Reserved -= blockSize(order);
+        m_Allocations.erase(it);
+
+        while (order + 1 < m_Free.size())
+        {
+            const uint32_t buddy = offset ^ blockSize(order);
+            auto buddyBlock = m_Free[order].find(buddy);
+            if (buddyBlock == m_Free[order].end())
+            {
+                break;
+            }
+            m_Free[order].erase(buddyBlock);
+            offset = std::min(offset, buddy);
+            ++order;
+        }
+        m_Free[order].insert(offset);
+    }
+
+    bool BuddyAllocator::grow()
+    {
+        if (m_Free.empty() || m_Capacity > UINT32_MAX / 4)
+        {
+            return false;
+        }
+        // The old range becomes the lower half of the new one; the upper half is its free buddy.
+        const size_t top = m_Free.size() - 1;
+        m_Free.emplace_back();
+        if (m_Free[top].erase(0) != 0)
+        {
+            m_Free[top + 1].insert(0);
+        }
+        else
+        {
+            m_Free[top].insert(m_Capacity);
+        }
+        m_Capacity *= 2;
+        return true;
+    }
+
+    BuddyAllocator::Stats BuddyAllocator::getStats() const
+    {
+        Stats stats;
+        stats.capacity = m_Capacity;
+        stats.used = m_Used;
+        stats.reserved = m_Reserved;
+        stats.allocations = static_cast<uint32_t>(m_Allocations.size());
+        for (size_t order = m_Free.size(); order-- > 0;)
+        {
+            if (!m_Free[order].empty())
+            {
+                stats.largestFree = blockSize(static_cast<uint32_t>(order));
+                break;
+            }
+        }
+        return stats;
+    }
+
+} // namespace Base
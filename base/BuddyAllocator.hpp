@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+namespace Base
+{
+    // Buddy allocator over the range [0, capacity) of some unit (vertices, indices). Blocks are
+    // power-of-two sizes of at least `minBlock` units; a request gets the smallest block that
+    // fits, split off a larger one if needed, and a freed block merges with its buddy whenever
+    // that is free too, so the range never fragments into pieces smaller than what is free
+    // around them. Allocations are placed as low as possible, and grow() doubles the range while
+    // keeping every offset.
+    class BuddyAllocator
+    {
+    public:
+        static constexpr uint32_t kInvalidOffset = UINT32_MAX;
+
+        struct Stats
+        {
+            uint32_t capacity = 0;
+            uint32_t used = 0;     // Units requested
+            uint32_t reserved = 0; // Units in allocated blocks (requests rounded up)
+            uint32_t allocations = 0;
+            uint32_t largestFree = 0;
+        };
+
+        BuddyAllocator() = default;
+
+        // `minBlock` is rounded up to a power of two, and `capacity` to a multiple of it that is
+        // a power of two. Drops every allocation.
+        void reset(uint32_t capacity, uint32_t minBlock = 1);
+
+        // Offset of `count` units, or kInvalidOffset when no free block is large enough.
+        uint32_t allocate(uint32_t count);
+        void free(uint32_t offset);
+        // Doubles the capacity. False when it would overflow.
+        bool grow();
+
+        uint32_t getCapacity() const { return m_Capacity; }
+        Stats getStats() const;
+
+    private:
+        struct Allocation
+        {
+            uint32_t count = 0;
+            uint8_t order = 0;
+        };
+
+        uint32_t blockSize(uint32_t order) const { return m_MinBlock << order; }
+
+        uint32_t m_MinBlock = 1;
+        uint32_t m_Capacity = 0;
+        std::vector<std::set<uint32_t>> m_Free; // Free block offsets by order
+        std::unordered_map<uint32_t, Allocation> m_Allocations;
+        uint32_t m_Used = 0;
+        uint32_t m_Reserved = 0;
+    };
+
+} // namespace Base
@@ -0,0 +1,252 @@
+#include "ClusterCuller.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <future>
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+    #include <arm_neon.h>
+    #define CLUSTER_CULLER_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define CLUSTER_CULLER_SSE2 1
+#endif
+
+namespace Base
+{
+    namespace
+    {
+        // Meshlets per task. Culling takes a few nanoseconds per meshlet, so only very large
+        // scenes gain from handing work to the pool at all.
+        constexpr size_t kChunkSize = 32768;
+
+        // Stored instead of a cutoff of 1, which must never cull, with room for rounding.
+        constexpr float kNeverCulled = 2.0f;
+
+        enum Result : uint8_t
+        {
+            Visible = 0,
+            OutsideFrustum = 1,
+            Backfacing = 2
+        };
+
+        void appendRange(std::vector<DrawRange> &ranges, uint32_t firstIndex, uint32_t indexCount)
+        {
+            if (!ranges.empty() && ranges.back().firstIndex + ranges.back().indexCount == firstIndex)
+            {
+                ranges.back().indexCount += indexCount;
+            }
+            else
+            {
+                ranges.push_back({firstIndex, indexCount});
+            }
+        }
+    } // namespace
+
+    void ClusterCuller::setMeshlets(const std::vector<Meshlet> &meshlets)
+    {
+        m_Count = meshlets.size();
+        const size_t padded = (m_Count + 3) & ~size_t(3);
+        for (std::vector<float> *array : {&m_CenterX, &m_CenterY, &m_CenterZ, &m_Radius, &m_ApexX, &m_ApexY, &m_ApexZ,
+                                          &m_AxisX, &m_AxisY, &m_AxisZ, &m_Cutoff})
+        {
+            array->assign(padded, 0.0f);
+        }
+        m_Ranges.resize(m_Count);
+        for (size_t i = 0; i < m_Count; ++i)
+        {
+            const Meshlet &meshlet = meshlets[i];
+            m_CenterX[i] = meshlet.center.x;
+            m_CenterY[i] = meshlet.center.y;
+            m_CenterZ[i] = meshlet.center.z;
+            m_Radius[i] = meshlet.radius;
+            m_ApexX[i] = meshlet.coneApex.x;
+            m_ApexY[i] = meshlet.coneApex.y;
+            m_ApexZ[i] = meshlet.coneApex.z;
+            m_AxisX[i] = meshlet.coneAxis.x;
+            m_AxisY[i] = meshlet.coneAxis.y;
+            m_AxisZ[i] = meshlet.coneAxis.z;
+            m_Cutoff[i] = meshlet.coneCutoff >= 1.0f ? kNeverCulled : meshlet.coneCutoff;
+            m_Ranges[i] = {meshlet.firstIndex, meshlet.indexCount};
+        }
+    }
+
+    void ClusterCuller::extractFrustumPlanes(const glm::mat4 &matrix, glm::vec4 planes[6])
+    {
+        // Gribb & Hartmann, "Fast Extraction of Viewing Frustum Planes from the World-View-Projection
+        // Matrix", 2001; glm matrices are column-major, so rows are gathered across columns.
+        const auto row = [&matrix](int r)
+        { return glm::vec4(matrix[0][r], matrix[1][r], matrix[2][r], matrix[3][r]); };
+        const glm::vec4 x = row(0), y = row(1), z = row(2), w = row(3);
+        planes[0] = w + x;
+        planes[1] = w - x;
+        planes[2] = w + y;
+        planes[3] = w - y;
+        planes[4] = w + z;
+        planes[5] = w - z;
+        for (int i = 0; i < 6; ++i)
+        {
+            const float length = glm::length(glm::vec3(planes[i]));
+            planes[i] = length > 0.0f ? planes[i] * (1.0f / length) : glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+        }
+    }
+
+    ClusterCuller::Stats ClusterCuller::cull(const glm::mat4 &viewProjection, const glm::mat4 &model,
+                                             const glm::vec3 &cameraPosition, std::vector<DrawRange> &ranges,
+                                             ThreadPool *pool)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        ranges.clear();
+
+        // Everything is tested in model space: the planes of the whole transform are the frustum
+        // as seen by the model, and the camera moves into it instead of every meshlet moving out.
+        glm::vec4 planes[6];
+        extractFrustumPlanes(viewProjection * model, planes);
+        const glm::vec3 camera = glm::vec3(glm::inverse(model) * glm::vec4(cameraPosition, 1.0f));
+
+        Stats stats;
+        stats.clusters = m_Count;
+        const size_t chunkCount = (m_Count + kChunkSize - 1) / kChunkSize;
+        if (pool == nullptr || chunkCount <= 1)
+        {
+            cullChunk(planes, camera, 0, m_Count, ranges, stats);
+        }
+        else
+        {
+            std::vector<std::vector<DrawRange>> chunkRanges(chunkCount);
+            std::vector<Stats> chunkStats(chunkCount);
+            const auto task = [&](size_t c)
+            { cullChunk(planes, camera, c * kChunkSize, std::min(m_Count, (c + 1) * kChunkSize), chunkRanges[c], chunkStats[c]); };
+            // The first chunk runs here rather than waiting idle.
+            std::vector<std::future<void>> pending;
+            for (size_t c = 1; c < chunkCount; ++c)
+            {
+                pending.push_back(pool->Enqueue([&task, c]() { task(c); }));
+            }
+            task(0);
+            for (size_t c = 0; c < chunkCount; ++c)
+            {
+                if (c > 0)
+                {
+                    pending[c - 1].get();
+                }
+                for (const DrawRange &range : chunkRanges[c])
+                {
+                    appendRange(ranges, range.firstIndex, range.indexCount);
+                }
+                stats.frustumCulled += chunkStats[c].frustumCulled;
+                stats.backfaceCulled += chunkStats[c].backfaceCulled;
+                stats.indexCount += chunkStats[c].indexCount;
+            }
+        }
+
+        stats.ranges = ranges.size();
+        stats.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return stats;
+    }
+
+    void ClusterCuller::cullChunk(const glm::vec4 planes[6], const glm::vec3 &camera, size_t begin, size_t end,
+                                  std::vector<DrawRange> &ranges, Stats &stats) const
+    {
+        // `begin` is a multiple of 4 (chunks are), so blocks of 4 stay aligned with the padding.
+        for (size_t i = begin; i < end; i += 4)
+        {
+            uint8_t results[4];
+#if CLUSTER_CULLER_SSE2
+            const __m128 cx = _mm_loadu_ps(&m_CenterX[i]);
+            const __m128 cy = _mm_loadu_ps(&m_CenterY[i]);
+            const __m128 cz = _mm_loadu_ps(&m_CenterZ[i]);
+            const __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(&m_Radius[i]));
+            __m128 outside = _mm_setzero_ps();
+            for (int p = 0; p < 6; ++p)
+            {
+                __m128 distance = _mm_add_ps(_mm_mul_ps(cx, _mm_set1_ps(planes[p].x)), _mm_set1_ps(planes[p].w));
+                distance = _mm_add_ps(distance, _mm_mul_ps(cy, _mm_set1_ps(planes[p].y)));
+                distance = _mm_add_ps(distance, _mm_mul_ps(cz, _mm_set1_ps(planes[p].z)));
+                outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, negRadius));
+            }
+
+            const __m128 dx = _mm_sub_ps(_mm_loadu_ps(&m_ApexX[i]), _mm_set1_ps(camera.x));
+            const __m128 dy = _mm_sub_ps(_mm_loadu_ps(&m_ApexY[i]), _mm_set1_ps(camera.y));
+            const __m128 dz = _mm_sub_ps(_mm_loadu_ps(&m_ApexZ[i]), _mm_set1_ps(camera.z));
+            const __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+            __m128 along = _mm_mul_ps(dx, _mm_loadu_ps(&m_AxisX[i]));
+            along = _mm_add_ps(along, _mm_mul_ps(dy, _mm_loadu_ps(&m_AxisY[i])));
+            along = _mm_add_ps(along, _mm_mul_ps(dz, _mm_loadu_ps(&m_AxisZ[i])));
+            const __m128 backfacing = _mm_cmpgt_ps(along, _mm_mul_ps(_mm_loadu_ps(&m_Cutoff[i]), length));
+
+            const int outsideMask = _mm_movemask_ps(outside);
+            const int backfacingMask = _mm_movemask_ps(backfacing);
+            for (int k = 0; k < 4; ++k)
+            {
+                results[k] = (outsideMask >> k) & 1 ? OutsideFrustum : (backfacingMask >> k) & 1 ? Backfacing : Visible;
+            }
+#elif CLUSTER_CULLER_NEON
+            const float32x4_t cx = vld1q_f32(&m_CenterX[i]);
+            const float32x4_t cy = vld1q_f32(&m_CenterY[i]);
+            const float32x4_t cz = vld1q_f32(&m_CenterZ[i]);
+            const float32x4_t negRadius = vnegq_f32(vld1q_f32(&m_Radius[i]));
+            uint32x4_t outside = vdupq_n_u32(0);
+            for (int p = 0; p < 6; ++p)
+            {
+                float32x4_t distance = vfmaq_n_f32(vdupq_n_f32(planes[p].w), cx, planes[p].x);
+                distance = vfmaq_n_f32(distance, cy, planes[p].y);
+                distance = vfmaq_n_f32(distance, cz, planes[p].z);
+                outside = vorrq_u32(outside, vcltq_f32(distance, negRadius));
+            }
+
+            const float32x4_t dx = vsubq_f32(vld1q_f32(&m_ApexX[i]), vdupq_n_f32(camera.x));
+            const float32x4_t dy = vsubq_f32(vld1q_f32(&m_ApexY[i]), vdupq_n_f32(camera.y));
+            const float32x4_t dz = vsubq_f32(vld1q_f32(&m_ApexZ[i]), vdupq_n_f32(camera.z));
+            const float32x4_t length = vsqrtq_f32(vfmaq_f32(vfmaq_f32(vmulq_f32(dx, dx), dy, dy), dz, dz));
+            float32x4_t along = vmulq_f32(dx, vld1q_f32(&m_AxisX[i]));
+            along = vfmaq_f32(along, dy, vld1q_f32(&m_AxisY[i]));
+            along = vfmaq_f32(along, dz, vld1q_f32(&m_AxisZ[i]));
+            const uint32x4_t backfacing = vcgtq_f32(along, vmulq_f32(vld1q_f32(&m_Cutoff[i]), length));
+
+            uint32_t outsideLanes[4], backfacingLanes[4];
+            vst1q_u32(outsideLanes, outside);
+            vst1q_u32(backfacingLanes, backfacing);
+            for (int k = 0; k < 4; ++k)
+            {
+                results[k] = outsideLanes[k] ? OutsideFrustum : backfacingLanes[k] ? Backfacing : Visible;
+            }
+#else
+            for (int k = 0; k < 4; ++k)
+            {
+                const size_t j = i + k;
+                bool outside = false;
+                for (int p = 0; p < 6; ++p)
+                {
+                    const float distance = planes[p].x * m_CenterX[j] + planes[p].y * m_CenterY[j] +
+                                           planes[p].z * m_CenterZ[j] + planes[p].w;
+                    outside = outside || distance < -m_Radius[j];
+                }
+                const glm::vec3 d(m_ApexX[j] - camera.x, m_ApexY[j] - camera.y, m_ApexZ[j] - camera.z);
+                const float along = d.x * m_AxisX[j] + d.y * m_AxisY[j] + d.z * m_AxisZ[j];
+                results[k] = outside ? OutsideFrustum : along > m_Cutoff[j] * glm::length(d) ? Backfacing : Visible;
+            }
+#endif
+            const size_t count = std::min<size_t>(4, end - i);
+            for (size_t k = 0; k < count; ++k)
+            {
+                const DrawRange &range = m_Ranges[i + k];
+                switch (results[k])
+                {
+                case OutsideFrustum:
+                    ++stats.frustumCulled;
+                    break;
+                case Backfacing:
+                    ++stats.backfaceCulled;
+                    break;
+                default:
+                    appendRange(ranges, range.firstIndex, range.indexCount);
+                    stats.indexCount += range.indexCount;
+                    break;
+                }
+            }
+        }
+    }
+
+} // namespace Base
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Mesh.hpp"
+#include "ThreadPool.hpp"
+
+namespace Base
+{
+    // Per-frame CPU culling of a mesh's meshlets against the view frustum (bounding spheres) and
+    // the camera position (normal cones), four meshlets at a time with SSE2/NEON where available.
+    // The bounds are kept as structure-of-arrays copies, and the survivors come out as compacted
+    // index ranges (adjacent meshlets merged) for Mesh::drawRanges.
+    class ClusterCuller
+    {
+    public:
+        struct Stats
+        {
+            size_t clusters = 0;
+            size_t frustumCulled = 0;
+            size_t backfaceCulled = 0;
+            size_t ranges = 0;
+            size_t indexCount = 0; // Left to draw
+            double milliseconds = 0.0;
+        };
+
+        ClusterCuller() = default;
+        explicit ClusterCuller(const std::vector<Meshlet> &meshlets) { setMeshlets(meshlets); }
+
+        void setMeshlets(const std::vector<Meshlet> &meshlets);
+        size_t getClusterCount() const { return m_Count; }
+
+        // `viewProjection` and `model` place the mesh on screen; `cameraPosition` is in world space.
+        // With a pool, large meshes are split into chunks across its workers.
+        Stats cull(const glm::mat4 &viewProjection, const glm::mat4 &model, const glm::vec3 &cameraPosition,
+                   std::vector<DrawRange> &ranges, ThreadPool *pool = nullptr);
+
+        // Left, right, bottom, top, near, far planes (xyz normal pointing inside, w distance) of
+        // the clip volume of `matrix`, normalized, in the space `matrix` maps from.
+        static void extractFrustumPlanes(const glm::mat4 &matrix, glm::vec4 planes[6]);
+
+    private:
+        void cullChunk(const glm::vec4 planes[6], const glm::vec3 &camera, size_t begin, size_t end,
+                       std::vector<DrawRange> &ranges, Stats &stats) const;
+
+        size_t m_Count = 0;
+        // Padded to a multiple of 4.
+        std::vector<float> m_CenterX, m_CenterY, m_CenterZ, m_Radius;
+        std::vector<float> m_ApexX, m_ApexY, m_ApexZ;
+        std::vector<float> m_AxisX, m_AxisY, m_AxisZ, m_Cutoff;
+        std::vector<DrawRange> m_Ranges;
+    };
+
+} // namespace Base
@@ -53,10 +53,10 @@ namespace Base
     class ParallelEventBus
     {
     public:
-        ParallelEventBus(size_t numThreads)
-            : m_ThreadPool(numThreads), m_NextSubscriptionId(1)
+        // Async handlers run on `threadPool`, typically the application's shared workers.
+        explicit ParallelEventBus(ThreadPool &threadPool)
+            : m_ThreadPool(threadPool), m_NextSubscriptionId(1)
         {
-            m_ThreadPool.Start();
         }
         ~ParallelEventBus() = default;
 
@@ -149,6 +149,6 @@ namespace Base
         std::map<std::type_index, std::map<uint64_t, EventHandler>> m_Handlers;
         mutable std::mutex m_HandlersMutex;
         std::atomic<uint64_t> m_NextSubscriptionId;
-        ThreadPool m_ThreadPool;
+        ThreadPool &m_ThreadPool;
     };
 }
\ No newline at end of file
@@ -0,0 +1,248 @@
+#include "GeometryBuffer.hpp"
+#include "Log.hpp"
+
+namespace Base
+{
+    GeometryBuffer::~GeometryBuffer()
+    {
+        shutdown();
+    }
+
+    bool GeometryBuffer::init(const VertexLayout &layout, uint32_t indexSize, uint32_t vertexCapacity, uint32_t indexCapacity)
+    {
+        shutdown();
+        if (layout.stride == 0 || (indexSize != 2 && indexSize != 4))
+        {
+            LOG_ERROR("GeometryBuffer: invalid layout or index size {}.", indexSize);
+            return false;
+        }
+        m_Layout = layout;
+        m_IndexSize = indexSize;
+        m_BaseVertex = supportsBaseVertex();
+        m_Vertices.reset(vertexCapacity);
+        m_Indices.reset(indexCapacity);
+        m_Growths = 0;
+
+        glGenVertexArrays(1, &m_Vao);
+        glGenBuffers(1, &m_Vbo);
+        glGenBuffers(1, &m_Ebo);
+        // Mutable storage: ranges are written with glBufferSubData and the buffers are replaced when they grow.
+        glBindBuffer(GL_COPY_WRITE_BUFFER, m_Vbo);
+        glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(m_Vertices.getCapacity()) * m_Layout.stride, nullptr,
+                     GL_STATIC_DRAW);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, m_Ebo);
+        glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(m_Indices.getCapacity()) * m_IndexSize, nullptr,
+                     GL_STATIC_DRAW);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        attachBuffers();
+        return true;
+    }
+
+    void GeometryBuffer::shutdown()
+    {
+        if (m_Vao != 0)
+        {
+            glDeleteVertexArrays(1, &m_Vao);
+            glDeleteBuffers(1, &m_Vbo);
+            glDeleteBuffers(1, &m_Ebo);
+        }
+        m_Vao = m_Vbo = m_Ebo = 0;
+    }
+
+    void GeometryBuffer::attachBuffers()
+    {
+        glBindVertexArray(m_Vao);
+        glBindBuffer(GL_ARRAY_BUFFER, m_Vbo);
+        for (const VertexAttribute &attribute : m_Layout.attributes)
+        {
+            glVertexAttribPointer(attribute.location, static_cast<GLint>(attribute.components), attribute.type,
+                                  attribute.normalized ? GL_TRUE : GL_FALSE, static_cast<GLsizei>(m_Layout.stride),
+                                  (void *)static_cast<size_t>(attribute.offset));
+            glEnableVertexAttribArray(attribute.location);
+        }
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_Ebo);
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    bool GeometryBuffer::reserve(BuddyAllocator &allocator, GLuint &buffer, uint32_t unitSize, uint32_t count, uint32_t &offset)
+    {
+        while ((offset = allocator.allocate(count)) == BuddyAllocator::kInvalidOffset)
+        {
+            const GLsizeiptr oldBytes = static_cast<GLsizeiptr>(allocator.getCapacity()) * unitSize;
+            if (!allocator.grow())
+            {
+                return false;
+            }
+
+            GLuint grown = 0;
+            glGenBuffers(1, &grown);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, grown);
+            glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(allocator.getCapacity()) * unitSize, nullptr,
+                         GL_STATIC_DRAW);
+            glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, oldBytes);
+            glBindBuffer(GL_COPY_READ_BUFFER, 0);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+            glDeleteBuffers(1, &buffer);
+            buffer = grown;
+            attachBuffers();
+            ++m_Growths;
+            LOG_DEBUG("GeometryBuffer: grew to {} KB.", allocator.getCapacity() * unitSize / 1024);
+        }
+        return true;
+    }
+
+    GeometryRange GeometryBuffer::allocate(const void *vertices, uint32_t vertexCount, const uint32_t *indices, uint32_t indexCount)
+    {
+        if (!isInitialized() || vertexCount == 0 || indexCount == 0)
+        {
+            LOG_ERROR("GeometryBuffer: nothing to allocate.");
+            return {};
+        }
+        if (m_IndexSize == 2 && vertexCount > 65536)
+        {
+            LOG_ERROR("GeometryBuffer: {} vertices need 32-bit indices.", vertexCount);
+            return {};
+        }
+        for (uint32_t i = 0; i < indexCount; ++i)
+        {
+            if (indices[i] >= vertexCount)
+            {
+                LOG_ERROR("GeometryBuffer: index {} is past the {} vertices.", indices[i], vertexCount);
+                return {};
+            }
+        }
+
+        GeometryRange range;
+        if (!reserve(m_Vertices, m_Vbo, m_Layout.stride, vertexCount, range.baseVertex))
+        {
+            LOG_ERROR("GeometryBuffer: no room for {} vertices.", vertexCount);
+            return {};
+        }
+        if (!m_BaseVertex && m_IndexSize == 2 && range.baseVertex + vertexCount > 65536)
+        {
+            m_Vertices.free(range.baseVertex);
+            LOG_ERROR("GeometryBuffer: without base vertex draws, 16-bit indices reach only the first 65536 vertices.");
+            return {};
+        }
+        if (!reserve(m_Indices, m_Ebo, m_IndexSize, indexCount, range.firstIndex))
+        {
+            m_Vertices.free(range.baseVertex);
+            LOG_ERROR("GeometryBuffer: no room for {} indices.", indexCount);
+            return {};
+        }
+        range.vertexCount = vertexCount;
+        range.indexCount = indexCount;
+
+        // Narrowed to the buffer's index size, and rebased here when the draw cannot do it.
+        const uint32_t rebase = m_BaseVertex ? 0 : range.baseVertex;
+        std::vector<uint8_t> packed(static_cast<size_t>(indexCount) * m_IndexSize);
+        if (m_IndexSize == 2)
+        {
+            uint16_t *out = reinterpret_cast<uint16_t *>(packed.data());
+            for (uint32_t i = 0; i < indexCount; ++i)
+            {
+                out[i] = static_cast<uint16_t>(indices[i] + rebase);
+            }
+        }
+        else
+        {
+            uint32_t *out = reinterpret_cast<uint32_t *>(packed.data());
+            for (uint32_t i = 0; i < indexCount; ++i)
+            {
+                out[i] = indices[i] + rebase;
+            }
+        }
+
+        glBindBuffer(GL_COPY_WRITE_BUFFER, m_Vbo);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(range.baseVertex) * m_Layout.stride,
+                        static_cast<GLsizeiptr>(vertexCount) * m_Layout.stride, vertices);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, m_Ebo);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(range.firstIndex) * m_IndexSize,
+                        static_cast<GLsizeiptr>(packed.size()), packed.data());
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        return range;
+    }
+
+    void GeometryBuffer::free(GeometryRange &range)
+    {
+        if (!range.isValid() || !isInitialized())
+        {
+            return;
+        }
+        m_Vertices.free(range.baseVertex);
+        m_Indices.free(range.firstIndex);
+        range = GeometryRange();
+    }
+
+    void GeometryBuffer::bind() const
+    {
+        glBindVertexArray(m_Vao);
+    }
+
+    void GeometryBuffer::draw(const GeometryRange &range, GLenum mode) const
+    {
+        const void *offset = (const void *)(static_cast<size_t>(range.firstIndex) * m_IndexSize);
+#if PLATFORM_DESKTOP || PLATFORM_ANDROID
+        if (m_BaseVertex)
+        {
+            glDrawElementsBaseVertex(mode, static_cast<GLsizei>(range.indexCount), getIndexType(), offset,
+                                     static_cast<GLint>(range.baseVertex));
+            return;
+        }
+#endif
+        glDrawElements(mode, static_cast<GLsizei>(range.indexCount), getIndexType(), offset);
+    }
+
+    void GeometryBuffer::drawRanges(const std::vector<GeometryRange> &ranges, GLenum mode) const
+    {
+        if (ranges.empty())
+        {
+            return;
+        }
+#if PLATFORM_DESKTOP
+        std::vector<GLsizei> counts(ranges.size());
+        std::vector<const void *> offsets(ranges.size());
+        std::vector<GLint> baseVertices(ranges.size());
+        for (size_t i = 0; i < ranges.size(); ++i)
+        {
+            counts[i] = static_cast<GLsizei>(ranges[i].indexCount);
+            offsets[i] = (const void *)(static_cast<size_t>(ranges[i].firstIndex) * m_IndexSize);
+            baseVertices[i] = static_cast<GLint>(ranges[i].baseVertex);
+        }
+        glMultiDrawElementsBaseVertex(mode, counts.data(), getIndexType(), offsets.data(), static_cast<GLsizei>(ranges.size()),
+                                      baseVertices.data());
+#else
+        // No glMultiDrawElements in GLES 3.0.
+        for (const GeometryRange &range : ranges)
+        {
+            draw(range, mode);
+        }
+#endif
+    }
+
+    GeometryBuffer::Stats GeometryBuffer::getStats() const
+    {
+        Stats stats;
+        stats.vertices = m_Vertices.getStats();
+        stats.indices = m_Indices.getStats();
+        stats.bytes = static_cast<size_t>(stats.vertices.capacity) * m_Layout.stride +
+                      static_cast<size_t>(stats.indices.capacity) * m_IndexSize;
+        stats.growths = m_Growths;
+        stats.baseVertex = m_BaseVertex;
+        return stats;
+    }
+
+    bool GeometryBuffer::supportsBaseVertex()
+    {
+#if PLATFORM_DESKTOP
+        return GLAD_GL_VERSION_3_2 != 0;
+#elif PLATFORM_ANDROID
+        return GLAD_GL_ES_VERSION_3_2 != 0;
+#else
+        return false;
+#endif
+    }
+
+} // namespace Base
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "BuddyAllocator.hpp"
+#include "Mesh.hpp"
+
+namespace Base
+{
+    // Where a mesh lives in a GeometryBuffer: its vertices start at `baseVertex`, its indices
+    // (relative to its own first vertex) at `firstIndex`.
+    struct GeometryRange
+    {
+        uint32_t baseVertex = 0;
+        uint32_t vertexCount = 0;
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+
+        bool isValid() const { return indexCount != 0; }
+    };
+
+    // One vertex buffer, one index buffer and one VAO shared by many small meshes of the same
+    // vertex layout, each of them a GeometryRange handed out by a BuddyAllocator per buffer.
+    // Drawing a range is a glDrawElementsBaseVertex with the VAO already bound, so meshes drawn
+    // one after another need no VAO or buffer switches, and a list of ranges drawn with the
+    // same state is a single glMultiDrawElementsBaseVertex on desktop. Full buffers double in
+    // size (copied on the GPU), keeping every range where it is.
+    //
+    // Without glDrawElementsBaseVertex (GLES 3.0, WebGL 2) the base vertex is added to the
+    // indices as they are copied in, which limits a 16-bit buffer to 65536 vertices in total.
+    class GeometryBuffer
+    {
+    public:
+        struct Stats
+        {
+            BuddyAllocator::Stats vertices;
+            BuddyAllocator::Stats indices;
+            size_t bytes = 0; // Both buffers
+            uint32_t growths = 0;
+            bool baseVertex = false;
+        };
+
+        GeometryBuffer() = default;
+        ~GeometryBuffer();
+
+        GeometryBuffer(const GeometryBuffer &) = delete;
+        GeometryBuffer &operator=(const GeometryBuffer &) = delete;
+
+        // `indexSize` is 2 or 4 bytes; with 2, a single range holds at most 65536 vertices.
+        bool init(const VertexLayout &layout, uint32_t indexSize, uint32_t vertexCapacity = 16 * 1024,
+                  uint32_t indexCapacity = 64 * 1024);
+        void shutdown();
+        bool isInitialized() const { return m_Vao != 0; }
+
+        // Copies a mesh in: `vertexCount` vertices in the buffer's layout and `indexCount` indices
+        // into them. Returns an invalid range (and logs why) when it does not fit.
+        GeometryRange allocate(const void *vertices, uint32_t vertexCount, const uint32_t *indices, uint32_t indexCount);
+        void free(GeometryRange &range);
+
+        // Binds the VAO; draw() and drawRanges() expect it to be bound.
+        void bind() const;
+        void draw(const GeometryRange &range, GLenum mode = GL_TRIANGLES) const;
+        void drawRanges(const std::vector<GeometryRange> &ranges, GLenum mode = GL_TRIANGLES) const;
+
+        const VertexLayout &getLayout() const { return m_Layout; }
+        uint32_t getIndexSize() const { return m_IndexSize; }
+        Stats getStats() const;
+
+        static bool supportsBaseVertex();
+
+    private:
+        // Allocates `count` units, growing the allocator and its buffer until they fit.
+        bool reserve(BuddyAllocator &allocator, GLuint &buffer, uint32_t unitSize, uint32_t count, uint32_t &offset);
+        void attachBuffers();
+        GLenum getIndexType() const { return m_IndexSize == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT; }
+
+        GLuint m_Vao = 0;
+        GLuint m_Vbo = 0;
+        GLuint m_Ebo = 0;
+        VertexLayout m_Layout;
+        uint32_t m_IndexSize = 2;
+        bool m_BaseVertex = false;
+        BuddyAllocator m_Vertices;
+        BuddyAllocator m_Indices;
+        uint32_t m_Growths = 0;
+    };
+
+} // namespace Base
@@ -0,0 +1,185 @@
+#include "HalfFloat.hpp"
+
+#include <cstring>
+
+#if defined(__F16C__) || defined(__AVX2__)
+    #include <immintrin.h>
+    #define HALF_FLOAT_F16C 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    #include <arm_neon.h>
+    #define HALF_FLOAT_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define HALF_FLOAT_SSE2 1
+#endif
+
+namespace Base
+{
+#if HALF_FLOAT_SSE2
+    namespace
+    {
+        // Four floats to half with round-to-nearest-even, branch-free (after F. Giesen's
+        // float_to_half_fast3_rtne). Each result sits in the low 16 bits of its lane, sign-extended,
+        // so _mm_packs_epi32 narrows it without saturating.
+        __m128i floatToHalf4(__m128 value)
+        {
+            const __m128 signMask = _mm_set1_ps(-0.0f);
+            const __m128i halfMax = _mm_set1_epi32((127 + 16) << 23);  // Rounds to infinity from here on
+            const __m128i minNormal = _mm_set1_epi32((127 - 14) << 23); // Smallest float giving a normal half
+            const __m128i subnormalMagic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+            const __m128i normalBias = _mm_set1_epi32(0xFFF - ((127 - 15) << 23));
+
+            const __m128 sign = _mm_and_ps(value, signMask);
+            const __m128 absolute = _mm_andnot_ps(signMask, value);
+            const __m128i bits = _mm_castps_si128(absolute);
+
+            const __m128i isNan = _mm_castps_si128(_mm_cmpunord_ps(absolute, absolute));
+            const __m128i isRegular = _mm_cmpgt_epi32(halfMax, bits);
+            const __m128i special = _mm_or_si128(_mm_and_si128(isNan, _mm_set1_epi32(0x200)), _mm_set1_epi32(0x7C00));
+
+            // Subnormal results: let the FPU round by adding a magic number.
+            const __m128i isSubnormal = _mm_cmpgt_epi32(minNormal, bits);
+            const __m128 subnormalSum = _mm_add_ps(absolute, _mm_castsi128_ps(subnormalMagic));
+            const __m128i subnormal = _mm_sub_epi32(_mm_castps_si128(subnormalSum), subnormalMagic);
+
+            // Normal results: rebias and round, nudging odd mantissas up for ties-to-even.
+            const __m128i mantissaOdd = _mm_srai_epi32(_mm_slli_epi32(bits, 31 - 13), 31);
+            const __m128i normal = _mm_srli_epi32(_mm_sub_epi32(_mm_add_epi32(bits, normalBias), mantissaOdd), 13);
+
+            const __m128i finite = _mm_or_si128(_mm_and_si128(isSubnormal, subnormal), _mm_andnot_si128(isSubnormal, normal));
+            const __m128i result = _mm_or_si128(_mm_and_si128(isRegular, finite), _mm_andnot_si128(isRegular, special));
+            return _mm_or_si128(result, _mm_srai_epi32(_mm_castps_si128(sign), 16));
+        }
+    } // namespace
+#endif
+
+    uint16_t floatToHalf(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        const uint32_t sign = (bits >> 16) & 0x8000u;
+        bits &= 0x7FFFFFFFu;
+
+        if (bits >= 0x7F800000u) // Inf or NaN; keep NaNs quiet
+        {
+            return static_cast<uint16_t>(sign | 0x7C00u | (bits > 0x7F800000u ? 0x200u : 0u));
+        }
+        if (bits >= 0x477FF000u) // Rounds past 65504
+        {
+            return static_cast<uint16_t>(sign | 0x7C00u);
+        }
+        if (bits < 0x38800000u) // Below 2^-14: subnormal half or zero
+        {
+            if (bits < 0x33000000u)
+            {
+                return static_cast<uint16_t>(sign);
+            }
+            const uint32_t mantissa = (bits & 0x7FFFFFu) | 0x800000u;
+            const uint32_t shift = 126u - (bits >> 23);
+            uint32_t half = mantissa >> shift;
+            const uint32_t remainder = mantissa & ((1u << shift) - 1u);
+            const uint32_t halfway = 1u << (shift - 1u);
+            if (remainder > halfway || (remainder == halfway && (half & 1u)))
+            {
+                half++;
+            }
+            return static_cast<uint16_t>(sign | half);
+        }
+
+        // Rebias the exponent from 127 to 15; a carry out of the mantissa correctly bumps it.
+        uint32_t half = (bits - 0x38000000u) >> 13;
+        const uint32_t remainder = bits & 0x1FFFu;
+        if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u)))
+        {
+            half++;
+        }
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    float halfToFloat(uint16_t value)
+    {
+        const uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+        uint32_t exponent = (value >> 10) & 0x1Fu;
+        uint32_t mantissa = value & 0x3FFu;
+
+        uint32_t bits;
+        if (exponent == 0x1Fu)
+        {
+            bits = sign | 0x7F800000u | (mantissa << 13);
+        }
+        else if (exponent != 0)
+        {
+            bits = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+        }
+        else if (mantissa == 0)
+        {
+            bits = sign;
+        }
+        else
+        {
+            // Subnormal half: normalize it, every float can hold it as a normal number.
+            exponent = 113;
+            while (!(mantissa & 0x400u))
+            {
+                mantissa <<= 1;
+                exponent--;
+            }
+            bits = sign | (exponent << 23) | ((mantissa & 0x3FFu) << 13);
+        }
+
+        float result;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+
+    void floatToHalf(const float *source, uint16_t *destination, size_t count)
+    {
+        size_t i = 0;
+#if HALF_FLOAT_F16C
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m128i half = _mm256_cvtps_ph(_mm256_loadu_ps(source + i), _MM_FROUND_TO_NEAREST_INT);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i), half);
+        }
+#elif HALF_FLOAT_NEON
+        for (; i + 4 <= count; i += 4)
+        {
+            const float16x4_t half = vcvt_f16_f32(vld1q_f32(source + i));
+            vst1_u16(destination + i, vreinterpret_u16_f16(half));
+        }
+#elif HALF_FLOAT_SSE2
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m128i low = floatToHalf4(_mm_loadu_ps(source + i));
+            const __m128i high = floatToHalf4(_mm_loadu_ps(source + i + 4));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i), _mm_packs_epi32(low, high));
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            destination[i] = floatToHalf(source[i]);
+        }
+    }
+
+    void halfToFloat(const uint16_t *source, float *destination, size_t count)
+    {
+        size_t i = 0;
+#if HALF_FLOAT_F16C
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m128i half = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i));
+            _mm256_storeu_ps(destination + i, _mm256_cvtph_ps(half));
+        }
+#elif HALF_FLOAT_NEON
+        for (; i + 4 <= count; i += 4)
+        {
+            vst1q_f32(destination + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(source + i))));
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            destination[i] = halfToFloat(source[i]);
+        }
+    }
+
+} // namespace Base
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Base
+{
+    // IEEE 754 binary16 conversions for GL_HALF_FLOAT data. Rounding is to nearest even; values
+    // past the half range become infinity.
+    uint16_t floatToHalf(float value);
+    float halfToFloat(uint16_t value);
+
+    // Bulk versions; use the F16C/NEON conversion instructions where the build enables them and
+    // SSE2 integer math otherwise (float to half only).
+    void floatToHalf(const float *source, uint16_t *destination, size_t count);
+    void halfToFloat(const uint16_t *source, float *destination, size_t count);
+
+} // namespace Base
@@ -0,0 +1,392 @@
+#include "HdrImage.hpp"
+#include "HalfFloat.hpp"
+#include "Log.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define HDR_IMAGE_SSE2 1
+#elif defined(__ARM_NEON)
+    #include <arm_neon.h>
+    #define HDR_IMAGE_NEON 1
+#endif
+
+namespace Base
+{
+    namespace
+    {
+        // 2^(e - 136): the shared exponent with the 8-bit mantissa scale folded in. Same mapping as
+        // stbi_loadf, so baked and runtime-decoded panoramas match.
+        const std::array<float, 256> &exponentScales()
+        {
+            static const std::array<float, 256> s_Scales = []()
+            {
+                std::array<float, 256> scales{};
+                for (int e = 1; e < 256; ++e)
+                {
+                    scales[e] = std::ldexp(1.0f, e - 136);
+                }
+                return scales;
+            }();
+            return s_Scales;
+        }
+
+        // Reads one header line; returns false at the end of the data.
+        bool readLine(const uint8_t *data, size_t size, size_t &position, std::string &line)
+        {
+            line.clear();
+            while (position < size)
+            {
+                const char c = static_cast<char>(data[position++]);
+                if (c == '\n')
+                {
+                    return true;
+                }
+                line.push_back(c);
+            }
+            return false;
+        }
+
+        // One scanline of the adaptive RLE format: each channel run-length coded separately.
+        bool readRleScanline(const uint8_t *data, size_t size, size_t &position, int width, uint8_t *out)
+        {
+            for (int channel = 0; channel < 4; ++channel)
+            {
+                int x = 0;
+                while (x < width)
+                {
+                    if (position >= size)
+                    {
+                        return false;
+                    }
+                    int count = data[position++];
+                    if (count > 128)
+                    {
+                        count -= 128;
+                        if (position >= size || x + count > width)
+                        {
+                            return false;
+                        }
+                        const uint8_t value = data[position++];
+                        for (int i = 0; i < count; ++i, ++x)
+                        {
+                            out[x * 4 + channel] = value;
+                        }
+                    }
+                    else
+                    {
+                        if (count == 0 || position + count > size || x + count > width)
+                        {
+                            return false;
+                        }
+                        for (int i = 0; i < count; ++i, ++x)
+                        {
+                            out[x * 4 + channel] = data[position++];
+                        }
+                    }
+                }
+            }
+            return true;
+        }
+
+        // Flat pixels, possibly with the original (1,1,1,n) repeat runs.
+        bool readFlatScanline(const uint8_t *data, size_t size, size_t &position, int width, uint8_t *out)
+        {
+            int shift = 0;
+            int x = 0;
+            while (x < width)
+            {
+                if (position + 4 > size)
+                {
+                    return false;
+                }
+                const uint8_t *pixel = data + position;
+                position += 4;
+                if (pixel[0] == 1 && pixel[1] == 1 && pixel[2] == 1)
+                {
+                    // Consecutive run markers extend the count by 8 bits each; four fill 32 bits.
+                    if (shift > 24)
+                    {
+                        return false;
+                    }
+                    const uint32_t count = static_cast<uint32_t>(pixel[3]) << shift;
+                    if (x == 0 || count > static_cast<uint32_t>(width - x))
+                    {
+                        return false;
+                    }
+                    for (uint32_t i = 0; i < count; ++i, ++x)
+                    {
+                        std::memcpy(out + x * 4, out + (x - 1) * 4, 4);
+                    }
+                    shift += 8;
+                }
+                else
+                {
+                    std::memcpy(out + x * 4, pixel, 4);
+                    x++;
+                    shift = 0;
+                }
+            }
+            return true;
+        }
+
+        // The sun in an outdoor panorama easily exceeds the half range; one infinity would poison every
+        // filtered lookup around it, so saturate at the largest finite half instead.
+        void clampToHalfRange(float *values, size_t count)
+        {
+            constexpr float kMaxHalf = 65504.0f;
+            for (size_t i = 0; i < count; ++i)
+            {
+                values[i] = std::min(values[i], kMaxHalf);
+            }
+        }
+
+        // Bilinear lookup in an RGB float panorama; wraps around horizontally, clamps at the poles.
+        void samplePanorama(const float *panorama, int width, int height, float u, float v, float out[3])
+        {
+            const float x = u * width - 0.5f;
+            const float y = std::clamp(v * height - 0.5f, 0.0f, static_cast<float>(height - 1));
+            const int x0 = static_cast<int>(std::floor(x));
+            const int y0 = static_cast<int>(y);
+            const float fx = x - x0;
+            const float fy = y - y0;
+            const int column0 = ((x0 % width) + width) % width;
+            const int column1 = (column0 + 1) % width;
+            const int row1 = std::min(y0 + 1, height - 1);
+
+            const float *p00 = panorama + (static_cast<size_t>(y0) * width + column0) * 3;
+            const float *p10 = panorama + (static_cast<size_t>(y0) * width + column1) * 3;
+            const float *p01 = panorama + (static_cast<size_t>(row1) * width + column0) * 3;
+            const float *p11 = panorama + (static_cast<size_t>(row1) * width + column1) * 3;
+            for (int c = 0; c < 3; ++c)
+            {
+                const float top = p00[c] + (p10[c] - p00[c]) * fx;
+                const float bottom = p01[c] + (p11[c] - p01[c]) * fx;
+                out[c] = top + (bottom - top) * fy;
+            }
+        }
+    } // namespace
+
+    bool HdrImage::isHdrFile(const std::string &path)
+    {
+        const size_t dot = path.find_last_of('.');
+        if (dot == std::string::npos)
+        {
+            return false;
+        }
+        std::string extension = path.substr(dot + 1);
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c)
+                       { return static_cast<char>(std::tolower(c)); });
+        return extension == "hdr";
+    }
+
+    void HdrImage::rgbeToFloat(const uint8_t *rgbe, float *rgb, size_t count)
+    {
+        const std::array<float, 256> &scales = exponentScales();
+        size_t i = 0;
+#if HDR_IMAGE_SSE2
+        // Each pixel becomes one 4-lane multiply; the stores overlap by a lane, which the next pixel
+        // overwrites, so the last pixel is left to the scalar loop.
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 5 <= count; i += 4)
+        {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rgbe + i * 4));
+            const __m128i low = _mm_unpacklo_epi8(bytes, zero);
+            const __m128i high = _mm_unpackhi_epi8(bytes, zero);
+            const __m128i pixels[4] = {_mm_unpacklo_epi16(low, zero), _mm_unpackhi_epi16(low, zero),
+                                       _mm_unpacklo_epi16(high, zero), _mm_unpackhi_epi16(high, zero)};
+            for (int p = 0; p < 4; ++p)
+            {
+                const __m128 scale = _mm_set1_ps(scales[rgbe[(i + p) * 4 + 3]]);
+                _mm_storeu_ps(rgb + (i + p) * 3, _mm_mul_ps(_mm_cvtepi32_ps(pixels[p]), scale));
+            }
+        }
+#elif HDR_IMAGE_NEON
+        for (; i + 5 <= count; i += 4)
+        {
+            const uint8x16_t bytes = vld1q_u8(rgbe + i * 4);
+            const uint16x8_t low = vmovl_u8(vget_low_u8(bytes));
+            const uint16x8_t high = vmovl_u8(vget_high_u8(bytes));
+            const uint32x4_t pixels[4] = {vmovl_u16(vget_low_u16(low)), vmovl_u16(vget_high_u16(low)),
+                                          vmovl_u16(vget_low_u16(high)), vmovl_u16(vget_high_u16(high))};
+            for (int p = 0; p < 4; ++p)
+            {
+                const float scale = scales[rgbe[(i + p) * 4 + 3]];
+                vst1q_f32(rgb + (i + p) * 3, vmulq_n_f32(vcvtq_f32_u32(pixels[p]), scale));
+            }
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            const float scale = scales[rgbe[i * 4 + 3]];
+            rgb[i * 3] = rgbe[i * 4] * scale;
+            rgb[i * 3 + 1] = rgbe[i * 4 + 1] * scale;
+            rgb[i * 3 + 2] = rgbe[i * 4 + 2] * scale;
+        }
+    }
+
+    void HdrImage::rgbeToHalf(const uint8_t *rgbe, uint16_t *rgb, size_t count)
+    {
+        // Through a small float buffer that stays in L1; both halves of the trip are vectorized.
+        constexpr size_t kChunk = 256;
+        float buffer[kChunk * 3];
+        for (size_t i = 0; i < count; i += kChunk)
+        {
+            const size_t pixels = std::min(kChunk, count - i);
+            rgbeToFloat(rgbe + i * 4, buffer, pixels);
+            clampToHalfRange(buffer, pixels * 3);
+            floatToHalf(buffer, rgb + i * 3, pixels * 3);
+        }
+    }
+
+    bool HdrImage::readRgbe(const uint8_t *data, size_t size, const std::string &name, int &width, int &height, std::vector<uint8_t> &rgbe)
+    {
+        size_t position = 0;
+        std::string line;
+        if (!readLine(data, size, position, line) || line.compare(0, 2, "#?") != 0)
+        {
+            LOG_ERROR("TEXTURE::LOAD_FAILED: '{}' is not a Radiance HDR file.", name);
+            return false;
+        }
+        while (readLine(data, size, position, line) && !line.empty())
+        {
+            if (line.compare(0, 7, "FORMAT=") == 0 && line != "FORMAT=32-bit_rle_rgbe")
+            {
+                LOG_ERROR("TEXTURE::LOAD_FAILED: '{}' uses {}; only 32-bit_rle_rgbe is supported.", name, line);
+                return false;
+            }
+        }
+
+        // Resolution string: "-Y <height> +X <width>" is top-down, "+Y" bottom-up.
+        char yAxis[3] = {};
+        char xAxis[3] = {};
+        if (!readLine(data, size, position, line) ||
+            std::sscanf(line.c_str(), "%2s %d %2s %d", yAxis, &height, xAxis, &width) != 4 ||
+            (std::strcmp(yAxis, "-Y") != 0 && std::strcmp(yAxis, "+Y") != 0) || std::strcmp(xAxis, "+X") != 0 ||
+            width <= 0 || height <= 0)
+        {
+            LOG_ERROR("TEXTURE::LOAD_FAILED: '{}' has an unsupported resolution line '{}'.", name, line);
+            return false;
+        }
+        const bool topDown = yAxis[0] == '-';
+
+        const size_t rowSize = static_cast<size_t>(width) * 4;
+        rgbe.resize(rowSize * height);
+        for (int y = 0; y < height; ++y)
+        {
+            uint8_t *row = rgbe.data() + rowSize * (topDown ? height - 1 - y : y);
+            const bool rle = width >= 8 && width < 32768 && position + 4 <= size && data[position] == 2 &&
+                             data[position + 1] == 2 && (data[position + 2] << 8 | data[position + 3]) == width;
+            bool ok;
+            if (rle)
+            {
+                position += 4;
+                ok = readRleScanline(data, size, position, width, row);
+            }
+            else
+            {
+                ok = readFlatScanline(data, size, position, width, row);
+            }
+            if (!ok)
+            {
+                LOG_ERROR("TEXTURE::LOAD_FAILED: '{}' is corrupt at scanline {}.", name, y);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void HdrImage::equirectToCubemap(const float *panorama, int width, int height, int faceSize, ContainerImage &image)
+    {
+        constexpr float kPi = 3.14159265358979f;
+        const size_t faceTexels = static_cast<size_t>(faceSize) * faceSize;
+        const size_t faceBytes = faceTexels * 3 * sizeof(uint16_t);
+        image.faceCount = 6;
+        image.width = faceSize;
+        image.height = faceSize;
+        image.data.resize(faceBytes * 6);
+
+        std::vector<float> face(faceTexels * 3);
+        for (int f = 0; f < 6; ++f)
+        {
+            // Rows run along t, as the cube map face conventions of the GL spec define them.
+            for (int row = 0; row < faceSize; ++row)
+            {
+                const float tc = 2.0f * (row + 0.5f) / faceSize - 1.0f;
+                for (int column = 0; column < faceSize; ++column)
+                {
+                    const float sc = 2.0f * (column + 0.5f) / faceSize - 1.0f;
+                    float direction[3];
+                    switch (f)
+                    {
+                    case 0: direction[0] = 1.0f; direction[1] = -tc; direction[2] = -sc; break; // +X
+                    case 1: direction[0] = -1.0f; direction[1] = -tc; direction[2] = sc; break; // -X
+                    case 2: direction[0] = sc; direction[1] = 1.0f; direction[2] = tc; break;   // +Y
+                    case 3: direction[0] = sc; direction[1] = -1.0f; direction[2] = -tc; break; // -Y
+                    case 4: direction[0] = sc; direction[1] = -tc; direction[2] = 1.0f; break;  // +Z
+                    default: direction[0] = -sc; direction[1] = -tc; direction[2] = -1.0f; break; // -Z
+                    }
+                    const float length = std::sqrt(direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2]);
+
+                    // Same mapping as the usual equirectangular shader lookup, v = 1 at the top.
+                    const float u = std::atan2(direction[2], direction[0]) / (2.0f * kPi) + 0.5f;
+                    const float v = std::asin(std::clamp(direction[1] / length, -1.0f, 1.0f)) / kPi + 0.5f;
+                    samplePanorama(panorama, width, height, u, v, face.data() + (static_cast<size_t>(row) * faceSize + column) * 3);
+                }
+            }
+
+            ImageLevel level;
+            level.offset = faceBytes * f;
+            level.size = faceBytes;
+            level.width = faceSize;
+            level.height = faceSize;
+            floatToHalf(face.data(), reinterpret_cast<uint16_t *>(image.data.data() + level.offset), face.size());
+            image.levels.push_back(level);
+        }
+    }
+
+    bool HdrImage::load(const void *fileData, size_t fileSize, const std::string &name, int cubemapFaceSize, ContainerImage &image)
+    {
+        int width = 0;
+        int height = 0;
+        std::vector<uint8_t> rgbe;
+        if (!readRgbe(static_cast<const uint8_t *>(fileData), fileSize, name, width, height, rgbe))
+        {
+            return false;
+        }
+
+        image = ContainerImage();
+        image.internalFormat = GL_RGB16F;
+        image.pixelFormat = GL_RGB;
+        image.pixelType = GL_HALF_FLOAT;
+        image.generateMipmaps = true;
+
+        const size_t pixelCount = static_cast<size_t>(width) * height;
+        if (cubemapFaceSize > 0)
+        {
+            std::vector<float> panorama(pixelCount * 3);
+            rgbeToFloat(rgbe.data(), panorama.data(), pixelCount);
+            clampToHalfRange(panorama.data(), panorama.size());
+            equirectToCubemap(panorama.data(), width, height, cubemapFaceSize, image);
+            return true;
+        }
+
+        ImageLevel level;
+        level.size = pixelCount * 3 * sizeof(uint16_t);
+        level.width = width;
+        level.height = height;
+        image.width = width;
+        image.height = height;
+        image.data.resize(level.size);
+        rgbeToHalf(rgbe.data(), reinterpret_cast<uint16_t *>(image.data.data()), pixelCount);
+        image.levels.push_back(level);
+        return true;
+    }
+
+} // namespace Base
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "TextureCompression.hpp"
+
+namespace Base
+{
+    // Radiance .hdr (RGBE) images, decoded straight to GL_RGB16F: half the memory of RGB32F and
+    // no float32 round trip through stb_image.
+    class HdrImage
+    {
+    public:
+        static bool isHdrFile(const std::string &path);
+
+        // Decodes to one RGB16F level, bottom row first, with the mip chain left to the driver.
+        // With cubemapFaceSize > 0 the equirectangular panorama is resampled into the six faces of
+        // a cube map of that size instead. Touches no GL state.
+        static bool load(const void *fileData, size_t fileSize, const std::string &name, int cubemapFaceSize, ContainerImage &image);
+
+        // Vectorized conversions of `count` RGBE pixels; rgbeToHalf saturates at the half range.
+        static void rgbeToFloat(const uint8_t *rgbe, float *rgb, size_t count);
+        static void rgbeToHalf(const uint8_t *rgbe, uint16_t *rgb, size_t count);
+
+    private:
+        // Raw RGBE pixels, bottom row first.
+        static bool readRgbe(const uint8_t *data, size_t size, const std::string &name, int &width, int &height, std::vector<uint8_t> &rgbe);
+        static void equirectToCubemap(const float *panorama, int width, int height, int faceSize, ContainerImage &image);
+    };
+
+} // namespace Base
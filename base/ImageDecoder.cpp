@@ -0,0 +1,215 @@
+#include "ImageDecoder.hpp"
+#include "Log.hpp"
+#include "PngDecoder.hpp"
+#include "QoiDecoder.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+
+// stb_image allocates through the tracked heap as well, so its scratch shows up in the stats.
+#define STBI_MALLOC(size) Base::ImageDecoder::allocate(size)
+#define STBI_REALLOC(memory, size) Base::ImageDecoder::reallocate(memory, size)
+#define STBI_FREE(memory) Base::ImageDecoder::release(memory)
+#define STBI_NO_JPEG
+//#define STBI_NO_PNG
+#define STBI_NO_BMP
+#define STBI_NO_PSD
+#define STBI_NO_TGA
+#define STBI_NO_GIF
+#define STBI_NO_PIC
+#define STBI_NO_PNM
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+namespace Base
+{
+    namespace
+    {
+        // Every block starts with its size; 16 bytes keep the payload aligned for SIMD loads.
+        constexpr size_t kHeaderSize = 16;
+
+        std::atomic<size_t> s_CurrentBytes = 0;
+        std::atomic<size_t> s_PeakBytes = 0;
+
+        void trackAllocation(size_t size)
+        {
+            const size_t current = s_CurrentBytes.fetch_add(size) + size;
+            size_t peak = s_PeakBytes.load();
+            while (current > peak && !s_PeakBytes.compare_exchange_weak(peak, current))
+            {
+            }
+        }
+
+        class StbDecoder : public ImageDecoder
+        {
+        public:
+            const char *getName() const override { return "stb_image"; }
+
+            bool canDecode(const uint8_t *data, size_t size) const override
+            {
+                int width = 0;
+                int height = 0;
+                int channels = 0;
+                return stbi_info_from_memory(data, static_cast<int>(size), &width, &height, &channels) != 0;
+            }
+
+            bool decode(const uint8_t *data, size_t size, ImageData &image) const override
+            {
+                // The per-thread flag keeps concurrent decodes on worker threads from racing on
+                // stb_image's global one.
+                stbi_set_flip_vertically_on_load_thread(true);
+                image = ImageData();
+                image.pixels = stbi_load_from_memory(data, static_cast<int>(size), &image.width, &image.height, &image.channels, 0);
+                return image.pixels != nullptr;
+            }
+        };
+
+        struct Registry
+        {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<ImageDecoder>> decoders;
+
+            Registry()
+            {
+                decoders.push_back(std::make_unique<QoiDecoder>());
+                decoders.push_back(std::make_unique<PngDecoder>());
+                decoders.push_back(std::make_unique<StbDecoder>());
+            }
+        };
+
+        Registry &registry()
+        {
+            static Registry s_Registry;
+            return s_Registry;
+        }
+    } // namespace
+
+    ImageData::~ImageData()
+    {
+        ImageDecoder::release(pixels);
+    }
+
+    ImageData::ImageData(ImageData &&other) noexcept
+        : width(other.width), height(other.height), channels(other.channels), pixels(other.pixels)
+    {
+        other.pixels = nullptr;
+    }
+
+    ImageData &ImageData::operator=(ImageData &&other) noexcept
+    {
+        if (this != &other)
+        {
+            ImageDecoder::release(pixels);
+            width = other.width;
+            height = other.height;
+            channels = other.channels;
+            pixels = other.pixels;
+            other.pixels = nullptr;
+        }
+        return *this;
+    }
+
+    std::vector<const ImageDecoder *> ImageDecoder::getDecoders()
+    {
+        Registry &decoders = registry();
+        std::lock_guard<std::mutex> lock(decoders.mutex);
+        std::vector<const ImageDecoder *> result;
+        for (const std::unique_ptr<ImageDecoder> &decoder : decoders.decoders)
+        {
+            result.push_back(decoder.get());
+        }
+        return result;
+    }
+
+    const ImageDecoder *ImageDecoder::findDecoder(const std::string &name)
+    {
+        for (const ImageDecoder *decoder : getDecoders())
+        {
+            if (name == decoder->getName())
+            {
+                return decoder;
+            }
+        }
+        return nullptr;
+    }
+
+    void ImageDecoder::registerDecoder(std::unique_ptr<ImageDecoder> decoder)
+    {
+        Registry &decoders = registry();
+        std::lock_guard<std::mutex> lock(decoders.mutex);
+        LOG_DEBUG("ImageDecoder: registered '{}'.", decoder->getName());
+        decoders.decoders.insert(decoders.decoders.begin(), std::move(decoder));
+    }
+
+    bool ImageDecoder::decodeImage(const uint8_t *data, size_t size, const std::string &name, ImageData &image)
+    {
+        for (const ImageDecoder *decoder : getDecoders())
+        {
+            if (decoder->canDecode(data, size))
+            {
+                if (decoder->decode(data, size, image))
+                {
+                    return true;
+                }
+                LOG_ERROR("TEXTURE::LOAD_FAILED: {} could not decode '{}'.", decoder->getName(), name);
+                return false;
+            }
+        }
+        LOG_ERROR("TEXTURE::LOAD_FAILED: No decoder recognizes '{}'.", name);
+        return false;
+    }
+
+    void *ImageDecoder::allocate(size_t size)
+    {
+        auto *block = static_cast<uint8_t *>(std::malloc(size + kHeaderSize));
+        if (!block)
+        {
+            return nullptr;
+        }
+        *reinterpret_cast<size_t *>(block) = size;
+        trackAllocation(size);
+        return block + kHeaderSize;
+    }
+
+    void *ImageDecoder::reallocate(void *memory, size_t size)
+    {
+        if (!memory)
+        {
+            return allocate(size);
+        }
+        uint8_t *block = static_cast<uint8_t *>(memory) - kHeaderSize;
+        const size_t oldSize = *reinterpret_cast<size_t *>(block);
+        auto *resized = static_cast<uint8_t *>(std::realloc(block, size + kHeaderSize));
+        if (!resized)
+        {
+            return nullptr;
+        }
+        *reinterpret_cast<size_t *>(resized) = size;
+        s_CurrentBytes -= oldSize;
+        trackAllocation(size);
+        return resized + kHeaderSize;
+    }
+
+    void ImageDecoder::release(void *memory)
+    {
+        if (!memory)
+        {
+            return;
+        }
+        uint8_t *block = static_cast<uint8_t *>(memory) - kHeaderSize;
+        s_CurrentBytes -= *reinterpret_cast<size_t *>(block);
+        std::free(block);
+    }
+
+    ImageDecoder::MemoryStats ImageDecoder::getMemoryStats()
+    {
+        return {s_CurrentBytes.load(), s_PeakBytes.load()};
+    }
+
+    void ImageDecoder::resetPeakMemory()
+    {
+        s_PeakBytes = s_CurrentBytes.load();
+    }
+
+} // namespace Base
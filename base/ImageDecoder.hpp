@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Base
+{
+    // Decoded 8-bit image, bottom row first (as OpenGL expects). `pixels` comes from
+    // ImageDecoder::allocate and is released with it.
+    struct ImageData
+    {
+        int width = 0;
+        int height = 0;
+        int channels = 0;
+        unsigned char *pixels = nullptr;
+
+        ImageData() = default;
+        ~ImageData();
+        ImageData(ImageData &&other) noexcept;
+        ImageData &operator=(ImageData &&other) noexcept;
+        ImageData(const ImageData &) = delete;
+        ImageData &operator=(const ImageData &) = delete;
+
+        size_t rowSize() const { return static_cast<size_t>(width) * channels; }
+        size_t byteSize() const { return rowSize() * height; }
+    };
+
+    // One image file format. Texture::readImageFile hands the file to the first registered
+    // decoder whose canDecode() accepts it: QOI, then the SIMD PNG path (PngDecoder), then
+    // stb_image for everything else, including the PNG variants PngDecoder leaves alone.
+    class ImageDecoder
+    {
+    public:
+        struct MemoryStats
+        {
+            size_t currentBytes = 0;
+            size_t peakBytes = 0;
+        };
+
+        virtual ~ImageDecoder() = default;
+
+        virtual const char *getName() const = 0;
+        // Looks at the header only.
+        virtual bool canDecode(const uint8_t *data, size_t size) const = 0;
+        // 1-4 channels as stored in the file. Must be thread safe.
+        virtual bool decode(const uint8_t *data, size_t size, ImageData &image) const = 0;
+
+        // Registered decoders, in the order they are tried.
+        static std::vector<const ImageDecoder *> getDecoders();
+        static const ImageDecoder *findDecoder(const std::string &name);
+        // Adds a decoder in front of the built-in ones. Call before any worker decodes.
+        static void registerDecoder(std::unique_ptr<ImageDecoder> decoder);
+        // `name` is only used in error messages.
+        static bool decodeImage(const uint8_t *data, size_t size, const std::string &name, ImageData &image);
+
+        // Heap used for pixels and decoder scratch (stb_image's included), counted so that
+        // tools/ImageDecodeBench can report the peak of a decode.
+        static void *allocate(size_t size);
+        static void *reallocate(void *memory, size_t size);
+        static void release(void *memory);
+        static MemoryStats getMemoryStats();
+        // Restarts peak tracking from the current usage.
+        static void resetPeakMemory();
+    };
+
+} // namespace Base
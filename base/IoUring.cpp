@@ -0,0 +1,223 @@
+#include "IoUring.hpp"
+
+#if PLATFORM_LINUX && __has_include(<linux/io_uring.h>)
+    #include <linux/io_uring.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+
+    #include <algorithm>
+    #include <atomic>
+    #include <cerrno>
+    #include <cstring>
+    #include <vector>
+    #define IO_URING_AVAILABLE 1
+#endif
+
+namespace Base
+{
+#if IO_URING_AVAILABLE
+    namespace
+    {
+        // The kernel reads the submission tail and writes the completion tail concurrently.
+        unsigned loadAcquire(unsigned *value)
+        {
+            return std::atomic_ref<unsigned>(*value).load(std::memory_order_acquire);
+        }
+
+        void storeRelease(unsigned *value, unsigned newValue)
+        {
+            std::atomic_ref<unsigned>(*value).store(newValue, std::memory_order_release);
+        }
+
+        void *mapRing(int fd, size_t size, off_t offset)
+        {
+            void *ring = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+            return ring == MAP_FAILED ? nullptr : ring;
+        }
+
+        unsigned *at(void *ring, uint32_t offset)
+        {
+            return reinterpret_cast<unsigned *>(static_cast<uint8_t *>(ring) + offset);
+        }
+
+        // io_uring_setup exists since 5.1 but IORING_OP_READ only since 5.6, like the probe itself.
+        bool supportsRead(int fd)
+        {
+            constexpr unsigned kOps = 256;
+            std::vector<uint8_t> buffer(sizeof(io_uring_probe) + kOps * sizeof(io_uring_probe_op));
+            auto *probe = reinterpret_cast<io_uring_probe *>(buffer.data());
+            if (syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, kOps) < 0)
+            {
+                return false;
+            }
+            return probe->last_op >= IORING_OP_READ && (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED) != 0;
+        }
+    } // namespace
+#endif
+
+    IoUring::~IoUring()
+    {
+        shutdown();
+    }
+
+    bool IoUring::initialize(unsigned entries)
+    {
+        shutdown();
+#if IO_URING_AVAILABLE
+        io_uring_params params = {};
+        const int fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0)
+        {
+            return false;
+        }
+        m_Fd = fd;
+        if (!supportsRead(fd))
+        {
+            shutdown();
+            return false;
+        }
+
+        m_SqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        m_CqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool singleMapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMapping)
+        {
+            m_SqRingSize = m_CqRingSize = std::max(m_SqRingSize, m_CqRingSize);
+        }
+        m_SqRing = mapRing(fd, m_SqRingSize, IORING_OFF_SQ_RING);
+        m_CqRing = singleMapping ? m_SqRing : mapRing(fd, m_CqRingSize, IORING_OFF_CQ_RING);
+        m_SqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        m_Sqes = mapRing(fd, m_SqesSize, IORING_OFF_SQES);
+        if (!m_SqRing || !m_CqRing || !m_Sqes)
+        {
+            shutdown();
+            return false;
+        }
+
+        m_SqHead = at(m_SqRing, params.sq_off.head);
+        m_SqTail = at(m_SqRing, params.sq_off.tail);
+        m_SqArray = at(m_SqRing, params.sq_off.array);
+        m_SqMask = *at(m_SqRing, params.sq_off.ring_mask);
+        m_SqEntries = params.sq_entries;
+        m_CqHead = at(m_CqRing, params.cq_off.head);
+        m_CqTail = at(m_CqRing, params.cq_off.tail);
+        m_Cqes = at(m_CqRing, params.cq_off.cqes);
+        m_CqMask = *at(m_CqRing, params.cq_off.ring_mask);
+        m_Queued = 0;
+        return true;
+#else
+        (void)entries;
+        return false;
+#endif
+    }
+
+    void IoUring::shutdown()
+    {
+#if IO_URING_AVAILABLE
+        if (m_Sqes)
+        {
+            munmap(m_Sqes, m_SqesSize);
+        }
+        if (m_CqRing && m_CqRing != m_SqRing)
+        {
+            munmap(m_CqRing, m_CqRingSize);
+        }
+        if (m_SqRing)
+        {
+            munmap(m_SqRing, m_SqRingSize);
+        }
+        if (m_Fd >= 0)
+        {
+            close(m_Fd);
+        }
+#endif
+        m_Fd = -1;
+        m_SqRing = m_CqRing = m_Sqes = nullptr;
+        m_SqHead = m_SqTail = m_SqArray = m_CqHead = m_CqTail = nullptr;
+        m_Cqes = nullptr;
+        m_Queued = 0;
+    }
+
+    bool IoUring::prepareRead(int fd, void *buffer, uint32_t size, uint64_t offset, uint64_t userData)
+    {
+#if IO_URING_AVAILABLE
+        if (m_Fd < 0)
+        {
+            return false;
+        }
+        const unsigned tail = *m_SqTail; // Only this thread writes it
+        if (tail - loadAcquire(m_SqHead) >= m_SqEntries)
+        {
+            return false;
+        }
+        const unsigned index = tail & m_SqMask;
+        io_uring_sqe &sqe = static_cast<io_uring_sqe *>(m_Sqes)[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_READ;
+        sqe.fd = fd;
+        sqe.addr = reinterpret_cast<uint64_t>(buffer);
+        sqe.len = size;
+        sqe.off = offset;
+        sqe.user_data = userData;
+        m_SqArray[index] = index;
+        storeRelease(m_SqTail, tail + 1);
+        m_Queued++;
+        return true;
+#else
+        (void)fd, (void)buffer, (void)size, (void)offset, (void)userData;
+        return false;
+#endif
+    }
+
+    bool IoUring::submit(unsigned waitFor)
+    {
+#if IO_URING_AVAILABLE
+        if (m_Fd < 0)
+        {
+            return false;
+        }
+        const unsigned flags = waitFor > 0 ? IORING_ENTER_GETEVENTS : 0;
+        for (;;)
+        {
+            const int submitted = static_cast<int>(syscall(__NR_io_uring_enter, m_Fd, m_Queued, waitFor, flags, nullptr, 0));
+            if (submitted >= 0)
+            {
+                m_Queued -= std::min<unsigned>(m_Queued, static_cast<unsigned>(submitted));
+                return true;
+            }
+            if (errno != EINTR)
+            {
+                return false;
+            }
+        }
+#else
+        (void)waitFor;
+        return false;
+#endif
+    }
+
+    bool IoUring::popCompletion(Completion &completion)
+    {
+#if IO_URING_AVAILABLE
+        if (m_Fd < 0)
+        {
+            return false;
+        }
+        const unsigned head = *m_CqHead; // Only this thread writes it
+        if (head == loadAcquire(m_CqTail))
+        {
+            return false;
+        }
+        const io_uring_cqe &cqe = static_cast<const io_uring_cqe *>(m_Cqes)[head & m_CqMask];
+        completion.userData = cqe.user_data;
+        completion.result = cqe.res;
+        storeRelease(m_CqHead, head + 1);
+        return true;
+#else
+        (void)completion;
+        return false;
+#endif
+    }
+
+} // namespace Base
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Base
+{
+    // Minimal io_uring on top of the raw system calls (no liburing), as much as Vfs::readAsync
+    // needs: reads are queued in the submission ring, handed to the kernel in batches, and reaped
+    // from the completion ring. initialize() fails on platforms other than Linux, on kernels
+    // without IORING_OP_READ (before 5.6) and wherever the kernel or a seccomp filter refuses
+    // io_uring; callers then fall back to blocking reads.
+    //
+    // Not thread-safe: one thread prepares, submits and reaps.
+    class IoUring
+    {
+    public:
+        struct Completion
+        {
+            uint64_t userData = 0;
+            int32_t result = 0; // Bytes transferred, or -errno
+        };
+
+        static constexpr unsigned kDefaultEntries = 64;
+
+        IoUring() = default;
+        ~IoUring();
+
+        IoUring(const IoUring &) = delete;
+        IoUring &operator=(const IoUring &) = delete;
+
+        bool initialize(unsigned entries = kDefaultEntries);
+        void shutdown();
+        bool isInitialized() const { return m_Fd >= 0; }
+
+        // Queues a read of `fd` at `offset` into `buffer`. False when the submission ring is full.
+        bool prepareRead(int fd, void *buffer, uint32_t size, uint64_t offset, uint64_t userData);
+        // Hands everything queued to the kernel, then blocks until at least `waitFor` completions
+        // are available (0: don't wait). False on failure.
+        bool submit(unsigned waitFor = 0);
+        // Takes the oldest available completion. False when there is none.
+        bool popCompletion(Completion &completion);
+
+        size_t getPendingSubmissions() const { return m_Queued; }
+
+    private:
+        int m_Fd = -1;
+        void *m_SqRing = nullptr;
+        void *m_CqRing = nullptr;
+        void *m_Sqes = nullptr;
+        size_t m_SqRingSize = 0;
+        size_t m_CqRingSize = 0;
+        size_t m_SqesSize = 0;
+
+        // Pointers into the rings, filled by initialize()
+        unsigned *m_SqHead = nullptr;
+        unsigned *m_SqTail = nullptr;
+        unsigned *m_SqArray = nullptr;
+        unsigned m_SqMask = 0;
+        unsigned m_SqEntries = 0;
+        unsigned *m_CqHead = nullptr;
+        unsigned *m_CqTail = nullptr;
+        void *m_Cqes = nullptr;
+        unsigned m_CqMask = 0;
+
+        unsigned m_Queued = 0; // Prepared but not yet submitted
+    };
+
+} // namespace Base
@@ -0,0 +1,60 @@
+#include "LodSelector.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Base
+{
+    void LodSelector::update(const Camera &camera, float viewportHeight)
+    {
+        m_CameraPosition = camera.getPosition();
+        m_PixelsPerUnitAtOne = viewportHeight / (2.0f * std::tan(glm::radians(camera.getFov()) * 0.5f));
+    }
+
+    float LodSelector::getPixelsPerUnit(float distance) const
+    {
+        // Objects around the camera are always shown at full detail.
+        return distance > 1e-4f ? m_PixelsPerUnitAtOne / distance : m_PixelsPerUnitAtOne * 1e4f;
+    }
+
+    float LodSelector::getPixelError(const MeshLod &lod, const glm::vec3 &worldCenter, float worldDiagonal) const
+    {
+        const float distance = glm::length(worldCenter - m_CameraPosition) - worldDiagonal * 0.5f;
+        return lod.error * worldDiagonal * getPixelsPerUnit(distance);
+    }
+
+    uint32_t LodSelector::select(const std::vector<MeshLod> &lods, const glm::vec3 &worldCenter, float worldDiagonal,
+                                 uint32_t current) const
+    {
+        if (lods.empty())
+        {
+            return 0;
+        }
+        const auto last = static_cast<uint32_t>(lods.size() - 1);
+        current = std::min(current, last);
+
+        // Coarsest LOD within `threshold` pixels; errors grow with the LOD index.
+        const auto coarsest = [&](float threshold)
+        {
+            uint32_t lod = 0;
+            while (lod < last && getPixelError(lods[lod + 1], worldCenter, worldDiagonal) <= threshold)
+            {
+                ++lod;
+            }
+            return lod;
+        };
+
+        const uint32_t wanted = coarsest(m_Settings.maxPixelError);
+        if (wanted > current)
+        {
+            return std::max(current, coarsest(m_Settings.maxPixelError * (1.0f - m_Settings.hysteresis)));
+        }
+        if (wanted < current &&
+            getPixelError(lods[current], worldCenter, worldDiagonal) > m_Settings.maxPixelError * (1.0f + m_Settings.hysteresis))
+        {
+            return wanted;
+        }
+        return current;
+    }
+
+} // namespace Base
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Camera.hpp"
+#include "Mesh.hpp"
+
+namespace Base
+{
+    // Picks a level of detail per object from how large its simplification error appears on
+    // screen: the coarsest LOD whose error (MeshLod::error times the object's bounds diagonal)
+    // projects to at most `maxPixelError` pixels, using the camera's vertical field of view and the
+    // viewport height. Distance is taken to the nearest point of the bounding sphere.
+    //
+    // To avoid popping back and forth at a threshold, an object only moves to a coarser LOD once
+    // its error is below maxPixelError * (1 - hysteresis), and only moves back to a finer one once
+    // the current error exceeds maxPixelError * (1 + hysteresis). Callers keep the previous LOD per
+    // object and pass it in.
+    class LodSelector
+    {
+    public:
+        struct Settings
+        {
+            float maxPixelError = 1.0f;
+            float hysteresis = 0.25f;
+        };
+
+        // Call once per frame, before select().
+        void update(const Camera &camera, float viewportHeight);
+
+        void setSettings(const Settings &settings) { m_Settings = settings; }
+        const Settings &getSettings() const { return m_Settings; }
+
+        // Pixels covered by one world unit at `distance` from the camera.
+        float getPixelsPerUnit(float distance) const;
+        // Projected error of `lod` in pixels.
+        float getPixelError(const MeshLod &lod, const glm::vec3 &worldCenter, float worldDiagonal) const;
+
+        // `worldCenter` and `worldDiagonal` are the object's bounds in world space (diagonal
+        // scaled by the model matrix). Returns `current` or the LOD to switch to; 0 without LODs.
+        uint32_t select(const std::vector<MeshLod> &lods, const glm::vec3 &worldCenter, float worldDiagonal,
+                        uint32_t current) const;
+
+    private:
+        glm::vec3 m_CameraPosition = glm::vec3(0.0f);
+        float m_PixelsPerUnitAtOne = 0.0f; // viewportHeight / (2 tan(fov / 2))
+        Settings m_Settings;
+    };
+
+} // namespace Base
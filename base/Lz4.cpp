@@ -0,0 +1,215 @@
+#include "Lz4.hpp"
+
+#include <cstring>
+#include <vector>
+
+namespace Base
+{
+    namespace
+    {
+        constexpr size_t kMinMatch = 4;
+        // The format requires the last 5 bytes to be literals and the last match to start at
+        // least 12 bytes before the end.
+        constexpr size_t kLastLiterals = 5;
+        constexpr size_t kMatchStartLimit = 12;
+        constexpr size_t kMaxOffset = 65535;
+        constexpr int kHashBits = 16;
+
+        uint32_t read32(const uint8_t *p)
+        {
+            uint32_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        uint32_t hash(uint32_t sequence)
+        {
+            return (sequence * 2654435761u) >> (32 - kHashBits);
+        }
+
+        // Lengths past the 4-bit token field continue in bytes of 255 and a remainder.
+        bool writeLength(uint8_t *&out, const uint8_t *end, size_t length)
+        {
+            for (; length >= 255; length -= 255)
+            {
+                if (out == end)
+                {
+                    return false;
+                }
+                *out++ = 255;
+            }
+            if (out == end)
+            {
+                return false;
+            }
+            *out++ = static_cast<uint8_t>(length);
+            return true;
+        }
+
+        bool readLength(const uint8_t *&in, const uint8_t *end, size_t &length)
+        {
+            uint8_t byte;
+            do
+            {
+                if (in == end)
+                {
+                    return false;
+                }
+                byte = *in++;
+                length += byte;
+            } while (byte == 255);
+            return true;
+        }
+
+        // Literals [literal, literal + literalCount), then a match, unless matchLength is 0 (the
+        // last sequence).
+        bool writeSequence(uint8_t *&out, const uint8_t *end, const uint8_t *literal, size_t literalCount, size_t offset,
+                           size_t matchLength)
+        {
+            if (out == end)
+            {
+                return false;
+            }
+            uint8_t *token = out++;
+            *token = static_cast<uint8_t>((literalCount >= 15 ? 15 : literalCount) << 4);
+            if (literalCount >= 15 && !writeLength(out, end, literalCount - 15))
+            {
+                return false;
+            }
+            if (static_cast<size_t>(end - out) < literalCount)
+            {
+                return false;
+            }
+            std::memcpy(out, literal, literalCount);
+            out += literalCount;
+            if (matchLength == 0)
+            {
+                return true;
+            }
+
+            if (end - out < 2)
+            {
+                return false;
+            }
+            *out++ = static_cast<uint8_t>(offset & 0xFF);
+            *out++ = static_cast<uint8_t>(offset >> 8);
+            const size_t extra = matchLength - kMinMatch;
+            *token |= static_cast<uint8_t>(extra >= 15 ? 15 : extra);
+            return extra < 15 || writeLength(out, end, extra - 15);
+        }
+    } // namespace
+
+    size_t Lz4::compress(const uint8_t *source, size_t size, uint8_t *destination, size_t capacity)
+    {
+        uint8_t *out = destination;
+        const uint8_t *end = destination + capacity;
+        size_t anchor = 0;
+
+        if (size > kMatchStartLimit)
+        {
+            std::vector<uint32_t> table(size_t(1) << kHashBits, 0);
+            const size_t matchStartLimit = size - kMatchStartLimit;
+            const size_t matchEndLimit = size - kLastLiterals;
+            size_t position = 0;
+            size_t misses = 0;
+            while (position < matchStartLimit)
+            {
+                const uint32_t sequence = read32(source + position);
+                const uint32_t slot = hash(sequence);
+                const size_t candidate = table[slot];
+                table[slot] = static_cast<uint32_t>(position);
+                if (candidate >= position || position - candidate > kMaxOffset || read32(source + candidate) != sequence)
+                {
+                    // Skip faster through data that does not compress.
+                    position += 1 + (misses++ >> 6);
+                    continue;
+                }
+                misses = 0;
+
+                size_t length = kMinMatch;
+                while (position + length < matchEndLimit && source[candidate + length] == source[position + length])
+                {
+                    ++length;
+                }
+                if (!writeSequence(out, end, source + anchor, position - anchor, position - candidate, length))
+                {
+                    return 0;
+                }
+                position += length;
+                anchor = position;
+                if (position - 2 < matchStartLimit)
+                {
+                    table[hash(read32(source + position - 2))] = static_cast<uint32_t>(position - 2);
+                }
+            }
+        }
+
+        if (!writeSequence(out, end, source + anchor, size - anchor, 0, 0))
+        {
+            return 0;
+        }
+        return static_cast<size_t>(out - destination);
+    }
+
+    bool Lz4::decompress(const uint8_t *source, size_t size, uint8_t *destination, size_t destinationSize)
+    {
+        const uint8_t *in = source;
+        const uint8_t *inEnd = source + size;
+        uint8_t *out = destination;
+        uint8_t *outEnd = destination + destinationSize;
+
+        while (in < inEnd)
+        {
+            const uint8_t token = *in++;
+            size_t literalCount = token >> 4;
+            if (literalCount == 15 && !readLength(in, inEnd, literalCount))
+            {
+                return false;
+            }
+            if (static_cast<size_t>(inEnd - in) < literalCount || static_cast<size_t>(outEnd - out) < literalCount)
+            {
+                return false;
+            }
+            std::memcpy(out, in, literalCount);
+            in += literalCount;
+            out += literalCount;
+            if (in == inEnd)
+            {
+                break; // The last sequence has no match.
+            }
+
+            if (inEnd - in < 2)
+            {
+                return false;
+            }
+            const size_t offset = size_t(in[0]) | (size_t(in[1]) << 8);
+            in += 2;
+            size_t length = token & 15;
+            if (length == 15 && !readLength(in, inEnd, length))
+            {
+                return false;
+            }
+            length += kMinMatch;
+            if (offset == 0 || offset > static_cast<size_t>(out - destination) || static_cast<size_t>(outEnd - out) < length)
+            {
+                return false;
+            }
+            const uint8_t *match = out - offset;
+            if (offset >= length)
+            {
+                std::memcpy(out, match, length);
+                out += length;
+            }
+            else
+            {
+                // Overlapping copy: repeats the last `offset` bytes.
+                for (size_t i = 0; i < length; ++i)
+                {
+                    *out++ = match[i];
+                }
+            }
+        }
+        return out == outEnd;
+    }
+
+} // namespace Base
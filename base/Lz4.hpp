@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Base
+{
+    // LZ4 block format (https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md): byte-aligned
+    // literal runs and back-references within 64 KB, so decoding is a tight copy loop. Compression
+    // is a single greedy pass with a 64K-entry hash table; the output is readable by any LZ4
+    // decoder, and decompress() reads any valid block.
+    class Lz4
+    {
+    public:
+        // Worst-case compressed size of `size` bytes.
+        static size_t compressBound(size_t size) { return size + size / 255 + 16; }
+
+        // Returns the compressed size, or 0 if it would not fit in `capacity`.
+        static size_t compress(const uint8_t *source, size_t size, uint8_t *destination, size_t capacity);
+        // `destinationSize` must be the exact decompressed size. False on malformed input.
+        static bool decompress(const uint8_t *source, size_t size, uint8_t *destination, size_t destinationSize);
+    };
+
+} // namespace Base
@@ -0,0 +1,134 @@
+#include "MappedFile.hpp"
+#include "Log.hpp"
+
+#include <SDL3/SDL.h>
+
+#include <utility>
+
+#if PLATFORM_WINDOWS
+    #define NOMINMAX
+    #include <windows.h>
+    #define MAPPED_FILE_WIN32 1
+#elif PLATFORM_LINUX || PLATFORM_APPLE
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #define MAPPED_FILE_POSIX 1
+#endif
+
+namespace Base
+{
+    MappedFile::~MappedFile()
+    {
+        close();
+    }
+
+    MappedFile::MappedFile(MappedFile &&other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+    {
+        if (this != &other)
+        {
+            close();
+            m_Data = std::exchange(other.m_Data, nullptr);
+            m_Size = std::exchange(other.m_Size, 0);
+            m_Mapping = std::exchange(other.m_Mapping, nullptr);
+            m_Buffer = std::exchange(other.m_Buffer, nullptr);
+            m_Open = std::exchange(other.m_Open, false);
+        }
+        return *this;
+    }
+
+    bool MappedFile::open(const std::string &path, bool logErrors)
+    {
+        close();
+
+#if MAPPED_FILE_WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file != INVALID_HANDLE_VALUE)
+        {
+            LARGE_INTEGER fileSize = {};
+            GetFileSizeEx(file, &fileSize);
+            m_Size = static_cast<size_t>(fileSize.QuadPart);
+            HANDLE mapping = m_Size > 0 ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+            CloseHandle(file);
+            if (mapping)
+            {
+                m_Mapping = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                // The view keeps the mapping alive.
+                CloseHandle(mapping);
+            }
+            if (m_Mapping || m_Size == 0)
+            {
+                m_Data = static_cast<const uint8_t *>(m_Mapping);
+                m_Open = true;
+                return true;
+            }
+        }
+#elif MAPPED_FILE_POSIX
+        const int file = ::open(path.c_str(), O_RDONLY);
+        if (file >= 0)
+        {
+            struct stat info = {};
+            if (fstat(file, &info) == 0)
+            {
+                m_Size = static_cast<size_t>(info.st_size);
+                void *mapping = m_Size > 0 ? mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, file, 0) : nullptr;
+                if (mapping != MAP_FAILED)
+                {
+                    m_Mapping = mapping;
+                    m_Data = static_cast<const uint8_t *>(mapping);
+                    m_Open = true;
+                }
+            }
+            ::close(file);
+            if (m_Open)
+            {
+                return true;
+            }
+        }
+#endif
+
+        // Not mappable here (or mapping failed): read the whole file.
+        m_Size = 0;
+        m_Buffer = SDL_LoadFile(path.c_str(), &m_Size);
+        if (!m_Buffer)
+        {
+            if (logErrors)
+            {
+                LOG_ERROR("MappedFile: could not open '{}': {}", path, SDL_GetError());
+            }
+            return false;
+        }
+        m_Data = static_cast<const uint8_t *>(m_Buffer);
+        m_Open = true;
+        return true;
+    }
+
+    void MappedFile::close()
+    {
+        if (m_Mapping)
+        {
+#if MAPPED_FILE_WIN32
+            UnmapViewOfFile(m_Mapping);
+#elif MAPPED_FILE_POSIX
+            munmap(m_Mapping, m_Size);
+#endif
+        }
+        if (m_Buffer)
+        {
+            SDL_free(m_Buffer);
+        }
+        m_Data = nullptr;
+        m_Size = 0;
+        m_Mapping = nullptr;
+        m_Buffer = nullptr;
+        m_Open = false;
+    }
+
+} // namespace Base
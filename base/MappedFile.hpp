@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Base
+{
+    // Read-only view of a whole file. Memory-mapped on Windows, Linux and Apple platforms, so
+    // opening costs no copy and pages are only read when touched; elsewhere (Android APK assets,
+    // Emscripten's virtual FS) the file is read into memory with SDL_LoadFile instead.
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(MappedFile &&other) noexcept;
+        MappedFile &operator=(MappedFile &&other) noexcept;
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        // `path` is used as is; resolve asset paths first. Returns false on failure, logging it
+        // unless `logErrors` is false (for files that are allowed to be missing).
+        bool open(const std::string &path, bool logErrors = true);
+        void close();
+
+        bool isOpen() const { return m_Open; }
+        // False when the contents were copied by the fallback path.
+        bool isMapped() const { return m_Mapping != nullptr; }
+        const uint8_t *data() const { return m_Data; }
+        size_t size() const { return m_Size; }
+
+    private:
+        const uint8_t *m_Data = nullptr;
+        size_t m_Size = 0;
+        void *m_Mapping = nullptr; // Platform mapping (view base on Windows)
+        void *m_Buffer = nullptr;  // SDL_LoadFile fallback
+        bool m_Open = false;
+    };
+
+} // namespace Base
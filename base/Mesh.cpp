@@ -0,0 +1,266 @@
+#include "Mesh.hpp"
+#include "Log.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace Base
+{
+    void MeshData::computeBounds()
+    {
+        if (vertices.empty())
+        {
+            boundsMin = boundsMax = glm::vec3(0.0f);
+            return;
+        }
+        boundsMin = boundsMax = vertices.front().position;
+        for (const MeshVertex &vertex : vertices)
+        {
+            boundsMin = glm::min(boundsMin, vertex.position);
+            boundsMax = glm::max(boundsMax, vertex.position);
+        }
+    }
+
+    void MeshData::computeNormals()
+    {
+        for (MeshVertex &vertex : vertices)
+        {
+            vertex.normal = glm::vec3(0.0f);
+        }
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            MeshVertex &a = vertices[indices[i]];
+            MeshVertex &b = vertices[indices[i + 1]];
+            MeshVertex &c = vertices[indices[i + 2]];
+            // Unnormalized, so larger triangles weigh more.
+            const glm::vec3 normal = glm::cross(b.position - a.position, c.position - a.position);
+            a.normal += normal;
+            b.normal += normal;
+            c.normal += normal;
+        }
+        for (MeshVertex &vertex : vertices)
+        {
+            const float length = glm::length(vertex.normal);
+            vertex.normal = length > 0.0f ? vertex.normal / length : glm::vec3(0.0f, 1.0f, 0.0f);
+        }
+    }
+
+    VertexLayout VertexLayout::standard()
+    {
+        VertexLayout layout;
+        layout.stride = sizeof(MeshVertex);
+        layout.attributes = {{0, 3, GL_FLOAT, false, static_cast<uint32_t>(offsetof(MeshVertex, position))},
+                             {1, 3, GL_FLOAT, false, static_cast<uint32_t>(offsetof(MeshVertex, normal))},
+                             {2, 2, GL_FLOAT, false, static_cast<uint32_t>(offsetof(MeshVertex, texCoord))}};
+        return layout;
+    }
+
+    MeshView MeshData::view() const
+    {
+        MeshView view;
+        view.vertices = vertices.data();
+        view.vertexCount = static_cast<uint32_t>(vertices.size());
+        view.layout = VertexLayout::standard();
+        view.indices = indices.data();
+        view.indexCount = static_cast<uint32_t>(indices.size());
+        view.indexSize = sizeof(uint32_t);
+        view.subMeshes = subMeshes;
+        view.lods = lods;
+        view.meshlets = meshlets;
+        view.boundsMin = boundsMin;
+        view.boundsMax = boundsMax;
+        return view;
+    }
+
+    Mesh::~Mesh()
+    {
+        release();
+    }
+
+    bool Mesh::upload(const MeshData &data)
+    {
+        return upload(data.view());
+    }
+
+    bool Mesh::upload(const MeshView &view)
+    {
+        if (!createBuffers(view, false))
+        {
+            return false;
+        }
+        finishUpload(view);
+        return true;
+    }
+
+    bool Mesh::beginUpload(const MeshView &view)
+    {
+        m_UploadedBytes = 0;
+        return createBuffers(view, true);
+    }
+
+    bool Mesh::uploadChunk(const MeshView &view, size_t maxBytes)
+    {
+        const size_t vertexBytes = static_cast<size_t>(view.vertexCount) * view.layout.stride;
+        const size_t totalBytes = vertexBytes + static_cast<size_t>(view.indexCount) * view.indexSize;
+        const size_t end = std::min(totalBytes, m_UploadedBytes + std::max<size_t>(maxBytes, 1));
+
+        // GL_COPY_WRITE_BUFFER leaves the array and element bindings (and so the VAO) alone.
+        if (m_UploadedBytes < vertexBytes)
+        {
+            const size_t chunkEnd = std::min(end, vertexBytes);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, m_Vbo);
+            glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(m_UploadedBytes),
+                            static_cast<GLsizeiptr>(chunkEnd - m_UploadedBytes),
+                            static_cast<const uint8_t *>(view.vertices) + m_UploadedBytes);
+            m_UploadedBytes = chunkEnd;
+        }
+        if (m_UploadedBytes >= vertexBytes && m_UploadedBytes < end)
+        {
+            const size_t offset = m_UploadedBytes - vertexBytes;
+            glBindBuffer(GL_COPY_WRITE_BUFFER, m_Ebo);
+            glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(end - m_UploadedBytes),
+                            static_cast<const uint8_t *>(view.indices) + offset);
+            m_UploadedBytes = end;
+        }
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        if (m_UploadedBytes < totalBytes)
+        {
+            return false;
+        }
+        finishUpload(view);
+        return true;
+    }
+
+    bool Mesh::createBuffers(const MeshView &view, bool streamed)
+    {
+        if (view.vertexCount == 0 || view.indexCount == 0 || (view.indexSize != 2 && view.indexSize != 4))
+        {
+            LOG_ERROR("Mesh: nothing to upload.");
+            return false;
+        }
+        release();
+
+        glGenVertexArrays(1, &m_Vao);
+        glGenBuffers(1, &m_Vbo);
+        glGenBuffers(1, &m_Ebo);
+
+        // Streamed buffers are only allocated here and filled by uploadChunk.
+        const void *vertices = streamed ? nullptr : view.vertices;
+        const void *indices = streamed ? nullptr : view.indices;
+        const GLsizeiptr vertexBytes = static_cast<GLsizeiptr>(view.vertexCount) * view.layout.stride;
+        const GLsizeiptr indexBytes = static_cast<GLsizeiptr>(view.indexCount) * view.indexSize;
+        glBindVertexArray(m_Vao);
+        glBindBuffer(GL_ARRAY_BUFFER, m_Vbo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_Ebo);
+#if PLATFORM_DESKTOP
+        if (GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage)
+        {
+            const GLbitfield flags = streamed ? GL_DYNAMIC_STORAGE_BIT : 0;
+            glBufferStorage(GL_ARRAY_BUFFER, vertexBytes, vertices, flags);
+            glBufferStorage(GL_ELEMENT_ARRAY_BUFFER, indexBytes, indices, flags);
+        }
+        else
+#endif
+        {
+            glBufferData(GL_ARRAY_BUFFER, vertexBytes, vertices, GL_STATIC_DRAW);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexBytes, indices, GL_STATIC_DRAW);
+        }
+
+        for (const VertexAttribute &attribute : view.layout.attributes)
+        {
+            glVertexAttribPointer(attribute.location, static_cast<GLint>(attribute.components), attribute.type,
+                                  attribute.normalized ? GL_TRUE : GL_FALSE, static_cast<GLsizei>(view.layout.stride),
+                                  (void *)static_cast<size_t>(attribute.offset));
+            glEnableVertexAttribArray(attribute.location);
+        }
+        glBindVertexArray(0);
+        return true;
+    }
+
+    void Mesh::finishUpload(const MeshView &view)
+    {
+        m_IndexCount = view.indexCount;
+        m_IndexType = view.indexSize == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        m_SubMeshes = view.subMeshes;
+        m_Lods = view.lods;
+        m_Meshlets = view.meshlets;
+        m_BoundsMin = view.boundsMin;
+        m_BoundsMax = view.boundsMax;
+    }
+
+    void Mesh::release()
+    {
+        if (m_Vao != 0)
+        {
+            glDeleteVertexArrays(1, &m_Vao);
+            glDeleteBuffers(1, &m_Vbo);
+            glDeleteBuffers(1, &m_Ebo);
+        }
+        m_Vao = m_Vbo = m_Ebo = 0;
+        m_IndexCount = 0;
+        m_SubMeshes.clear();
+        m_Lods.clear();
+        m_Meshlets.clear();
+    }
+
+    void Mesh::draw() const
+    {
+        drawLod(0);
+    }
+
+    void Mesh::drawLod(size_t lod) const
+    {
+        glBindVertexArray(m_Vao);
+        if (m_Lods.empty())
+        {
+            glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_IndexCount), m_IndexType, nullptr);
+            return;
+        }
+        const MeshLod &range = m_Lods[std::min(lod, m_Lods.size() - 1)];
+        const size_t indexSize = m_IndexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(range.indexCount), m_IndexType,
+                       (void *)(static_cast<size_t>(range.firstIndex) * indexSize));
+    }
+
+    void Mesh::drawRanges(const std::vector<DrawRange> &ranges) const
+    {
+        if (ranges.empty())
+        {
+            return;
+        }
+        glBindVertexArray(m_Vao);
+        const size_t indexSize = m_IndexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+#if PLATFORM_DESKTOP
+        std::vector<GLsizei> counts(ranges.size());
+        std::vector<const void *> offsets(ranges.size());
+        for (size_t i = 0; i < ranges.size(); ++i)
+        {
+            counts[i] = static_cast<GLsizei>(ranges[i].indexCount);
+            offsets[i] = (const void *)(static_cast<size_t>(ranges[i].firstIndex) * indexSize);
+        }
+        glMultiDrawElements(GL_TRIANGLES, counts.data(), m_IndexType, offsets.data(), static_cast<GLsizei>(ranges.size()));
+#else
+        // No glMultiDrawElements in GLES 3.0.
+        for (const DrawRange &range : ranges)
+        {
+            glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(range.indexCount), m_IndexType,
+                           (void *)(static_cast<size_t>(range.firstIndex) * indexSize));
+        }
+#endif
+    }
+
+    void Mesh::drawSubMesh(size_t index) const
+    {
+        if (index >= m_SubMeshes.size())
+        {
+            return;
+        }
+        const SubMesh &subMesh = m_SubMeshes[index];
+        glBindVertexArray(m_Vao);
+        const size_t indexSize = m_IndexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(subMesh.indexCount), m_IndexType,
+                       (void *)(static_cast<size_t>(subMesh.firstIndex) * indexSize));
+    }
+
+} // namespace Base
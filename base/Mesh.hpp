@@ -0,0 +1,180 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#if PLATFORM_DESKTOP
+    #include <glad/gl.h>
+#elif PLATFORM_ANDROID
+    #include <glad/egl.h>
+    #include <glad/gles2.h>
+#elif PLATFORM_EMSCRIPTEN || PLATFORM_IOS
+    #include <glad/gles2.h>
+#endif
+
+namespace Base
+{
+    // Same layout as the chapters' Vertex: attribute locations 0 (position), 1 (normal) and
+    // 2 (texCoord).
+    struct MeshVertex
+    {
+        glm::vec3 position = glm::vec3(0.0f);
+        glm::vec3 normal = glm::vec3(0.0f);
+        glm::vec2 texCoord = glm::vec2(0.0f);
+    };
+
+    // Index range drawn with one material.
+    struct SubMesh
+    {
+        std::string name;
+        std::string material;
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+    };
+
+    // Level of detail: the whole mesh simplified to `indexCount` indices from `firstIndex`, over
+    // the same vertices as the full mesh. LOD 0 is the full mesh (the submesh ranges); `error` is
+    // the deviation from it relative to the bounds diagonal.
+    struct MeshLod
+    {
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+        float error = 0.0f;
+    };
+
+    // Cluster of up to 64 vertices and 124 triangles of the full mesh (see MeshletBuilder), drawn
+    // as `indexCount` indices from `firstIndex`. The bounding sphere and normal cone let
+    // ClusterCuller skip it when it is outside the frustum or faces away from the camera: every
+    // triangle is backfacing for a camera position p with
+    // dot(normalize(coneApex - p), coneAxis) > coneCutoff. A cutoff of 1 means never backfacing.
+    struct Meshlet
+    {
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+        glm::vec3 center = glm::vec3(0.0f);
+        float radius = 0.0f;
+        glm::vec3 coneApex = glm::vec3(0.0f);
+        glm::vec3 coneAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+        float coneCutoff = 1.0f;
+    };
+
+    // Index range for Mesh::drawRanges.
+    struct DrawRange
+    {
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+    };
+
+    // One vertex attribute as passed to glVertexAttribPointer.
+    struct VertexAttribute
+    {
+        uint32_t location = 0;
+        uint32_t components = 0;
+        GLenum type = GL_FLOAT;
+        bool normalized = false;
+        uint32_t offset = 0;
+    };
+
+    struct VertexLayout
+    {
+        uint32_t stride = 0;
+        std::vector<VertexAttribute> attributes;
+
+        // MeshVertex: float position, normal and texCoord.
+        static VertexLayout standard();
+    };
+
+    // Non-owning description of GPU-ready vertex and index data, whatever it is stored in.
+    struct MeshView
+    {
+        const void *vertices = nullptr;
+        uint32_t vertexCount = 0;
+        VertexLayout layout;
+        const void *indices = nullptr;
+        uint32_t indexCount = 0;
+        uint32_t indexSize = 4; // Bytes per index: 2 or 4
+        std::vector<SubMesh> subMeshes;
+        std::vector<MeshLod> lods; // Empty without generated LODs
+        std::vector<Meshlet> meshlets; // Empty without generated meshlets
+        glm::vec3 boundsMin = glm::vec3(0.0f);
+        glm::vec3 boundsMax = glm::vec3(0.0f);
+    };
+
+    // Indexed triangle list on the CPU, as produced by the loaders.
+    struct MeshData
+    {
+        std::vector<MeshVertex> vertices;
+        std::vector<uint32_t> indices; // Full mesh first, then the LOD ranges
+        std::vector<SubMesh> subMeshes;
+        std::vector<MeshLod> lods;
+        std::vector<Meshlet> meshlets; // Over the full mesh
+        glm::vec3 boundsMin = glm::vec3(0.0f);
+        glm::vec3 boundsMax = glm::vec3(0.0f);
+
+        // Of the full mesh.
+        size_t getTriangleCount() const { return (lods.empty() ? indices.size() : lods[0].indexCount) / 3; }
+        size_t getByteSize() const { return vertices.size() * sizeof(MeshVertex) + indices.size() * sizeof(uint32_t); }
+        void computeBounds();
+        // Area-weighted vertex normals from the triangles.
+        void computeNormals();
+        MeshView view() const;
+    };
+
+    // GPU copy of a mesh: one VAO with its vertex and index buffer. The buffers are immutable
+    // (glBufferStorage) where the context supports it.
+    class Mesh
+    {
+    public:
+        Mesh() = default;
+        ~Mesh();
+
+        Mesh(const Mesh &) = delete;
+        Mesh &operator=(const Mesh &) = delete;
+
+        bool upload(const MeshData &data);
+        bool upload(const MeshView &view);
+        // upload(view) spread over several frames, for meshes too large to copy in one:
+        // beginUpload allocates the buffers and every uploadChunk copies up to `maxBytes` more of
+        // `view`, which must stay valid until it returns true. Nothing is drawn until then.
+        bool beginUpload(const MeshView &view);
+        bool uploadChunk(const MeshView &view, size_t maxBytes);
+        bool isUploading() const { return m_Vao != 0 && m_IndexCount == 0; }
+        void release();
+
+        void draw() const;
+        void drawSubMesh(size_t index) const;
+        // Draws the whole mesh at a level of detail; the full mesh without LODs.
+        void drawLod(size_t lod) const;
+        // Draws index ranges, e.g. the meshlets left by ClusterCuller, in one call where supported.
+        void drawRanges(const std::vector<DrawRange> &ranges) const;
+
+        GLuint getVao() const { return m_Vao; }
+        size_t getIndexCount() const { return m_IndexCount; }
+        const std::vector<SubMesh> &getSubMeshes() const { return m_SubMeshes; }
+        const std::vector<MeshLod> &getLods() const { return m_Lods; }
+        const std::vector<Meshlet> &getMeshlets() const { return m_Meshlets; }
+        glm::vec3 getBoundsMin() const { return m_BoundsMin; }
+        glm::vec3 getBoundsMax() const { return m_BoundsMax; }
+
+    private:
+        bool createBuffers(const MeshView &view, bool streamed);
+        void finishUpload(const MeshView &view);
+
+        GLuint m_Vao = 0;
+        GLuint m_Vbo = 0;
+        GLuint m_Ebo = 0;
+        size_t m_IndexCount = 0;
+        GLenum m_IndexType = GL_UNSIGNED_INT;
+        std::vector<SubMesh> m_SubMeshes;
+        std::vector<MeshLod> m_Lods;
+        std::vector<Meshlet> m_Meshlets;
+        glm::vec3 m_BoundsMin = glm::vec3(0.0f);
+        glm::vec3 m_BoundsMax = glm::vec3(0.0f);
+        size_t m_UploadedBytes = 0;
+    };
+
+} // namespace Base
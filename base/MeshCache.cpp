@@ -0,0 +1,389 @@
+#include "MeshCache.hpp"
+#include "AssetFile.hpp"
+#include "AssimpImporter.hpp"
+#include "Log.hpp"
+#include "MeshOptimizer.hpp"
+#include "MeshSimplifier.hpp"
+#include "MeshletBuilder.hpp"
+#include "ObjLoader.hpp"
+#include "PathUtils.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+namespace Base
+{
+    namespace
+    {
+        constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ull;
+        constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4Full;
+        constexpr uint64_t kPrime3 = 0x165667B19E3779F9ull;
+        constexpr uint64_t kPrime4 = 0x85EBCA77C2B2AE63ull;
+        constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ull;
+
+        // Bump when import() produces different output for the same source, so that caches made
+        // by older builds miss.
+        constexpr uint32_t kImportVersion = 3;
+
+        uint64_t rotateLeft(uint64_t value, int bits)
+        {
+            return (value << bits) | (value >> (64 - bits));
+        }
+
+        uint64_t read64(const uint8_t *data)
+        {
+            uint64_t value;
+            std::memcpy(&value, data, sizeof(value));
+            return value;
+        }
+
+        uint32_t read32(const uint8_t *data)
+        {
+            uint32_t value;
+            std::memcpy(&value, data, sizeof(value));
+            return value;
+        }
+
+        uint64_t round(uint64_t accumulator, uint64_t input)
+        {
+            return rotateLeft(accumulator + input * kPrime2, 31) * kPrime1;
+        }
+
+        uint64_t mergeRound(uint64_t accumulator, uint64_t value)
+        {
+            return (accumulator ^ round(0, value)) * kPrime1 + kPrime4;
+        }
+
+        double millisecondsSince(std::chrono::steady_clock::time_point start)
+        {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        std::string lowerExtension(const std::string &path)
+        {
+            std::string extension = std::filesystem::path(path).extension().string();
+            std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c)
+                           { return static_cast<char>(std::tolower(c)); });
+            return extension;
+        }
+
+        // "a%20b.bin" -> "a b.bin"; glTF URIs are percent-encoded.
+        std::string decodeUri(std::string_view uri)
+        {
+            std::string decoded;
+            for (size_t i = 0; i < uri.size(); ++i)
+            {
+                if (uri[i] == '%' && i + 2 < uri.size() && std::isxdigit(static_cast<unsigned char>(uri[i + 1])) &&
+                    std::isxdigit(static_cast<unsigned char>(uri[i + 2])))
+                {
+                    decoded += static_cast<char>(std::stoi(std::string(uri.substr(i + 1, 2)), nullptr, 16));
+                    i += 2;
+                }
+                else
+                {
+                    decoded += uri[i];
+                }
+            }
+            return decoded;
+        }
+
+        // The "uri" of every entry in a .gltf's top-level "buffers" array, except embedded data: URIs.
+        // Just enough JSON to walk that array; a malformed file yields whatever was found before the error.
+        std::vector<std::string> findGltfBufferUris(std::string_view json)
+        {
+            std::vector<std::string> uris;
+            const size_t key = json.find("\"buffers\"");
+            size_t i = key == std::string_view::npos ? key : json.find('[', key);
+            if (i == std::string_view::npos)
+            {
+                return uris;
+            }
+
+            int depth = 0;
+            bool expectUri = false;
+            for (; i < json.size(); ++i)
+            {
+                const char c = json[i];
+                if (c == '[' || c == '{')
+                {
+                    ++depth;
+                }
+                else if (c == ']' || c == '}')
+                {
+                    if (--depth == 0)
+                    {
+                        break;
+                    }
+                }
+                else if (c == '"')
+                {
+                    size_t end = i + 1;
+                    while (end < json.size() && json[end] != '"')
+                    {
+                        end += json[end] == '\\' ? 2 : 1;
+                    }
+                    if (end >= json.size())
+                    {
+                        break;
+                    }
+                    const std::string_view text = json.substr(i + 1, end - i - 1);
+                    size_t next = end + 1;
+                    while (next < json.size() && std::isspace(static_cast<unsigned char>(json[next])))
+                    {
+                        ++next;
+                    }
+                    // Depth 2 is a buffer object; a string followed by ':' is one of its keys.
+                    if (next < json.size() && json[next] == ':')
+                    {
+                        expectUri = depth == 2 && text == "uri";
+                    }
+                    else
+                    {
+                        if (expectUri && text.substr(0, 5) != "data:")
+                        {
+                            uris.push_back(decodeUri(text));
+                        }
+                        expectUri = false;
+                    }
+                    i = end;
+                }
+            }
+            return uris;
+        }
+    } // namespace
+
+    MeshCache &MeshCache::Get()
+    {
+        static std::unique_ptr<MeshCache> s_Instance(new MeshCache());
+        return *s_Instance;
+    }
+
+    uint64_t MeshCache::hashBytes(const void *data, size_t size)
+    {
+        const uint64_t seed = (uint64_t(MeshFile::kVersion) << 32) | kImportVersion;
+        const auto *p = static_cast<const uint8_t *>(data);
+        const uint8_t *end = p + size;
+        uint64_t hash;
+
+        if (size >= 32)
+        {
+            uint64_t v1 = seed + kPrime1 + kPrime2;
+            uint64_t v2 = seed + kPrime2;
+            uint64_t v3 = seed;
+            uint64_t v4 = seed - kPrime1;
+            for (; p + 32 <= end; p += 32)
+            {
+                v1 = round(v1, read64(p));
+                v2 = round(v2, read64(p + 8));
+                v3 = round(v3, read64(p + 16));
+                v4 = round(v4, read64(p + 24));
+            }
+            hash = rotateLeft(v1, 1) + rotateLeft(v2, 7) + rotateLeft(v3, 12) + rotateLeft(v4, 18);
+            hash = mergeRound(hash, v1);
+            hash = mergeRound(hash, v2);
+            hash = mergeRound(hash, v3);
+            hash = mergeRound(hash, v4);
+        }
+        else
+        {
+            hash = seed + kPrime5;
+        }
+        hash += static_cast<uint64_t>(size);
+
+        for (; p + 8 <= end; p += 8)
+        {
+            hash = rotateLeft(hash ^ round(0, read64(p)), 27) * kPrime1 + kPrime4;
+        }
+        if (p + 4 <= end)
+        {
+            hash = rotateLeft(hash ^ (read32(p) * kPrime1), 23) * kPrime2 + kPrime3;
+            p += 4;
+        }
+        for (; p < end; ++p)
+        {
+            hash = rotateLeft(hash ^ (*p * kPrime5), 11) * kPrime1;
+        }
+
+        hash ^= hash >> 33;
+        hash *= kPrime2;
+        hash ^= hash >> 29;
+        hash *= kPrime3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+    void MeshCache::setVertexFormat(const VertexFormat &format)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Format = format;
+    }
+
+    VertexFormat MeshCache::getVertexFormat() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Format;
+    }
+
+    void MeshCache::setDirectory(const std::string &directory)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Directory = directory;
+        if (!m_Directory.empty() && m_Directory.back() != '/' && m_Directory.back() != '\\')
+        {
+            m_Directory += '/';
+        }
+    }
+
+    std::string MeshCache::getDirectory() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Directory.empty() ? getPrefPath("meshcache/") : m_Directory;
+    }
+
+    std::string MeshCache::getCachePath(uint64_t sourceHash) const
+    {
+        return getDirectory() + fmt::format("{:016x}.mesh", sourceHash);
+    }
+
+    MeshCache::Stats MeshCache::getStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Stats;
+    }
+
+    bool MeshCache::load(const std::string &path, MeshFile &mesh, ThreadPool *pool)
+    {
+        AssetFile source;
+        if (!source.open(path))
+        {
+            LOG_ERROR("MeshCache: cannot open '{}'.", path);
+            return false;
+        }
+        return loadSource(path, source.data(), source.size(), mesh, pool);
+    }
+
+    bool MeshCache::loadFile(const std::string &path, MeshFile &mesh, ThreadPool *pool)
+    {
+        MappedFile source;
+        if (!source.open(path))
+        {
+            LOG_ERROR("MeshCache: cannot open '{}'.", path);
+            return false;
+        }
+        return loadSource(path, source.data(), source.size(), mesh, pool);
+    }
+
+    bool MeshCache::loadSource(const std::string &path, const uint8_t *data, size_t size, MeshFile &mesh, ThreadPool *pool)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const VertexFormat format = getVertexFormat();
+        uint64_t hash = round(hashBytes(data, size), format.getKey());
+        if (lowerExtension(path) == ".gltf")
+        {
+            // Opened like AssimpImporter opens them, so the key covers the bytes it will import.
+            const std::filesystem::path directory = std::filesystem::path(path).parent_path();
+            for (const std::string &uri : findGltfBufferUris(std::string_view(reinterpret_cast<const char *>(data), size)))
+            {
+                const std::string bufferPath = (directory / uri).generic_string();
+                AssetFile buffer;
+                if (buffer.open(bufferPath) || buffer.openNative(bufferPath))
+                {
+                    hash = round(hash, hashBytes(buffer.data(), buffer.size()));
+                }
+            }
+        }
+        const std::string cachePath = getCachePath(hash);
+
+        std::error_code error;
+        if (std::filesystem::exists(cachePath, error) && mesh.open(cachePath) && mesh.getSourceHash() == hash)
+        {
+            const double ms = millisecondsSince(start);
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            ++m_Stats.hits;
+            m_Stats.hitMs += ms;
+            LOG_DEBUG("MeshCache: '{}' from '{}' in {:.2f} ms.", path, cachePath, ms);
+            return true;
+        }
+
+        MeshData imported;
+        if (!import(path, data, size, pool, imported))
+        {
+            return false;
+        }
+
+        QuantizedMesh quantized;
+        MeshQuantizer::Report report;
+        MeshQuantizer::quantize(imported, format, quantized, &report);
+        if (format.getKey() != VertexFormat::uncompressed().getKey())
+        {
+            LOG_INFO("MeshCache: '{}' as {}: {} -> {} bytes per vertex, {} -> {} KB, {} -> {} KB read per draw.", path,
+                     format.getName(), report.sourceStride, report.stride, report.sourceBytes / 1024, report.bytes / 1024,
+                     report.sourceDrawBytes / 1024, report.drawBytes / 1024);
+        }
+
+        std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path(), error);
+        const bool written = MeshFile::write(cachePath, quantized.view(), hash) && mesh.open(cachePath);
+        if (!written)
+        {
+            std::vector<uint8_t> bytes;
+            MeshFile::serialize(quantized.view(), hash, bytes);
+            mesh.open(std::move(bytes));
+        }
+
+        const double ms = millisecondsSince(start);
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        ++m_Stats.misses;
+        m_Stats.missMs += ms;
+        m_Stats.writeFailures += written ? 0 : 1;
+        LOG_INFO("MeshCache: imported '{}' in {:.2f} ms{}.", path, ms, written ? fmt::format(", cached as '{}'", cachePath) : "");
+        return true;
+    }
+
+    bool MeshCache::import(const std::string &path, const uint8_t *data, size_t size, ThreadPool *pool, MeshData &mesh)
+    {
+        const std::string extension = lowerExtension(path);
+        bool imported = false;
+        if (extension == ".obj")
+        {
+            imported = ObjLoader::parse(reinterpret_cast<const char *>(data), size, path, mesh, pool);
+        }
+        else if (AssimpImporter::supports(extension))
+        {
+            imported = AssimpImporter::parse(data, size, path, mesh, pool);
+        }
+        else
+        {
+            LOG_ERROR("MeshCache: no importer for '{}'.", path);
+        }
+        if (!imported)
+        {
+            return false;
+        }
+
+        // Cache files are what gets drawn, so this is where meshes are optimized.
+        const MeshOptimizer::Report report = MeshOptimizer::optimize(mesh);
+        LOG_INFO("MeshCache: optimized '{}' in {:.2f} ms, ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}.", path,
+                 report.milliseconds, report.before.acmr, report.after.acmr, report.before.atvr, report.after.atvr);
+
+        auto start = std::chrono::steady_clock::now();
+        const size_t meshlets = MeshletBuilder::build(mesh);
+        LOG_INFO("MeshCache: {} meshlets for '{}' in {:.2f} ms.", meshlets, path, millisecondsSince(start));
+
+        start = std::chrono::steady_clock::now();
+        MeshSimplifier::generateLods(mesh);
+        std::string chain;
+        for (const MeshLod &lod : mesh.lods)
+        {
+            chain += fmt::format("{}{} ({:.4f})", chain.empty() ? "" : ", ", lod.indexCount / 3, lod.error);
+        }
+        LOG_INFO("MeshCache: LODs of '{}' in {:.2f} ms: {}.", path, millisecondsSince(start),
+                 chain.empty() ? "none" : chain);
+        return true;
+    }
+
+} // namespace Base
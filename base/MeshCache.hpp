@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "MeshFile.hpp"
+#include "MeshQuantizer.hpp"
+#include "ThreadPool.hpp"
+
+namespace Base
+{
+    // Content-addressed cache of imported meshes. load() hashes the source file, and if
+    // <directory>/<hash>.mesh exists it is mapped and returned as is; otherwise the source is
+    // imported (ObjLoader for .obj, AssimpImporter for the other model formats), run through
+    // MeshOptimizer, split into meshlets by MeshletBuilder, given a LOD chain by MeshSimplifier,
+    // stored in the vertex format set with setVertexFormat (uncompressed by default), written
+    // there for the next run and returned. Editing a model or switching formats changes the key,
+    // so stale entries are never read (they are simply left behind). The external buffers a .gltf
+    // refers to are hashed along with it.
+    //
+    // The directory defaults to "meshcache/" under the SDL pref path, which is writable on every
+    // platform. When writing fails the freshly imported mesh is still returned, from memory.
+    class MeshCache
+    {
+    public:
+        struct Stats
+        {
+            size_t hits = 0;
+            size_t misses = 0;
+            size_t writeFailures = 0;
+            double hitMs = 0.0;  // Total time of cache hits, hashing included
+            double missMs = 0.0; // Total time of imports
+        };
+
+        static MeshCache &Get();
+
+        MeshCache() = default;
+        MeshCache(const MeshCache &) = delete;
+        MeshCache &operator=(const MeshCache &) = delete;
+
+        // `path` is relative to the assets directory. Thread safe; `pool` is handed to the
+        // importer on a miss.
+        bool load(const std::string &path, MeshFile &mesh, ThreadPool *pool = nullptr);
+        // Same for a path outside the assets directory (tools).
+        bool loadFile(const std::string &fullPath, MeshFile &mesh, ThreadPool *pool = nullptr);
+
+        void setVertexFormat(const VertexFormat &format);
+        VertexFormat getVertexFormat() const;
+
+        void setDirectory(const std::string &directory);
+        std::string getDirectory() const;
+        std::string getCachePath(uint64_t sourceHash) const;
+
+        // 64-bit hash used as the cache key (XXH64 seeded with the file format and import versions).
+        static uint64_t hashBytes(const void *data, size_t size);
+
+        Stats getStats() const;
+
+    private:
+        bool loadSource(const std::string &path, const uint8_t *data, size_t size, MeshFile &mesh, ThreadPool *pool);
+        bool import(const std::string &path, const uint8_t *data, size_t size, ThreadPool *pool, MeshData &mesh);
+
+        mutable std::mutex m_Mutex;
+        std::string m_Directory;
+        VertexFormat m_Format = VertexFormat::uncompressed();
+        Stats m_Stats;
+    };
+
+} // namespace Base
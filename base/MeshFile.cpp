@@ -0,0 +1,377 @@
+#include "MeshFile.hpp"
+#include "Log.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace Base
+{
+    namespace
+    {
+        constexpr char kMagic[4] = {'C', 'G', 'M', 'H'};
+        constexpr size_t kBlobAlignment = 64;
+
+        struct FileHeader
+        {
+            char magic[4];
+            uint32_t version;
+            uint64_t sourceHash;
+            uint32_t vertexCount;
+            uint32_t vertexStride;
+            uint32_t indexCount;
+            uint32_t indexSize;
+            uint32_t attributeCount;
+            uint32_t subMeshCount;
+            uint32_t lodCount;
+            float boundsMin[3];
+            float boundsMax[3];
+            uint32_t meshletCount;
+            uint64_t attributeOffset;
+            uint64_t vertexOffset;
+            uint64_t indexOffset;
+            uint64_t subMeshOffset;
+            uint64_t lodOffset;
+            uint64_t meshletOffset;
+            uint64_t stringOffset;
+            uint64_t fileSize;
+        };
+
+        struct FileAttribute
+        {
+            uint32_t location;
+            uint32_t components;
+            uint32_t type;
+            uint32_t normalized;
+            uint32_t offset;
+        };
+
+        struct FileSubMesh
+        {
+            uint32_t firstIndex;
+            uint32_t indexCount;
+            uint32_t nameOffset;
+            uint32_t nameLength;
+            uint32_t materialOffset;
+            uint32_t materialLength;
+        };
+
+        struct FileLod
+        {
+            uint32_t firstIndex;
+            uint32_t indexCount;
+            float error;
+        };
+
+        struct FileMeshlet
+        {
+            uint32_t firstIndex;
+            uint32_t indexCount;
+            float center[3];
+            float radius;
+            float coneApex[3];
+            float coneAxis[3];
+            float coneCutoff;
+        };
+
+        size_t alignUp(size_t value, size_t alignment)
+        {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+
+        template <typename T>
+        void writeAt(std::vector<uint8_t> &out, size_t offset, const T &value)
+        {
+            std::memcpy(out.data() + offset, &value, sizeof(T));
+        }
+
+        template <typename T>
+        T readAt(const uint8_t *data, size_t offset)
+        {
+            T value;
+            std::memcpy(&value, data + offset, sizeof(T));
+            return value;
+        }
+
+        bool inBounds(uint64_t offset, uint64_t size, size_t fileSize)
+        {
+            return offset <= fileSize && size <= fileSize - offset;
+        }
+    } // namespace
+
+    void MeshFile::serialize(const MeshView &view, uint64_t sourceHash, std::vector<uint8_t> &out)
+    {
+        std::string strings;
+        std::vector<FileSubMesh> subMeshes;
+        for (const SubMesh &subMesh : view.subMeshes)
+        {
+            FileSubMesh entry = {subMesh.firstIndex, subMesh.indexCount, 0, 0, 0, 0};
+            entry.nameOffset = static_cast<uint32_t>(strings.size());
+            entry.nameLength = static_cast<uint32_t>(subMesh.name.size());
+            strings += subMesh.name;
+            entry.materialOffset = static_cast<uint32_t>(strings.size());
+            entry.materialLength = static_cast<uint32_t>(subMesh.material.size());
+            strings += subMesh.material;
+            subMeshes.push_back(entry);
+        }
+
+        const size_t vertexBytes = static_cast<size_t>(view.vertexCount) * view.layout.stride;
+        const size_t indexBytes = static_cast<size_t>(view.indexCount) * view.indexSize;
+
+        FileHeader header = {};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.sourceHash = sourceHash;
+        header.vertexCount = view.vertexCount;
+        header.vertexStride = view.layout.stride;
+        header.indexCount = view.indexCount;
+        header.indexSize = view.indexSize;
+        header.attributeCount = static_cast<uint32_t>(view.layout.attributes.size());
+        header.subMeshCount = static_cast<uint32_t>(subMeshes.size());
+        header.lodCount = static_cast<uint32_t>(view.lods.size());
+        header.meshletCount = static_cast<uint32_t>(view.meshlets.size());
+        for (int i = 0; i < 3; ++i)
+        {
+            header.boundsMin[i] = view.boundsMin[i];
+            header.boundsMax[i] = view.boundsMax[i];
+        }
+        header.attributeOffset = sizeof(FileHeader);
+        header.vertexOffset = alignUp(header.attributeOffset + header.attributeCount * sizeof(FileAttribute), kBlobAlignment);
+        header.indexOffset = alignUp(header.vertexOffset + vertexBytes, kBlobAlignment);
+        header.subMeshOffset = alignUp(header.indexOffset + indexBytes, 8);
+        header.lodOffset = header.subMeshOffset + subMeshes.size() * sizeof(FileSubMesh);
+        header.meshletOffset = header.lodOffset + view.lods.size() * sizeof(FileLod);
+        header.stringOffset = header.meshletOffset + view.meshlets.size() * sizeof(FileMeshlet);
+        header.fileSize = header.stringOffset + strings.size();
+
+        out.assign(header.fileSize, 0);
+        writeAt(out, 0, header);
+        for (size_t i = 0; i < view.layout.attributes.size(); ++i)
+        {
+            const VertexAttribute &attribute = view.layout.attributes[i];
+            const FileAttribute entry = {attribute.location, attribute.components, attribute.type,
+                                         attribute.normalized ? 1u : 0u, attribute.offset};
+            writeAt(out, header.attributeOffset + i * sizeof(FileAttribute), entry);
+        }
+        std::memcpy(out.data() + header.vertexOffset, view.vertices, vertexBytes);
+        std::memcpy(out.data() + header.indexOffset, view.indices, indexBytes);
+        for (size_t i = 0; i < subMeshes.size(); ++i)
+        {
+            writeAt(out, header.subMeshOffset + i * sizeof(FileSubMesh), subMeshes[i]);
+        }
+        for (size_t i = 0; i < view.lods.size(); ++i)
+        {
+            const MeshLod &lod = view.lods[i];
+            writeAt(out, header.lodOffset + i * sizeof(FileLod), FileLod{lod.firstIndex, lod.indexCount, lod.error});
+        }
+        for (size_t i = 0; i < view.meshlets.size(); ++i)
+        {
+            const Meshlet &meshlet = view.meshlets[i];
+            FileMeshlet entry = {meshlet.firstIndex, meshlet.indexCount, {}, meshlet.radius, {}, {}, meshlet.coneCutoff};
+            for (int c = 0; c < 3; ++c)
+            {
+                entry.center[c] = meshlet.center[c];
+                entry.coneApex[c] = meshlet.coneApex[c];
+                entry.coneAxis[c] = meshlet.coneAxis[c];
+            }
+            writeAt(out, header.meshletOffset + i * sizeof(FileMeshlet), entry);
+        }
+        std::memcpy(out.data() + header.stringOffset, strings.data(), strings.size());
+    }
+
+    bool MeshFile::write(const std::string &path, const MeshView &view, uint64_t sourceHash)
+    {
+        std::vector<uint8_t> bytes;
+        serialize(view, sourceHash, bytes);
+
+        const std::string temporary = path + ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            if (!file.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size())))
+            {
+                LOG_ERROR("MeshFile: cannot write '{}'.", temporary);
+                return false;
+            }
+        }
+        std::error_code error;
+        std::filesystem::rename(temporary, path, error);
+        if (error)
+        {
+            LOG_ERROR("MeshFile: cannot rename '{}' to '{}': {}", temporary, path, error.message());
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+        return true;
+    }
+
+    bool MeshFile::open(const std::string &path)
+    {
+        close();
+        if (!m_File.open(path))
+        {
+            return false;
+        }
+        m_Data = m_File.data();
+        m_Size = m_File.size();
+        return parse(path);
+    }
+
+    bool MeshFile::open(std::vector<uint8_t> bytes)
+    {
+        close();
+        m_Bytes = std::move(bytes);
+        m_Data = m_Bytes.data();
+        m_Size = m_Bytes.size();
+        return parse("<memory>");
+    }
+
+    void MeshFile::close()
+    {
+        m_File.close();
+        m_Bytes.clear();
+        m_Data = nullptr;
+        m_Size = 0;
+        m_SourceHash = 0;
+        m_View = MeshView();
+    }
+
+    bool MeshFile::parse(const std::string &name)
+    {
+        if (m_Size < sizeof(FileHeader) || std::memcmp(m_Data, kMagic, sizeof(kMagic)) != 0)
+        {
+            LOG_ERROR("MeshFile: '{}' is not a mesh file.", name);
+            close();
+            return false;
+        }
+        const FileHeader header = readAt<FileHeader>(m_Data, 0);
+        if (header.version != kVersion)
+        {
+            // Not an error: caches from older builds are simply rebuilt.
+            LOG_DEBUG("MeshFile: '{}' has version {}, expected {}.", name, header.version, kVersion);
+            close();
+            return false;
+        }
+        const bool valid = header.fileSize == m_Size && (header.indexSize == 2 || header.indexSize == 4) &&
+                           inBounds(header.attributeOffset, uint64_t(header.attributeCount) * sizeof(FileAttribute), m_Size) &&
+                           inBounds(header.vertexOffset, uint64_t(header.vertexCount) * header.vertexStride, m_Size) &&
+                           inBounds(header.indexOffset, uint64_t(header.indexCount) * header.indexSize, m_Size) &&
+                           inBounds(header.subMeshOffset, uint64_t(header.subMeshCount) * sizeof(FileSubMesh), m_Size) &&
+                           inBounds(header.lodOffset, uint64_t(header.lodCount) * sizeof(FileLod), m_Size) &&
+                           inBounds(header.meshletOffset, uint64_t(header.meshletCount) * sizeof(FileMeshlet), m_Size) &&
+                           header.stringOffset <= m_Size;
+        if (!valid)
+        {
+            LOG_ERROR("MeshFile: '{}' is truncated or corrupt.", name);
+            close();
+            return false;
+        }
+
+        m_SourceHash = header.sourceHash;
+        m_View.vertices = m_Data + header.vertexOffset;
+        m_View.vertexCount = header.vertexCount;
+        m_View.layout.stride = header.vertexStride;
+        for (uint32_t i = 0; i < header.attributeCount; ++i)
+        {
+            const FileAttribute entry = readAt<FileAttribute>(m_Data, header.attributeOffset + i * sizeof(FileAttribute));
+            m_View.layout.attributes.push_back({entry.location, entry.components, static_cast<GLenum>(entry.type),
+                                                entry.normalized != 0, entry.offset});
+        }
+        m_View.indices = m_Data + header.indexOffset;
+        m_View.indexCount = header.indexCount;
+        m_View.indexSize = header.indexSize;
+
+        const char *strings = reinterpret_cast<const char *>(m_Data + header.stringOffset);
+        const size_t stringBytes = m_Size - header.stringOffset;
+        for (uint32_t i = 0; i < header.subMeshCount; ++i)
+        {
+            const FileSubMesh entry = readAt<FileSubMesh>(m_Data, header.subMeshOffset + i * sizeof(FileSubMesh));
+            if (!inBounds(entry.nameOffset, entry.nameLength, stringBytes) ||
+                !inBounds(entry.materialOffset, entry.materialLength, stringBytes))
+            {
+                LOG_ERROR("MeshFile: '{}' has a corrupt submesh table.", name);
+                close();
+                return false;
+            }
+            SubMesh subMesh;
+            subMesh.name.assign(strings + entry.nameOffset, entry.nameLength);
+            subMesh.material.assign(strings + entry.materialOffset, entry.materialLength);
+            subMesh.firstIndex = entry.firstIndex;
+            subMesh.indexCount = entry.indexCount;
+            m_View.subMeshes.push_back(std::move(subMesh));
+        }
+        for (uint32_t i = 0; i < header.lodCount; ++i)
+        {
+            const FileLod entry = readAt<FileLod>(m_Data, header.lodOffset + i * sizeof(FileLod));
+            if (uint64_t(entry.firstIndex) + entry.indexCount > header.indexCount)
+            {
+                LOG_ERROR("MeshFile: '{}' has a corrupt LOD table.", name);
+                close();
+                return false;
+            }
+            m_View.lods.push_back({entry.firstIndex, entry.indexCount, entry.error});
+        }
+        for (uint32_t i = 0; i < header.meshletCount; ++i)
+        {
+            const FileMeshlet entry = readAt<FileMeshlet>(m_Data, header.meshletOffset + i * sizeof(FileMeshlet));
+            if (uint64_t(entry.firstIndex) + entry.indexCount > header.indexCount)
+            {
+                LOG_ERROR("MeshFile: '{}' has a corrupt meshlet table.", name);
+                close();
+                return false;
+            }
+            Meshlet meshlet;
+            meshlet.firstIndex = entry.firstIndex;
+            meshlet.indexCount = entry.indexCount;
+            meshlet.center = glm::vec3(entry.center[0], entry.center[1], entry.center[2]);
+            meshlet.radius = entry.radius;
+            meshlet.coneApex = glm::vec3(entry.coneApex[0], entry.coneApex[1], entry.coneApex[2]);
+            meshlet.coneAxis = glm::vec3(entry.coneAxis[0], entry.coneAxis[1], entry.coneAxis[2]);
+            meshlet.coneCutoff = entry.coneCutoff;
+            m_View.meshlets.push_back(meshlet);
+        }
+        m_View.boundsMin = glm::vec3(header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]);
+        m_View.boundsMax = glm::vec3(header.boundsMax[0], header.boundsMax[1], header.boundsMax[2]);
+        return true;
+    }
+
+    bool MeshFile::toMeshData(MeshData &mesh) const
+    {
+        const VertexLayout standard = VertexLayout::standard();
+        bool matches = isOpen() && m_View.layout.stride == standard.stride &&
+                       m_View.layout.attributes.size() == standard.attributes.size();
+        for (size_t i = 0; matches && i < standard.attributes.size(); ++i)
+        {
+            const VertexAttribute &a = m_View.layout.attributes[i];
+            const VertexAttribute &b = standard.attributes[i];
+            matches = a.location == b.location && a.components == b.components && a.type == b.type && a.offset == b.offset;
+        }
+        if (!matches)
+        {
+            return false;
+        }
+
+        mesh = MeshData();
+        mesh.vertices.resize(m_View.vertexCount);
+        std::memcpy(mesh.vertices.data(), m_View.vertices, mesh.vertices.size() * sizeof(MeshVertex));
+        mesh.indices.resize(m_View.indexCount);
+        if (m_View.indexSize == 4)
+        {
+            std::memcpy(mesh.indices.data(), m_View.indices, mesh.indices.size() * sizeof(uint32_t));
+        }
+        else
+        {
+            const auto *indices = static_cast<const uint8_t *>(m_View.indices);
+            for (size_t i = 0; i < mesh.indices.size(); ++i)
+            {
+                mesh.indices[i] = readAt<uint16_t>(indices, i * sizeof(uint16_t));
+            }
+        }
+        mesh.subMeshes = m_View.subMeshes;
+        mesh.lods = m_View.lods;
+        mesh.meshlets = m_View.meshlets;
+        mesh.boundsMin = m_View.boundsMin;
+        mesh.boundsMax = m_View.boundsMax;
+        return true;
+    }
+
+} // namespace Base
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MappedFile.hpp"
+#include "Mesh.hpp"
+
+namespace Base
+{
+    // Binary mesh container (.mesh), laid out so that a memory-mapped file can go straight to
+    // glBufferStorage/glBufferData without parsing:
+    //
+    //   Header                 magic "CGMH", version, source hash, counts, bounds, section offsets
+    //   VertexAttribute table  location, components, GL type, normalized, offset per attribute
+    //   Vertex blob            vertexCount * vertexStride bytes, 64-byte aligned
+    //   Index blob             indexCount * indexSize bytes (2 or 4), 64-byte aligned
+    //   SubMesh table          first index, index count and name/material string ranges
+    //   LOD table              first index, index count and error per level of detail
+    //   Meshlet table          index range, bounding sphere and normal cone per meshlet
+    //   String blob            submesh names and materials, not terminated
+    //
+    // Everything is little-endian, which all supported platforms are.
+    class MeshFile
+    {
+    public:
+        static constexpr uint32_t kVersion = 3;
+
+        MeshFile() = default;
+
+        // Serializes `view` (any vertex layout) into `out`.
+        static void serialize(const MeshView &view, uint64_t sourceHash, std::vector<uint8_t> &out);
+        // Writes to a temporary file first and renames it, so readers never see a partial file.
+        static bool write(const std::string &path, const MeshView &view, uint64_t sourceHash);
+
+        // Maps a .mesh file (full path) and checks its header.
+        bool open(const std::string &path);
+        // Same for bytes from serialize(); the MeshFile keeps them.
+        bool open(std::vector<uint8_t> bytes);
+        void close();
+
+        bool isOpen() const { return m_Data != nullptr; }
+        bool isMapped() const { return m_File.isMapped(); }
+        uint64_t getSourceHash() const { return m_SourceHash; }
+        size_t getByteSize() const { return m_Size; }
+
+        // Points into the file; valid while it stays open.
+        const MeshView &getView() const { return m_View; }
+        // Copy as a MeshData, for CPU-side processing. Only for the standard layout.
+        bool toMeshData(MeshData &mesh) const;
+
+    private:
+        bool parse(const std::string &name);
+
+        MappedFile m_File;
+        std::vector<uint8_t> m_Bytes;
+        const uint8_t *m_Data = nullptr;
+        size_t m_Size = 0;
+        uint64_t m_SourceHash = 0;
+        MeshView m_View;
+    };
+
+} // namespace Base
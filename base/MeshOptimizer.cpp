@@ -0,0 +1,387 @@
+#include "MeshOptimizer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
+namespace Base
+{
+    namespace
+    {
+        constexpr uint32_t kNone = UINT32_MAX;
+
+        // FIFO post-transform cache: a vertex hits while fewer than `size` misses happened since
+        // it was last loaded.
+        class FifoCache
+        {
+        public:
+            FifoCache(size_t vertexCount, uint32_t size) : m_Size(size), m_LoadedAt(vertexCount, 0) {}
+
+            // True on a miss.
+            bool access(uint32_t vertex)
+            {
+                if (m_LoadedAt[vertex] != 0 && m_Time - m_LoadedAt[vertex] < m_Size)
+                {
+                    return false;
+                }
+                m_LoadedAt[vertex] = ++m_Time;
+                return true;
+            }
+
+            void reset()
+            {
+                // Moving time forward empties the cache without touching every vertex.
+                m_Time += m_Size;
+            }
+
+        private:
+            uint32_t m_Size;
+            uint32_t m_Time = 0;
+            std::vector<uint32_t> m_LoadedAt;
+        };
+
+        uint32_t triangleMisses(FifoCache &cache, const uint32_t *triangle)
+        {
+            return uint32_t(cache.access(triangle[0])) + cache.access(triangle[1]) + cache.access(triangle[2]);
+        }
+
+        // Vertex -> triangles, as offsets into one flat array.
+        struct Adjacency
+        {
+            std::vector<uint32_t> offsets;
+            std::vector<uint32_t> triangles;
+
+            Adjacency(const uint32_t *indices, size_t indexCount, size_t vertexCount) : offsets(vertexCount + 1, 0)
+            {
+                for (size_t i = 0; i < indexCount; ++i)
+                {
+                    ++offsets[indices[i] + 1];
+                }
+                std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+                triangles.resize(indexCount);
+                std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+                for (size_t i = 0; i < indexCount; ++i)
+                {
+                    triangles[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+                }
+            }
+        };
+    } // namespace
+
+    MeshOptimizer::CacheStats MeshOptimizer::analyzeVertexCache(const uint32_t *indices, size_t indexCount,
+                                                                size_t vertexCount, uint32_t cacheSize)
+    {
+        CacheStats stats;
+        if (indexCount < 3 || vertexCount == 0)
+        {
+            return stats;
+        }
+        FifoCache cache(vertexCount, cacheSize);
+        std::vector<bool> used(vertexCount, false);
+        size_t transformed = 0;
+        size_t usedCount = 0;
+        for (size_t i = 0; i < indexCount; ++i)
+        {
+            transformed += cache.access(indices[i]);
+            if (!used[indices[i]])
+            {
+                used[indices[i]] = true;
+                ++usedCount;
+            }
+        }
+        stats.acmr = static_cast<float>(transformed) / static_cast<float>(indexCount / 3);
+        stats.atvr = static_cast<float>(transformed) / static_cast<float>(usedCount);
+        return stats;
+    }
+
+    void MeshOptimizer::optimizeVertexCache(uint32_t *indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize,
+                                            std::vector<uint32_t> *clusters)
+    {
+        const size_t triangleCount = indexCount / 3;
+        if (clusters)
+        {
+            clusters->clear();
+        }
+        if (triangleCount == 0)
+        {
+            return;
+        }
+
+        const Adjacency adjacency(indices, indexCount, vertexCount);
+        std::vector<uint32_t> liveTriangles(vertexCount);
+        for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+        {
+            liveTriangles[vertex] = adjacency.offsets[vertex + 1] - adjacency.offsets[vertex];
+        }
+        std::vector<uint32_t> cacheTime(vertexCount, 0);
+        std::vector<bool> emitted(triangleCount, false);
+        std::vector<uint32_t> deadEnds;
+        std::vector<uint32_t> candidates;
+        std::vector<uint32_t> output;
+        output.reserve(indexCount);
+
+        uint32_t time = cacheSize + 1;
+        uint32_t cursor = 0; // Next vertex to try when the dead-end stack runs dry
+        uint32_t fanning = indices[0];
+        while (fanning != kNone)
+        {
+            // Emit every remaining triangle around the fanning vertex.
+            candidates.clear();
+            for (uint32_t i = adjacency.offsets[fanning]; i < adjacency.offsets[fanning + 1]; ++i)
+            {
+                const uint32_t triangle = adjacency.triangles[i];
+                if (emitted[triangle])
+                {
+                    continue;
+                }
+                emitted[triangle] = true;
+                for (int corner = 0; corner < 3; ++corner)
+                {
+                    const uint32_t vertex = indices[triangle * 3 + corner];
+                    output.push_back(vertex);
+                    deadEnds.push_back(vertex);
+                    candidates.push_back(vertex);
+                    --liveTriangles[vertex];
+                    if (time - cacheTime[vertex] > cacheSize)
+                    {
+                        cacheTime[vertex] = time++;
+                    }
+                }
+            }
+
+            // Next fanning vertex: the candidate still in cache after its remaining triangles
+            // are emitted, that entered the cache earliest.
+            uint32_t next = kNone;
+            int bestPriority = -1;
+            for (uint32_t vertex : candidates)
+            {
+                if (liveTriangles[vertex] == 0)
+                {
+                    continue;
+                }
+                int priority = 0;
+                if (time - cacheTime[vertex] + 2 * liveTriangles[vertex] <= cacheSize)
+                {
+                    priority = static_cast<int>(time - cacheTime[vertex]);
+                }
+                if (priority > bestPriority)
+                {
+                    bestPriority = priority;
+                    next = vertex;
+                }
+            }
+
+            if (next == kNone)
+            {
+                // Dead end: recently used vertices first, then any vertex with triangles left.
+                while (!deadEnds.empty() && next == kNone)
+                {
+                    const uint32_t vertex = deadEnds.back();
+                    deadEnds.pop_back();
+                    if (liveTriangles[vertex] > 0)
+                    {
+                        next = vertex;
+                    }
+                }
+                while (next == kNone && cursor < vertexCount)
+                {
+                    if (liveTriangles[cursor] > 0)
+                    {
+                        next = cursor;
+                    }
+                    ++cursor;
+                }
+            }
+            fanning = next;
+        }
+
+        std::copy(output.begin(), output.end(), indices);
+
+        if (clusters)
+        {
+            // A triangle that misses on all three vertices starts over with a cold cache.
+            FifoCache cache(vertexCount, cacheSize);
+            for (size_t triangle = 0; triangle < triangleCount; ++triangle)
+            {
+                if (triangleMisses(cache, indices + triangle * 3) == 3 || triangle == 0)
+                {
+                    clusters->push_back(static_cast<uint32_t>(triangle));
+                }
+            }
+        }
+    }
+
+    void MeshOptimizer::optimizeOverdraw(uint32_t *indices, size_t indexCount, const MeshVertex *vertices,
+                                         size_t vertexCount, const std::vector<uint32_t> &clusters, uint32_t cacheSize,
+                                         float threshold)
+    {
+        const size_t triangleCount = indexCount / 3;
+        if (triangleCount == 0 || clusters.empty())
+        {
+            return;
+        }
+
+        // Split the cold-cache runs further wherever the part so far is already about as cache
+        // efficient as the whole run, so the clusters are small enough to sort usefully.
+        std::vector<uint32_t> starts;
+        FifoCache cache(vertexCount, cacheSize);
+        for (size_t c = 0; c < clusters.size(); ++c)
+        {
+            const uint32_t begin = clusters[c];
+            const uint32_t end = c + 1 < clusters.size() ? clusters[c + 1] : static_cast<uint32_t>(triangleCount);
+
+            cache.reset();
+            uint32_t runMisses = 0;
+            for (uint32_t triangle = begin; triangle < end; ++triangle)
+            {
+                runMisses += triangleMisses(cache, indices + triangle * 3);
+            }
+            const float runAcmr = static_cast<float>(runMisses) / static_cast<float>(end - begin);
+
+            cache.reset();
+            uint32_t start = begin;
+            uint32_t misses = 0;
+            starts.push_back(begin);
+            for (uint32_t triangle = begin; triangle < end; ++triangle)
+            {
+                misses += triangleMisses(cache, indices + triangle * 3);
+                const float acmr = static_cast<float>(misses) / static_cast<float>(triangle + 1 - start);
+                if (triangle + 1 < end && acmr <= runAcmr * threshold)
+                {
+                    start = triangle + 1;
+                    starts.push_back(start);
+                    misses = 0;
+                    cache.reset();
+                }
+            }
+            // A short tail that is not efficient on its own stays with the cluster before it.
+            if (start != begin && static_cast<float>(misses) / static_cast<float>(end - start) > runAcmr * threshold)
+            {
+                starts.pop_back();
+            }
+        }
+        if (starts.size() < 2)
+        {
+            return;
+        }
+
+        // Area-weighted centroids and normals.
+        struct Cluster
+        {
+            uint32_t begin;
+            uint32_t end;
+            float sortKey;
+        };
+        glm::vec3 meshCenter(0.0f);
+        float meshArea = 0.0f;
+        std::vector<Cluster> sorted;
+        std::vector<glm::vec3> centers;
+        std::vector<glm::vec3> normals;
+        for (size_t c = 0; c < starts.size(); ++c)
+        {
+            const uint32_t begin = starts[c];
+            const uint32_t end = c + 1 < starts.size() ? starts[c + 1] : static_cast<uint32_t>(triangleCount);
+            glm::vec3 center(0.0f);
+            glm::vec3 normal(0.0f);
+            float area = 0.0f;
+            for (uint32_t triangle = begin; triangle < end; ++triangle)
+            {
+                const glm::vec3 &a = vertices[indices[triangle * 3]].position;
+                const glm::vec3 &b = vertices[indices[triangle * 3 + 1]].position;
+                const glm::vec3 &c2 = vertices[indices[triangle * 3 + 2]].position;
+                const glm::vec3 cross = glm::cross(b - a, c2 - a);
+                const float triangleArea = glm::length(cross);
+                center += (a + b + c2) * (triangleArea / 3.0f);
+                normal += cross;
+                area += triangleArea;
+            }
+            meshCenter += center;
+            meshArea += area;
+            centers.push_back(area > 0.0f ? center / area : center);
+            const float length = glm::length(normal);
+            normals.push_back(length > 0.0f ? normal / length : normal);
+            sorted.push_back({begin, end, 0.0f});
+        }
+        meshCenter = meshArea > 0.0f ? meshCenter / meshArea : meshCenter;
+        for (size_t c = 0; c < sorted.size(); ++c)
+        {
+            sorted[c].sortKey = glm::dot(centers[c] - meshCenter, normals[c]);
+        }
+        std::stable_sort(sorted.begin(), sorted.end(), [](const Cluster &a, const Cluster &b) { return a.sortKey > b.sortKey; });
+
+        std::vector<uint32_t> reordered;
+        reordered.reserve(triangleCount * 3);
+        for (const Cluster &cluster : sorted)
+        {
+            reordered.insert(reordered.end(), indices + cluster.begin * 3, indices + cluster.end * 3);
+        }
+
+        const float before = analyzeVertexCache(indices, triangleCount * 3, vertexCount, cacheSize).acmr;
+        const float after = analyzeVertexCache(reordered.data(), reordered.size(), vertexCount, cacheSize).acmr;
+        if (after <= before * threshold)
+        {
+            std::copy(reordered.begin(), reordered.end(), indices);
+        }
+    }
+
+    void MeshOptimizer::optimizeVertexFetch(MeshData &mesh)
+    {
+        std::vector<uint32_t> remap(mesh.vertices.size(), kNone);
+        std::vector<MeshVertex> vertices;
+        vertices.reserve(mesh.vertices.size());
+        for (uint32_t &index : mesh.indices)
+        {
+            if (remap[index] == kNone)
+            {
+                remap[index] = static_cast<uint32_t>(vertices.size());
+                vertices.push_back(mesh.vertices[index]);
+            }
+            index = remap[index];
+        }
+        mesh.vertices = std::move(vertices);
+    }
+
+    MeshOptimizer::Report MeshOptimizer::optimize(MeshData &mesh)
+    {
+        return optimize(mesh, Options());
+    }
+
+    MeshOptimizer::Report MeshOptimizer::optimize(MeshData &mesh, const Options &options)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        Report report;
+        const size_t fullIndexCount = mesh.getTriangleCount() * 3;
+        report.before = analyzeVertexCache(mesh.indices.data(), fullIndexCount, mesh.vertices.size(), options.cacheSize);
+
+        // Without submeshes the full mesh is one range. LOD ranges are left as they are.
+        std::vector<SubMesh> ranges = mesh.subMeshes;
+        if (ranges.empty())
+        {
+            ranges.push_back({"", "", 0, static_cast<uint32_t>(fullIndexCount)});
+        }
+        std::vector<uint32_t> clusters;
+        for (const SubMesh &range : ranges)
+        {
+            uint32_t *indices = mesh.indices.data() + range.firstIndex;
+            if (options.vertexCache)
+            {
+                optimizeVertexCache(indices, range.indexCount, mesh.vertices.size(), options.cacheSize,
+                                    options.overdraw ? &clusters : nullptr);
+                if (options.overdraw)
+                {
+                    optimizeOverdraw(indices, range.indexCount, mesh.vertices.data(), mesh.vertices.size(), clusters,
+                                     options.cacheSize, options.overdrawThreshold);
+                }
+            }
+        }
+        if (options.vertexFetch)
+        {
+            optimizeVertexFetch(mesh);
+        }
+
+        report.after = analyzeVertexCache(mesh.indices.data(), fullIndexCount, mesh.vertices.size(), options.cacheSize);
+        report.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return report;
+    }
+
+} // namespace Base
@@ -0,0 +1,437 @@
+#include "MeshQuantizer.hpp"
+#include "HalfFloat.hpp"
+#include "MeshOptimizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fmt/format.h>
+
+namespace Base
+{
+    namespace
+    {
+        const char *positionName(VertexFormat::Position position)
+        {
+            switch (position)
+            {
+            case VertexFormat::Position::Half:
+                return "half16";
+            case VertexFormat::Position::Unorm16:
+                return "unorm16";
+            default:
+                return "float32";
+            }
+        }
+
+        const char *directionName(VertexFormat::Direction direction)
+        {
+            switch (direction)
+            {
+            case VertexFormat::Direction::Octahedral16:
+                return "oct16";
+            case VertexFormat::Direction::Octahedral8:
+                return "oct8";
+            default:
+                return "float32";
+            }
+        }
+
+        // Adds an attribute taking `size` bytes (padding included) at the end of the layout.
+        void addAttribute(VertexLayout &layout, uint32_t location, uint32_t components, GLenum type, bool normalized,
+                          uint32_t size)
+        {
+            layout.attributes.push_back({location, components, type, normalized, layout.stride});
+            layout.stride += size;
+        }
+
+        void addDirection(VertexLayout &layout, uint32_t location, VertexFormat::Direction direction, bool withSign)
+        {
+            // The sign rides along as a third (or fourth, for floats) component.
+            switch (direction)
+            {
+            case VertexFormat::Direction::Octahedral16:
+                addAttribute(layout, location, withSign ? 3 : 2, GL_SHORT, true, withSign ? 8 : 4);
+                break;
+            case VertexFormat::Direction::Octahedral8:
+                addAttribute(layout, location, withSign ? 3 : 2, GL_BYTE, true, 4);
+                break;
+            default:
+                addAttribute(layout, location, withSign ? 4 : 3, GL_FLOAT, false, withSign ? 16 : 12);
+                break;
+            }
+        }
+
+        VertexLayout makeLayout(const VertexFormat &format)
+        {
+            VertexLayout layout;
+            switch (format.position)
+            {
+            case VertexFormat::Position::Half:
+                addAttribute(layout, 0, 3, GL_HALF_FLOAT, false, 8);
+                break;
+            case VertexFormat::Position::Unorm16:
+                addAttribute(layout, 0, 3, GL_UNSIGNED_SHORT, true, 8);
+                break;
+            default:
+                addAttribute(layout, 0, 3, GL_FLOAT, false, 12);
+                break;
+            }
+            addDirection(layout, 1, format.normal, false);
+            if (format.texCoord == VertexFormat::TexCoord::Half)
+            {
+                addAttribute(layout, 2, 2, GL_HALF_FLOAT, false, 4);
+            }
+            else
+            {
+                addAttribute(layout, 2, 2, GL_FLOAT, false, 8);
+            }
+            if (format.tangents)
+            {
+                addDirection(layout, 3, format.tangent, true);
+            }
+            return layout;
+        }
+
+        const VertexAttribute *findAttribute(const VertexLayout &layout, uint32_t location)
+        {
+            for (const VertexAttribute &attribute : layout.attributes)
+            {
+                if (attribute.location == location)
+                {
+                    return &attribute;
+                }
+            }
+            return nullptr;
+        }
+
+        template <typename T>
+        void store(uint8_t *destination, const T &value)
+        {
+            std::memcpy(destination, &value, sizeof(T));
+        }
+
+        // Signed normalized value as GL 4.2+/GLES 3 read it back: max(c / maxValue, -1).
+        float decodeSnorm(int value, int maxValue)
+        {
+            return std::max(static_cast<float>(value) / static_cast<float>(maxValue), -1.0f);
+        }
+
+        // Octahedral encoding at `maxValue` (127 or 32767) precision. Of the four roundings around
+        // the exact result, the one decoding closest to the input is kept.
+        glm::ivec2 quantizeOctahedral(const glm::vec3 &direction, int maxValue)
+        {
+            const glm::vec2 exact = MeshQuantizer::encodeOctahedral(direction) * static_cast<float>(maxValue);
+            glm::ivec2 best(0);
+            float bestDot = -2.0f;
+            for (int corner = 0; corner < 4; ++corner)
+            {
+                const glm::ivec2 candidate(static_cast<int>((corner & 1) ? std::ceil(exact.x) : std::floor(exact.x)),
+                                           static_cast<int>((corner & 2) ? std::ceil(exact.y) : std::floor(exact.y)));
+                const glm::vec3 decoded = MeshQuantizer::decodeOctahedral(
+                    glm::vec2(decodeSnorm(candidate.x, maxValue), decodeSnorm(candidate.y, maxValue)));
+                const float dot = glm::dot(decoded, direction);
+                if (dot > bestDot)
+                {
+                    bestDot = dot;
+                    best = candidate;
+                }
+            }
+            return best;
+        }
+
+        // Writes a unit vector (and the sign, for tangents); returns what the shader will decode.
+        glm::vec3 writeDirection(uint8_t *destination, VertexFormat::Direction direction, const glm::vec3 &value,
+                                 bool withSign, float sign)
+        {
+            switch (direction)
+            {
+            case VertexFormat::Direction::Octahedral16:
+            {
+                const glm::ivec2 encoded = quantizeOctahedral(value, 32767);
+                store(destination, static_cast<int16_t>(encoded.x));
+                store(destination + 2, static_cast<int16_t>(encoded.y));
+                if (withSign)
+                {
+                    store(destination + 4, static_cast<int16_t>(sign < 0.0f ? -32767 : 32767));
+                }
+                return MeshQuantizer::decodeOctahedral(glm::vec2(decodeSnorm(encoded.x, 32767), decodeSnorm(encoded.y, 32767)));
+            }
+            case VertexFormat::Direction::Octahedral8:
+            {
+                const glm::ivec2 encoded = quantizeOctahedral(value, 127);
+                destination[0] = static_cast<uint8_t>(static_cast<int8_t>(encoded.x));
+                destination[1] = static_cast<uint8_t>(static_cast<int8_t>(encoded.y));
+                if (withSign)
+                {
+                    destination[2] = static_cast<uint8_t>(static_cast<int8_t>(sign < 0.0f ? -127 : 127));
+                }
+                return MeshQuantizer::decodeOctahedral(glm::vec2(decodeSnorm(encoded.x, 127), decodeSnorm(encoded.y, 127)));
+            }
+            default:
+                store(destination, value);
+                if (withSign)
+                {
+                    store(destination + 12, sign);
+                }
+                return value;
+            }
+        }
+
+        float angleDegrees(const glm::vec3 &a, const glm::vec3 &b)
+        {
+            return glm::degrees(std::acos(std::clamp(glm::dot(a, b), -1.0f, 1.0f)));
+        }
+    } // namespace
+
+    VertexFormat VertexFormat::uncompressed()
+    {
+        VertexFormat format;
+        format.position = Position::Float;
+        format.normal = Direction::Float;
+        format.texCoord = TexCoord::Float;
+        format.tangents = false;
+        format.shortIndices = false;
+        return format;
+    }
+
+    uint32_t VertexFormat::getKey() const
+    {
+        return static_cast<uint32_t>(position) | static_cast<uint32_t>(normal) << 4 | static_cast<uint32_t>(texCoord) << 8 |
+               (tangents ? 1u + static_cast<uint32_t>(tangent) : 0u) << 12 | (shortIndices ? 1u : 0u) << 16;
+    }
+
+    std::string VertexFormat::getName() const
+    {
+        std::string name = fmt::format("{}/{}/{}", positionName(position), directionName(normal),
+                                       texCoord == TexCoord::Half ? "half16" : "float32");
+        if (tangents)
+        {
+            name += fmt::format("/{}", directionName(tangent));
+        }
+        return name;
+    }
+
+    MeshView QuantizedMesh::view() const
+    {
+        MeshView view;
+        view.vertices = vertices.data();
+        view.vertexCount = vertexCount;
+        view.layout = layout;
+        view.indices = indices.data();
+        view.indexCount = indexCount;
+        view.indexSize = indexSize;
+        view.subMeshes = subMeshes;
+        view.lods = lods;
+        view.meshlets = meshlets;
+        view.boundsMin = boundsMin;
+        view.boundsMax = boundsMax;
+        return view;
+    }
+
+    glm::vec2 MeshQuantizer::encodeOctahedral(const glm::vec3 &direction)
+    {
+        const float sum = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+        if (sum == 0.0f)
+        {
+            return glm::vec2(0.0f);
+        }
+        glm::vec2 p = glm::vec2(direction.x, direction.y) / sum;
+        if (direction.z < 0.0f)
+        {
+            // Fold the lower hemisphere over the diagonals.
+            p = glm::vec2((1.0f - std::abs(p.y)) * (p.x >= 0.0f ? 1.0f : -1.0f),
+                          (1.0f - std::abs(p.x)) * (p.y >= 0.0f ? 1.0f : -1.0f));
+        }
+        return p;
+    }
+
+    glm::vec3 MeshQuantizer::decodeOctahedral(const glm::vec2 &encoded)
+    {
+        // Same as octDecode in mesh.vert.
+        glm::vec3 direction(encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y));
+        const float t = std::max(-direction.z, 0.0f);
+        direction.x += direction.x >= 0.0f ? -t : t;
+        direction.y += direction.y >= 0.0f ? -t : t;
+        return glm::normalize(direction);
+    }
+
+    void MeshQuantizer::computeTangents(const MeshData &mesh, std::vector<glm::vec4> &tangents)
+    {
+        std::vector<glm::vec3> tangentSums(mesh.vertices.size(), glm::vec3(0.0f));
+        std::vector<glm::vec3> bitangentSums(mesh.vertices.size(), glm::vec3(0.0f));
+        for (size_t i = 0; i < mesh.getTriangleCount() * 3; i += 3)
+        {
+            const uint32_t i0 = mesh.indices[i], i1 = mesh.indices[i + 1], i2 = mesh.indices[i + 2];
+            const MeshVertex &v0 = mesh.vertices[i0];
+            const glm::vec3 e1 = mesh.vertices[i1].position - v0.position;
+            const glm::vec3 e2 = mesh.vertices[i2].position - v0.position;
+            const glm::vec2 d1 = mesh.vertices[i1].texCoord - v0.texCoord;
+            const glm::vec2 d2 = mesh.vertices[i2].texCoord - v0.texCoord;
+            const float determinant = d1.x * d2.y - d2.x * d1.y;
+            if (std::abs(determinant) < 1e-12f)
+            {
+                continue;
+            }
+            // Not divided by the determinant's magnitude, so larger triangles weigh more.
+            const float sign = determinant > 0.0f ? 1.0f : -1.0f;
+            const glm::vec3 tangent = (e1 * d2.y - e2 * d1.y) * sign;
+            const glm::vec3 bitangent = (e2 * d1.x - e1 * d2.x) * sign;
+            for (uint32_t index : {i0, i1, i2})
+            {
+                tangentSums[index] += tangent;
+                bitangentSums[index] += bitangent;
+            }
+        }
+
+        tangents.resize(mesh.vertices.size());
+        for (size_t i = 0; i < mesh.vertices.size(); ++i)
+        {
+            const glm::vec3 &normal = mesh.vertices[i].normal;
+            glm::vec3 tangent = tangentSums[i] - normal * glm::dot(normal, tangentSums[i]);
+            if (glm::dot(tangent, tangent) < 1e-20f)
+            {
+                // No usable texture coordinates: any vector orthogonal to the normal.
+                tangent = glm::cross(normal, std::abs(normal.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f));
+            }
+            tangent = glm::normalize(tangent);
+            const float handedness = glm::dot(glm::cross(normal, tangent), bitangentSums[i]) < 0.0f ? -1.0f : 1.0f;
+            tangents[i] = glm::vec4(tangent, handedness);
+        }
+    }
+
+    void MeshQuantizer::quantize(const MeshData &mesh, const VertexFormat &format, QuantizedMesh &out, Report *report)
+    {
+        out = QuantizedMesh();
+        out.format = format;
+        out.layout = makeLayout(format);
+        out.vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+        out.indexCount = static_cast<uint32_t>(mesh.indices.size());
+        out.subMeshes = mesh.subMeshes;
+        out.lods = mesh.lods;
+        out.meshlets = mesh.meshlets;
+        out.boundsMin = mesh.boundsMin;
+        out.boundsMax = mesh.boundsMax;
+
+        std::vector<glm::vec4> tangents;
+        if (format.tangents)
+        {
+            computeTangents(mesh, tangents);
+        }
+
+        const glm::vec3 extent = mesh.boundsMax - mesh.boundsMin;
+        const uint32_t stride = out.layout.stride;
+        const uint32_t normalOffset = findAttribute(out.layout, 1)->offset;
+        const uint32_t texCoordOffset = findAttribute(out.layout, 2)->offset;
+        float maxPositionError = 0.0f;
+        float maxNormalError = 0.0f;
+        out.vertices.assign(static_cast<size_t>(out.vertexCount) * stride, 0);
+        for (size_t i = 0; i < mesh.vertices.size(); ++i)
+        {
+            const MeshVertex &vertex = mesh.vertices[i];
+            uint8_t *destination = out.vertices.data() + i * stride;
+
+            glm::vec3 position = vertex.position;
+            switch (format.position)
+            {
+            case VertexFormat::Position::Half:
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    const uint16_t half = floatToHalf(vertex.position[axis]);
+                    store(destination + axis * 2, half);
+                    position[axis] = halfToFloat(half);
+                }
+                break;
+            case VertexFormat::Position::Unorm16:
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    const float unit = extent[axis] > 0.0f ? (vertex.position[axis] - mesh.boundsMin[axis]) / extent[axis] : 0.0f;
+                    const auto value = static_cast<uint16_t>(std::lround(std::clamp(unit, 0.0f, 1.0f) * 65535.0f));
+                    store(destination + axis * 2, value);
+                    position[axis] = mesh.boundsMin[axis] + static_cast<float>(value) / 65535.0f * extent[axis];
+                }
+                break;
+            default:
+                store(destination, vertex.position);
+                break;
+            }
+            maxPositionError = std::max(maxPositionError, glm::length(position - vertex.position));
+
+            const glm::vec3 normal = writeDirection(destination + normalOffset, format.normal, vertex.normal, false, 1.0f);
+            maxNormalError = std::max(maxNormalError, angleDegrees(normal, vertex.normal));
+
+            if (format.texCoord == VertexFormat::TexCoord::Half)
+            {
+                store(destination + texCoordOffset, floatToHalf(vertex.texCoord.x));
+                store(destination + texCoordOffset + 2, floatToHalf(vertex.texCoord.y));
+            }
+            else
+            {
+                store(destination + texCoordOffset, vertex.texCoord);
+            }
+
+            if (format.tangents)
+            {
+                writeDirection(destination + findAttribute(out.layout, 3)->offset, format.tangent, glm::vec3(tangents[i]),
+                               true, tangents[i].w);
+            }
+        }
+
+        // 0xFFFF stays free so that primitive restart can never trigger.
+        out.indexSize = format.shortIndices && out.vertexCount < 0xFFFF ? 2 : 4;
+        out.indices.resize(static_cast<size_t>(out.indexCount) * out.indexSize);
+        if (out.indexSize == 2)
+        {
+            for (size_t i = 0; i < mesh.indices.size(); ++i)
+            {
+                store(out.indices.data() + i * 2, static_cast<uint16_t>(mesh.indices[i]));
+            }
+        }
+        else
+        {
+            std::memcpy(out.indices.data(), mesh.indices.data(), out.indices.size());
+        }
+
+        if (report)
+        {
+            // A draw of the full mesh.
+            const size_t drawIndices = mesh.getTriangleCount() * 3;
+            const MeshOptimizer::CacheStats cache =
+                MeshOptimizer::analyzeVertexCache(mesh.indices.data(), drawIndices, mesh.vertices.size());
+            const auto transformed = static_cast<size_t>(cache.acmr * static_cast<float>(mesh.getTriangleCount()) + 0.5f);
+            report->sourceBytes = mesh.getByteSize();
+            report->bytes = out.getByteSize();
+            report->sourceStride = sizeof(MeshVertex);
+            report->stride = stride;
+            report->indexSize = out.indexSize;
+            report->sourceDrawBytes = drawIndices * sizeof(uint32_t) + transformed * sizeof(MeshVertex);
+            report->drawBytes = drawIndices * out.indexSize + transformed * stride;
+            report->maxPositionError = maxPositionError;
+            report->maxNormalError = maxNormalError;
+        }
+    }
+
+    void MeshQuantizer::getPositionDecode(const MeshView &view, glm::vec3 &scale, glm::vec3 &offset)
+    {
+        const VertexAttribute *position = findAttribute(view.layout, 0);
+        if (position && position->type == GL_UNSIGNED_SHORT && position->normalized)
+        {
+            scale = view.boundsMax - view.boundsMin;
+            offset = view.boundsMin;
+        }
+        else
+        {
+            scale = glm::vec3(1.0f);
+            offset = glm::vec3(0.0f);
+        }
+    }
+
+    std::vector<ShaderSpecialization> MeshQuantizer::getShaderSpecializations(const VertexLayout &layout)
+    {
+        const VertexAttribute *normal = findAttribute(layout, 1);
+        const VertexAttribute *tangent = findAttribute(layout, 3);
+        return {{"NORMAL_ENCODING", normal && normal->type != GL_FLOAT ? 1u : 0u},
+                {"TANGENT_ENCODING", tangent && tangent->type != GL_FLOAT ? 1u : 0u}};
+    }
+
+} // namespace Base
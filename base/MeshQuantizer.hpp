@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Mesh.hpp"
+#include "Shader.hpp"
+
+namespace Base
+{
+    // Storage format of each vertex attribute, decoded by assets/shaders/mesh.vert:
+    //
+    //  - Position: Float (12 bytes), Half (8) or Unorm16 (8): 16-bit fractions of the mesh bounds,
+    //    decoded as offset + value * scale (see MeshQuantizer::getPositionDecode). Unsigned
+    //    normalization is used because GL 4.1 and 4.2+ convert signed normalized values
+    //    differently, while unsigned ones are converted the same everywhere.
+    //  - Normal: Float (12 bytes) or octahedral (Cigolle et al., "A Survey of Efficient
+    //    Representations for Independent Unit Vectors", 2014) in two snorm16 (4 bytes) or two
+    //    snorm8 (2 bytes, padded to 4). Tangents use the same encoding plus a handedness sign.
+    //  - TexCoord: Float (8 bytes) or Half (4).
+    //
+    // Every attribute starts on a 4-byte boundary.
+    struct VertexFormat
+    {
+        enum class Position : uint8_t
+        {
+            Float,
+            Half,
+            Unorm16
+        };
+
+        enum class Direction : uint8_t
+        {
+            Float,
+            Octahedral16,
+            Octahedral8
+        };
+
+        enum class TexCoord : uint8_t
+        {
+            Float,
+            Half
+        };
+
+        Position position = Position::Unorm16;
+        Direction normal = Direction::Octahedral16;
+        TexCoord texCoord = TexCoord::Half;
+        bool tangents = false;         // Generated from the texture coordinates, at location 3
+        Direction tangent = Direction::Octahedral16;
+        bool shortIndices = true;      // 16-bit indices whenever every vertex can be addressed
+
+        // The MeshVertex layout with 32-bit indices: quantizing with it changes nothing.
+        static VertexFormat uncompressed();
+
+        // Distinct for every format, for cache keys.
+        uint32_t getKey() const;
+        // e.g. "unorm16/oct16/half16".
+        std::string getName() const;
+    };
+
+    // Vertex and index bytes in a VertexFormat, ready for Mesh::upload or MeshFile::write.
+    struct QuantizedMesh
+    {
+        VertexFormat format;
+        VertexLayout layout;
+        std::vector<uint8_t> vertices;
+        std::vector<uint8_t> indices;
+        uint32_t vertexCount = 0;
+        uint32_t indexCount = 0;
+        uint32_t indexSize = 4;
+        std::vector<SubMesh> subMeshes;
+        std::vector<MeshLod> lods;
+        std::vector<Meshlet> meshlets;
+        glm::vec3 boundsMin = glm::vec3(0.0f);
+        glm::vec3 boundsMax = glm::vec3(0.0f);
+
+        size_t getByteSize() const { return vertices.size() + indices.size(); }
+        MeshView view() const;
+    };
+
+    class MeshQuantizer
+    {
+    public:
+        struct Report
+        {
+            size_t sourceBytes = 0; // MeshData as is: 32-byte vertices, 32-bit indices
+            size_t bytes = 0;
+            uint32_t sourceStride = sizeof(MeshVertex);
+            uint32_t stride = 0;
+            uint32_t indexSize = 4;
+            // Bytes a full draw reads (indices plus one vertex fetch per post-transform cache
+            // miss, see MeshOptimizer), before and after.
+            size_t sourceDrawBytes = 0;
+            size_t drawBytes = 0;
+            float maxPositionError = 0.0f; // In model units
+            float maxNormalError = 0.0f;   // In degrees
+        };
+
+        static void quantize(const MeshData &mesh, const VertexFormat &format, QuantizedMesh &out, Report *report = nullptr);
+
+        // Uniforms for mesh.vert: position = u_PositionOffset + attribute * u_PositionScale.
+        static void getPositionDecode(const MeshView &view, glm::vec3 &scale, glm::vec3 &offset);
+        // Specializations for mesh.vert matching the layout (NORMAL_ENCODING, TANGENT_ENCODING).
+        static std::vector<ShaderSpecialization> getShaderSpecializations(const VertexLayout &layout);
+
+        // Unit vector to/from the [-1, 1]^2 octahedral square.
+        static glm::vec2 encodeOctahedral(const glm::vec3 &direction);
+        static glm::vec3 decodeOctahedral(const glm::vec2 &encoded);
+
+        // Per-vertex tangents (xyz) with the bitangent handedness in w, orthogonal to the normals.
+        static void computeTangents(const MeshData &mesh, std::vector<glm::vec4> &tangents);
+    };
+
+} // namespace Base
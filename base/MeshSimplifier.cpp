@@ -0,0 +1,442 @@
+#include "MeshSimplifier.hpp"
+#include "MeshOptimizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <numeric>
+#include <unordered_set>
+
+namespace Base
+{
+    namespace
+    {
+        constexpr uint32_t kNone = UINT32_MAX;
+
+        // Symmetric 4x4 quadric (A, b, c) of a sum of area-weighted squared plane distances.
+        struct Quadric
+        {
+            double a00 = 0, a01 = 0, a02 = 0, a11 = 0, a12 = 0, a22 = 0;
+            double b0 = 0, b1 = 0, b2 = 0;
+            double c = 0;
+            double weight = 0;
+
+            void addPlane(double nx, double ny, double nz, double d, double w)
+            {
+                a00 += w * nx * nx;
+                a01 += w * nx * ny;
+                a02 += w * nx * nz;
+                a11 += w * ny * ny;
+                a12 += w * ny * nz;
+                a22 += w * nz * nz;
+                b0 += w * nx * d;
+                b1 += w * ny * d;
+                b2 += w * nz * d;
+                c += w * d * d;
+                weight += w;
+            }
+
+            Quadric &operator+=(const Quadric &o)
+            {
+                a00 += o.a00;
+                a01 += o.a01;
+                a02 += o.a02;
+                a11 += o.a11;
+                a12 += o.a12;
+                a22 += o.a22;
+                b0 += o.b0;
+                b1 += o.b1;
+                b2 += o.b2;
+                c += o.c;
+                weight += o.weight;
+                return *this;
+            }
+
+            double evaluate(const glm::vec3 &p) const
+            {
+                const double x = p.x, y = p.y, z = p.z;
+                return a00 * x * x + a11 * y * y + a22 * z * z + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+                       2.0 * (b0 * x + b1 * y + b2 * z) + c;
+            }
+        };
+
+        struct Collapse
+        {
+            uint32_t from;
+            uint32_t to;
+            double cost; // Mean squared distance
+        };
+
+        uint64_t edgeKey(uint32_t a, uint32_t b)
+        {
+            return (static_cast<uint64_t>(a) << 32) | b;
+        }
+
+        glm::vec3 triangleNormal(const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c)
+        {
+            return glm::cross(b - a, c - a);
+        }
+
+        float boundsDiagonal(const MeshVertex *vertices, const uint32_t *indices, size_t indexCount)
+        {
+            if (indexCount == 0)
+            {
+                return 0.0f;
+            }
+            glm::vec3 low = vertices[indices[0]].position;
+            glm::vec3 high = low;
+            for (size_t i = 1; i < indexCount; ++i)
+            {
+                low = glm::min(low, vertices[indices[i]].position);
+                high = glm::max(high, vertices[indices[i]].position);
+            }
+            return glm::length(high - low);
+        }
+
+        // Collapse state of one index list. reduce() can be called with decreasing targets to
+        // get successive LODs, all measured against the original surface.
+        class Collapser
+        {
+        public:
+            Collapser(const MeshVertex *vertices, size_t vertexCount, const uint32_t *indices, size_t indexCount)
+                : m_Vertices(vertices), m_Group(vertexCount, kNone), m_Locked(vertexCount, false), m_Quadrics(vertexCount),
+                  m_Offsets(vertexCount + 1), m_CollapseTo(vertexCount), m_Touched(vertexCount)
+            {
+                m_Indices.assign(indices, indices + indexCount - indexCount % 3);
+                m_Diagonal = boundsDiagonal(vertices, indices, indexCount);
+                if (m_Diagonal > 0.0f)
+                {
+                    classifyVertices();
+                    computeQuadrics();
+                }
+            }
+
+            const std::vector<uint32_t> &getIndices() const { return m_Indices; }
+            float getDiagonal() const { return m_Diagonal; }
+            // Largest error so far, relative to the diagonal.
+            float getError() const { return static_cast<float>(std::sqrt(m_Reached) / m_Diagonal); }
+
+            void reduce(size_t targetIndexCount, float maxError);
+
+        private:
+            void classifyVertices();
+            void computeQuadrics();
+            bool pass(size_t targetIndexCount, double limit);
+
+            const MeshVertex *m_Vertices;
+            std::vector<uint32_t> m_Indices;
+            std::vector<uint32_t> m_Group; // First vertex at the same position
+            std::vector<bool> m_Locked;    // By group
+            std::vector<Quadric> m_Quadrics; // By group
+            float m_Diagonal = 0.0f;
+            double m_Reached = 0.0;
+
+            // Scratch space of pass().
+            std::vector<uint32_t> m_Offsets;
+            std::vector<uint32_t> m_Triangles;
+            std::vector<Collapse> m_Collapses;
+            std::vector<uint32_t> m_CollapseTo;
+            std::vector<bool> m_Touched;
+            std::vector<uint32_t> m_Next;
+        };
+
+        void Collapser::classifyVertices()
+        {
+            const MeshVertex *vertices = m_Vertices;
+            // Vertices sharing a position form one group; a group of several is a seam.
+            std::vector<uint32_t> referenced;
+            {
+                std::vector<bool> seen(m_Group.size(), false);
+                for (uint32_t index : m_Indices)
+                {
+                    if (!seen[index])
+                    {
+                        seen[index] = true;
+                        referenced.push_back(index);
+                    }
+                }
+            }
+            std::sort(referenced.begin(), referenced.end(), [&](uint32_t a, uint32_t b)
+                      {
+                          const glm::vec3 &p = vertices[a].position;
+                          const glm::vec3 &q = vertices[b].position;
+                          return p.x != q.x ? p.x < q.x : p.y != q.y ? p.y < q.y : p.z < q.z;
+                      });
+            for (size_t begin = 0; begin < referenced.size();)
+            {
+                size_t end = begin + 1;
+                const glm::vec3 &p = vertices[referenced[begin]].position;
+                while (end < referenced.size() && vertices[referenced[end]].position.x == p.x &&
+                       vertices[referenced[end]].position.y == p.y && vertices[referenced[end]].position.z == p.z)
+                {
+                    ++end;
+                }
+                for (size_t i = begin; i < end; ++i)
+                {
+                    m_Group[referenced[i]] = referenced[begin];
+                }
+                m_Locked[referenced[begin]] = end - begin > 1;
+                begin = end;
+            }
+
+            // Open borders: group edges without a twin in the opposite direction.
+            std::unordered_set<uint64_t> edges;
+            edges.reserve(m_Indices.size());
+            for (size_t i = 0; i < m_Indices.size(); i += 3)
+            {
+                for (int e = 0; e < 3; ++e)
+                {
+                    edges.insert(edgeKey(m_Group[m_Indices[i + e]], m_Group[m_Indices[i + (e + 1) % 3]]));
+                }
+            }
+            for (size_t i = 0; i < m_Indices.size(); i += 3)
+            {
+                for (int e = 0; e < 3; ++e)
+                {
+                    const uint32_t a = m_Group[m_Indices[i + e]];
+                    const uint32_t b = m_Group[m_Indices[i + (e + 1) % 3]];
+                    if (edges.count(edgeKey(b, a)) == 0)
+                    {
+                        m_Locked[a] = true;
+                        m_Locked[b] = true;
+                    }
+                }
+            }
+        }
+
+        void Collapser::computeQuadrics()
+        {
+            for (size_t i = 0; i < m_Indices.size(); i += 3)
+            {
+                const glm::vec3 &p0 = m_Vertices[m_Indices[i]].position;
+                const glm::vec3 normal = triangleNormal(p0, m_Vertices[m_Indices[i + 1]].position, m_Vertices[m_Indices[i + 2]].position);
+                const double length = std::sqrt(double(normal.x) * normal.x + double(normal.y) * normal.y + double(normal.z) * normal.z);
+                if (length == 0.0)
+                {
+                    continue;
+                }
+                const double nx = normal.x / length, ny = normal.y / length, nz = normal.z / length;
+                const double d = -(nx * p0.x + ny * p0.y + nz * p0.z);
+                for (int corner = 0; corner < 3; ++corner)
+                {
+                    m_Quadrics[m_Group[m_Indices[i + corner]]].addPlane(nx, ny, nz, d, length * 0.5);
+                }
+            }
+        }
+
+        void Collapser::reduce(size_t targetIndexCount, float maxError)
+        {
+            if (m_Diagonal <= 0.0f)
+            {
+                return;
+            }
+            const double limit = double(maxError) * m_Diagonal * double(maxError) * m_Diagonal;
+            while (m_Indices.size() > targetIndexCount && pass(targetIndexCount, limit))
+            {
+            }
+        }
+
+        // Does the cheapest collapses that don't touch each other's neighbourhoods; false when
+        // nothing could be collapsed.
+        bool Collapser::pass(size_t targetIndexCount, double limit)
+        {
+            std::fill(m_Offsets.begin(), m_Offsets.end(), 0);
+            for (uint32_t index : m_Indices)
+            {
+                ++m_Offsets[index + 1];
+            }
+            std::partial_sum(m_Offsets.begin(), m_Offsets.end(), m_Offsets.begin());
+            m_Triangles.resize(m_Indices.size());
+            {
+                std::vector<uint32_t> cursor(m_Offsets.begin(), m_Offsets.end() - 1);
+                for (size_t i = 0; i < m_Indices.size(); ++i)
+                {
+                    m_Triangles[cursor[m_Indices[i]]++] = static_cast<uint32_t>(i / 3);
+                }
+            }
+
+            m_Collapses.clear();
+            for (size_t i = 0; i < m_Indices.size(); i += 3)
+            {
+                for (int e = 0; e < 3; ++e)
+                {
+                    const uint32_t a = m_Indices[i + e];
+                    const uint32_t b = m_Indices[i + (e + 1) % 3];
+                    for (const auto &[from, to] : {std::pair<uint32_t, uint32_t>(a, b), std::pair<uint32_t, uint32_t>(b, a)})
+                    {
+                        if (m_Locked[m_Group[from]])
+                        {
+                            continue;
+                        }
+                        Quadric quadric = m_Quadrics[m_Group[from]];
+                        quadric += m_Quadrics[m_Group[to]];
+                        const double cost =
+                            quadric.weight > 0.0 ? std::max(quadric.evaluate(m_Vertices[to].position), 0.0) / quadric.weight : 0.0;
+                        m_Collapses.push_back({from, to, cost});
+                    }
+                }
+            }
+            std::sort(m_Collapses.begin(), m_Collapses.end(), [](const Collapse &a, const Collapse &b)
+                      { return a.cost != b.cost ? a.cost < b.cost : a.from != b.from ? a.from < b.from : a.to < b.to; });
+
+            std::iota(m_CollapseTo.begin(), m_CollapseTo.end(), 0u);
+            std::fill(m_Touched.begin(), m_Touched.end(), false);
+            const size_t goal = (m_Indices.size() - targetIndexCount) / 3;
+            size_t removed = 0;
+            size_t performed = 0;
+            for (const Collapse &collapse : m_Collapses)
+            {
+                if (removed >= goal || collapse.cost > limit)
+                {
+                    break;
+                }
+                if (m_Touched[collapse.from] || m_Touched[collapse.to])
+                {
+                    continue;
+                }
+
+                // The triangles around `from` that survive must not flip.
+                bool valid = true;
+                size_t shared = 0;
+                for (uint32_t t = m_Offsets[collapse.from]; t < m_Offsets[collapse.from + 1] && valid; ++t)
+                {
+                    const uint32_t *triangle = m_Indices.data() + m_Triangles[t] * 3;
+                    if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to)
+                    {
+                        ++shared;
+                        continue;
+                    }
+                    glm::vec3 moved[3];
+                    for (int corner = 0; corner < 3; ++corner)
+                    {
+                        moved[corner] = m_Vertices[triangle[corner] == collapse.from ? collapse.to : triangle[corner]].position;
+                    }
+                    const glm::vec3 before = triangleNormal(m_Vertices[triangle[0]].position, m_Vertices[triangle[1]].position,
+                                                            m_Vertices[triangle[2]].position);
+                    valid = glm::dot(before, triangleNormal(moved[0], moved[1], moved[2])) > 0.0f;
+                }
+                if (!valid || shared == 0)
+                {
+                    continue;
+                }
+
+                m_CollapseTo[collapse.from] = collapse.to;
+                m_Quadrics[m_Group[collapse.to]] += m_Quadrics[m_Group[collapse.from]];
+                for (uint32_t t = m_Offsets[collapse.from]; t < m_Offsets[collapse.from + 1]; ++t)
+                {
+                    const uint32_t *triangle = m_Indices.data() + m_Triangles[t] * 3;
+                    m_Touched[triangle[0]] = m_Touched[triangle[1]] = m_Touched[triangle[2]] = true;
+                }
+                removed += shared;
+                m_Reached = std::max(m_Reached, collapse.cost);
+                ++performed;
+            }
+            if (performed == 0)
+            {
+                return false;
+            }
+
+            m_Next.clear();
+            for (size_t i = 0; i < m_Indices.size(); i += 3)
+            {
+                const uint32_t a = m_CollapseTo[m_Indices[i]];
+                const uint32_t b = m_CollapseTo[m_Indices[i + 1]];
+                const uint32_t c = m_CollapseTo[m_Indices[i + 2]];
+                if (a != b && b != c && a != c)
+                {
+                    m_Next.insert(m_Next.end(), {a, b, c});
+                }
+            }
+            m_Indices.swap(m_Next);
+            return true;
+        }
+    } // namespace
+
+    void MeshSimplifier::simplify(const MeshVertex *vertices, size_t vertexCount, const uint32_t *indices, size_t indexCount,
+                                  size_t targetIndexCount, float maxError, std::vector<uint32_t> &out, float *error)
+    {
+        Collapser collapser(vertices, vertexCount, indices, indexCount);
+        collapser.reduce(targetIndexCount, maxError);
+        out = collapser.getIndices();
+        if (error)
+        {
+            *error = collapser.getDiagonal() > 0.0f ? collapser.getError() : 0.0f;
+        }
+    }
+
+    size_t MeshSimplifier::generateLods(MeshData &mesh)
+    {
+        return generateLods(mesh, LodOptions());
+    }
+
+    size_t MeshSimplifier::generateLods(MeshData &mesh, const LodOptions &options)
+    {
+        const size_t fullIndexCount = mesh.getTriangleCount() * 3;
+        mesh.indices.resize(fullIndexCount);
+        mesh.lods.clear();
+
+        std::vector<SubMesh> ranges = mesh.subMeshes;
+        if (ranges.empty())
+        {
+            ranges.push_back({"", "", 0, static_cast<uint32_t>(fullIndexCount)});
+        }
+        const float meshDiagonal = boundsDiagonal(mesh.vertices.data(), mesh.indices.data(), fullIndexCount);
+        if (meshDiagonal <= 0.0f)
+        {
+            return 1;
+        }
+
+        // One collapse state per submesh, reduced further for every LOD. Errors are against the
+        // full mesh since the quadrics keep accumulating from it.
+        std::vector<std::unique_ptr<Collapser>> collapsers;
+        for (const SubMesh &range : ranges)
+        {
+            collapsers.push_back(std::make_unique<Collapser>(mesh.vertices.data(), mesh.vertices.size(),
+                                                             mesh.indices.data() + range.firstIndex, range.indexCount));
+        }
+
+        std::vector<MeshLod> lods = {{0, static_cast<uint32_t>(fullIndexCount), 0.0f}};
+        std::vector<uint32_t> level;
+        size_t previousCount = fullIndexCount;
+        while (lods.size() < options.maxLods)
+        {
+            const size_t target = static_cast<size_t>(static_cast<double>(previousCount) * options.ratio) / 3 * 3;
+            if (target / 3 < options.minTriangles)
+            {
+                break;
+            }
+
+            level.clear();
+            float levelError = 0.0f;
+            for (size_t i = 0; i < ranges.size(); ++i)
+            {
+                Collapser &collapser = *collapsers[i];
+                const float diagonal = collapser.getDiagonal();
+                if (diagonal > 0.0f)
+                {
+                    const auto rangeTarget = static_cast<size_t>(static_cast<double>(ranges[i].indexCount) * target / fullIndexCount);
+                    collapser.reduce(rangeTarget, options.maxError * meshDiagonal / diagonal);
+                    levelError = std::max(levelError, collapser.getError() * diagonal / meshDiagonal);
+                }
+                level.insert(level.end(), collapser.getIndices().begin(), collapser.getIndices().end());
+            }
+            // The error limit was hit well before the target.
+            if (level.size() > previousCount - (previousCount - target) / 2)
+            {
+                break;
+            }
+
+            MeshOptimizer::optimizeVertexCache(level.data(), level.size(), mesh.vertices.size());
+            lods.push_back({static_cast<uint32_t>(mesh.indices.size()), static_cast<uint32_t>(level.size()), levelError});
+            mesh.indices.insert(mesh.indices.end(), level.begin(), level.end());
+            previousCount = level.size();
+        }
+
+        if (lods.size() > 1)
+        {
+            mesh.lods = std::move(lods);
+        }
+        return std::max<size_t>(mesh.lods.size(), 1);
+    }
+
+} // namespace Base
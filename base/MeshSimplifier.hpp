@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Mesh.hpp"
+
+namespace Base
+{
+    // Quadric error metric simplification (Garland & Heckbert, "Surface Simplification Using
+    // Quadric Error Metrics", 1997) by half-edge collapses: a vertex is merged into one of its
+    // neighbours, never moved, so a simplified mesh is only a new index list over the original
+    // vertices and every LOD can share one vertex buffer.
+    //
+    // Vertices on open borders and attribute seams (several vertices at one position, e.g. hard
+    // edges or texture seams) never move, which keeps outlines and seams watertight. Collapses that
+    // would flip a triangle are skipped.
+    class MeshSimplifier
+    {
+    public:
+        struct LodOptions
+        {
+            uint32_t maxLods = 5;         // Including the full mesh
+            float ratio = 0.5f;           // Triangle count of each LOD relative to the previous one
+            float maxError = 0.05f;       // Relative to the bounds diagonal; no coarser LODs past it
+            uint32_t minTriangles = 64;
+        };
+
+        // Simplifies `indices` towards `targetIndexCount` indices without exceeding `maxError`
+        // (relative to the bounds diagonal of the referenced vertices). `error`, if given,
+        // receives the largest error reached, on the same scale.
+        static void simplify(const MeshVertex *vertices, size_t vertexCount, const uint32_t *indices, size_t indexCount,
+                             size_t targetIndexCount, float maxError, std::vector<uint32_t> &out, float *error = nullptr);
+
+        // Appends LODs 1.. of the full mesh to `mesh.indices` and fills `mesh.lods` (LOD 0 being
+        // the full mesh). Each submesh is simplified on its own, so material borders stay put.
+        // Replaces any LODs the mesh already had. Returns the number of LODs, 1 if none could be
+        // made.
+        static size_t generateLods(MeshData &mesh, const LodOptions &options);
+        static size_t generateLods(MeshData &mesh);
+    };
+
+} // namespace Base
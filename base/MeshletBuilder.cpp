@@ -0,0 +1,353 @@
+#include "MeshletBuilder.hpp"
+#include "MeshOptimizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Base
+{
+    namespace
+    {
+        constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
+
+        // How much a triangle facing away from the meshlet's average normal counts against it,
+        // relative to its distance: a wide cone makes the backface test useless.
+        constexpr float kConeWeight = 2.0f;
+
+        class Clusterer
+        {
+        public:
+            Clusterer(const std::vector<MeshVertex> &vertices, uint32_t *indices, size_t indexCount)
+                : m_Indices(indices), m_TriangleCount(indexCount / 3)
+            {
+                const size_t vertexCount = vertices.size();
+                m_Live.assign(vertexCount, 0);
+                m_Marked.assign(vertexCount, 0);
+                m_Used.assign(m_TriangleCount, 0);
+                m_Centroids.resize(m_TriangleCount);
+                m_Normals.resize(m_TriangleCount);
+
+                // Triangles around each vertex, as offsets into one array.
+                m_AdjacencyOffsets.assign(vertexCount + 1, 0);
+                for (size_t i = 0; i < m_TriangleCount * 3; ++i)
+                {
+                    ++m_Live[indices[i]];
+                }
+                for (size_t v = 0; v < vertexCount; ++v)
+                {
+                    m_AdjacencyOffsets[v + 1] = m_AdjacencyOffsets[v] + m_Live[v];
+                }
+                m_Adjacency.resize(m_TriangleCount * 3);
+                std::vector<uint32_t> fill(m_AdjacencyOffsets.begin(), m_AdjacencyOffsets.end() - 1);
+                for (size_t t = 0; t < m_TriangleCount; ++t)
+                {
+                    const glm::vec3 &a = vertices[indices[t * 3 + 0]].position;
+                    const glm::vec3 &b = vertices[indices[t * 3 + 1]].position;
+                    const glm::vec3 &c = vertices[indices[t * 3 + 2]].position;
+                    m_Centroids[t] = (a + b + c) / 3.0f;
+                    const glm::vec3 normal = glm::cross(b - a, c - a);
+                    const float length = glm::length(normal);
+                    m_Normals[t] = length > 0.0f ? normal / length : glm::vec3(0.0f);
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        m_Adjacency[fill[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+                    }
+                }
+            }
+
+            // Meshlet ranges relative to the start of `indices`, which are reordered to match.
+            void run(std::vector<Meshlet> &meshlets)
+            {
+                std::vector<uint32_t> order;
+                order.reserve(m_TriangleCount);
+                size_t cursor = 0;
+                uint32_t seed = m_TriangleCount > 0 ? 0 : kNone;
+                while (seed != kNone)
+                {
+                    const size_t first = order.size();
+                    grow(seed, order);
+
+                    Meshlet meshlet;
+                    meshlet.firstIndex = static_cast<uint32_t>(first * 3);
+                    meshlet.indexCount = static_cast<uint32_t>((order.size() - first) * 3);
+                    meshlets.push_back(meshlet);
+
+                    seed = nextSeed();
+                    for (uint32_t v : m_MeshletVertices)
+                    {
+                        m_Marked[v] = 0;
+                    }
+                    m_MeshletVertices.clear();
+                    if (seed == kNone)
+                    {
+                        while (cursor < m_TriangleCount && m_Used[cursor])
+                        {
+                            ++cursor;
+                        }
+                        seed = cursor < m_TriangleCount ? static_cast<uint32_t>(cursor) : kNone;
+                    }
+                }
+
+                std::vector<uint32_t> reordered(m_TriangleCount * 3);
+                for (size_t i = 0; i < order.size(); ++i)
+                {
+                    std::copy_n(m_Indices + order[i] * 3, 3, reordered.data() + i * 3);
+                }
+                std::copy(reordered.begin(), reordered.end(), m_Indices);
+            }
+
+        private:
+            uint32_t newVertices(uint32_t triangle) const
+            {
+                const uint32_t *t = m_Indices + triangle * 3;
+                return uint32_t(!m_Marked[t[0]]) + uint32_t(!m_Marked[t[1]] && t[1] != t[0]) +
+                       uint32_t(!m_Marked[t[2]] && t[2] != t[0] && t[2] != t[1]);
+            }
+
+            void add(uint32_t triangle, std::vector<uint32_t> &order)
+            {
+                m_Used[triangle] = 1;
+                order.push_back(triangle);
+                for (int k = 0; k < 3; ++k)
+                {
+                    const uint32_t v = m_Indices[triangle * 3 + k];
+                    --m_Live[v];
+                    if (!m_Marked[v])
+                    {
+                        m_Marked[v] = 1;
+                        m_MeshletVertices.push_back(v);
+                    }
+                }
+                m_CentroidSum += m_Centroids[triangle];
+                m_NormalSum += m_Normals[triangle];
+            }
+
+            void grow(uint32_t seed, std::vector<uint32_t> &order)
+            {
+                m_CentroidSum = glm::vec3(0.0f);
+                m_NormalSum = glm::vec3(0.0f);
+                add(seed, order);
+                for (uint32_t triangles = 1; triangles < MeshletBuilder::kMaxTriangles; ++triangles)
+                {
+                    const glm::vec3 center = m_CentroidSum / static_cast<float>(triangles);
+                    const float normalLength = glm::length(m_NormalSum);
+                    const glm::vec3 axis = normalLength > 0.0f ? m_NormalSum / normalLength : glm::vec3(0.0f);
+
+                    uint32_t best = kNone;
+                    uint32_t bestNew = 4;
+                    float bestCost = std::numeric_limits<float>::max();
+                    for (uint32_t v : m_MeshletVertices)
+                    {
+                        if (m_Live[v] == 0)
+                        {
+                            continue;
+                        }
+                        for (uint32_t i = m_AdjacencyOffsets[v]; i < m_AdjacencyOffsets[v + 1]; ++i)
+                        {
+                            const uint32_t triangle = m_Adjacency[i];
+                            if (m_Used[triangle])
+                            {
+                                continue;
+                            }
+                            const uint32_t added = newVertices(triangle);
+                            if (m_MeshletVertices.size() + added > MeshletBuilder::kMaxVertices || added > bestNew)
+                            {
+                                continue;
+                            }
+                            const float cost = glm::length(m_Centroids[triangle] - center) *
+                                               (1.0f + kConeWeight * (1.0f - glm::dot(m_Normals[triangle], axis)));
+                            if (added < bestNew || cost < bestCost)
+                            {
+                                best = triangle;
+                                bestNew = added;
+                                bestCost = cost;
+                            }
+                        }
+                    }
+                    if (best == kNone)
+                    {
+                        break;
+                    }
+                    add(best, order);
+                }
+            }
+
+            // A free triangle next to the meshlet just built, so the next one continues the
+            // front; the one with the fewest free neighbours, so that no strays are left behind.
+            uint32_t nextSeed() const
+            {
+                uint32_t seed = kNone;
+                uint32_t bestLive = std::numeric_limits<uint32_t>::max();
+                for (uint32_t v : m_MeshletVertices)
+                {
+                    for (uint32_t i = m_AdjacencyOffsets[v]; m_Live[v] != 0 && i < m_AdjacencyOffsets[v + 1]; ++i)
+                    {
+                        const uint32_t triangle = m_Adjacency[i];
+                        if (m_Used[triangle])
+                        {
+                            continue;
+                        }
+                        const uint32_t *t = m_Indices + triangle * 3;
+                        const uint32_t live = m_Live[t[0]] + m_Live[t[1]] + m_Live[t[2]];
+                        if (live < bestLive)
+                        {
+                            seed = triangle;
+                            bestLive = live;
+                        }
+                    }
+                }
+                return seed;
+            }
+
+            uint32_t *m_Indices;
+            size_t m_TriangleCount;
+
+            std::vector<uint32_t> m_AdjacencyOffsets;
+            std::vector<uint32_t> m_Adjacency;
+            std::vector<uint32_t> m_Live; // Unused triangles around each vertex
+            std::vector<uint8_t> m_Marked;
+            std::vector<uint8_t> m_Used;
+            std::vector<glm::vec3> m_Centroids;
+            std::vector<glm::vec3> m_Normals;
+
+            std::vector<uint32_t> m_MeshletVertices;
+            glm::vec3 m_CentroidSum = glm::vec3(0.0f);
+            glm::vec3 m_NormalSum = glm::vec3(0.0f);
+        };
+    } // namespace
+
+    size_t MeshletBuilder::build(MeshData &mesh)
+    {
+        mesh.meshlets.clear();
+        const size_t fullIndexCount = mesh.lods.empty() ? mesh.indices.size() : mesh.lods[0].indexCount;
+
+        std::vector<SubMesh> ranges = mesh.subMeshes;
+        if (ranges.empty())
+        {
+            SubMesh whole;
+            whole.indexCount = static_cast<uint32_t>(fullIndexCount);
+            ranges.push_back(whole);
+        }
+        std::vector<uint32_t> localIds(mesh.vertices.size(), kNone);
+        std::vector<uint32_t> globalIds;
+        std::vector<uint32_t> local;
+        for (const SubMesh &range : ranges)
+        {
+            if (range.indexCount < 3 || size_t(range.firstIndex) + range.indexCount > fullIndexCount)
+            {
+                continue;
+            }
+            const size_t first = mesh.meshlets.size();
+            Clusterer clusterer(mesh.vertices, mesh.indices.data() + range.firstIndex, range.indexCount);
+            clusterer.run(mesh.meshlets);
+            for (size_t i = first; i < mesh.meshlets.size(); ++i)
+            {
+                Meshlet &meshlet = mesh.meshlets[i];
+                meshlet.firstIndex += range.firstIndex;
+                computeBounds(mesh.vertices.data(), mesh.indices.data(), meshlet);
+
+                // Growth order is not cache order: reorder within the meshlet, over its own few
+                // vertices so that this stays cheap.
+                uint32_t *indices = mesh.indices.data() + meshlet.firstIndex;
+                local.resize(meshlet.indexCount);
+                for (uint32_t k = 0; k < meshlet.indexCount; ++k)
+                {
+                    if (localIds[indices[k]] == kNone)
+                    {
+                        localIds[indices[k]] = static_cast<uint32_t>(globalIds.size());
+                        globalIds.push_back(indices[k]);
+                    }
+                    local[k] = localIds[indices[k]];
+                }
+                MeshOptimizer::optimizeVertexCache(local.data(), local.size(), globalIds.size());
+                for (uint32_t k = 0; k < meshlet.indexCount; ++k)
+                {
+                    indices[k] = globalIds[local[k]];
+                }
+                for (uint32_t vertex : globalIds)
+                {
+                    localIds[vertex] = kNone;
+                }
+                globalIds.clear();
+            }
+        }
+        return mesh.meshlets.size();
+    }
+
+    void MeshletBuilder::computeBounds(const MeshVertex *vertices, const uint32_t *indices, Meshlet &meshlet)
+    {
+        const uint32_t *begin = indices + meshlet.firstIndex;
+        const uint32_t *end = begin + meshlet.indexCount;
+
+        glm::vec3 lower(std::numeric_limits<float>::max());
+        glm::vec3 upper(-std::numeric_limits<float>::max());
+        for (const uint32_t *index = begin; index != end; ++index)
+        {
+            lower = glm::min(lower, vertices[*index].position);
+            upper = glm::max(upper, vertices[*index].position);
+        }
+        meshlet.center = (lower + upper) * 0.5f;
+        meshlet.radius = 0.0f;
+        for (const uint32_t *index = begin; index != end; ++index)
+        {
+            meshlet.radius = std::max(meshlet.radius, glm::length(vertices[*index].position - meshlet.center));
+        }
+
+        // Normal cone (the "cone of normals" of Shirman & Abi-Ezzi, 1993): the average normal and
+        // the widest angle from it. The apex is moved back along the axis until every triangle's
+        // plane is in front of it, so that the test holds for cameras close to the meshlet too.
+        std::vector<glm::vec3> normals;
+        normals.reserve(meshlet.indexCount / 3);
+        glm::vec3 sum(0.0f);
+        for (const uint32_t *t = begin; t + 3 <= end; t += 3)
+        {
+            const glm::vec3 normal = glm::cross(vertices[t[1]].position - vertices[t[0]].position,
+                                                vertices[t[2]].position - vertices[t[0]].position);
+            const float length = glm::length(normal);
+            normals.push_back(length > 0.0f ? normal / length : glm::vec3(0.0f));
+            sum += normals.back();
+        }
+        meshlet.coneApex = meshlet.center;
+        meshlet.coneAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+        meshlet.coneCutoff = 1.0f;
+        const float sumLength = glm::length(sum);
+        if (sumLength <= 0.0f)
+        {
+            return;
+        }
+        const glm::vec3 axis = sum / sumLength;
+        meshlet.coneAxis = axis;
+
+        float minDot = 1.0f;
+        for (const glm::vec3 &normal : normals)
+        {
+            if (glm::dot(normal, normal) > 0.0f)
+            {
+                minDot = std::min(minDot, glm::dot(normal, axis));
+            }
+        }
+        // Past ~84 degrees the apex would have to move arbitrarily far back.
+        if (minDot <= 0.1f)
+        {
+            return;
+        }
+        float offset = 0.0f;
+        for (size_t i = 0; i < normals.size(); ++i)
+        {
+            if (glm::dot(normals[i], normals[i]) == 0.0f)
+            {
+                continue;
+            }
+            const float along = glm::dot(axis, normals[i]);
+            for (int k = 0; k < 3; ++k)
+            {
+                const glm::vec3 &corner = vertices[begin[i * 3 + k]].position;
+                offset = std::max(offset, glm::dot(meshlet.center - corner, normals[i]) / along);
+            }
+        }
+        meshlet.coneApex = meshlet.center - axis * offset;
+        meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+    }
+
+} // namespace Base
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Mesh.hpp"
+
+namespace Base
+{
+    // Splits the full mesh into meshlets: small, spatially compact clusters of triangles that
+    // share vertices, so that ClusterCuller can reject whole groups of triangles before drawing.
+    // Meshlets grow greedily over shared edges, preferring triangles that add no new vertices,
+    // then those closest to the cluster and facing the same way, which keeps both the bounding
+    // spheres and the normal cones tight.
+    class MeshletBuilder
+    {
+    public:
+        static constexpr uint32_t kMaxVertices = 64;
+        static constexpr uint32_t kMaxTriangles = 124;
+
+        // Reorders the triangles of each submesh so that every meshlet is one contiguous index
+        // range, and fills `mesh.meshlets`. LOD ranges are left as they are. Run after
+        // MeshOptimizer::optimize, which would otherwise break the ranges up again. Returns the
+        // number of meshlets.
+        static size_t build(MeshData &mesh);
+
+        // Bounding sphere and normal cone of the triangles in `meshlet`'s range.
+        static void computeBounds(const MeshVertex *vertices, const uint32_t *indices, Meshlet &meshlet);
+    };
+
+} // namespace Base
@@ -0,0 +1,673 @@
+#include "ObjLoader.hpp"
+#include "AssetFile.hpp"
+#include "Log.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <future>
+#include <thread>
+
+namespace Base
+{
+    namespace
+    {
+        // Smaller files are parsed in one piece; spawning tasks would cost more than it saves.
+        constexpr size_t kMinChunkSize = 256 * 1024;
+        constexpr int32_t kMissing = INT32_MIN;
+
+        enum RelativeBits : uint8_t
+        {
+            RelativePosition = 1,
+            RelativeTexCoord = 2,
+            RelativeNormal = 4
+        };
+
+        // One face corner. Indices are 0-based; negative OBJ indices count back from the vertices
+        // seen so far, which a chunk only knows locally, so those stay chunk-relative (flagged in
+        // `relative`) until the chunk's base offsets are known.
+        struct Corner
+        {
+            int32_t position = kMissing;
+            int32_t texCoord = kMissing;
+            int32_t normal = kMissing;
+            uint8_t relative = 0;
+        };
+
+        struct Marker
+        {
+            enum Kind : uint8_t
+            {
+                Group,
+                Material
+            };
+
+            size_t corner = 0; // First corner (in the chunk) the marker applies to
+            Kind kind = Group;
+            std::string name;
+        };
+
+        struct Chunk
+        {
+            const char *begin = nullptr;
+            const char *end = nullptr;
+            std::vector<glm::vec3> positions;
+            std::vector<glm::vec2> texCoords;
+            std::vector<glm::vec3> normals;
+            std::vector<Corner> corners;
+            std::vector<Marker> markers;
+            size_t skippedLines = 0;
+
+            // Prefix sums over the previous chunks.
+            size_t positionBase = 0;
+            size_t texCoordBase = 0;
+            size_t normalBase = 0;
+            bool valid = true;
+        };
+
+        double millisecondsSince(std::chrono::steady_clock::time_point start)
+        {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        bool isBlank(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\r';
+        }
+
+        const char *skipBlanks(const char *p, const char *end)
+        {
+            while (p < end && isBlank(*p))
+            {
+                ++p;
+            }
+            return p;
+        }
+
+        double powerOf10(int exponent)
+        {
+            // Exactly representable up to 1e22, so mantissa * or / these rounds only once.
+            static constexpr double kPowers[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                                 1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                                 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+            return exponent <= 22 ? kPowers[exponent] : std::pow(10.0, exponent);
+        }
+
+        // Decimal float as written by exporters: [sign] digits [. digits] [e [sign] digits].
+        // Returns nullptr if there is no number at `p`.
+        const char *parseFloat(const char *p, const char *end, float &out)
+        {
+            p = skipBlanks(p, end);
+            bool negative = false;
+            if (p < end && (*p == '-' || *p == '+'))
+            {
+                negative = *p == '-';
+                ++p;
+            }
+
+            uint64_t mantissa = 0;
+            int exponent = 0;
+            int significantDigits = 0;
+            bool anyDigits = false;
+            for (; p < end && *p >= '0' && *p <= '9'; ++p)
+            {
+                anyDigits = true;
+                if (significantDigits < 19)
+                {
+                    mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+                    significantDigits += mantissa != 0;
+                }
+                else
+                {
+                    ++exponent;
+                }
+            }
+            if (p < end && *p == '.')
+            {
+                for (++p; p < end && *p >= '0' && *p <= '9'; ++p)
+                {
+                    anyDigits = true;
+                    if (significantDigits < 19)
+                    {
+                        mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+                        significantDigits += mantissa != 0;
+                        --exponent;
+                    }
+                }
+            }
+            if (!anyDigits)
+            {
+                return nullptr;
+            }
+            if (p < end && (*p == 'e' || *p == 'E'))
+            {
+                const char *q = p + 1;
+                bool negativeExponent = false;
+                if (q < end && (*q == '-' || *q == '+'))
+                {
+                    negativeExponent = *q == '-';
+                    ++q;
+                }
+                if (q < end && *q >= '0' && *q <= '9')
+                {
+                    int value = 0;
+                    for (; q < end && *q >= '0' && *q <= '9'; ++q)
+                    {
+                        value = std::min(value * 10 + (*q - '0'), 1000);
+                    }
+                    exponent += negativeExponent ? -value : value;
+                    p = q;
+                }
+            }
+
+            double value = static_cast<double>(mantissa);
+            value = exponent < 0 ? value / powerOf10(-exponent) : value * powerOf10(exponent);
+            out = static_cast<float>(negative ? -value : value);
+            return p;
+        }
+
+        const char *parseInt(const char *p, const char *end, int32_t &out)
+        {
+            bool negative = false;
+            if (p < end && (*p == '-' || *p == '+'))
+            {
+                negative = *p == '-';
+                ++p;
+            }
+            if (p == end || *p < '0' || *p > '9')
+            {
+                return nullptr;
+            }
+            int64_t value = 0;
+            for (; p < end && *p >= '0' && *p <= '9'; ++p)
+            {
+                value = std::min<int64_t>(value * 10 + (*p - '0'), INT32_MAX);
+            }
+            out = static_cast<int32_t>(negative ? -value : value);
+            return p;
+        }
+
+        // OBJ index (1-based, or negative from the end) to a 0-based one; false for index 0.
+        bool toZeroBased(int32_t index, size_t localCount, uint8_t bit, int32_t &out, uint8_t &relative)
+        {
+            if (index > 0)
+            {
+                out = index - 1;
+                return true;
+            }
+            if (index < 0)
+            {
+                out = static_cast<int32_t>(localCount) + index;
+                relative |= bit;
+                return true;
+            }
+            return false;
+        }
+
+        // "v/vt/vn", "v//vn", "v/vt" or "v".
+        const char *parseCorner(const char *p, const char *end, const Chunk &chunk, Corner &corner)
+        {
+            int32_t index = 0;
+            p = parseInt(p, end, index);
+            if (!p || !toZeroBased(index, chunk.positions.size(), RelativePosition, corner.position, corner.relative))
+            {
+                return nullptr;
+            }
+            if (p < end && *p == '/')
+            {
+                ++p;
+                if (p < end && *p != '/')
+                {
+                    p = parseInt(p, end, index);
+                    if (!p || !toZeroBased(index, chunk.texCoords.size(), RelativeTexCoord, corner.texCoord, corner.relative))
+                    {
+                        return nullptr;
+                    }
+                }
+                if (p < end && *p == '/')
+                {
+                    p = parseInt(p + 1, end, index);
+                    if (!p || !toZeroBased(index, chunk.normals.size(), RelativeNormal, corner.normal, corner.relative))
+                    {
+                        return nullptr;
+                    }
+                }
+            }
+            return p;
+        }
+
+        std::string restOfLine(const char *p, const char *end)
+        {
+            p = skipBlanks(p, end);
+            const char *last = end;
+            while (last > p && isBlank(last[-1]))
+            {
+                --last;
+            }
+            return std::string(p, last);
+        }
+
+        bool startsWith(const char *p, const char *end, const char *word)
+        {
+            const size_t length = std::strlen(word);
+            return static_cast<size_t>(end - p) > length && std::memcmp(p, word, length) == 0 && isBlank(p[length]);
+        }
+
+        void parseChunk(Chunk &chunk)
+        {
+            std::vector<Corner> polygon;
+            const char *p = chunk.begin;
+            while (p < chunk.end)
+            {
+                const char *lineEnd = static_cast<const char *>(std::memchr(p, '\n', chunk.end - p));
+                if (!lineEnd)
+                {
+                    lineEnd = chunk.end;
+                }
+                const char *q = skipBlanks(p, lineEnd);
+                bool ok = true;
+
+                if (q + 1 < lineEnd && q[0] == 'v' && isBlank(q[1]))
+                {
+                    glm::vec3 position;
+                    ok = (q = parseFloat(q + 2, lineEnd, position.x)) && (q = parseFloat(q, lineEnd, position.y)) &&
+                         (q = parseFloat(q, lineEnd, position.z));
+                    if (ok)
+                    {
+                        chunk.positions.push_back(position);
+                    }
+                }
+                else if (q + 2 < lineEnd && q[0] == 'v' && q[1] == 'n' && isBlank(q[2]))
+                {
+                    glm::vec3 normal;
+                    ok = (q = parseFloat(q + 3, lineEnd, normal.x)) && (q = parseFloat(q, lineEnd, normal.y)) &&
+                         (q = parseFloat(q, lineEnd, normal.z));
+                    if (ok)
+                    {
+                        chunk.normals.push_back(normal);
+                    }
+                }
+                else if (q + 2 < lineEnd && q[0] == 'v' && q[1] == 't' && isBlank(q[2]))
+                {
+                    // A missing v defaults to 0.
+                    glm::vec2 texCoord(0.0f);
+                    ok = (q = parseFloat(q + 3, lineEnd, texCoord.x)) != nullptr;
+                    if (ok)
+                    {
+                        parseFloat(q, lineEnd, texCoord.y);
+                        chunk.texCoords.push_back(texCoord);
+                    }
+                }
+                else if (q + 1 < lineEnd && q[0] == 'f' && isBlank(q[1]))
+                {
+                    polygon.clear();
+                    q = skipBlanks(q + 2, lineEnd);
+                    while (ok && q < lineEnd)
+                    {
+                        Corner corner;
+                        q = parseCorner(q, lineEnd, chunk, corner);
+                        ok = q != nullptr;
+                        if (ok)
+                        {
+                            polygon.push_back(corner);
+                            q = skipBlanks(q, lineEnd);
+                        }
+                    }
+                    ok = ok && polygon.size() >= 3;
+                    for (size_t i = 2; ok && i < polygon.size(); ++i)
+                    {
+                        chunk.corners.push_back(polygon[0]);
+                        chunk.corners.push_back(polygon[i - 1]);
+                        chunk.corners.push_back(polygon[i]);
+                    }
+                }
+                else if (q + 1 < lineEnd && (q[0] == 'o' || q[0] == 'g') && isBlank(q[1]))
+                {
+                    chunk.markers.push_back({chunk.corners.size(), Marker::Group, restOfLine(q + 2, lineEnd)});
+                }
+                else if (startsWith(q, lineEnd, "usemtl"))
+                {
+                    chunk.markers.push_back({chunk.corners.size(), Marker::Material, restOfLine(q + 7, lineEnd)});
+                }
+
+                if (!ok)
+                {
+                    ++chunk.skippedLines;
+                }
+                p = lineEnd + 1;
+            }
+        }
+
+        bool resolveIndex(int32_t &index, uint8_t relative, uint8_t bit, size_t base, size_t count)
+        {
+            if (index == kMissing)
+            {
+                return true;
+            }
+            const int64_t resolved = static_cast<int64_t>(index) + ((relative & bit) ? static_cast<int64_t>(base) : 0);
+            index = static_cast<int32_t>(resolved);
+            return resolved >= 0 && resolved < static_cast<int64_t>(count);
+        }
+
+        // Turns the chunk's corners into global 0-based indices (kMissing stays).
+        void resolveChunk(Chunk &chunk, size_t positionCount, size_t texCoordCount, size_t normalCount)
+        {
+            for (Corner &corner : chunk.corners)
+            {
+                chunk.valid = chunk.valid &&
+                              resolveIndex(corner.position, corner.relative, RelativePosition, chunk.positionBase, positionCount) &&
+                              resolveIndex(corner.texCoord, corner.relative, RelativeTexCoord, chunk.texCoordBase, texCoordCount) &&
+                              resolveIndex(corner.normal, corner.relative, RelativeNormal, chunk.normalBase, normalCount);
+            }
+        }
+
+        // Maps (position, texCoord, normal) triples to output vertices. Open addressing with
+        // linear probing over one flat array keeps the lookups cache friendly.
+        class CornerMap
+        {
+        public:
+            explicit CornerMap(size_t expected)
+            {
+                size_t capacity = 64;
+                while (capacity < expected * 2)
+                {
+                    capacity *= 2;
+                }
+                m_Slots.resize(capacity);
+            }
+
+            // The vertex for `corner`, or `next` if it is new.
+            uint32_t findOrInsert(const Corner &corner, uint32_t next)
+            {
+                if ((m_Count + 1) * 10 > m_Slots.size() * 7)
+                {
+                    grow();
+                }
+                const size_t mask = m_Slots.size() - 1;
+                for (size_t i = hashOf(corner) & mask;; i = (i + 1) & mask)
+                {
+                    Slot &slot = m_Slots[i];
+                    if (slot.vertex == kEmpty)
+                    {
+                        slot = {corner.position, corner.texCoord, corner.normal, next};
+                        ++m_Count;
+                        return next;
+                    }
+                    if (slot.position == corner.position && slot.texCoord == corner.texCoord && slot.normal == corner.normal)
+                    {
+                        return slot.vertex;
+                    }
+                }
+            }
+
+        private:
+            static constexpr uint32_t kEmpty = UINT32_MAX;
+
+            struct Slot
+            {
+                int32_t position = 0;
+                int32_t texCoord = 0;
+                int32_t normal = 0;
+                uint32_t vertex = kEmpty;
+            };
+
+            static size_t hashOf(const Corner &corner)
+            {
+                uint32_t hash = static_cast<uint32_t>(corner.position) * 0x9E3779B1u;
+                hash ^= static_cast<uint32_t>(corner.texCoord) * 0x85EBCA77u;
+                hash ^= static_cast<uint32_t>(corner.normal) * 0xC2B2AE3Du;
+                hash ^= hash >> 15;
+                hash *= 0x2C1B3C6Du;
+                hash ^= hash >> 13;
+                return hash;
+            }
+
+            void grow()
+            {
+                std::vector<Slot> old(m_Slots.size() * 2);
+                old.swap(m_Slots);
+                const size_t mask = m_Slots.size() - 1;
+                for (const Slot &slot : old)
+                {
+                    if (slot.vertex == kEmpty)
+                    {
+                        continue;
+                    }
+                    size_t i = hashOf({slot.position, slot.texCoord, slot.normal}) & mask;
+                    while (m_Slots[i].vertex != kEmpty)
+                    {
+                        i = (i + 1) & mask;
+                    }
+                    m_Slots[i] = slot;
+                }
+            }
+
+            std::vector<Slot> m_Slots;
+            size_t m_Count = 0;
+        };
+
+        // Splits at line ends into roughly equal pieces.
+        std::vector<Chunk> splitChunks(const char *text, size_t size, ThreadPool *pool)
+        {
+            size_t chunkCount = 1;
+            if (pool)
+            {
+                const size_t threads = std::max(1u, std::thread::hardware_concurrency());
+                chunkCount = std::clamp<size_t>(size / kMinChunkSize, 1, threads * 2);
+            }
+
+            std::vector<Chunk> chunks;
+            const char *end = text + size;
+            const char *begin = text;
+            for (size_t i = 0; i < chunkCount && begin < end; ++i)
+            {
+                const char *split = i + 1 == chunkCount ? end : std::min(end, text + size * (i + 1) / chunkCount);
+                if (split < end)
+                {
+                    const char *newline = static_cast<const char *>(std::memchr(split, '\n', end - split));
+                    split = newline ? newline + 1 : end;
+                }
+                if (split > begin)
+                {
+                    Chunk chunk;
+                    chunk.begin = begin;
+                    chunk.end = split;
+                    chunks.push_back(std::move(chunk));
+                }
+                begin = split;
+            }
+            return chunks;
+        }
+
+        // Runs `task(chunk)` for every chunk, on the pool when there is one.
+        template <typename Task>
+        void forEachChunk(std::vector<Chunk> &chunks, ThreadPool *pool, Task task)
+        {
+            if (!pool || chunks.size() < 2)
+            {
+                for (Chunk &chunk : chunks)
+                {
+                    task(chunk);
+                }
+                return;
+            }
+            std::vector<std::future<void>> pending;
+            pending.reserve(chunks.size());
+            for (Chunk &chunk : chunks)
+            {
+                pending.push_back(pool->Enqueue([&task, &chunk]() { task(chunk); }));
+            }
+            for (std::future<void> &future : pending)
+            {
+                future.get();
+            }
+        }
+
+        void buildSubMeshes(const std::vector<Chunk> &chunks, MeshData &mesh)
+        {
+            SubMesh current;
+            size_t cornerBase = 0;
+            auto startSubMesh = [&](size_t firstCorner)
+            {
+                current.indexCount = static_cast<uint32_t>(firstCorner) - current.firstIndex;
+                if (current.indexCount > 0)
+                {
+                    mesh.subMeshes.push_back(current);
+                }
+                current.firstIndex = static_cast<uint32_t>(firstCorner);
+            };
+
+            for (const Chunk &chunk : chunks)
+            {
+                for (const Marker &marker : chunk.markers)
+                {
+                    startSubMesh(cornerBase + marker.corner);
+                    (marker.kind == Marker::Group ? current.name : current.material) = marker.name;
+                }
+                cornerBase += chunk.corners.size();
+            }
+            startSubMesh(cornerBase);
+        }
+    } // namespace
+
+    bool ObjLoader::load(const std::string &path, MeshData &mesh, ThreadPool *pool, Stats *stats)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        AssetFile file;
+        if (!file.open(path))
+        {
+            LOG_ERROR("ObjLoader: cannot open '{}'.", path);
+            return false;
+        }
+        const double mapMs = millisecondsSince(start);
+
+        Stats localStats;
+        Stats &result = stats ? *stats : localStats;
+        if (!parse(reinterpret_cast<const char *>(file.data()), file.size(), path, mesh, pool, &result))
+        {
+            return false;
+        }
+        result.mapMs = mapMs;
+        result.totalMs = millisecondsSince(start);
+        LOG_DEBUG("ObjLoader: '{}' ({} vertices, {} triangles, {} submeshes) in {:.2f} ms ({} chunks: parse {:.2f} ms, "
+                  "index {:.2f} ms)",
+                  path, mesh.vertices.size(), mesh.getTriangleCount(), mesh.subMeshes.size(), result.totalMs,
+                  result.chunks, result.parseMs, result.indexMs);
+        return true;
+    }
+
+    bool ObjLoader::parse(const char *text, size_t size, const std::string &name, MeshData &mesh, ThreadPool *pool,
+                          Stats *stats)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        mesh = MeshData();
+
+        std::vector<Chunk> chunks = splitChunks(text, size, pool);
+        forEachChunk(chunks, pool, [](Chunk &chunk) { parseChunk(chunk); });
+        const double parseMs = millisecondsSince(start);
+        const auto indexStart = std::chrono::steady_clock::now();
+
+        size_t positionCount = 0;
+        size_t texCoordCount = 0;
+        size_t normalCount = 0;
+        size_t cornerCount = 0;
+        size_t skippedLines = 0;
+        for (Chunk &chunk : chunks)
+        {
+            chunk.positionBase = positionCount;
+            chunk.texCoordBase = texCoordCount;
+            chunk.normalBase = normalCount;
+            positionCount += chunk.positions.size();
+            texCoordCount += chunk.texCoords.size();
+            normalCount += chunk.normals.size();
+            cornerCount += chunk.corners.size();
+            skippedLines += chunk.skippedLines;
+        }
+        if (skippedLines > 0)
+        {
+            LOG_WARN("ObjLoader: skipped {} malformed line(s) in '{}'.", skippedLines, name);
+        }
+        if (cornerCount == 0)
+        {
+            LOG_ERROR("ObjLoader: '{}' has no faces.", name);
+            return false;
+        }
+        if (cornerCount > UINT32_MAX)
+        {
+            LOG_ERROR("ObjLoader: '{}' is too large for 32-bit indices.", name);
+            return false;
+        }
+
+        forEachChunk(chunks, pool, [&](Chunk &chunk) { resolveChunk(chunk, positionCount, texCoordCount, normalCount); });
+        for (const Chunk &chunk : chunks)
+        {
+            if (!chunk.valid)
+            {
+                LOG_ERROR("ObjLoader: '{}' references a vertex that does not exist.", name);
+                return false;
+            }
+        }
+
+        // Attribute streams in file order, then one pass over the corners to weld them.
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec2> texCoords;
+        std::vector<glm::vec3> normals;
+        positions.reserve(positionCount);
+        texCoords.reserve(texCoordCount);
+        normals.reserve(normalCount);
+        for (const Chunk &chunk : chunks)
+        {
+            positions.insert(positions.end(), chunk.positions.begin(), chunk.positions.end());
+            texCoords.insert(texCoords.end(), chunk.texCoords.begin(), chunk.texCoords.end());
+            normals.insert(normals.end(), chunk.normals.begin(), chunk.normals.end());
+        }
+
+        CornerMap map(positionCount);
+        mesh.indices.reserve(cornerCount);
+        mesh.vertices.reserve(positionCount);
+        bool missingNormals = false;
+        for (const Chunk &chunk : chunks)
+        {
+            for (const Corner &corner : chunk.corners)
+            {
+                const uint32_t next = static_cast<uint32_t>(mesh.vertices.size());
+                const uint32_t vertex = map.findOrInsert(corner, next);
+                if (vertex == next)
+                {
+                    MeshVertex &added = mesh.vertices.emplace_back();
+                    added.position = positions[corner.position];
+                    if (corner.texCoord != kMissing)
+                    {
+                        added.texCoord = texCoords[corner.texCoord];
+                    }
+                    if (corner.normal != kMissing)
+                    {
+                        added.normal = normals[corner.normal];
+                    }
+                    missingNormals = missingNormals || corner.normal == kMissing;
+                }
+                mesh.indices.push_back(vertex);
+            }
+        }
+        if (missingNormals)
+        {
+            mesh.computeNormals();
+        }
+        buildSubMeshes(chunks, mesh);
+        mesh.computeBounds();
+
+        if (stats)
+        {
+            stats->fileBytes = size;
+            stats->chunks = chunks.size();
+            stats->corners = cornerCount;
+            stats->parseMs = parseMs;
+            stats->indexMs = millisecondsSince(indexStart);
+            stats->totalMs = millisecondsSince(start);
+        }
+        return true;
+    }
+
+} // namespace Base
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "Mesh.hpp"
+#include "ThreadPool.hpp"
+
+namespace Base
+{
+    // Wavefront .obj reader built for load time rather than completeness: the file is
+    // memory-mapped, cut into line-aligned chunks that are parsed in parallel (with a hand-written
+    // float parser instead of strtof), and the v/vt/vn corners are welded into an indexed mesh
+    // through a flat open-addressing hash map. Polygons are fanned into triangles, `o`/`g` and
+    // `usemtl` start new submeshes, and normals are generated when the file has none. Materials
+    // (.mtl), lines, points and free-form geometry are ignored.
+    //
+    // tools/MeshBench compares it with assimp's OBJ importer.
+    class ObjLoader
+    {
+    public:
+        struct Stats
+        {
+            size_t fileBytes = 0;
+            size_t chunks = 0;
+            size_t corners = 0; // Face corners before welding
+            double mapMs = 0.0;
+            double parseMs = 0.0;
+            double indexMs = 0.0; // Index resolution, welding and normal generation
+            double totalMs = 0.0;
+        };
+
+        // `path` is relative to the assets directory. With a started `pool`, the chunks are parsed
+        // on its workers; do not call this from one of that pool's own tasks.
+        static bool load(const std::string &path, MeshData &mesh, ThreadPool *pool = nullptr, Stats *stats = nullptr);
+        // Same for a file that is already in memory. `name` is only used in messages.
+        static bool parse(const char *text, size_t size, const std::string &name, MeshData &mesh,
+                          ThreadPool *pool = nullptr, Stats *stats = nullptr);
+    };
+
+} // namespace Base
@@ -0,0 +1,374 @@
+#include "PakFile.hpp"
+#include "Log.hpp"
+#include "Lz4.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace Base
+{
+    namespace
+    {
+        constexpr char kMagic[4] = {'C', 'G', 'P', 'K'};
+        constexpr size_t kDataAlignment = 64;
+
+        struct FileHeader
+        {
+            char magic[4];
+            uint32_t version;
+            uint32_t entryCount;
+            uint32_t bucketCount;
+            uint64_t bucketOffset;
+            uint64_t entryOffset;
+            uint64_t stringOffset;
+            uint64_t fileSize;
+        };
+
+        struct FileEntry
+        {
+            uint64_t pathHash;
+            uint64_t offset;
+            uint64_t size;
+            uint64_t storedSize;
+            uint32_t pathOffset;
+            uint32_t pathLength;
+            uint32_t compression;
+            uint32_t reserved;
+        };
+
+        size_t alignUp(size_t value, size_t alignment)
+        {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+
+        template <typename T>
+        void writeAt(std::vector<uint8_t> &out, size_t offset, const T &value)
+        {
+            std::memcpy(out.data() + offset, &value, sizeof(T));
+        }
+
+        template <typename T>
+        T readAt(const uint8_t *data, size_t offset)
+        {
+            T value;
+            std::memcpy(&value, data + offset, sizeof(T));
+            return value;
+        }
+
+        bool inBounds(uint64_t offset, uint64_t size, size_t fileSize)
+        {
+            return offset <= fileSize && size <= fileSize - offset;
+        }
+
+        bool readWholeFile(const std::filesystem::path &path, std::vector<uint8_t> &out)
+        {
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            if (!file)
+            {
+                return false;
+            }
+            out.resize(static_cast<size_t>(file.tellg()));
+            file.seekg(0);
+            return out.empty() || file.read(reinterpret_cast<char *>(out.data()), static_cast<std::streamsize>(out.size()));
+        }
+    } // namespace
+
+    std::string PakFile::normalizePath(std::string_view path)
+    {
+        std::string normalized(path);
+        std::replace(normalized.begin(), normalized.end(), '\\', '/');
+        while (normalized.rfind("./", 0) == 0)
+        {
+            normalized.erase(0, 2);
+        }
+        size_t start = normalized.find_first_not_of('/');
+        return start == std::string::npos ? std::string() : normalized.substr(start);
+    }
+
+    uint64_t PakFile::hashPath(std::string_view normalizedPath)
+    {
+        uint64_t hash = 0xCBF29CE484222325ull;
+        for (char c : normalizedPath)
+        {
+            hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001B3ull;
+        }
+        return hash;
+    }
+
+    bool PakFile::build(const std::string &directory, const std::string &path)
+    {
+        return build(directory, path, BuildOptions());
+    }
+
+    bool PakFile::build(const std::string &directory, const std::string &path, const BuildOptions &options,
+                        BuildReport *report)
+    {
+        std::error_code error;
+        std::vector<std::string> paths;
+        for (std::filesystem::recursive_directory_iterator it(directory, error), end; !error && it != end; it.increment(error))
+        {
+            if (it->is_regular_file(error))
+            {
+                paths.push_back(normalizePath(std::filesystem::relative(it->path(), directory, error).generic_string()));
+            }
+        }
+        if (error)
+        {
+            LOG_ERROR("PakFile: cannot list '{}': {}", directory, error.message());
+            return false;
+        }
+        // Sorted, so the same tree always gives the same archive.
+        std::sort(paths.begin(), paths.end());
+
+        uint32_t bucketCount = 1;
+        while (bucketCount < paths.size() * 2)
+        {
+            bucketCount *= 2;
+        }
+
+        std::string strings;
+        std::vector<FileEntry> entries(paths.size());
+        std::vector<std::vector<uint8_t>> blobs(paths.size());
+        BuildReport result;
+        for (size_t i = 0; i < paths.size(); ++i)
+        {
+            std::vector<uint8_t> contents;
+            if (!readWholeFile(std::filesystem::path(directory) / paths[i], contents))
+            {
+                LOG_ERROR("PakFile: cannot read '{}'.", paths[i]);
+                return false;
+            }
+            FileEntry &entry = entries[i];
+            entry = {hashPath(paths[i]), 0, contents.size(), contents.size(), static_cast<uint32_t>(strings.size()),
+                     static_cast<uint32_t>(paths[i].size()), static_cast<uint32_t>(Compression::None), 0};
+            strings += paths[i];
+            result.sourceBytes += contents.size();
+
+            if (options.compress && !contents.empty())
+            {
+                std::vector<uint8_t> packed(Lz4::compressBound(contents.size()));
+                const size_t packedSize = Lz4::compress(contents.data(), contents.size(), packed.data(), packed.size());
+                if (packedSize > 0 && packedSize <= contents.size() * (1.0f - options.minSavings))
+                {
+                    packed.resize(packedSize);
+                    contents = std::move(packed);
+                    entry.storedSize = packedSize;
+                    entry.compression = static_cast<uint32_t>(Compression::Lz4);
+                    ++result.compressed;
+                }
+            }
+            blobs[i] = std::move(contents);
+        }
+
+        FileHeader header = {};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.entryCount = static_cast<uint32_t>(entries.size());
+        header.bucketCount = bucketCount;
+        header.bucketOffset = sizeof(FileHeader);
+        header.entryOffset = alignUp(header.bucketOffset + bucketCount * sizeof(uint32_t), 8);
+        header.stringOffset = header.entryOffset + entries.size() * sizeof(FileEntry);
+        size_t offset = header.stringOffset + strings.size();
+        for (size_t i = 0; i < entries.size(); ++i)
+        {
+            offset = alignUp(offset, kDataAlignment);
+            entries[i].offset = offset;
+            offset += blobs[i].size();
+        }
+        header.fileSize = offset;
+
+        std::vector<uint8_t> bytes(header.fileSize, 0);
+        writeAt(bytes, 0, header);
+        std::vector<uint32_t> buckets(bucketCount, 0);
+        for (uint32_t i = 0; i < entries.size(); ++i)
+        {
+            uint32_t slot = static_cast<uint32_t>(entries[i].pathHash) & (bucketCount - 1);
+            while (buckets[slot] != 0)
+            {
+                slot = (slot + 1) & (bucketCount - 1);
+            }
+            buckets[slot] = i + 1;
+        }
+        std::memcpy(bytes.data() + header.bucketOffset, buckets.data(), buckets.size() * sizeof(uint32_t));
+        for (size_t i = 0; i < entries.size(); ++i)
+        {
+            writeAt(bytes, header.entryOffset + i * sizeof(FileEntry), entries[i]);
+            if (!blobs[i].empty())
+            {
+                std::memcpy(bytes.data() + entries[i].offset, blobs[i].data(), blobs[i].size());
+            }
+        }
+        std::memcpy(bytes.data() + header.stringOffset, strings.data(), strings.size());
+
+        const std::string temporary = path + ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            if (!file.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size())))
+            {
+                LOG_ERROR("PakFile: cannot write '{}'.", temporary);
+                return false;
+            }
+        }
+        std::filesystem::rename(temporary, path, error);
+        if (error)
+        {
+            LOG_ERROR("PakFile: cannot rename '{}' to '{}': {}", temporary, path, error.message());
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+
+        result.files = entries.size();
+        result.bytes = bytes.size();
+        if (report)
+        {
+            *report = result;
+        }
+        return true;
+    }
+
+    bool PakFile::open(const std::string &path)
+    {
+        close();
+        if (!m_File.open(path, false))
+        {
+            return false;
+        }
+        m_Data = m_File.data();
+        m_Size = m_File.size();
+        return parse(path);
+    }
+
+    void PakFile::close()
+    {
+        m_File.close();
+        m_Data = nullptr;
+        m_Size = 0;
+        m_EntryCount = 0;
+        m_BucketMask = 0;
+        m_Buckets = nullptr;
+        m_Entries = nullptr;
+        m_Strings = nullptr;
+        m_StringBytes = 0;
+    }
+
+    bool PakFile::parse(const std::string &name)
+    {
+        if (m_Size < sizeof(FileHeader) || std::memcmp(m_Data, kMagic, sizeof(kMagic)) != 0)
+        {
+            LOG_ERROR("PakFile: '{}' is not an archive.", name);
+            close();
+            return false;
+        }
+        const FileHeader header = readAt<FileHeader>(m_Data, 0);
+        if (header.version != kVersion)
+        {
+            LOG_ERROR("PakFile: '{}' has version {}, expected {}; rebuild it.", name, header.version, kVersion);
+            close();
+            return false;
+        }
+        const bool valid = header.fileSize == m_Size && header.bucketCount != 0 &&
+                           (header.bucketCount & (header.bucketCount - 1)) == 0 && header.entryCount < header.bucketCount &&
+                           inBounds(header.bucketOffset, uint64_t(header.bucketCount) * sizeof(uint32_t), m_Size) &&
+                           inBounds(header.entryOffset, uint64_t(header.entryCount) * sizeof(FileEntry), m_Size) &&
+                           header.stringOffset <= m_Size;
+        if (!valid)
+        {
+            LOG_ERROR("PakFile: '{}' is truncated or corrupt.", name);
+            close();
+            return false;
+        }
+        m_EntryCount = header.entryCount;
+        m_BucketMask = header.bucketCount - 1;
+        m_Buckets = m_Data + header.bucketOffset;
+        m_Entries = m_Data + header.entryOffset;
+        m_Strings = reinterpret_cast<const char *>(m_Data + header.stringOffset);
+        m_StringBytes = m_Size - header.stringOffset;
+
+        // Checked once here, so lookups can trust the table.
+        for (uint32_t i = 0; i < m_EntryCount; ++i)
+        {
+            const FileEntry entry = readAt<FileEntry>(m_Entries, i * sizeof(FileEntry));
+            if (!inBounds(entry.offset, entry.storedSize, m_Size) || !inBounds(entry.pathOffset, entry.pathLength, m_StringBytes) ||
+                entry.compression > static_cast<uint32_t>(Compression::Lz4) ||
+                (entry.compression == static_cast<uint32_t>(Compression::None) && entry.size != entry.storedSize))
+            {
+                LOG_ERROR("PakFile: '{}' has a corrupt entry table.", name);
+                close();
+                return false;
+            }
+        }
+        LOG_INFO("PakFile: '{}' with {} entries ({} KB){}.", name, m_EntryCount, m_Size / 1024,
+                 isMapped() ? ", mapped" : "");
+        return true;
+    }
+
+    PakFile::Entry PakFile::entryAt(uint32_t index) const
+    {
+        const FileEntry entry = readAt<FileEntry>(m_Entries, index * sizeof(FileEntry));
+        Entry result;
+        result.path = std::string_view(m_Strings + entry.pathOffset, entry.pathLength);
+        result.data = m_Data + entry.offset;
+        result.size = static_cast<size_t>(entry.size);
+        result.storedSize = static_cast<size_t>(entry.storedSize);
+        result.compression = static_cast<Compression>(entry.compression);
+        return result;
+    }
+
+    bool PakFile::find(std::string_view path, Entry &entry) const
+    {
+        if (!isOpen())
+        {
+            return false;
+        }
+        const std::string normalized = normalizePath(path);
+        const uint64_t hash = hashPath(normalized);
+        // Written at most half full, so a probe reaches an empty bucket; the cap guards corrupt tables.
+        uint32_t slot = static_cast<uint32_t>(hash) & m_BucketMask;
+        for (uint64_t probe = 0; probe <= m_BucketMask; ++probe, slot = (slot + 1) & m_BucketMask)
+        {
+            const uint32_t index = readAt<uint32_t>(m_Buckets, slot * sizeof(uint32_t));
+            if (index == 0 || index > m_EntryCount)
+            {
+                return false;
+            }
+            if (readAt<uint64_t>(m_Entries, (index - 1) * sizeof(FileEntry)) == hash)
+            {
+                entry = entryAt(index - 1);
+                if (entry.path == normalized)
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    bool PakFile::contains(std::string_view path) const
+    {
+        Entry entry;
+        return find(path, entry);
+    }
+
+    bool PakFile::read(const Entry &entry, std::vector<uint8_t> &out)
+    {
+        out.resize(entry.size);
+        if (entry.compression == Compression::None)
+        {
+            if (entry.size > 0)
+            {
+                std::memcpy(out.data(), entry.data, entry.size);
+            }
+            return true;
+        }
+        if (!Lz4::decompress(entry.data, entry.storedSize, out.data(), out.size()))
+        {
+            LOG_ERROR("PakFile: '{}' does not decompress.", entry.path);
+            out.clear();
+            return false;
+        }
+        return true;
+    }
+
+} // namespace Base
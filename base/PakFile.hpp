@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "MappedFile.hpp"
+
+namespace Base
+{
+    // Packed asset archive (.pak): every file of an asset tree in one memory-mapped file, so a
+    // lookup is a hash probe and reading an uncompressed entry is a pointer into the mapping:
+    //
+    //   Header          magic "CGPK", version, entry and bucket counts, section offsets
+    //   Bucket table    open-addressed hash table of entry indices + 1 (0 = empty), power of two
+    //   Entry table     path hash, data offset, size, stored size, path range, compression
+    //   String blob     paths relative to the archive root, '/'-separated, not terminated
+    //   Data            one blob per entry, 64-byte aligned, stored as is or LZ4-compressed
+    //
+    // Everything is little-endian, which all supported platforms are.
+    class PakFile
+    {
+    public:
+        static constexpr uint32_t kVersion = 1;
+
+        enum class Compression : uint32_t
+        {
+            None = 0,
+            Lz4 = 1
+        };
+
+        struct Entry
+        {
+            std::string_view path;
+            const uint8_t *data = nullptr; // Stored bytes, inside the mapping
+            size_t size = 0;               // Uncompressed
+            size_t storedSize = 0;
+            Compression compression = Compression::None;
+        };
+
+        struct BuildOptions
+        {
+            bool compress = true;
+            // Entries are only kept compressed when that saves at least this fraction.
+            float minSavings = 0.1f;
+        };
+
+        struct BuildReport
+        {
+            size_t files = 0;
+            size_t compressed = 0;
+            size_t sourceBytes = 0;
+            size_t bytes = 0;
+        };
+
+        PakFile() = default;
+
+        // Packs every file under `directory` into `path` (written to a temporary file and renamed).
+        static bool build(const std::string &directory, const std::string &path, const BuildOptions &options,
+                          BuildReport *report = nullptr);
+        static bool build(const std::string &directory, const std::string &path);
+
+        // "./shaders\\a.vert" -> "shaders/a.vert"; the form paths are stored and looked up in.
+        static std::string normalizePath(std::string_view path);
+        // FNV-1a of the normalized path.
+        static uint64_t hashPath(std::string_view normalizedPath);
+
+        // Maps an archive (full path) and checks its header. Quietly false if there is none.
+        bool open(const std::string &path);
+        void close();
+
+        bool isOpen() const { return m_Data != nullptr; }
+        bool isMapped() const { return m_File.isMapped(); }
+        size_t getEntryCount() const { return m_EntryCount; }
+        size_t getByteSize() const { return m_Size; }
+
+        // `path` relative to the archive root, in any form normalizePath accepts.
+        bool find(std::string_view path, Entry &entry) const;
+        bool contains(std::string_view path) const;
+        // Uncompressed contents of `entry` into `out`.
+        static bool read(const Entry &entry, std::vector<uint8_t> &out);
+
+    private:
+        bool parse(const std::string &name);
+        Entry entryAt(uint32_t index) const;
+
+        MappedFile m_File;
+        const uint8_t *m_Data = nullptr;
+        size_t m_Size = 0;
+        uint32_t m_EntryCount = 0;
+        uint32_t m_BucketMask = 0;
+        const uint8_t *m_Buckets = nullptr;
+        const uint8_t *m_Entries = nullptr;
+        const char *m_Strings = nullptr;
+        size_t m_StringBytes = 0;
+    };
+
+} // namespace Base
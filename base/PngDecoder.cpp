@@ -0,0 +1,421 @@
+#include "PngDecoder.hpp"
+#include "Log.hpp"
+
+#include <stb_image.h>
+
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+    #include <arm_neon.h>
+    #define PNG_DECODER_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define PNG_DECODER_SSE2 1
+#endif
+
+namespace Base
+{
+    namespace
+    {
+        constexpr uint8_t kSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+        enum Filter : uint8_t
+        {
+            FilterNone = 0,
+            FilterSub = 1,
+            FilterUp = 2,
+            FilterAverage = 3,
+            FilterPaeth = 4
+        };
+
+        uint32_t readU32(const uint8_t *data)
+        {
+            return (uint32_t(data[0]) << 24) | (uint32_t(data[1]) << 16) | (uint32_t(data[2]) << 8) | data[3];
+        }
+
+        // Channels of a supported color type, 0 otherwise.
+        int channelsOf(uint8_t colorType)
+        {
+            switch (colorType)
+            {
+            case 0: return 1; // Gray
+            case 2: return 3; // RGB
+            case 4: return 2; // Gray + alpha
+            case 6: return 4; // RGBA
+            default: return 0;
+            }
+        }
+
+        // Frees ImageDecoder::allocate memory on scope exit.
+        struct ScopedBuffer
+        {
+            void *memory = nullptr;
+            ~ScopedBuffer() { ImageDecoder::release(memory); }
+        };
+
+        uint8_t paethScalar(int a, int b, int c)
+        {
+            const int pa = std::abs(b - c);
+            const int pb = std::abs(a - c);
+            const int pc = std::abs(a + b - 2 * c);
+            if (pa <= pb && pa <= pc)
+            {
+                return static_cast<uint8_t>(a);
+            }
+            return static_cast<uint8_t>(pb <= pc ? b : c);
+        }
+
+        void unfilterUp(const uint8_t *source, const uint8_t *prior, uint8_t *row, size_t size)
+        {
+            size_t i = 0;
+#if PNG_DECODER_SSE2
+            for (; i + 16 <= size; i += 16)
+            {
+                const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i));
+                const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(prior + i));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(row + i), _mm_add_epi8(x, b));
+            }
+#elif PNG_DECODER_NEON
+            for (; i + 16 <= size; i += 16)
+            {
+                vst1q_u8(row + i, vaddq_u8(vld1q_u8(source + i), vld1q_u8(prior + i)));
+            }
+#endif
+            for (; i < size; ++i)
+            {
+                row[i] = static_cast<uint8_t>(source[i] + prior[i]);
+            }
+        }
+
+        // Sub, Average and Paeth depend on the pixel to the left, so they run one pixel at a time;
+        // for 3 and 4 bytes per pixel all channels share one vector.
+#if PNG_DECODER_SSE2
+        using Pixel = __m128i;
+
+        template <int Bpp>
+        Pixel loadPixel(const uint8_t *pixel)
+        {
+            uint32_t value = 0;
+            std::memcpy(&value, pixel, Bpp);
+            return _mm_cvtsi32_si128(static_cast<int>(value));
+        }
+
+        template <int Bpp>
+        void storePixel(uint8_t *pixel, Pixel value)
+        {
+            const uint32_t bits = static_cast<uint32_t>(_mm_cvtsi128_si32(value));
+            std::memcpy(pixel, &bits, Bpp);
+        }
+
+        Pixel zeroPixel() { return _mm_setzero_si128(); }
+        Pixel addPixels(Pixel a, Pixel b) { return _mm_add_epi8(a, b); }
+
+        Pixel averagePixels(Pixel a, Pixel b)
+        {
+            // _mm_avg_epu8 rounds up; PNG truncates.
+            return _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), _mm_set1_epi8(1)));
+        }
+
+        Pixel paethPixels(Pixel a, Pixel b, Pixel c)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i a16 = _mm_unpacklo_epi8(a, zero);
+            const __m128i b16 = _mm_unpacklo_epi8(b, zero);
+            const __m128i c16 = _mm_unpacklo_epi8(c, zero);
+            const __m128i bc = _mm_sub_epi16(b16, c16);
+            const __m128i ac = _mm_sub_epi16(a16, c16);
+            const __m128i abc = _mm_add_epi16(bc, ac);
+            const __m128i pa = _mm_max_epi16(bc, _mm_sub_epi16(zero, bc));
+            const __m128i pb = _mm_max_epi16(ac, _mm_sub_epi16(zero, ac));
+            const __m128i pc = _mm_max_epi16(abc, _mm_sub_epi16(zero, abc));
+
+            // b unless pb > pc, then a unless pa > min(pb, pc).
+            const __m128i useC = _mm_cmpgt_epi16(pb, pc);
+            const __m128i predictBc = _mm_or_si128(_mm_and_si128(useC, c16), _mm_andnot_si128(useC, b16));
+            const __m128i useBc = _mm_cmpgt_epi16(pa, _mm_min_epi16(pb, pc));
+            const __m128i predict = _mm_or_si128(_mm_and_si128(useBc, predictBc), _mm_andnot_si128(useBc, a16));
+            return _mm_packus_epi16(predict, predict);
+        }
+#elif PNG_DECODER_NEON
+        using Pixel = uint8x8_t;
+
+        template <int Bpp>
+        Pixel loadPixel(const uint8_t *pixel)
+        {
+            uint32_t value = 0;
+            std::memcpy(&value, pixel, Bpp);
+            return vreinterpret_u8_u32(vdup_n_u32(value));
+        }
+
+        template <int Bpp>
+        void storePixel(uint8_t *pixel, Pixel value)
+        {
+            const uint32_t bits = vget_lane_u32(vreinterpret_u32_u8(value), 0);
+            std::memcpy(pixel, &bits, Bpp);
+        }
+
+        Pixel zeroPixel() { return vdup_n_u8(0); }
+        Pixel addPixels(Pixel a, Pixel b) { return vadd_u8(a, b); }
+        Pixel averagePixels(Pixel a, Pixel b) { return vhadd_u8(a, b); }
+
+        Pixel paethPixels(Pixel a, Pixel b, Pixel c)
+        {
+            const int16x8_t a16 = vreinterpretq_s16_u16(vmovl_u8(a));
+            const int16x8_t b16 = vreinterpretq_s16_u16(vmovl_u8(b));
+            const int16x8_t c16 = vreinterpretq_s16_u16(vmovl_u8(c));
+            const int16x8_t pa = vabdq_s16(b16, c16);
+            const int16x8_t pb = vabdq_s16(a16, c16);
+            const int16x8_t pc = vabsq_s16(vsubq_s16(vaddq_s16(a16, b16), vshlq_n_s16(c16, 1)));
+
+            const uint16x8_t useC = vcgtq_s16(pb, pc);
+            const int16x8_t predictBc = vbslq_s16(useC, c16, b16);
+            const uint16x8_t useBc = vcgtq_s16(pa, vminq_s16(pb, pc));
+            return vmovn_u16(vreinterpretq_u16_s16(vbslq_s16(useBc, predictBc, a16)));
+        }
+#endif
+
+#if PNG_DECODER_SSE2 || PNG_DECODER_NEON
+        template <int Bpp>
+        void unfilterPixels(uint8_t filter, const uint8_t *source, const uint8_t *prior, uint8_t *row, size_t size)
+        {
+            Pixel left = zeroPixel();
+            Pixel upperLeft = zeroPixel();
+            for (size_t i = 0; i < size; i += Bpp)
+            {
+                const Pixel x = loadPixel<Bpp>(source + i);
+                if (filter == FilterSub)
+                {
+                    left = addPixels(x, left);
+                }
+                else if (filter == FilterAverage)
+                {
+                    left = addPixels(x, averagePixels(left, loadPixel<Bpp>(prior + i)));
+                }
+                else
+                {
+                    const Pixel up = loadPixel<Bpp>(prior + i);
+                    left = addPixels(x, paethPixels(left, up, upperLeft));
+                    upperLeft = up;
+                }
+                storePixel<Bpp>(row + i, left);
+            }
+        }
+#endif
+
+        void unfilterScalar(uint8_t filter, const uint8_t *source, const uint8_t *prior, uint8_t *row, size_t size, int bpp)
+        {
+            for (size_t i = 0; i < size; ++i)
+            {
+                const int a = i >= static_cast<size_t>(bpp) ? row[i - bpp] : 0;
+                const int c = i >= static_cast<size_t>(bpp) ? prior[i - bpp] : 0;
+                int predict = 0;
+                switch (filter)
+                {
+                case FilterSub: predict = a; break;
+                case FilterAverage: predict = (a + prior[i]) >> 1; break;
+                default: predict = paethScalar(a, prior[i], c); break;
+                }
+                row[i] = static_cast<uint8_t>(source[i] + predict);
+            }
+        }
+
+        bool unfilterRow(uint8_t filter, const uint8_t *source, const uint8_t *prior, uint8_t *row, size_t size, int bpp)
+        {
+            switch (filter)
+            {
+            case FilterNone:
+                std::memcpy(row, source, size);
+                return true;
+            case FilterUp:
+                unfilterUp(source, prior, row, size);
+                return true;
+            case FilterSub:
+            case FilterAverage:
+            case FilterPaeth:
+#if PNG_DECODER_SSE2 || PNG_DECODER_NEON
+                if (bpp == 4)
+                {
+                    unfilterPixels<4>(filter, source, prior, row, size);
+                    return true;
+                }
+                if (bpp == 3)
+                {
+                    unfilterPixels<3>(filter, source, prior, row, size);
+                    return true;
+                }
+#endif
+                unfilterScalar(filter, source, prior, row, size, bpp);
+                return true;
+            default:
+                return false;
+            }
+        }
+    } // namespace
+
+    bool PngDecoder::canDecode(const uint8_t *data, size_t size) const
+    {
+        // Signature, then IHDR as the first chunk.
+        if (size < 33 || std::memcmp(data, kSignature, sizeof(kSignature)) != 0 || std::memcmp(data + 12, "IHDR", 4) != 0)
+        {
+            return false;
+        }
+        const uint8_t bitDepth = data[24];
+        const uint8_t colorType = data[25];
+        const uint8_t interlace = data[28];
+        return bitDepth == 8 && channelsOf(colorType) != 0 && data[26] == 0 && data[27] == 0 && interlace == 0;
+    }
+
+    bool PngDecoder::decode(const uint8_t *data, size_t size, ImageData &image) const
+    {
+        if (!canDecode(data, size))
+        {
+            return false;
+        }
+        const uint32_t width = readU32(data + 16);
+        const uint32_t height = readU32(data + 20);
+        int channels = channelsOf(data[25]);
+        if (width == 0 || height == 0 || width > (1u << 24) || height > (1u << 24))
+        {
+            return false;
+        }
+        const size_t rowSize = static_cast<size_t>(width) * channels;
+        const size_t filteredSize = (rowSize + 1) * height;
+        if (filteredSize > static_cast<size_t>(INT32_MAX))
+        {
+            return false;
+        }
+
+        // Collect the IDAT chunks; most files have one, which is inflated in place.
+        const uint8_t *compressed = nullptr;
+        size_t compressedSize = 0;
+        ScopedBuffer joined;
+        // tRNS of a gray or RGB image: one 16-bit sample per channel marking the transparent color.
+        uint8_t colorKey[3] = {};
+        bool hasColorKey = false;
+        for (size_t offset = sizeof(kSignature); offset + 12 <= size;)
+        {
+            const uint32_t length = readU32(data + offset);
+            const uint8_t *type = data + offset + 4;
+            const uint8_t *payload = data + offset + 8;
+            if (length > size - offset - 12)
+            {
+                return false;
+            }
+            if (std::memcmp(type, "IDAT", 4) == 0)
+            {
+                if (!compressed)
+                {
+                    compressed = payload;
+                }
+                else
+                {
+                    if (!joined.memory)
+                    {
+                        joined.memory = ImageDecoder::allocate(compressedSize);
+                        std::memcpy(joined.memory, compressed, compressedSize);
+                    }
+                    void *grown = ImageDecoder::reallocate(joined.memory, compressedSize + length);
+                    if (!grown)
+                    {
+                        return false;
+                    }
+                    joined.memory = grown;
+                    std::memcpy(static_cast<uint8_t *>(joined.memory) + compressedSize, payload, length);
+                    compressed = static_cast<const uint8_t *>(joined.memory);
+                }
+                compressedSize += length;
+            }
+            else if (std::memcmp(type, "tRNS", 4) == 0 && (channels == 1 || channels == 3) &&
+                     length >= static_cast<uint32_t>(channels) * 2)
+            {
+                // An 8-bit image has no sample with a nonzero high byte, so such a key matches nothing.
+                hasColorKey = true;
+                for (int c = 0; c < channels; ++c)
+                {
+                    colorKey[c] = payload[c * 2 + 1];
+                    hasColorKey = hasColorKey && payload[c * 2] == 0;
+                }
+            }
+            else if (std::memcmp(type, "IEND", 4) == 0)
+            {
+                break;
+            }
+            offset += 12 + length;
+        }
+        if (!compressed)
+        {
+            return false;
+        }
+
+        int inflatedSize = 0;
+        ScopedBuffer filtered;
+        filtered.memory = stbi_zlib_decode_malloc_guesssize_headerflag(reinterpret_cast<const char *>(compressed),
+                                                                       static_cast<int>(compressedSize),
+                                                                       static_cast<int>(filteredSize), &inflatedSize, 1);
+        if (!filtered.memory || static_cast<size_t>(inflatedSize) < filteredSize)
+        {
+            return false;
+        }
+
+        ScopedBuffer zeroRow;
+        zeroRow.memory = ImageDecoder::allocate(rowSize);
+        auto *pixels = static_cast<uint8_t *>(ImageDecoder::allocate(rowSize * height));
+        if (!zeroRow.memory || !pixels)
+        {
+            ImageDecoder::release(pixels);
+            return false;
+        }
+        std::memset(zeroRow.memory, 0, rowSize);
+
+        // File rows run top to bottom; write them bottom up. The row above in the file is the
+        // one just written below in memory.
+        const auto *source = static_cast<const uint8_t *>(filtered.memory);
+        for (uint32_t y = 0; y < height; ++y, source += rowSize + 1)
+        {
+            uint8_t *row = pixels + (height - 1 - y) * rowSize;
+            const uint8_t *prior = y == 0 ? static_cast<const uint8_t *>(zeroRow.memory) : row + rowSize;
+            if (!unfilterRow(source[0], source + 1, prior, row, rowSize, channels))
+            {
+                ImageDecoder::release(pixels);
+                return false;
+            }
+        }
+
+        // Like stb_image, turn the color key into an alpha channel: 0 where a pixel matches it.
+        if (hasColorKey)
+        {
+            const int keyedChannels = channels + 1;
+            const size_t pixelCount = static_cast<size_t>(width) * height;
+            auto *keyed = static_cast<uint8_t *>(ImageDecoder::allocate(pixelCount * keyedChannels));
+            if (!keyed)
+            {
+                ImageDecoder::release(pixels);
+                return false;
+            }
+            for (size_t i = 0; i < pixelCount; ++i)
+            {
+                const uint8_t *in = pixels + i * channels;
+                uint8_t *out = keyed + i * keyedChannels;
+                bool matches = true;
+                for (int c = 0; c < channels; ++c)
+                {
+                    out[c] = in[c];
+                    matches = matches && in[c] == colorKey[c];
+                }
+                out[channels] = matches ? 0 : 255;
+            }
+            ImageDecoder::release(pixels);
+            pixels = keyed;
+            channels = keyedChannels;
+        }
+
+        image = ImageData();
+        image.width = static_cast<int>(width);
+        image.height = static_cast<int>(height);
+        image.channels = channels;
+        image.pixels = pixels;
+        return true;
+    }
+
+} // namespace Base
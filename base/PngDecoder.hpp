@@ -0,0 +1,20 @@
+#pragma once
+
+#include "ImageDecoder.hpp"
+
+namespace Base
+{
+    // PNG decoder for the common case: 8-bit gray, gray+alpha, RGB or RGBA without interlacing.
+    // Inflates with stb_image's zlib, then reverses the row filters with SSE2/NEON (Up 16 bytes at
+    // a time; Sub, Average and Paeth one pixel per vector) while writing the rows bottom first,
+    // which saves stb's separate flip pass. A tRNS color key becomes an alpha channel, as stb_image
+    // does it. Palette, 16-bit and interlaced files go to stb_image.
+    class PngDecoder : public ImageDecoder
+    {
+    public:
+        const char *getName() const override { return "png-simd"; }
+        bool canDecode(const uint8_t *data, size_t size) const override;
+        bool decode(const uint8_t *data, size_t size, ImageData &image) const override;
+    };
+
+} // namespace Base
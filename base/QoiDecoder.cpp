@@ -0,0 +1,261 @@
+#include "QoiDecoder.hpp"
+
+#include <cstring>
+
+namespace Base
+{
+    namespace
+    {
+        constexpr size_t kHeaderSize = 14;
+        constexpr uint8_t kEndMarker[8] = {0, 0, 0, 0, 0, 0, 0, 1};
+
+        constexpr uint8_t kOpIndex = 0x00; // 00xxxxxx
+        constexpr uint8_t kOpDiff = 0x40;  // 01xxxxxx
+        constexpr uint8_t kOpLuma = 0x80;  // 10xxxxxx
+        constexpr uint8_t kOpRun = 0xC0;   // 11xxxxxx
+        constexpr uint8_t kOpRgb = 0xFE;
+        constexpr uint8_t kOpRgba = 0xFF;
+        constexpr uint8_t kMask = 0xC0;
+
+        struct Rgba
+        {
+            uint8_t r = 0;
+            uint8_t g = 0;
+            uint8_t b = 0;
+            uint8_t a = 255;
+
+            bool operator==(const Rgba &other) const
+            {
+                return r == other.r && g == other.g && b == other.b && a == other.a;
+            }
+        };
+
+        int hashOf(const Rgba &pixel)
+        {
+            return (pixel.r * 3 + pixel.g * 5 + pixel.b * 7 + pixel.a * 11) % 64;
+        }
+
+        uint32_t readU32(const uint8_t *data)
+        {
+            return (uint32_t(data[0]) << 24) | (uint32_t(data[1]) << 16) | (uint32_t(data[2]) << 8) | data[3];
+        }
+
+        void writeU32(std::vector<uint8_t> &out, uint32_t value)
+        {
+            out.push_back(static_cast<uint8_t>(value >> 24));
+            out.push_back(static_cast<uint8_t>(value >> 16));
+            out.push_back(static_cast<uint8_t>(value >> 8));
+            out.push_back(static_cast<uint8_t>(value));
+        }
+    } // namespace
+
+    bool QoiDecoder::canDecode(const uint8_t *data, size_t size) const
+    {
+        return size >= kHeaderSize + sizeof(kEndMarker) && std::memcmp(data, "qoif", 4) == 0 &&
+               (data[12] == 3 || data[12] == 4);
+    }
+
+    bool QoiDecoder::decode(const uint8_t *data, size_t size, ImageData &image) const
+    {
+        if (!canDecode(data, size))
+        {
+            return false;
+        }
+        const uint32_t width = readU32(data + 4);
+        const uint32_t height = readU32(data + 8);
+        const int channels = data[12];
+        // The spec caps images at 400 million pixels.
+        if (width == 0 || height == 0 || height >= 400000000u / width)
+        {
+            return false;
+        }
+
+        const size_t rowSize = static_cast<size_t>(width) * channels;
+        auto *pixels = static_cast<uint8_t *>(ImageDecoder::allocate(rowSize * height));
+        if (!pixels)
+        {
+            return false;
+        }
+
+        Rgba index[64] = {};
+        for (Rgba &entry : index)
+        {
+            entry.a = 0;
+        }
+        Rgba pixel;
+        int run = 0;
+        const uint8_t *in = data + kHeaderSize;
+        const uint8_t *end = data + size - sizeof(kEndMarker);
+
+        // Pixels are stored top row first; write the rows bottom up.
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            uint8_t *out = pixels + (height - 1 - y) * rowSize;
+            for (uint32_t x = 0; x < width; ++x, out += channels)
+            {
+                if (run > 0)
+                {
+                    --run;
+                }
+                else if (in < end)
+                {
+                    const uint8_t op = *in++;
+                    if (op == kOpRgb)
+                    {
+                        if (end - in < 3)
+                        {
+                            break;
+                        }
+                        pixel.r = in[0];
+                        pixel.g = in[1];
+                        pixel.b = in[2];
+                        in += 3;
+                    }
+                    else if (op == kOpRgba)
+                    {
+                        if (end - in < 4)
+                        {
+                            break;
+                        }
+                        pixel = {in[0], in[1], in[2], in[3]};
+                        in += 4;
+                    }
+                    else if ((op & kMask) == kOpIndex)
+                    {
+                        pixel = index[op];
+                    }
+                    else if ((op & kMask) == kOpDiff)
+                    {
+                        pixel.r = static_cast<uint8_t>(pixel.r + ((op >> 4) & 3) - 2);
+                        pixel.g = static_cast<uint8_t>(pixel.g + ((op >> 2) & 3) - 2);
+                        pixel.b = static_cast<uint8_t>(pixel.b + (op & 3) - 2);
+                    }
+                    else if ((op & kMask) == kOpLuma)
+                    {
+                        if (in == end)
+                        {
+                            break;
+                        }
+                        const uint8_t next = *in++;
+                        const int dg = (op & 0x3F) - 32;
+                        pixel.r = static_cast<uint8_t>(pixel.r + dg - 8 + ((next >> 4) & 0x0F));
+                        pixel.g = static_cast<uint8_t>(pixel.g + dg);
+                        pixel.b = static_cast<uint8_t>(pixel.b + dg - 8 + (next & 0x0F));
+                    }
+                    else
+                    {
+                        run = op & 0x3F;
+                    }
+                    index[hashOf(pixel)] = pixel;
+                }
+
+                out[0] = pixel.r;
+                out[1] = pixel.g;
+                out[2] = pixel.b;
+                if (channels == 4)
+                {
+                    out[3] = pixel.a;
+                }
+            }
+        }
+
+        image = ImageData();
+        image.width = static_cast<int>(width);
+        image.height = static_cast<int>(height);
+        image.channels = channels;
+        image.pixels = pixels;
+        return true;
+    }
+
+    bool QoiDecoder::encode(const uint8_t *pixels, int width, int height, int channels, std::vector<uint8_t> &out)
+    {
+        if (!pixels || width <= 0 || height <= 0 || (channels != 3 && channels != 4))
+        {
+            return false;
+        }
+
+        out.clear();
+        out.reserve(kHeaderSize + static_cast<size_t>(width) * height * (channels + 1) + sizeof(kEndMarker));
+        out.insert(out.end(), {'q', 'o', 'i', 'f'});
+        writeU32(out, static_cast<uint32_t>(width));
+        writeU32(out, static_cast<uint32_t>(height));
+        out.push_back(static_cast<uint8_t>(channels));
+        out.push_back(0); // sRGB with linear alpha
+
+        Rgba index[64] = {};
+        for (Rgba &entry : index)
+        {
+            entry.a = 0;
+        }
+        Rgba previous;
+        int run = 0;
+        const size_t rowSize = static_cast<size_t>(width) * channels;
+        const size_t pixelCount = static_cast<size_t>(width) * height;
+        size_t written = 0;
+
+        for (int y = height - 1; y >= 0; --y)
+        {
+            const uint8_t *in = pixels + y * rowSize;
+            for (int x = 0; x < width; ++x, in += channels)
+            {
+                const Rgba pixel = {in[0], in[1], in[2], channels == 4 ? in[3] : uint8_t(255)};
+                ++written;
+                if (pixel == previous)
+                {
+                    ++run;
+                    if (run == 62 || written == pixelCount)
+                    {
+                        out.push_back(static_cast<uint8_t>(kOpRun | (run - 1)));
+                        run = 0;
+                    }
+                    continue;
+                }
+                if (run > 0)
+                {
+                    out.push_back(static_cast<uint8_t>(kOpRun | (run - 1)));
+                    run = 0;
+                }
+
+                const int hash = hashOf(pixel);
+                if (index[hash] == pixel)
+                {
+                    out.push_back(static_cast<uint8_t>(kOpIndex | hash));
+                }
+                else
+                {
+                    index[hash] = pixel;
+                    if (pixel.a == previous.a)
+                    {
+                        const int8_t dr = static_cast<int8_t>(pixel.r - previous.r);
+                        const int8_t dg = static_cast<int8_t>(pixel.g - previous.g);
+                        const int8_t db = static_cast<int8_t>(pixel.b - previous.b);
+                        const int drg = dr - dg;
+                        const int dbg = db - dg;
+                        if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1)
+                        {
+                            out.push_back(static_cast<uint8_t>(kOpDiff | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2)));
+                        }
+                        else if (dg >= -32 && dg <= 31 && drg >= -8 && drg <= 7 && dbg >= -8 && dbg <= 7)
+                        {
+                            out.push_back(static_cast<uint8_t>(kOpLuma | (dg + 32)));
+                            out.push_back(static_cast<uint8_t>(((drg + 8) << 4) | (dbg + 8)));
+                        }
+                        else
+                        {
+                            out.insert(out.end(), {kOpRgb, pixel.r, pixel.g, pixel.b});
+                        }
+                    }
+                    else
+                    {
+                        out.insert(out.end(), {kOpRgba, pixel.r, pixel.g, pixel.b, pixel.a});
+                    }
+                }
+                previous = pixel;
+            }
+        }
+
+        out.insert(out.end(), std::begin(kEndMarker), std::end(kEndMarker));
+        return true;
+    }
+
+} // namespace Base
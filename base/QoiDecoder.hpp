@@ -0,0 +1,21 @@
+#pragma once
+
+#include "ImageDecoder.hpp"
+
+namespace Base
+{
+    // QOI ("Quite OK Image", qoiformat.org): lossless RGB/RGBA with a single-pass byte-oriented
+    // codec. Decodes several times faster than PNG at a similar size, which makes it a good
+    // target for assets that are read far more often than they are written.
+    class QoiDecoder : public ImageDecoder
+    {
+    public:
+        const char *getName() const override { return "qoi"; }
+        bool canDecode(const uint8_t *data, size_t size) const override;
+        bool decode(const uint8_t *data, size_t size, ImageData &image) const override;
+
+        // Encodes 3 or 4 channel pixels, bottom row first like ImageData, into a .qoi file.
+        static bool encode(const uint8_t *pixels, int width, int height, int channels, std::vector<uint8_t> &out);
+    };
+
+} // namespace Base
@@ -0,0 +1,53 @@
+#include "SamplerCache.hpp"
+#include "Log.hpp"
+
+#include <functional>
+
+namespace Base
+{
+    SamplerCache &SamplerCache::Get()
+    {
+        static std::unique_ptr<SamplerCache> s_Instance(new SamplerCache());
+        return *s_Instance;
+    }
+
+    size_t SamplerCache::StateHash::operator()(const SamplerState &state) const
+    {
+        size_t hash = 0;
+        for (GLenum value : {state.wrapS, state.wrapT, state.wrapR, state.minFilter, state.magFilter})
+        {
+            hash = hash * 31 + std::hash<GLenum>()(value);
+        }
+        return hash;
+    }
+
+    GLuint SamplerCache::acquire(const SamplerState &state)
+    {
+        auto it = m_Samplers.find(state);
+        if (it != m_Samplers.end())
+        {
+            return it->second;
+        }
+
+        GLuint sampler = 0;
+        glGenSamplers(1, &sampler);
+        glSamplerParameteri(sampler, GL_TEXTURE_WRAP_S, static_cast<GLint>(state.wrapS));
+        glSamplerParameteri(sampler, GL_TEXTURE_WRAP_T, static_cast<GLint>(state.wrapT));
+        glSamplerParameteri(sampler, GL_TEXTURE_WRAP_R, static_cast<GLint>(state.wrapR));
+        glSamplerParameteri(sampler, GL_TEXTURE_MIN_FILTER, static_cast<GLint>(state.minFilter));
+        glSamplerParameteri(sampler, GL_TEXTURE_MAG_FILTER, static_cast<GLint>(state.magFilter));
+        m_Samplers.emplace(state, sampler);
+        LOG_DEBUG("SamplerCache: created sampler {} ({} total).", sampler, m_Samplers.size());
+        return sampler;
+    }
+
+    void SamplerCache::clear()
+    {
+        for (const auto &[state, sampler] : m_Samplers)
+        {
+            glDeleteSamplers(1, &sampler);
+        }
+        m_Samplers.clear();
+    }
+
+} // namespace Base
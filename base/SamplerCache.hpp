@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+
+#if PLATFORM_DESKTOP
+    #include <glad/gl.h>
+#elif PLATFORM_ANDROID
+    #include <glad/egl.h>
+    #include <glad/gles2.h>
+#elif PLATFORM_EMSCRIPTEN || PLATFORM_IOS
+    #include <glad/gles2.h>
+#endif
+
+namespace Base
+{
+    // Everything a GL sampler object holds that textures in this project vary.
+    struct SamplerState
+    {
+        GLenum wrapS = GL_REPEAT;
+        GLenum wrapT = GL_REPEAT;
+        GLenum wrapR = GL_REPEAT;
+        GLenum minFilter = GL_LINEAR_MIPMAP_LINEAR;
+        GLenum magFilter = GL_LINEAR;
+
+        bool operator==(const SamplerState &other) const = default;
+    };
+
+    // One GL sampler object per distinct SamplerState, shared by every texture that asks for it,
+    // so sampling state lives in a handful of objects instead of in each texture.
+    class SamplerCache
+    {
+    public:
+        static SamplerCache &Get();
+
+        SamplerCache() = default;
+        SamplerCache(const SamplerCache &) = delete;
+        SamplerCache &operator=(const SamplerCache &) = delete;
+
+        // Creates the sampler on first use; must run on the GL thread.
+        GLuint acquire(const SamplerState &state);
+        // Deletes every sampler; called before the GL context goes away.
+        void clear();
+
+        size_t getSamplerCount() const { return m_Samplers.size(); }
+
+    private:
+        struct StateHash
+        {
+            size_t operator()(const SamplerState &state) const;
+        };
+
+        std::unordered_map<SamplerState, GLuint, StateHash> m_Samplers;
+    };
+
+} // namespace Base
@@ -1,14 +1,144 @@
 #include "Shader.hpp"
+#include "AssetFile.hpp"
+#include "ShaderHotReload.hpp"
+#include "SpirvModule.hpp"
 #include "Log.hpp"
 #include <vector>
-#include <SDL3/SDL_iostream.h>
+#include <algorithm>
+#include <numeric>
 #include <glm/gtc/type_ptr.hpp>
 
 namespace Base
 {
+    namespace
+    {
+        bool isSamplerType(GLenum type)
+        {
+            switch (type)
+            {
+            case GL_SAMPLER_2D:
+            case GL_SAMPLER_3D:
+            case GL_SAMPLER_CUBE:
+            case GL_SAMPLER_2D_SHADOW:
+            case GL_SAMPLER_2D_ARRAY:
+            case GL_SAMPLER_2D_ARRAY_SHADOW:
+            case GL_SAMPLER_CUBE_SHADOW:
+            case GL_INT_SAMPLER_2D:
+            case GL_INT_SAMPLER_3D:
+            case GL_INT_SAMPLER_CUBE:
+            case GL_INT_SAMPLER_2D_ARRAY:
+            case GL_UNSIGNED_INT_SAMPLER_2D:
+            case GL_UNSIGNED_INT_SAMPLER_3D:
+            case GL_UNSIGNED_INT_SAMPLER_CUBE:
+            case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
+#if PLATFORM_DESKTOP
+            case GL_SAMPLER_1D:
+            case GL_SAMPLER_1D_SHADOW:
+            case GL_SAMPLER_2D_MULTISAMPLE:
+            case GL_SAMPLER_2D_RECT:
+            case GL_SAMPLER_BUFFER:
+#endif
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        // Drivers report arrays as "name[0]"; the table stores the plain name.
+        std::string normalizeResourceName(const GLchar *name, GLsizei length)
+        {
+            std::string result(name, static_cast<size_t>(std::max(length, 0)));
+            if (result.size() > 3 && result.compare(result.size() - 3, 3, "[0]") == 0)
+            {
+                result.resize(result.size() - 3);
+            }
+            return result;
+        }
+
+        struct RegisteredBlockLayout
+        {
+            BlockLayout layout = BlockLayout::Std140;
+            std::vector<BlockField> fields;
+            size_t cppSize = 0;
+        };
+
+        std::unordered_map<std::string, RegisteredBlockLayout> &blockLayoutRegistry()
+        {
+            static std::unordered_map<std::string, RegisteredBlockLayout> s_BlockLayouts;
+            return s_BlockLayouts;
+        }
+
+        // Creates and compiles one stage with the platform's version/precision preamble and the
+        // specialization defines, without querying the result (which would wait for the driver's compiler).
+        GLuint compileStage(GLenum stage, const std::string &defines, const char *code)
+        {
+            const char *vertexSources[] = {GLSL_VERSION_STRING "\n", defines.c_str(), code}; // Vert shaders don't need precision
+            const char *fragmentSources[] = {GLSL_VERSION_STRING "\n", GLSL_PRECISION_STRING "\n", defines.c_str(), code};
+            GLuint shader = glCreateShader(stage);
+            if (stage == GL_VERTEX_SHADER)
+            {
+                glShaderSource(shader, 3, vertexSources, NULL);
+            }
+            else
+            {
+                glShaderSource(shader, 4, fragmentSources, NULL);
+            }
+            glCompileShader(shader);
+            return shader;
+        }
+
+        bool resourceLess(const ShaderResource &a, const ShaderResource &b)
+        {
+            if (a.kind != b.kind)
+                return a.kind < b.kind;
+            return a.name < b.name;
+        }
+
+        // "shaders/chapter13.vert" -> "shaders/spirv/chapter13.vert.spv", as written by the CompileShadersSpirv target.
+        std::string spirvPathFor(const std::string &path)
+        {
+            size_t slash = path.find_last_of('/');
+            size_t fileStart = slash == std::string::npos ? 0 : slash + 1;
+            return path.substr(0, fileStart) + "spirv/" + path.substr(fileStart) + ".spv";
+        }
+    }
+
+    GLuint Shader::getBlockBinding(const std::string &blockName)
+    {
+        static std::unordered_map<std::string, GLuint> s_BlockBindings;
+
+        auto it = s_BlockBindings.find(blockName);
+        if (it != s_BlockBindings.end())
+        {
+            return it->second;
+        }
+
+        GLuint binding = static_cast<GLuint>(s_BlockBindings.size());
+        GLint maxBindings = 0;
+        glGetIntegerv(GL_MAX_UNIFORM_BUFFER_BINDINGS, &maxBindings);
+        if (binding >= static_cast<GLuint>(maxBindings))
+        {
+            LOG_ERROR("Uniform block '{}' exceeds GL_MAX_UNIFORM_BUFFER_BINDINGS ({}).", blockName, maxBindings);
+        }
+
+        s_BlockBindings.emplace(blockName, binding);
+        LOG_DEBUG("Uniform block '{}' assigned to binding point {}.", blockName, binding);
+        return binding;
+    }
+
+    void Shader::registerBlockLayout(const std::string &blockName, BlockLayout layout,
+                                     const BlockField *fields, size_t fieldCount, size_t cppSize)
+    {
+        RegisteredBlockLayout &entry = blockLayoutRegistry()[blockName];
+        entry.layout = layout;
+        entry.fields.assign(fields, fields + fieldCount);
+        entry.cppSize = cppSize;
+    }
 
     Shader::~Shader()
     {
+        ShaderHotReload::Get().unregisterShader(this);
+        cancelReload();
         if (m_ID != 0)
         {
             glDeleteProgram(m_ID);
@@ -17,16 +147,30 @@ namespace Base
 
     GLint Shader::getUniformLocation(const std::string &name) const
     {
-        if (m_UniformLocationCache.find(name) != m_UniformLocationCache.end())
+        if (auto it = m_UniformLocationCache.find(name); it != m_UniformLocationCache.end())
         {
-            return m_UniformLocationCache[name];
+            return it->second;
         }
 
-        GLint location = glGetUniformLocation(m_ID, name.c_str());
-        if (location == -1)
+        GLint location = -1;
+        const ShaderResource *resource = findResource(ShaderResource::Kind::Uniform, name);
+        if (resource == nullptr)
+        {
+            resource = findResource(ShaderResource::Kind::Sampler, name);
+        }
+
+        if (resource != nullptr)
+        {
+            location = resource->location;
+        }
+        else
+        {
+            // Individual array elements ("lights[2].color") are not listed in the table.
+            location = glGetUniformLocation(m_ID, name.c_str());
+        }
+
+        if (location == -1 && m_ReportedMissing.insert(name).second)
         {
-            // Use your logger to warn that a specific uniform was not found.
-            // This is the key diagnostic message you need.
             LOG_WARN("Uniform '{}' not found in shader program!", name);
         }
 
@@ -34,87 +178,176 @@ namespace Base
         return location;
     }
 
-    bool Shader::loadFromFile(const std::string &vertexPath, const std::string &fragmentPath)
+    const ShaderResource *Shader::findResource(ShaderResource::Kind kind, std::string_view name) const
     {
-        std::vector<char> vertexBuffer;
-        std::vector<char> fragmentBuffer;
-
-        auto readFileSdl = [](const std::string &path, std::vector<char> &buffer) -> bool
+        auto it = std::lower_bound(m_Resources.begin(), m_Resources.end(), std::make_pair(kind, name),
+                                   [](const ShaderResource &resource, const std::pair<ShaderResource::Kind, std::string_view> &key)
+                                   {
+                                       if (resource.kind != key.first)
+                                           return resource.kind < key.first;
+                                       return std::string_view(resource.name) < key.second;
+                                   });
+        if (it != m_Resources.end() && it->kind == kind && it->name == name)
         {
-            LOG_DEBUG("Loading asset with SDL_IOStream: '{}'", path);
+            return &*it;
+        }
+        return nullptr;
+    }
+
+    bool Shader::hasUniform(std::string_view name) const
+    {
+        return findResource(ShaderResource::Kind::Uniform, name) != nullptr ||
+               findResource(ShaderResource::Kind::Sampler, name) != nullptr;
+    }
+
+    bool Shader::hasUniformBlock(std::string_view name) const
+    {
+        return findResource(ShaderResource::Kind::UniformBlock, name) != nullptr;
+    }
+
+    bool Shader::hasAttribute(std::string_view name) const
+    {
+        return findResource(ShaderResource::Kind::Attribute, name) != nullptr;
+    }
 
-            SDL_IOStream *io = SDL_IOFromFile(path.c_str(), "rb");
-            if (io == nullptr)
+    bool Shader::validateUniforms(std::initializer_list<std::string_view> names) const
+    {
+        bool valid = true;
+        for (std::string_view name : names)
+        {
+            if (!hasUniform(name))
             {
-                LOG_ERROR("SDL_IOFromFile failed for '{}': {}", path, SDL_GetError());
-                return false;
+                if (m_ReportedMissing.emplace(name).second)
+                {
+                    LOG_WARN("Shader program {} has no active uniform '{}'.", m_ID, name);
+                }
+                valid = false;
             }
+        }
+        return valid;
+    }
 
-            Sint64 size = SDL_GetIOSize(io);
-            if (size <= 0)
+    bool Shader::validateAttributes(std::initializer_list<std::string_view> names) const
+    {
+        bool valid = true;
+        for (std::string_view name : names)
+        {
+            if (!hasAttribute(name))
             {
-                LOG_ERROR("SDL_GetIOSize failed or file is empty for '{}': {}", path, SDL_GetError());
-                SDL_CloseIO(io);
-                return false;
+                LOG_WARN("Shader program {} has no active attribute '{}'.", m_ID, name);
+                valid = false;
             }
+        }
+        return valid;
+    }
 
-            buffer.resize(static_cast<size_t>(size));
-            size_t bytes_read = SDL_ReadIO(io, buffer.data(), static_cast<size_t>(size));
-            SDL_CloseIO(io);
+    bool Shader::loadFromFile(const std::string &vertexPath, const std::string &fragmentPath,
+                              const std::vector<ShaderSpecialization> &specializations)
+    {
+        ShaderFiles files;
+        return readFiles(vertexPath, fragmentPath, files) && load(files, specializations);
+    }
 
-            if (bytes_read != static_cast<size_t>(size))
+    bool Shader::readFiles(const std::string &vertexPath, const std::string &fragmentPath, ShaderFiles &files)
+    {
+        files.vertexPath = vertexPath;
+        files.fragmentPath = fragmentPath;
+        bool hasSpirv = false;
+#if PLATFORM_DESKTOP
+        if (GLAD_GL_VERSION_4_6 || GLAD_GL_ARB_gl_spirv)
+        {
+            const std::string paths[2] = {spirvPathFor(vertexPath), spirvPathFor(fragmentPath)};
+            hasSpirv = true;
+            for (int i = 0; i < 2 && hasSpirv; ++i)
             {
-                LOG_ERROR("SDL_ReadIO failed to read full file: {}", path);
-                return false;
+                if (!files.spirv[i].open(paths[i]))
+                {
+                    LOG_DEBUG("No SPIR-V module at '{}', compiling GLSL.", paths[i]);
+                    hasSpirv = false;
+                }
             }
+            if (!hasSpirv)
+            {
+                files.spirv[0].close();
+                files.spirv[1].close();
+            }
+        }
+#endif
 
-            return true;
-        };
-
-        bool vLoaded = readFileSdl(resolveAssetPath(vertexPath), vertexBuffer);
-        bool fLoaded = readFileSdl(resolveAssetPath(fragmentPath), fragmentBuffer);
-
-        if (!vLoaded || !fLoaded)
+        const std::string *paths[2] = {&vertexPath, &fragmentPath};
+        bool hasSources = true;
+        for (int i = 0; i < 2; ++i)
+        {
+            AssetFile file;
+            if (!file.open(*paths[i]) || file.size() == 0)
+            {
+                // Only an error when there is no SPIR-V to use instead.
+                if (!hasSpirv)
+                {
+                    LOG_ERROR("Could not read shader '{}'.", *paths[i]);
+                }
+                hasSources = false;
+                continue;
+            }
+            files.source[i].assign(reinterpret_cast<const char *>(file.data()), file.size());
+        }
+        if (!hasSpirv && !hasSources)
         {
-            LOG_ERROR("SHADER::LOAD_FAILED: Could not load one or both shader files via SDL_IOStream.");
+            LOG_ERROR("SHADER::LOAD_FAILED: Could not load one or both shader files.");
             return false;
         }
+        return true;
+    }
 
-        vertexBuffer.push_back('\0');
-        fragmentBuffer.push_back('\0');
+    bool Shader::load(const ShaderFiles &files, const std::vector<ShaderSpecialization> &specializations)
+    {
+        m_Defines.clear();
+        for (const ShaderSpecialization &specialization : specializations)
+        {
+            m_Defines += "#define " + specialization.name + " " + std::to_string(specialization.value) + "\n";
+        }
 
-        return compileFromSource(vertexBuffer.data(), fragmentBuffer.data());
+        bool loaded = false;
+#if PLATFORM_DESKTOP
+        loaded = files.spirv[0].isOpen() && files.spirv[1].isOpen() && loadSpirv(files, specializations);
+#endif
+        if (!loaded)
+        {
+            if (files.source[0].empty() || files.source[1].empty())
+            {
+                LOG_ERROR("SHADER::LOAD_FAILED: Could not load one or both shader files.");
+                return false;
+            }
+            if (!compileFromSource(files.source[0].c_str(), files.source[1].c_str()))
+            {
+                return false;
+            }
+        }
+
+        m_VertexPath = files.vertexPath;
+        m_FragmentPath = files.fragmentPath;
+        ShaderHotReload::Get().registerShader(this);
+        return true;
     }
 
     bool Shader::compileFromSource(const char *vShaderCode, const char *fShaderCode)
     {
-        const char *definitions[] =
-            {
-                GLSL_VERSION_STRING "\n",
-                GLSL_PRECISION_STRING "\n"};
-
-        LOG_DEBUG("--- Compiling Vertex Shader Source ---\n{}{}{}", definitions[0], definitions[1], vShaderCode);
-        LOG_DEBUG("--- Compiling Fragment Shader Source ---\n{}{}{}", definitions[0], definitions[1], fShaderCode);
+        LOG_DEBUG("--- Compiling Vertex Shader Source ---\n{}\n{}", GLSL_VERSION_STRING, vShaderCode);
+        LOG_DEBUG("--- Compiling Fragment Shader Source ---\n{}\n{}\n{}", GLSL_VERSION_STRING, GLSL_PRECISION_STRING, fShaderCode);
 
         const GLubyte *version = glGetString(GL_SHADING_LANGUAGE_VERSION);
         LOG_DEBUG("SHADING_LANGUAGE_VERSION: {}", reinterpret_cast<const char *>(version));
 
         GLuint vertex, fragment;
 
-        const char *vertexSources[] = {definitions[0], vShaderCode}; // Vert shaders don't need precision
-        vertex = glCreateShader(GL_VERTEX_SHADER);
-        glShaderSource(vertex, 2, vertexSources, NULL);
-        glCompileShader(vertex);
+        vertex = compileStage(GL_VERTEX_SHADER, m_Defines, vShaderCode);
         if (!checkCompileErrors(vertex, "VERTEX"))
         {
             glDeleteShader(vertex);
             return false;
         }
 
-        const char *fragmentSources[] = {definitions[0], definitions[1], fShaderCode};
-        fragment = glCreateShader(GL_FRAGMENT_SHADER);
-        glShaderSource(fragment, 3, fragmentSources, NULL);
-        glCompileShader(fragment);
+        fragment = compileStage(GL_FRAGMENT_SHADER, m_Defines, fShaderCode);
         if (!checkCompileErrors(fragment, "FRAGMENT"))
         {
             glDeleteShader(vertex);
@@ -130,6 +363,7 @@ namespace Base
         {
             glDeleteShader(vertex);
             glDeleteShader(fragment);
+            glDeleteProgram(m_ID);
             m_ID = 0;
             return false;
         }
@@ -138,10 +372,197 @@ namespace Base
         glDeleteShader(vertex);
         glDeleteShader(fragment);
 
+        m_IsSpirv = false;
+        reflect();
+        assignBlockBindings();
+        checkRegisteredBlockLayouts();
+
         LOG_INFO("Shader compiled successfully from source.");
         return true;
     }
 
+#if PLATFORM_DESKTOP
+    bool Shader::loadSpirv(const ShaderFiles &files, const std::vector<ShaderSpecialization> &specializations)
+    {
+        const std::string paths[2] = {spirvPathFor(files.vertexPath), spirvPathFor(files.fragmentPath)};
+        const GLenum stages[2] = {GL_VERTEX_SHADER, GL_FRAGMENT_SHADER};
+        const char *stageNames[2] = {"VERTEX", "FRAGMENT"};
+        SpirvModule modules[2];
+        for (int i = 0; i < 2; ++i)
+        {
+            bool loaded = modules[i].load(files.spirv[i].data(), files.spirv[i].size());
+            if (!loaded)
+            {
+                // The build step leaves an empty file behind when glslang rejects a shader.
+                LOG_WARN("'{}' is not a valid SPIR-V module, compiling GLSL instead.", paths[i]);
+                return false;
+            }
+            // Bake the shared name -> binding table into the module; SPIR-V programs have no block names to query.
+            modules[i].remapBlockBindings([](const std::string &blockName) { return getBlockBinding(blockName); });
+        }
+
+        GLuint shaders[2] = {0, 0};
+        auto cleanup = [&]()
+        {
+            for (GLuint shader : shaders)
+            {
+                if (shader != 0)
+                {
+                    glDeleteShader(shader);
+                }
+            }
+        };
+
+        for (int i = 0; i < 2; ++i)
+        {
+            std::vector<GLuint> ids;
+            std::vector<GLuint> values;
+            for (const ShaderSpecialization &specialization : specializations)
+            {
+                GLuint specId = 0;
+                if (modules[i].findSpecConstant(specialization.name, specId))
+                {
+                    ids.push_back(specId);
+                    values.push_back(specialization.value);
+                }
+            }
+
+            const std::vector<uint32_t> &words = modules[i].getWords();
+            shaders[i] = glCreateShader(stages[i]);
+            glShaderBinary(1, &shaders[i], GL_SHADER_BINARY_FORMAT_SPIR_V_ARB, words.data(),
+                           static_cast<GLsizei>(words.size() * sizeof(uint32_t)));
+            if (GLAD_GL_VERSION_4_6)
+            {
+                glSpecializeShader(shaders[i], "main", static_cast<GLuint>(ids.size()), ids.data(), values.data());
+            }
+            else
+            {
+                glSpecializeShaderARB(shaders[i], "main", static_cast<GLuint>(ids.size()), ids.data(), values.data());
+            }
+            if (!checkCompileErrors(shaders[i], stageNames[i]))
+            {
+                LOG_WARN("Specializing '{}' failed, compiling GLSL instead.", paths[i]);
+                cleanup();
+                return false;
+            }
+        }
+
+        GLuint program = glCreateProgram();
+        glAttachShader(program, shaders[0]);
+        glAttachShader(program, shaders[1]);
+        glLinkProgram(program);
+        cleanup();
+        if (!checkCompileErrors(program, "PROGRAM"))
+        {
+            LOG_WARN("Linking SPIR-V modules '{}' / '{}' failed, compiling GLSL instead.", paths[0], paths[1]);
+            glDeleteProgram(program);
+            return false;
+        }
+
+        if (m_ID != 0)
+        {
+            glDeleteProgram(m_ID);
+        }
+        m_ID = program;
+        m_IsSpirv = true;
+
+        m_Resources.clear();
+        m_UniformLocationCache.clear();
+        m_ReportedMissing.clear();
+        std::unordered_map<std::string, GLint> blockIndices;
+        modules[0].reflect(true, m_Resources, blockIndices);
+        modules[1].reflect(false, m_Resources, blockIndices);
+        finishReflection();
+        checkRegisteredBlockLayouts();
+
+        LOG_INFO("Shader loaded from SPIR-V modules '{}' / '{}'.", paths[0], paths[1]);
+        return true;
+    }
+#endif
+
+    void Shader::beginReload(const char *vShaderCode, const char *fShaderCode)
+    {
+        cancelReload();
+        m_PendingVertex = compileStage(GL_VERTEX_SHADER, m_Defines, vShaderCode);
+        m_PendingFragment = compileStage(GL_FRAGMENT_SHADER, m_Defines, fShaderCode);
+        m_PendingProgram = glCreateProgram();
+        glAttachShader(m_PendingProgram, m_PendingVertex);
+        glAttachShader(m_PendingProgram, m_PendingFragment);
+        // Linking failed stages simply fails the link, so there is no need to wait for the compile results here.
+        glLinkProgram(m_PendingProgram);
+    }
+
+    bool Shader::isReloadReady() const
+    {
+        if (m_PendingProgram == 0)
+        {
+            return false;
+        }
+#if PLATFORM_DESKTOP
+        if (GLAD_GL_KHR_parallel_shader_compile)
+        {
+            GLint completed = GL_FALSE;
+            glGetProgramiv(m_PendingProgram, GL_COMPLETION_STATUS_KHR, &completed);
+            return completed == GL_TRUE;
+        }
+#endif
+        // Without the extension any status query blocks until the driver is done anyway.
+        return true;
+    }
+
+    bool Shader::finishReload()
+    {
+        if (m_PendingProgram == 0)
+        {
+            return false;
+        }
+
+        bool ok = checkCompileErrors(m_PendingVertex, "VERTEX") &&
+                  checkCompileErrors(m_PendingFragment, "FRAGMENT") &&
+                  checkCompileErrors(m_PendingProgram, "PROGRAM");
+        if (!ok)
+        {
+            LOG_WARN("Shader reload of '{}' / '{}' failed, keeping program {}.", m_VertexPath, m_FragmentPath, m_ID);
+            cancelReload();
+            return false;
+        }
+
+        glDeleteShader(m_PendingVertex);
+        glDeleteShader(m_PendingFragment);
+        if (m_ID != 0)
+        {
+            glDeleteProgram(m_ID);
+        }
+        m_ID = m_PendingProgram;
+        m_PendingProgram = m_PendingVertex = m_PendingFragment = 0;
+
+        // Reloads always come from the GLSL sources, even if the program was first loaded as SPIR-V.
+        m_IsSpirv = false;
+        reflect();
+        assignBlockBindings();
+        checkRegisteredBlockLayouts();
+
+        LOG_INFO("Shader '{}' / '{}' reloaded as program {}.", m_VertexPath, m_FragmentPath, m_ID);
+        return true;
+    }
+
+    void Shader::cancelReload()
+    {
+        if (m_PendingProgram != 0)
+        {
+            glDeleteProgram(m_PendingProgram);
+        }
+        if (m_PendingVertex != 0)
+        {
+            glDeleteShader(m_PendingVertex);
+        }
+        if (m_PendingFragment != 0)
+        {
+            glDeleteShader(m_PendingFragment);
+        }
+        m_PendingProgram = m_PendingVertex = m_PendingFragment = 0;
+    }
+
     void Shader::use() const
     {
         glUseProgram(m_ID);
@@ -174,12 +595,12 @@ namespace Base
 
     void Shader::setMat3(const std::string &name, const glm::mat3 &mat) const
     {
-        glUniformMatrix3fv(glGetUniformLocation(m_ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        glUniformMatrix3fv(getUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
     }
 
     void Shader::setMat4(const std::string &name, const glm::mat4 &mat) const
     {
-        glUniformMatrix4fv(glGetUniformLocation(m_ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
     }
 
     bool Shader::checkCompileErrors(GLuint shader, const std::string &type)
@@ -209,6 +630,209 @@ namespace Base
         return true;
     }
 
-    
+    void Shader::reflect()
+    {
+        m_Resources.clear();
+        m_UniformLocationCache.clear();
+        m_ReportedMissing.clear();
+        if (m_ID == 0)
+        {
+            return;
+        }
+
+        GLint count = 0;
+        GLint maxLength = 0;
+        std::vector<GLchar> nameBuffer;
+
+        // Vertex attributes
+        glGetProgramiv(m_ID, GL_ACTIVE_ATTRIBUTES, &count);
+        glGetProgramiv(m_ID, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxLength);
+        nameBuffer.resize(std::max(maxLength, 1));
+        for (GLint i = 0; i < count; ++i)
+        {
+            GLsizei length = 0;
+            ShaderResource resource;
+            resource.kind = ShaderResource::Kind::Attribute;
+            glGetActiveAttrib(m_ID, static_cast<GLuint>(i), static_cast<GLsizei>(nameBuffer.size()), &length,
+                              &resource.size, &resource.type, nameBuffer.data());
+            resource.name = normalizeResourceName(nameBuffer.data(), length);
+            resource.location = glGetAttribLocation(m_ID, nameBuffer.data());
+            m_Resources.push_back(std::move(resource));
+        }
+
+        // Uniforms, samplers and uniform block members
+        glGetProgramiv(m_ID, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(m_ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+        nameBuffer.resize(std::max(maxLength, 1));
+        if (count > 0)
+        {
+            std::vector<GLuint> indices(static_cast<size_t>(count));
+            std::iota(indices.begin(), indices.end(), 0u);
+            std::vector<GLint> blockIndices(indices.size(), -1);
+            std::vector<GLint> offsets(indices.size(), -1);
+            std::vector<GLint> arrayStrides(indices.size(), -1);
+            glGetActiveUniformsiv(m_ID, count, indices.data(), GL_UNIFORM_BLOCK_INDEX, blockIndices.data());
+            glGetActiveUniformsiv(m_ID, count, indices.data(), GL_UNIFORM_OFFSET, offsets.data());
+            glGetActiveUniformsiv(m_ID, count, indices.data(), GL_UNIFORM_ARRAY_STRIDE, arrayStrides.data());
+
+            for (GLint i = 0; i < count; ++i)
+            {
+                GLsizei length = 0;
+                ShaderResource resource;
+                glGetActiveUniform(m_ID, static_cast<GLuint>(i), static_cast<GLsizei>(nameBuffer.size()), &length,
+                                   &resource.size, &resource.type, nameBuffer.data());
+                resource.kind = isSamplerType(resource.type) ? ShaderResource::Kind::Sampler : ShaderResource::Kind::Uniform;
+                resource.name = normalizeResourceName(nameBuffer.data(), length);
+                resource.blockIndex = blockIndices[i];
+                if (resource.blockIndex == -1)
+                {
+                    resource.location = glGetUniformLocation(m_ID, nameBuffer.data());
+                }
+                else
+                {
+                    resource.offset = offsets[i];
+                    resource.arrayStride = arrayStrides[i];
+                }
+                m_Resources.push_back(std::move(resource));
+            }
+        }
+
+        // Uniform blocks
+        glGetProgramiv(m_ID, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+        glGetProgramiv(m_ID, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxLength);
+        nameBuffer.resize(std::max(maxLength, 1));
+        for (GLint i = 0; i < count; ++i)
+        {
+            GLsizei length = 0;
+            ShaderResource resource;
+            resource.kind = ShaderResource::Kind::UniformBlock;
+            glGetActiveUniformBlockName(m_ID, static_cast<GLuint>(i), static_cast<GLsizei>(nameBuffer.size()), &length, nameBuffer.data());
+            glGetActiveUniformBlockiv(m_ID, static_cast<GLuint>(i), GL_UNIFORM_BLOCK_DATA_SIZE, &resource.size);
+            glGetActiveUniformBlockiv(m_ID, static_cast<GLuint>(i), GL_UNIFORM_BLOCK_BINDING, &resource.binding);
+            resource.name = normalizeResourceName(nameBuffer.data(), length);
+            resource.location = i;
+            m_Resources.push_back(std::move(resource));
+        }
+
+        finishReflection();
+    }
+
+    void Shader::finishReflection()
+    {
+        std::sort(m_Resources.begin(), m_Resources.end(), resourceLess);
+        // Resources declared in both stages of a SPIR-V program are collected twice.
+        m_Resources.erase(std::unique(m_Resources.begin(), m_Resources.end(), [](const ShaderResource &a, const ShaderResource &b)
+                                      { return a.kind == b.kind && a.name == b.name; }),
+                          m_Resources.end());
+
+        LOG_DEBUG("Shader program {} reflection: {} active resources.", m_ID, m_Resources.size());
+        for (const ShaderResource &resource : m_Resources)
+        {
+            LOG_TRACE("  [{}] '{}' type=0x{:X} size={} location={} block={} offset={}",
+                      static_cast<int>(resource.kind), resource.name, resource.type, resource.size,
+                      resource.location, resource.blockIndex, resource.offset);
+        }
+    }
+
+    void Shader::assignBlockBindings()
+    {
+        for (ShaderResource &resource : m_Resources)
+        {
+            if (resource.kind != ShaderResource::Kind::UniformBlock)
+            {
+                continue;
+            }
+            GLuint binding = getBlockBinding(resource.name);
+            glUniformBlockBinding(m_ID, static_cast<GLuint>(resource.location), binding);
+            resource.binding = static_cast<GLint>(binding);
+        }
+    }
+
+    bool Shader::checkBlockLayout(const std::string &blockName) const
+    {
+        auto registered = blockLayoutRegistry().find(blockName);
+        if (registered == blockLayoutRegistry().end())
+        {
+            LOG_WARN("Shader program {}: no C++ layout registered for uniform block '{}'.", m_ID, blockName);
+            return false;
+        }
+        const ShaderResource *block = findResource(ShaderResource::Kind::UniformBlock, blockName);
+        if (!block)
+        {
+            LOG_WARN("Shader program {} has no active uniform block '{}'.", m_ID, blockName);
+            return false;
+        }
+
+        const RegisteredBlockLayout &layout = registered->second;
+        bool valid = true;
+        if (layout.layout != BlockLayout::Std140)
+        {
+            // Uniform blocks in GLSL 4.10 / ES 3.00 only come in std140 (or implementation-defined) flavours.
+            LOG_ERROR("Uniform block '{}' is described with a std430 layout; uniform blocks must use std140.", blockName);
+            valid = false;
+        }
+        if (static_cast<size_t>(block->size) > layout.cppSize)
+        {
+            LOG_ERROR("Uniform block '{}' needs {} bytes but its C++ struct is only {} bytes.", blockName, block->size, layout.cppSize);
+            valid = false;
+        }
+
+        for (const BlockField &field : layout.fields)
+        {
+            const ShaderResource *member = findResource(ShaderResource::Kind::Uniform, field.name);
+            if (!member || member->blockIndex != block->location)
+            {
+                // Members the optimizer removed are fine; they simply aren't read.
+                LOG_DEBUG("Uniform block '{}': member '{}' is not active in program {}.", blockName, field.name, m_ID);
+                continue;
+            }
+            if (static_cast<size_t>(member->offset) != field.offset)
+            {
+                LOG_ERROR("Uniform block '{}': member '{}' is at offset {} in GLSL but {} in C++.",
+                          blockName, field.name, member->offset, field.offset);
+                valid = false;
+            }
+            if (member->type != 0 && member->type != field.glType)
+            {
+                LOG_ERROR("Uniform block '{}': member '{}' has GLSL type 0x{:X} but C++ type 0x{:X}.",
+                          blockName, field.name, member->type, field.glType);
+                valid = false;
+            }
+            if (field.arrayStride != 0 && static_cast<size_t>(member->arrayStride) != field.arrayStride)
+            {
+                LOG_ERROR("Uniform block '{}': member '{}' has array stride {} in GLSL but {} in C++.",
+                          blockName, field.name, member->arrayStride, field.arrayStride);
+                valid = false;
+            }
+        }
+
+        for (const ShaderResource &member : m_Resources)
+        {
+            if (member.kind != ShaderResource::Kind::Uniform || member.blockIndex != block->location)
+            {
+                continue;
+            }
+            bool described = std::any_of(layout.fields.begin(), layout.fields.end(),
+                                         [&](const BlockField &field) { return field.name == member.name; });
+            if (!described)
+            {
+                LOG_ERROR("Uniform block '{}': GLSL member '{}' has no counterpart in the C++ struct.", blockName, member.name);
+                valid = false;
+            }
+        }
+        return valid;
+    }
+
+    void Shader::checkRegisteredBlockLayouts() const
+    {
+        for (const ShaderResource &resource : m_Resources)
+        {
+            if (resource.kind == ShaderResource::Kind::UniformBlock &&
+                blockLayoutRegistry().count(resource.name) != 0)
+            {
+                checkBlockLayout(resource.name);
+            }
+        }
+    }
 
-} // namespace Base
\ No newline at end of file
+} // namespace Base
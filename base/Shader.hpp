@@ -1,8 +1,15 @@
 
 #pragma once
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <vector>
+#include <initializer_list>
 #include <unordered_map>
+#include <unordered_set>
 #include <glm/glm.hpp>
+#include "AssetFile.hpp"
+#include "UniformLayout.hpp"
 #if PLATFORM_DESKTOP
     #include <glad/gl.h>
 #elif PLATFORM_ANDROID
@@ -22,21 +29,82 @@
 
 namespace Base {
 
+// One active program resource, as reported by the driver after linking.
+struct ShaderResource
+{
+    enum class Kind : uint8_t
+    {
+        Attribute,
+        Uniform,
+        Sampler,
+        UniformBlock
+    };
+
+    Kind kind = Kind::Uniform;
+    std::string name;     // Array resources are stored without the trailing "[0]"
+    GLenum type = 0;      // GL_FLOAT_VEC3, GL_SAMPLER_2D, ... (0 for blocks)
+    GLint size = 0;       // Array length, or data size in bytes for blocks
+    GLint location = -1;  // Attribute/uniform location, or block index for blocks
+    GLint blockIndex = -1; // Owning block of a block member, -1 for default-block uniforms
+    GLint offset = -1;    // Byte offset inside the owning block
+    GLint arrayStride = -1; // Byte stride between elements of a block member array
+    GLint binding = -1;   // Binding point (blocks only)
+};
+
+// Compile-time constant overridden when a program is built. Shaders declare it so that both the
+// SPIR-V and the GLSL paths pick it up:
+//
+//     #ifdef GL_SPIRV
+//     layout(constant_id = 0) const int MAX_LIGHTS = 4;
+//     #elif !defined(MAX_LIGHTS)
+//     #define MAX_LIGHTS 4
+//     #endif
+//
+// SPIR-V modules get the value through glSpecializeShader, GLSL sources as a prepended #define.
+struct ShaderSpecialization
+{
+    std::string name;
+    uint32_t value = 0;
+};
+
+// What loadFromFile reads: the offline-compiled SPIR-V modules, where the driver takes SPIR-V
+// and the build produced them, and the GLSL sources to fall back on. Shader::readFiles touches no
+// GL state, so it may run on worker threads; Shader::load does the rest on the GL thread.
+struct ShaderFiles
+{
+    std::string vertexPath;
+    std::string fragmentPath;
+    AssetFile spirv[2];    // Vertex, fragment; closed when there are none
+    std::string source[2]; // Empty when unreadable
+};
+
 class Shader {
 public:
     Shader() = default;
     ~Shader();
 
-    inline static std::string resolveAssetPath(const std::string& relativePath) {
-        #ifdef __ANDROID__
-            return relativePath;
-        #else
-            return "assets/" + relativePath;
-        #endif
+    // Global block name -> binding point table. Every program that declares a block with
+    // the same name gets the same binding point, so buffers can be bound once by name.
+    static GLuint getBlockBinding(const std::string& blockName);
+
+    // Registers the C++ struct (described with BASE_UNIFORM_BLOCK) that feeds the named block.
+    // Every program linked afterwards that declares the block is checked against it.
+    template <typename T>
+    static void registerBlockLayout(const std::string& blockName)
+    {
+        const auto& description = UniformBlockTraits<T>::description;
+        registerBlockLayout(blockName, description.layout, description.fields.data(), description.fields.size(), sizeof(T));
     }
+    static void registerBlockLayout(const std::string& blockName, BlockLayout layout,
+                                    const BlockField* fields, size_t fieldCount, size_t cppSize);
 
     GLint getUniformLocation(const std::string &name) const;
-    bool loadFromFile(const std::string& vertexPath, const std::string& fragmentPath);
+    // Prefers the offline-compiled "shaders/spirv/<file>.spv" modules when the driver supports
+    // GL_ARB_gl_spirv and falls back to compiling the GLSL sources otherwise.
+    bool loadFromFile(const std::string& vertexPath, const std::string& fragmentPath,
+                      const std::vector<ShaderSpecialization>& specializations = {});
+    static bool readFiles(const std::string& vertexPath, const std::string& fragmentPath, ShaderFiles& files);
+    bool load(const ShaderFiles& files, const std::vector<ShaderSpecialization>& specializations = {});
     bool compileFromSource(const char* vShaderCode, const char* fShaderCode);
     
     void use() const;
@@ -51,13 +119,55 @@ public:
     void setMat4(const std::string& name, const glm::mat4& mat) const;
 
     GLuint getProgramID() const {return m_ID;} 
+    bool isSpirv() const { return m_IsSpirv; }
+    const std::string& getVertexPath() const { return m_VertexPath; }
+    const std::string& getFragmentPath() const { return m_FragmentPath; }
+
+    // Non-blocking rebuild used by ShaderHotReload: beginReload() only issues the compile/link,
+    // finishReload() swaps the new program in if it linked and keeps the current one otherwise.
+    void beginReload(const char* vShaderCode, const char* fShaderCode);
+    bool isReloadPending() const { return m_PendingProgram != 0; }
+    bool isReloadReady() const;
+    bool finishReload();
+    void cancelReload();
+
+    // Reflection table, sorted by (kind, name). Filled once after every successful link.
+    const std::vector<ShaderResource>& getResources() const { return m_Resources; }
+    const ShaderResource* findResource(ShaderResource::Kind kind, std::string_view name) const;
+    bool hasUniform(std::string_view name) const;
+    bool hasUniformBlock(std::string_view name) const;
+    bool hasAttribute(std::string_view name) const;
+
+    // Setup-time validation: logs every missing name once and returns false if any is absent.
+    bool validateUniforms(std::initializer_list<std::string_view> names) const;
+    bool validateAttributes(std::initializer_list<std::string_view> names) const;
+    // Compares the reflected layout of a block with its registered C++ description.
+    bool checkBlockLayout(const std::string& blockName) const;
 
     Shader(const Shader&) = delete;
     Shader& operator=(const Shader&) = delete;
 private:
     GLuint m_ID = 0;
+    std::string m_VertexPath;
+    std::string m_FragmentPath;
+    GLuint m_PendingProgram = 0;
+    GLuint m_PendingVertex = 0;
+    GLuint m_PendingFragment = 0;
+    std::string m_Defines; // "#define NAME value" lines for the specializations, prepended to GLSL sources
+    bool m_IsSpirv = false;
+
     bool checkCompileErrors(GLuint shader, const std::string& type);
+#if PLATFORM_DESKTOP
+    bool loadSpirv(const ShaderFiles& files, const std::vector<ShaderSpecialization>& specializations);
+#endif
+    void reflect();
+    void finishReflection();
+    void assignBlockBindings();
+    void checkRegisteredBlockLayouts() const;
+
+    std::vector<ShaderResource> m_Resources;
     mutable std::unordered_map<std::string, GLint> m_UniformLocationCache;
+    mutable std::unordered_set<std::string> m_ReportedMissing;
 };
 
 } // namespace Base
\ No newline at end of file
@@ -0,0 +1,335 @@
+#include "ShaderHotReload.hpp"
+#include "Shader.hpp"
+#include "Log.hpp"
+#include "Vfs.hpp"
+
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <memory>
+
+#if PLATFORM_LINUX
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace Base
+{
+    namespace
+    {
+        // Editors tend to write a file in several steps; wait until it has been quiet for a moment.
+        constexpr uint64_t kDebounceMs = 100;
+        // Debounce periods a change is retried for while its files cannot be read.
+        constexpr uint32_t kMaxFailedReads = 5;
+
+        std::string normalizePath(const std::string &path)
+        {
+            std::error_code ec;
+            std::filesystem::path absolute = std::filesystem::absolute(path, ec);
+            return (ec ? std::filesystem::path(path) : absolute).lexically_normal().string();
+        }
+
+        bool readTextFile(const std::string &path, std::string &out)
+        {
+            std::ifstream file(path, std::ios::binary);
+            if (!file)
+            {
+                return false;
+            }
+            std::ostringstream contents;
+            contents << file.rdbuf();
+            out = contents.str();
+            return true;
+        }
+    }
+
+    ShaderHotReload &ShaderHotReload::Get()
+    {
+        static std::unique_ptr<ShaderHotReload> s_Instance(new ShaderHotReload());
+        return *s_Instance;
+    }
+
+    ShaderHotReload::~ShaderHotReload()
+    {
+        shutdown();
+    }
+
+    void ShaderHotReload::initialize()
+    {
+#if PLATFORM_DESKTOP
+        if (m_Initialized)
+        {
+            return;
+        }
+
+        if (GLAD_GL_KHR_parallel_shader_compile)
+        {
+            // Let the driver pick how many compiler threads to use; this is what makes compiles asynchronous.
+            glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+            LOG_INFO("ShaderHotReload: using GL_KHR_parallel_shader_compile.");
+        }
+        else
+        {
+            LOG_INFO("ShaderHotReload: GL_KHR_parallel_shader_compile unavailable, reloads compile synchronously.");
+        }
+
+#if PLATFORM_LINUX
+        m_InotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (m_InotifyFd < 0)
+        {
+            LOG_ERROR("ShaderHotReload: inotify_init1 failed: {}", std::strerror(errno));
+            return;
+        }
+#endif
+        m_Initialized = true;
+
+        for (const Entry &entry : m_Entries)
+        {
+            watchFile(entry.vertexFile);
+            watchFile(entry.fragmentFile);
+        }
+#endif
+    }
+
+    void ShaderHotReload::shutdown()
+    {
+        for (Entry &entry : m_Entries)
+        {
+            entry.shader->cancelReload();
+        }
+        m_Entries.clear();
+
+#if PLATFORM_LINUX
+        if (m_InotifyFd >= 0)
+        {
+            close(m_InotifyFd); // also drops every watch
+            m_InotifyFd = -1;
+        }
+        m_WatchDirectories.clear();
+#elif PLATFORM_DESKTOP
+        m_FileTimes.clear();
+#endif
+        m_Initialized = false;
+    }
+
+    void ShaderHotReload::registerShader(Shader *shader)
+    {
+#if PLATFORM_DESKTOP
+        auto it = std::find_if(m_Entries.begin(), m_Entries.end(), [shader](const Entry &e) { return e.shader == shader; });
+        Entry &entry = it != m_Entries.end() ? *it : m_Entries.emplace_back();
+        entry.shader = shader;
+        entry.vertexFile = resolveWatchPath(shader->getVertexPath());
+        entry.fragmentFile = resolveWatchPath(shader->getFragmentPath());
+        entry.dirty = false;
+
+        if (m_Initialized)
+        {
+            watchFile(entry.vertexFile);
+            watchFile(entry.fragmentFile);
+        }
+#else
+        (void)shader;
+#endif
+    }
+
+    void ShaderHotReload::unregisterShader(Shader *shader)
+    {
+        m_Entries.erase(std::remove_if(m_Entries.begin(), m_Entries.end(), [shader](const Entry &e) { return e.shader == shader; }),
+                        m_Entries.end());
+    }
+
+    std::string ShaderHotReload::resolveWatchPath(const std::string &relativePath) const
+    {
+#ifdef ASSETS_SOURCE_DIR
+        // Prefer the source tree so edits don't have to go through the CopyAssets step first.
+        std::string sourcePath = std::string(ASSETS_SOURCE_DIR) + "/" + relativePath;
+        std::error_code ec;
+        if (std::filesystem::exists(sourcePath, ec))
+        {
+            return normalizePath(sourcePath);
+        }
+#endif
+        return normalizePath(Vfs::resolvePath(relativePath));
+    }
+
+    void ShaderHotReload::watchFile(const std::string &fullPath)
+    {
+#if PLATFORM_LINUX
+        if (m_InotifyFd < 0)
+        {
+            return;
+        }
+        // Watch the directory rather than the file: editors usually save by renaming a temporary file over it.
+        std::string directory = std::filesystem::path(fullPath).parent_path().string();
+        for (const auto &[wd, dir] : m_WatchDirectories)
+        {
+            if (dir == directory)
+            {
+                return;
+            }
+        }
+        int wd = inotify_add_watch(m_InotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+        if (wd < 0)
+        {
+            LOG_WARN("ShaderHotReload: cannot watch '{}': {}", directory, std::strerror(errno));
+            return;
+        }
+        m_WatchDirectories[wd] = directory;
+        LOG_DEBUG("ShaderHotReload: watching '{}'.", directory);
+#elif PLATFORM_DESKTOP
+        std::error_code ec;
+        auto time = std::filesystem::last_write_time(fullPath, ec);
+        m_FileTimes[fullPath] = ec ? 0 : static_cast<int64_t>(time.time_since_epoch().count());
+#else
+        (void)fullPath;
+#endif
+    }
+
+    void ShaderHotReload::pollChanges()
+    {
+#if PLATFORM_LINUX
+        if (m_InotifyFd < 0)
+        {
+            return;
+        }
+        alignas(inotify_event) char buffer[4096];
+        for (;;)
+        {
+            ssize_t length = read(m_InotifyFd, buffer, sizeof(buffer));
+            if (length <= 0)
+            {
+                break; // EAGAIN: nothing more queued
+            }
+            for (char *ptr = buffer; ptr < buffer + length;)
+            {
+                const inotify_event *event = reinterpret_cast<const inotify_event *>(ptr);
+                auto dir = m_WatchDirectories.find(event->wd);
+                if (event->len > 0 && dir != m_WatchDirectories.end())
+                {
+                    markDirty(dir->second + "/" + event->name);
+                }
+                ptr += sizeof(inotify_event) + event->len;
+            }
+        }
+#elif PLATFORM_DESKTOP
+        // No inotify: stat the watched files a few times per second.
+        uint64_t now = SDL_GetTicks();
+        if (now - m_LastPollTicks < 250)
+        {
+            return;
+        }
+        m_LastPollTicks = now;
+        for (auto &[path, lastTime] : m_FileTimes)
+        {
+            std::error_code ec;
+            auto time = std::filesystem::last_write_time(path, ec);
+            if (ec)
+            {
+                continue;
+            }
+            int64_t ticks = static_cast<int64_t>(time.time_since_epoch().count());
+            if (ticks != lastTime)
+            {
+                lastTime = ticks;
+                markDirty(path);
+            }
+        }
+#endif
+    }
+
+    void ShaderHotReload::markDirty(const std::string &fullPath)
+    {
+        const std::string path = normalizePath(fullPath);
+        for (Entry &entry : m_Entries)
+        {
+            if (entry.vertexFile == path || entry.fragmentFile == path)
+            {
+                if (!entry.dirty)
+                {
+                    LOG_INFO("ShaderHotReload: '{}' changed.", path);
+                }
+                entry.dirty = true;
+                entry.dirtySince = SDL_GetTicks();
+                entry.failedReads = 0;
+            }
+        }
+    }
+
+    size_t ShaderHotReload::getPendingCount() const
+    {
+        return static_cast<size_t>(std::count_if(m_Entries.begin(), m_Entries.end(), [](const Entry &e)
+                                                 { return e.dirty || e.shader->isReloadPending(); }));
+    }
+
+    void ShaderHotReload::update()
+    {
+        if (!m_Initialized || !m_Enabled || m_Entries.empty())
+        {
+            return;
+        }
+
+        const uint64_t start = SDL_GetPerformanceCounter();
+        const double ticksPerMs = static_cast<double>(SDL_GetPerformanceFrequency()) / 1000.0;
+        auto overBudget = [&]()
+        {
+            return static_cast<double>(SDL_GetPerformanceCounter() - start) / ticksPerMs >= m_FrameBudgetMs;
+        };
+
+        pollChanges();
+
+        // Swap in programs the driver has finished with. Programs are only replaced here, between
+        // frames, so a frame never mixes old and new versions.
+        for (Entry &entry : m_Entries)
+        {
+            if (overBudget())
+            {
+                return;
+            }
+            if (entry.shader->isReloadPending() && entry.shader->isReloadReady())
+            {
+                if (entry.shader->finishReload())
+                {
+                    m_ReloadCount++;
+                }
+                else
+                {
+                    m_FailureCount++;
+                }
+            }
+        }
+
+        // Kick off new compiles for files that have settled.
+        const uint64_t now = SDL_GetTicks();
+        for (Entry &entry : m_Entries)
+        {
+            if (!entry.dirty || now - entry.dirtySince < kDebounceMs || overBudget())
+            {
+                continue;
+            }
+
+            std::string vertexSource;
+            std::string fragmentSource;
+            if (!readTextFile(entry.vertexFile, vertexSource) || !readTextFile(entry.fragmentFile, fragmentSource))
+            {
+                // Probably caught mid-save: try again after another debounce. A file that stays
+                // unreadable (deleted, renamed) waits for the next change event instead.
+                entry.dirtySince = now;
+                if (++entry.failedReads >= kMaxFailedReads)
+                {
+                    LOG_WARN("ShaderHotReload: could not read '{}' / '{}'.", entry.vertexFile, entry.fragmentFile);
+                    entry.dirty = false;
+                }
+                continue;
+            }
+
+            entry.dirty = false;
+            entry.failedReads = 0;
+            entry.shader->beginReload(vertexSource.c_str(), fragmentSource.c_str());
+        }
+    }
+
+} // namespace Base
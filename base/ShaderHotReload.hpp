@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace Base
+{
+    class Shader;
+
+    // Watches the source files of every Shader loaded with loadFromFile() and rebuilds the affected
+    // programs when they change (desktop only). Rebuilds are issued without waiting on the driver and
+    // swapped in by update() at the start of a frame; a program that fails to compile or link is
+    // discarded and the previous one stays in use.
+    class ShaderHotReload
+    {
+    public:
+        static ShaderHotReload &Get();
+
+        ShaderHotReload() = default;
+        ~ShaderHotReload();
+
+        ShaderHotReload(const ShaderHotReload &) = delete;
+        ShaderHotReload &operator=(const ShaderHotReload &) = delete;
+
+        void initialize();
+        void shutdown();
+
+        void registerShader(Shader *shader);
+        void unregisterShader(Shader *shader);
+
+        // Called once per frame, before the application's update/render.
+        void update();
+
+        void setEnabled(bool enabled) { m_Enabled = enabled; }
+        bool isEnabled() const { return m_Enabled; }
+        // Upper bound on the time update() spends per frame; work that does not fit waits for the next frame.
+        void setFrameBudget(float milliseconds) { m_FrameBudgetMs = milliseconds; }
+        float getFrameBudget() const { return m_FrameBudgetMs; }
+
+        size_t getWatchedShaderCount() const { return m_Entries.size(); }
+        size_t getPendingCount() const;
+        uint32_t getReloadCount() const { return m_ReloadCount; }
+        uint32_t getFailureCount() const { return m_FailureCount; }
+
+    private:
+        struct Entry
+        {
+            Shader *shader = nullptr;
+            std::string vertexFile;
+            std::string fragmentFile;
+            bool dirty = false;
+            uint64_t dirtySince = 0;
+            uint32_t failedReads = 0; // In a row, since the last change event
+        };
+
+        std::string resolveWatchPath(const std::string &relativePath) const;
+        void watchFile(const std::string &fullPath);
+        void pollChanges();
+        void markDirty(const std::string &fullPath);
+
+        std::vector<Entry> m_Entries;
+        bool m_Initialized = false;
+        bool m_Enabled = true;
+        float m_FrameBudgetMs = 2.0f;
+        uint32_t m_ReloadCount = 0;
+        uint32_t m_FailureCount = 0;
+
+#if PLATFORM_LINUX
+        int m_InotifyFd = -1;
+        std::unordered_map<int, std::string> m_WatchDirectories; // inotify watch descriptor -> directory
+#else
+        std::unordered_map<std::string, int64_t> m_FileTimes; // path -> last seen write time
+        uint64_t m_LastPollTicks = 0;
+#endif
+    };
+
+} // namespace Base
@@ -0,0 +1,550 @@
+#include "SpirvModule.hpp"
+#include "Log.hpp"
+
+#include <cstring>
+
+namespace Base
+{
+    namespace
+    {
+        constexpr uint32_t kSpirvMagic = 0x07230203;
+        constexpr size_t kHeaderWords = 5;
+
+        // Opcodes
+        constexpr uint32_t OpName = 5;
+        constexpr uint32_t OpMemberName = 6;
+        constexpr uint32_t OpTypeBool = 20;
+        constexpr uint32_t OpTypeInt = 21;
+        constexpr uint32_t OpTypeFloat = 22;
+        constexpr uint32_t OpTypeVector = 23;
+        constexpr uint32_t OpTypeMatrix = 24;
+        constexpr uint32_t OpTypeImage = 25;
+        constexpr uint32_t OpTypeSampledImage = 27;
+        constexpr uint32_t OpTypeArray = 28;
+        constexpr uint32_t OpTypeStruct = 30;
+        constexpr uint32_t OpTypePointer = 32;
+        constexpr uint32_t OpConstant = 43;
+        constexpr uint32_t OpVariable = 59;
+        constexpr uint32_t OpDecorate = 71;
+        constexpr uint32_t OpMemberDecorate = 72;
+
+        // Decorations
+        constexpr uint32_t DecorationSpecId = 1;
+        constexpr uint32_t DecorationBlock = 2;
+        constexpr uint32_t DecorationArrayStride = 6;
+        constexpr uint32_t DecorationMatrixStride = 7;
+        constexpr uint32_t DecorationLocation = 30;
+        constexpr uint32_t DecorationBinding = 33;
+        constexpr uint32_t DecorationOffset = 35;
+
+        // Storage classes
+        constexpr uint32_t StorageUniformConstant = 0;
+        constexpr uint32_t StorageInput = 1;
+        constexpr uint32_t StorageUniform = 2;
+
+        // Image dimensionality
+        constexpr uint32_t Dim2D = 1;
+        constexpr uint32_t Dim3D = 2;
+        constexpr uint32_t DimCube = 3;
+
+        std::string readString(const uint32_t *words, size_t wordCount)
+        {
+            const char *chars = reinterpret_cast<const char *>(words);
+            return std::string(chars, strnlen(chars, wordCount * sizeof(uint32_t)));
+        }
+
+        uint64_t memberKey(uint32_t structId, uint32_t member)
+        {
+            return (static_cast<uint64_t>(structId) << 32) | member;
+        }
+    }
+
+    bool SpirvModule::load(const void *data, size_t size)
+    {
+        if (size < kHeaderWords * sizeof(uint32_t) || size % sizeof(uint32_t) != 0)
+        {
+            return false;
+        }
+        m_Words.resize(size / sizeof(uint32_t));
+        std::memcpy(m_Words.data(), data, size);
+        if (m_Words[0] != kSpirvMagic)
+        {
+            m_Words.clear();
+            return false;
+        }
+
+        for (size_t i = kHeaderWords; i < m_Words.size();)
+        {
+            const uint32_t opcode = m_Words[i] & 0xFFFF;
+            const uint32_t wordCount = m_Words[i] >> 16;
+            if (wordCount == 0 || i + wordCount > m_Words.size())
+            {
+                LOG_ERROR("SPIR-V module is truncated at word {}.", i);
+                m_Words.clear();
+                return false;
+            }
+            const uint32_t *op = &m_Words[i];
+
+            switch (opcode)
+            {
+            case OpName:
+                m_Names[op[1]] = readString(op + 2, wordCount - 2);
+                break;
+            case OpMemberName:
+            {
+                auto &names = m_MemberNames[op[1]];
+                if (names.size() <= op[2])
+                {
+                    names.resize(op[2] + 1);
+                }
+                names[op[2]] = readString(op + 3, wordCount - 3);
+                break;
+            }
+            case OpTypeBool:
+                m_Types[op[1]].opcode = opcode;
+                break;
+            case OpTypeInt:
+            case OpTypeFloat:
+            {
+                Type &type = m_Types[op[1]];
+                type.opcode = opcode;
+                type.width = op[2];
+                type.isSigned = opcode == OpTypeInt ? op[3] != 0 : true;
+                break;
+            }
+            case OpTypeVector:
+            case OpTypeMatrix:
+            case OpTypeArray:
+            {
+                Type &type = m_Types[op[1]];
+                type.opcode = opcode;
+                type.componentType = op[2];
+                type.count = op[3];
+                break;
+            }
+            case OpTypeImage:
+            {
+                Type &type = m_Types[op[1]];
+                type.opcode = opcode;
+                type.componentType = op[2];
+                type.dim = op[3];
+                type.depth = op[4] == 1;
+                type.arrayed = op[5] != 0;
+                type.multisampled = op[6] != 0;
+                break;
+            }
+            case OpTypeSampledImage:
+            {
+                Type &type = m_Types[op[1]];
+                type.opcode = opcode;
+                type.componentType = op[2];
+                break;
+            }
+            case OpTypeStruct:
+            {
+                Type &type = m_Types[op[1]];
+                type.opcode = opcode;
+                type.members.assign(op + 2, op + wordCount);
+                break;
+            }
+            case OpTypePointer:
+            {
+                Type &type = m_Types[op[1]];
+                type.opcode = opcode;
+                type.componentType = op[3];
+                break;
+            }
+            case OpConstant:
+                if (wordCount >= 4)
+                {
+                    m_Constants[op[2]] = op[3];
+                }
+                break;
+            case OpVariable:
+                m_Variables.push_back({op[2], op[1], op[3]});
+                break;
+            case OpDecorate:
+            {
+                Decorations &decorations = m_Decorations[op[1]];
+                switch (op[2])
+                {
+                case DecorationSpecId: decorations.specId = static_cast<int32_t>(op[3]); break;
+                case DecorationBlock: decorations.block = true; break;
+                case DecorationArrayStride: decorations.arrayStride = static_cast<int32_t>(op[3]); break;
+                case DecorationLocation: decorations.location = static_cast<int32_t>(op[3]); break;
+                case DecorationBinding:
+                    decorations.binding = static_cast<int32_t>(op[3]);
+                    decorations.bindingWord = i + 3;
+                    break;
+                default: break;
+                }
+                break;
+            }
+            case OpMemberDecorate:
+            {
+                MemberDecorations &decorations = m_MemberDecorations[memberKey(op[1], op[2])];
+                if (op[3] == DecorationOffset)
+                {
+                    decorations.offset = static_cast<int32_t>(op[4]);
+                }
+                else if (op[3] == DecorationMatrixStride)
+                {
+                    decorations.matrixStride = static_cast<int32_t>(op[4]);
+                }
+                break;
+            }
+            default:
+                break;
+            }
+            i += wordCount;
+        }
+        return true;
+    }
+
+    std::string SpirvModule::nameOf(uint32_t id) const
+    {
+        auto it = m_Names.find(id);
+        return it != m_Names.end() ? it->second : std::string();
+    }
+
+    const SpirvModule::Type *SpirvModule::typeOf(uint32_t id) const
+    {
+        auto it = m_Types.find(id);
+        return it != m_Types.end() ? &it->second : nullptr;
+    }
+
+    uint32_t SpirvModule::arrayLength(const Type &type) const
+    {
+        auto it = m_Constants.find(type.count);
+        return it != m_Constants.end() ? it->second : 1;
+    }
+
+    void SpirvModule::remapBlockBindings(const std::function<GLuint(const std::string &)> &bindingForBlock)
+    {
+        for (const Variable &variable : m_Variables)
+        {
+            if (variable.storageClass != StorageUniform)
+            {
+                continue;
+            }
+            const Type *pointer = typeOf(variable.pointerType);
+            auto decorations = m_Decorations.find(variable.id);
+            if (!pointer || decorations == m_Decorations.end() || decorations->second.bindingWord == 0)
+            {
+                continue;
+            }
+            std::string blockName = nameOf(pointer->componentType);
+            if (!blockName.empty())
+            {
+                const GLuint binding = bindingForBlock(blockName);
+                m_Words[decorations->second.bindingWord] = binding;
+                decorations->second.binding = static_cast<int32_t>(binding);
+            }
+        }
+    }
+
+    bool SpirvModule::findSpecConstant(std::string_view name, GLuint &specId) const
+    {
+        for (const auto &[id, decorations] : m_Decorations)
+        {
+            if (decorations.specId >= 0 && nameOf(id) == name)
+            {
+                specId = static_cast<GLuint>(decorations.specId);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    GLenum SpirvModule::glTypeOf(uint32_t typeId) const
+    {
+        const Type *type = typeOf(typeId);
+        if (!type)
+        {
+            return 0;
+        }
+
+        switch (type->opcode)
+        {
+        case OpTypeBool: return GL_BOOL;
+        case OpTypeFloat: return GL_FLOAT;
+        case OpTypeInt: return type->isSigned ? GL_INT : GL_UNSIGNED_INT;
+        case OpTypeArray: return glTypeOf(type->componentType);
+        case OpTypeVector:
+        {
+            static const GLenum floats[] = {GL_FLOAT_VEC2, GL_FLOAT_VEC3, GL_FLOAT_VEC4};
+            static const GLenum ints[] = {GL_INT_VEC2, GL_INT_VEC3, GL_INT_VEC4};
+            static const GLenum uints[] = {GL_UNSIGNED_INT_VEC2, GL_UNSIGNED_INT_VEC3, GL_UNSIGNED_INT_VEC4};
+            static const GLenum bools[] = {GL_BOOL_VEC2, GL_BOOL_VEC3, GL_BOOL_VEC4};
+            const Type *component = typeOf(type->componentType);
+            if (!component || type->count < 2 || type->count > 4)
+            {
+                return 0;
+            }
+            const uint32_t index = type->count - 2;
+            switch (component->opcode)
+            {
+            case OpTypeFloat: return floats[index];
+            case OpTypeInt: return component->isSigned ? ints[index] : uints[index];
+            case OpTypeBool: return bools[index];
+            default: return 0;
+            }
+        }
+        case OpTypeMatrix:
+        {
+            // [columns - 2][rows - 2]
+            static const GLenum matrices[3][3] = {
+                {GL_FLOAT_MAT2, GL_FLOAT_MAT2x3, GL_FLOAT_MAT2x4},
+                {GL_FLOAT_MAT3x2, GL_FLOAT_MAT3, GL_FLOAT_MAT3x4},
+                {GL_FLOAT_MAT4x2, GL_FLOAT_MAT4x3, GL_FLOAT_MAT4}};
+            const Type *column = typeOf(type->componentType);
+            if (!column || type->count < 2 || type->count > 4 || column->count < 2 || column->count > 4)
+            {
+                return 0;
+            }
+            return matrices[type->count - 2][column->count - 2];
+        }
+        case OpTypeSampledImage:
+        {
+            const Type *image = typeOf(type->componentType);
+            const Type *sampled = image ? typeOf(image->componentType) : nullptr;
+            if (!image || !sampled)
+            {
+                return 0;
+            }
+            const bool isInt = sampled->opcode == OpTypeInt;
+            const bool isUnsigned = isInt && !sampled->isSigned;
+            switch (image->dim)
+            {
+            case Dim2D:
+                if (image->multisampled)
+                    return GL_SAMPLER_2D_MULTISAMPLE;
+                if (image->depth)
+                    return image->arrayed ? GL_SAMPLER_2D_ARRAY_SHADOW : GL_SAMPLER_2D_SHADOW;
+                if (image->arrayed)
+                    return isUnsigned ? GL_UNSIGNED_INT_SAMPLER_2D_ARRAY : isInt ? GL_INT_SAMPLER_2D_ARRAY : GL_SAMPLER_2D_ARRAY;
+                return isUnsigned ? GL_UNSIGNED_INT_SAMPLER_2D : isInt ? GL_INT_SAMPLER_2D : GL_SAMPLER_2D;
+            case Dim3D:
+                return isUnsigned ? GL_UNSIGNED_INT_SAMPLER_3D : isInt ? GL_INT_SAMPLER_3D : GL_SAMPLER_3D;
+            case DimCube:
+                if (image->depth)
+                    return GL_SAMPLER_CUBE_SHADOW;
+                return isUnsigned ? GL_UNSIGNED_INT_SAMPLER_CUBE : isInt ? GL_INT_SAMPLER_CUBE : GL_SAMPLER_CUBE;
+            default:
+                return 0;
+            }
+        }
+        default:
+            return 0;
+        }
+    }
+
+    uint32_t SpirvModule::locationCount(uint32_t typeId) const
+    {
+        // Default-block uniforms: every (array element of a) non-struct member takes one location.
+        const Type *type = typeOf(typeId);
+        if (!type)
+        {
+            return 1;
+        }
+        if (type->opcode == OpTypeArray)
+        {
+            return arrayLength(*type) * locationCount(type->componentType);
+        }
+        if (type->opcode == OpTypeStruct)
+        {
+            uint32_t count = 0;
+            for (uint32_t member : type->members)
+            {
+                count += locationCount(member);
+            }
+            return count;
+        }
+        return 1;
+    }
+
+    uint32_t SpirvModule::byteSize(uint32_t typeId, const MemberDecorations &decorations) const
+    {
+        const Type *type = typeOf(typeId);
+        if (!type)
+        {
+            return 0;
+        }
+        switch (type->opcode)
+        {
+        case OpTypeBool:
+            return 4;
+        case OpTypeInt:
+        case OpTypeFloat:
+            return type->width / 8;
+        case OpTypeVector:
+            return type->count * byteSize(type->componentType, decorations);
+        case OpTypeMatrix:
+            return type->count * static_cast<uint32_t>(decorations.matrixStride);
+        case OpTypeArray:
+        {
+            auto stride = m_Decorations.find(typeId);
+            const uint32_t arrayStride = stride != m_Decorations.end() ? static_cast<uint32_t>(stride->second.arrayStride) : 0;
+            return arrayLength(*type) * arrayStride;
+        }
+        case OpTypeStruct:
+        {
+            if (type->members.empty())
+            {
+                return 0;
+            }
+            const uint32_t last = static_cast<uint32_t>(type->members.size() - 1);
+            auto lastDecorations = m_MemberDecorations.find(memberKey(typeId, last));
+            if (lastDecorations == m_MemberDecorations.end())
+            {
+                return 0;
+            }
+            return static_cast<uint32_t>(lastDecorations->second.offset) + byteSize(type->members[last], lastDecorations->second);
+        }
+        default:
+            return 0;
+        }
+    }
+
+    void SpirvModule::flattenUniform(uint32_t typeId, const std::string &name, GLint location, std::vector<ShaderResource> &out) const
+    {
+        const Type *type = typeOf(typeId);
+        if (!type)
+        {
+            return;
+        }
+
+        if (type->opcode == OpTypeStruct)
+        {
+            auto names = m_MemberNames.find(typeId);
+            GLint memberLocation = location;
+            for (size_t m = 0; m < type->members.size(); ++m)
+            {
+                const std::string memberName = names != m_MemberNames.end() && m < names->second.size() ? names->second[m] : std::to_string(m);
+                flattenUniform(type->members[m], name + "." + memberName, memberLocation, out);
+                memberLocation += static_cast<GLint>(locationCount(type->members[m]));
+            }
+            return;
+        }
+
+        const Type *element = type->opcode == OpTypeArray ? typeOf(type->componentType) : type;
+        if (type->opcode == OpTypeArray && element && element->opcode == OpTypeStruct)
+        {
+            const uint32_t stride = locationCount(type->componentType);
+            for (uint32_t i = 0; i < arrayLength(*type); ++i)
+            {
+                flattenUniform(type->componentType, name + "[" + std::to_string(i) + "]", location + static_cast<GLint>(i * stride), out);
+            }
+            return;
+        }
+
+        ShaderResource resource;
+        resource.name = name;
+        resource.type = glTypeOf(typeId);
+        resource.kind = element && element->opcode == OpTypeSampledImage ? ShaderResource::Kind::Sampler : ShaderResource::Kind::Uniform;
+        resource.size = type->opcode == OpTypeArray ? static_cast<GLint>(arrayLength(*type)) : 1;
+        resource.location = location;
+        out.push_back(std::move(resource));
+    }
+
+    void SpirvModule::flattenBlock(uint32_t structId, const std::string &prefix, GLint baseOffset, GLint blockIndex,
+                                   std::vector<ShaderResource> &out) const
+    {
+        const Type *type = typeOf(structId);
+        if (!type)
+        {
+            return;
+        }
+        auto names = m_MemberNames.find(structId);
+        for (size_t m = 0; m < type->members.size(); ++m)
+        {
+            const uint32_t memberType = type->members[m];
+            const std::string memberName = prefix + (names != m_MemberNames.end() && m < names->second.size() ? names->second[m] : std::to_string(m));
+            auto decorations = m_MemberDecorations.find(memberKey(structId, static_cast<uint32_t>(m)));
+            const GLint offset = baseOffset + (decorations != m_MemberDecorations.end() ? decorations->second.offset : 0);
+
+            const Type *member = typeOf(memberType);
+            if (member && member->opcode == OpTypeStruct)
+            {
+                flattenBlock(memberType, memberName + ".", offset, blockIndex, out);
+                continue;
+            }
+
+            ShaderResource resource;
+            resource.kind = ShaderResource::Kind::Uniform;
+            resource.name = memberName;
+            resource.type = glTypeOf(memberType);
+            resource.size = 1;
+            resource.blockIndex = blockIndex;
+            resource.offset = offset;
+            if (member && member->opcode == OpTypeArray)
+            {
+                resource.size = static_cast<GLint>(arrayLength(*member));
+                auto stride = m_Decorations.find(memberType);
+                resource.arrayStride = stride != m_Decorations.end() ? stride->second.arrayStride : 0;
+            }
+            out.push_back(std::move(resource));
+        }
+    }
+
+    void SpirvModule::reflect(bool isVertexStage, std::vector<ShaderResource> &out,
+                              std::unordered_map<std::string, GLint> &blockIndices) const
+    {
+        for (const Variable &variable : m_Variables)
+        {
+            const Type *pointer = typeOf(variable.pointerType);
+            if (!pointer)
+            {
+                continue;
+            }
+            const uint32_t typeId = pointer->componentType;
+            auto decorations = m_Decorations.find(variable.id);
+            const GLint location = decorations != m_Decorations.end() ? decorations->second.location : -1;
+
+            if (variable.storageClass == StorageInput && isVertexStage)
+            {
+                std::string name = nameOf(variable.id);
+                if (name.empty() || name.rfind("gl_", 0) == 0)
+                {
+                    continue; // built-ins
+                }
+                ShaderResource resource;
+                resource.kind = ShaderResource::Kind::Attribute;
+                resource.name = std::move(name);
+                resource.type = glTypeOf(typeId);
+                resource.size = 1;
+                resource.location = location;
+                out.push_back(std::move(resource));
+            }
+            else if (variable.storageClass == StorageUniformConstant)
+            {
+                flattenUniform(typeId, nameOf(variable.id), location, out);
+            }
+            else if (variable.storageClass == StorageUniform)
+            {
+                auto typeDecorations = m_Decorations.find(typeId);
+                if (typeDecorations == m_Decorations.end() || !typeDecorations->second.block)
+                {
+                    continue;
+                }
+                const std::string blockName = nameOf(typeId);
+                auto [index, inserted] = blockIndices.try_emplace(blockName, static_cast<GLint>(blockIndices.size()));
+                if (inserted)
+                {
+                    ShaderResource block;
+                    block.kind = ShaderResource::Kind::UniformBlock;
+                    block.name = blockName;
+                    block.size = static_cast<GLint>((byteSize(typeId, {}) + 15) / 16 * 16);
+                    block.location = index->second;
+                    block.binding = decorations != m_Decorations.end() ? decorations->second.binding : -1;
+                    out.push_back(std::move(block));
+                }
+
+                // Like the GL API, members of a block with an instance name are reported as "Block.member".
+                const bool hasInstanceName = !nameOf(variable.id).empty();
+                flattenBlock(typeId, hasInstanceName ? blockName + "." : std::string(), 0, index->second, out);
+            }
+        }
+    }
+
+} // namespace Base
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Shader.hpp"
+
+namespace Base
+{
+    // Minimal reader for offline-compiled SPIR-V modules (GL_ARB_gl_spirv). Drivers do not report
+    // names for SPIR-V programs, so the uniform/attribute/block table Shader relies on is rebuilt
+    // here from the module's debug names and decorations.
+    class SpirvModule
+    {
+    public:
+        bool load(const void *data, size_t size);
+
+        const std::vector<uint32_t> &getWords() const { return m_Words; }
+
+        // Rewrites the Binding decoration of every uniform block to bindingForBlock(blockName).
+        void remapBlockBindings(const std::function<GLuint(const std::string &)> &bindingForBlock);
+
+        // Looks up the SpecId of a specialization constant by its debug name.
+        bool findSpecConstant(std::string_view name, GLuint &specId) const;
+
+        // Appends the module's attributes (vertex stage only), uniforms, samplers and uniform blocks.
+        // blockIndices maps block names to the indices used for ShaderResource::blockIndex.
+        void reflect(bool isVertexStage, std::vector<ShaderResource> &out,
+                     std::unordered_map<std::string, GLint> &blockIndices) const;
+
+    private:
+        struct Type
+        {
+            uint32_t opcode = 0;
+            uint32_t componentType = 0; // vector/matrix/array element, pointer pointee, sampled image's image
+            uint32_t count = 0;         // vector components, matrix columns, array length id
+            uint32_t width = 0;         // scalar bit width
+            bool isSigned = false;
+            uint32_t dim = 0;           // image dimensionality
+            bool depth = false;
+            bool arrayed = false;
+            bool multisampled = false;
+            std::vector<uint32_t> members; // struct member type ids
+        };
+
+        struct Decorations
+        {
+            int32_t location = -1;
+            int32_t binding = -1;
+            int32_t specId = -1;
+            int32_t arrayStride = 0;
+            bool block = false;
+            size_t bindingWord = 0; // index of the Binding literal in m_Words
+        };
+
+        struct MemberDecorations
+        {
+            int32_t offset = -1;
+            int32_t matrixStride = 0;
+        };
+
+        struct Variable
+        {
+            uint32_t id = 0;
+            uint32_t pointerType = 0;
+            uint32_t storageClass = 0;
+        };
+
+        std::string nameOf(uint32_t id) const;
+        const Type *typeOf(uint32_t id) const;
+        uint32_t arrayLength(const Type &type) const;
+        GLenum glTypeOf(uint32_t typeId) const;
+        uint32_t locationCount(uint32_t typeId) const;
+        uint32_t byteSize(uint32_t typeId, const MemberDecorations &decorations) const;
+        void flattenUniform(uint32_t typeId, const std::string &name, GLint location, std::vector<ShaderResource> &out) const;
+        void flattenBlock(uint32_t structId, const std::string &prefix, GLint baseOffset, GLint blockIndex,
+                          std::vector<ShaderResource> &out) const;
+
+        std::vector<uint32_t> m_Words;
+        std::unordered_map<uint32_t, std::string> m_Names;
+        std::unordered_map<uint32_t, std::vector<std::string>> m_MemberNames;
+        std::unordered_map<uint32_t, Decorations> m_Decorations;
+        std::unordered_map<uint64_t, MemberDecorations> m_MemberDecorations; // (struct id << 32) | member
+        std::unordered_map<uint32_t, Type> m_Types;
+        std::unordered_map<uint32_t, uint32_t> m_Constants;
+        std::vector<Variable> m_Variables;
+    };
+
+} // namespace Base
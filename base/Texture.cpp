@@ -1,20 +1,96 @@
-#define STBI_NO_JPEG
-//#define STBI_NO_PNG
-#define STBI_NO_BMP
-#define STBI_NO_PSD
-#define STBI_NO_TGA
-#define STBI_NO_GIF
-#define STBI_NO_HDR
-#define STBI_NO_PIC
-#define STBI_NO_PNM
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
-
+#include "AssetFile.hpp"
+#include "HdrImage.hpp"
 #include "Log.hpp"
+#include "SamplerCache.hpp"
 #include "Texture.hpp"
 
+#include <algorithm>
+
 namespace Base
 {
+    namespace
+    {
+        bool hasTextureStorage()
+        {
+#if PLATFORM_DESKTOP
+            return GLAD_GL_VERSION_4_2 || GLAD_GL_ARB_texture_storage; // Not on macOS' 4.1 context
+#else
+            return true; // Core in GLES 3.0
+#endif
+        }
+
+        GLsizei mipLevelCount(int width, int height)
+        {
+            GLsizei levels = 1;
+            for (int size = std::max(width, height); size > 1; size /= 2)
+            {
+                levels++;
+            }
+            return levels;
+        }
+
+        // Fills one mip level of a face, or of all `layers` of an array, either inside immutable
+        // storage or by specifying the level.
+        void uploadLevel(GLenum target, GLint mip, const ContainerImage &image, const ImageLevel &level, GLsizei layers, bool immutable)
+        {
+            const uint8_t *pixels = image.data.data() + level.offset;
+            const bool compressed = image.codec != TextureCodec::None;
+            if (target == GL_TEXTURE_2D_ARRAY)
+            {
+                const GLsizei size = static_cast<GLsizei>(level.size) * layers;
+                if (compressed && immutable)
+                {
+                    glCompressedTexSubImage3D(target, mip, 0, 0, 0, level.width, level.height, layers, image.internalFormat, size, pixels);
+                }
+                else if (compressed)
+                {
+                    glCompressedTexImage3D(target, mip, image.internalFormat, level.width, level.height, layers, 0, size, pixels);
+                }
+                else if (immutable)
+                {
+                    glTexSubImage3D(target, mip, 0, 0, 0, level.width, level.height, layers, image.pixelFormat, image.pixelType, pixels);
+                }
+                else
+                {
+                    glTexImage3D(target, mip, static_cast<GLint>(image.internalFormat), level.width, level.height, layers, 0,
+                                 image.pixelFormat, image.pixelType, pixels);
+                }
+                return;
+            }
+
+            if (compressed && immutable)
+            {
+                glCompressedTexSubImage2D(target, mip, 0, 0, level.width, level.height, image.internalFormat,
+                                          static_cast<GLsizei>(level.size), pixels);
+            }
+            else if (compressed)
+            {
+                glCompressedTexImage2D(target, mip, image.internalFormat, level.width, level.height, 0,
+                                       static_cast<GLsizei>(level.size), pixels);
+            }
+            else if (immutable)
+            {
+                glTexSubImage2D(target, mip, 0, 0, level.width, level.height, image.pixelFormat, image.pixelType, pixels);
+            }
+            else
+            {
+                glTexImage2D(target, mip, static_cast<GLint>(image.internalFormat), level.width, level.height, 0,
+                             image.pixelFormat, image.pixelType, pixels);
+            }
+        }
+
+        SamplerState samplerStateFor(const TextureSettings &settings, bool cubemap)
+        {
+            SamplerState state;
+            // Cube maps always clamp, or the face edges would filter against the opposite side.
+            state.wrapS = cubemap ? GL_CLAMP_TO_EDGE : settings.wrapS;
+            state.wrapT = cubemap ? GL_CLAMP_TO_EDGE : settings.wrapT;
+            state.wrapR = cubemap ? GL_CLAMP_TO_EDGE : GL_REPEAT;
+            state.minFilter = settings.minFilter;
+            state.magFilter = settings.magFilter;
+            return state;
+        }
+    } // namespace
 
     Texture::Texture()
     {
@@ -29,76 +105,289 @@ namespace Base
         }
     }
 
-    bool Texture::loadFromFile(const std::string &path)
+    bool Texture::readImageFile(const std::string &path, ImageData &image)
+    {
+        AssetFile file;
+        if (!file.open(path))
+        {
+            LOG_ERROR("TEXTURE::LOAD_FAILED: could not open '{}'.", path);
+            return false;
+        }
+
+        // Decoders return the rows bottom first, as OpenGL expects.
+        return ImageDecoder::decodeImage(file.data(), file.size(), path, image);
+    }
+
+    bool Texture::readContainerFile(const std::string &path, ContainerImage &image)
     {
-        // OpenGL expects textures to be flipped vertically
-        stbi_set_flip_vertically_on_load(true);
+        AssetFile file;
+        if (!file.open(path))
+        {
+            LOG_ERROR("TEXTURE::LOAD_FAILED: could not open '{}'.", path);
+            return false;
+        }
+        return TextureCompression::load(file.data(), file.size(), path, image);
+    }
 
-        std::string fullPath = resolveAssetPath(path);
-        size_t fileSize = 0;
-        void* fileData = SDL_LoadFile(fullPath.c_str(), &fileSize);
+    std::string Texture::bakedPathFor(const std::string &path)
+    {
+        const size_t dot = path.find_last_of('.');
+        const size_t slash = path.find_last_of("/\\");
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+        {
+            return path + ".ktx2";
+        }
+        return path.substr(0, dot) + ".ktx2";
+    }
 
-         if (!fileData) {
-            LOG_ERROR("TEXTURE::LOAD_FAILED: SDL_LoadFile could not open '{}': {}", fullPath, SDL_GetError());
+    bool Texture::readBakedFile(const std::string &path, ContainerImage &image)
+    {
+        // Not finding one is the normal case (web/mobile builds, no baker run), so stay quiet about it.
+        AssetFile file;
+        if (!file.open(bakedPathFor(path)))
+        {
             return false;
         }
+        return decodeBakedFile(bakedPathFor(path), file.data(), file.size(), image);
+    }
 
-        unsigned char *data = stbi_load_from_memory(
-            static_cast<const stbi_uc*>(fileData),
-            static_cast<int>(fileSize),
-            &m_Width, &m_Height, &m_NrChannels, 0
-        );
+    bool Texture::decodeBakedFile(const std::string &bakedPath, const uint8_t *data, size_t size, ContainerImage &image)
+    {
+        if (!TextureCompression::load(data, size, bakedPath, image))
+        {
+            return false;
+        }
+        // The source would have been sampled without sRGB decoding; keep the chapters looking the same.
+        TextureCompression::useLinearFormat(image);
+        return true;
+    }
 
-        SDL_free(fileData);
+    bool Texture::allocate(int width, int height, int channels, const TextureSettings &settings)
+    {
+        GLenum internalFormat = 0;
+        if (channels == 1)
+        {
+            m_Format = GL_RED;
+            internalFormat = GL_R8;
+        }
+        else if (channels == 3)
+        {
+            m_Format = GL_RGB;
+            internalFormat = GL_RGB8;
+        }
+        else if (channels == 4)
+        {
+            m_Format = GL_RGBA;
+            internalFormat = GL_RGBA8;
+        }
+        else
+        {
+            LOG_ERROR("TEXTURE::LOAD_FAILED: Unsupported number of channels ({})", channels);
+            return false;
+        }
+        m_Target = GL_TEXTURE_2D;
+        m_LayerCount = 1;
+        m_Width = width;
+        m_Height = height;
+        m_NrChannels = channels;
+        // A full mip chain adds a third on top of level 0.
+        m_ByteSize = static_cast<size_t>(width) * height * channels;
+        m_ByteSize += m_ByteSize / 3;
 
-        if (data)
+        glBindTexture(GL_TEXTURE_2D, m_ID);
+        if (hasTextureStorage())
         {
-            GLenum format;
-            if (m_NrChannels == 1)
-                format = GL_RED;
-            else if (m_NrChannels == 3)
-                format = GL_RGB;
-            else if (m_NrChannels == 4)
-                format = GL_RGBA;
-            else
+            // Room for the whole chain up front; generateMipmaps() fills it in place.
+            glTexStorage2D(GL_TEXTURE_2D, mipLevelCount(width, height), internalFormat, width, height);
+        }
+        else
+        {
+            glTexImage2D(GL_TEXTURE_2D, 0, static_cast<GLint>(internalFormat), width, height, 0, m_Format, GL_UNSIGNED_BYTE, nullptr);
+        }
+        m_Sampler = SamplerCache::Get().acquire(samplerStateFor(settings, false));
+        return true;
+    }
+
+    size_t Texture::getByteSize() const
+    {
+        return m_ByteSize;
+    }
+
+    bool Texture::upload(const ContainerImage &image, const TextureSettings &settings)
+    {
+        const int imagesPerLevel = image.imagesPerLevel();
+        if (image.levels.empty() || image.levels.size() % imagesPerLevel != 0)
+        {
+            return false;
+        }
+        const bool cubemap = image.faceCount == 6;
+        const bool array = image.layerCount > 0;
+        m_Target = cubemap ? GL_TEXTURE_CUBE_MAP : array ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D;
+        m_Width = image.width;
+        m_Height = image.height;
+        m_LayerCount = array ? image.layerCount : 1;
+        m_NrChannels = image.pixelFormat == GL_RGB ? 3 : 4;
+        m_Format = image.pixelFormat;
+        m_ByteSize = image.data.size();
+
+        // GLES 3.0 can only generate mipmaps for color-renderable formats, which excludes half floats.
+#if PLATFORM_DESKTOP
+        const bool canGenerateMipmaps = true;
+#else
+        const bool canGenerateMipmaps = image.pixelType != GL_HALF_FLOAT;
+#endif
+        const bool generateMipmaps = image.generateMipmaps && image.codec == TextureCodec::None && canGenerateMipmaps;
+        const GLsizei fileLevels = static_cast<GLsizei>(image.levels.size() / imagesPerLevel);
+        const GLsizei storageLevels = generateMipmaps ? mipLevelCount(m_Width, m_Height) : fileLevels;
+        const bool immutable = hasTextureStorage();
+
+        glBindTexture(m_Target, m_ID);
+        if (immutable && array)
+        {
+            glTexStorage3D(m_Target, storageLevels, image.internalFormat, m_Width, m_Height, m_LayerCount);
+        }
+        else if (immutable)
+        {
+            glTexStorage2D(m_Target, storageLevels, image.internalFormat, m_Width, m_Height);
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        if (array)
+        {
+            // The layers of a level are contiguous, so one call per level uploads all of them.
+            for (size_t i = 0; i < image.levels.size(); i += imagesPerLevel)
             {
-                LOG_ERROR("TEXTURE::LOAD_FAILED: Unsupported number of channels ({}) in image '{}'", m_NrChannels, path);
-                stbi_image_free(data);
-                return false;
+                uploadLevel(m_Target, static_cast<GLint>(i / imagesPerLevel), image, image.levels[i], m_LayerCount, immutable);
             }
+        }
+        else
+        {
+            for (size_t i = 0; i < image.levels.size(); ++i)
+            {
+                const GLenum target = cubemap ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + static_cast<GLenum>(i % imagesPerLevel) : GL_TEXTURE_2D;
+                uploadLevel(target, static_cast<GLint>(i / imagesPerLevel), image, image.levels[i], 1, immutable);
+            }
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+        if (generateMipmaps)
+        {
+            glGenerateMipmap(m_Target);
+            m_ByteSize += m_ByteSize / 3;
+        }
+        else if (!immutable)
+        {
+            // Sample only the levels the file has; the texture stays complete with a mipmapped filter.
+            glTexParameteri(m_Target, GL_TEXTURE_MAX_LEVEL, fileLevels - 1);
+        }
+        m_Sampler = SamplerCache::Get().acquire(samplerStateFor(settings, cubemap));
+        return true;
+    }
+
+    void Texture::uploadRows(int firstRow, int rowCount, const void *pixels)
+    {
+        glBindTexture(GL_TEXTURE_2D, m_ID);
+        // Rows of 1- and 3-channel images are not 4-byte aligned in general.
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, firstRow, m_Width, rowCount, m_Format, GL_UNSIGNED_BYTE, pixels);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    }
+
+    void Texture::generateMipmaps()
+    {
+        glBindTexture(GL_TEXTURE_2D, m_ID);
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
 
-            glBindTexture(GL_TEXTURE_2D, m_ID);
+    bool Texture::readHdrFile(const std::string &path, int cubemapFaceSize, ContainerImage &image)
+    {
+        AssetFile file;
+        if (!file.open(path))
+        {
+            LOG_ERROR("TEXTURE::LOAD_FAILED: could not open '{}'.", path);
+            return false;
+        }
+        return HdrImage::load(file.data(), file.size(), path, cubemapFaceSize, image);
+    }
 
-            glTexImage2D(GL_TEXTURE_2D, 0, format, m_Width, m_Height, 0, format, GL_UNSIGNED_BYTE, data);
-            glGenerateMipmap(GL_TEXTURE_2D);
+    bool Texture::isGpuReadyFile(const std::string &path)
+    {
+        return TextureCompression::isContainerFile(path) || HdrImage::isHdrFile(path);
+    }
 
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    bool Texture::decodeGpuReadyFile(const std::string &path, const uint8_t *data, size_t size, int cubemapFaceSize, ContainerImage &image)
+    {
+        if (TextureCompression::isContainerFile(path))
+        {
+            return TextureCompression::load(data, size, path, image);
+        }
+        return HdrImage::load(data, size, path, cubemapFaceSize, image);
+    }
 
-            stbi_image_free(data);
+    bool Texture::readGpuReadyFile(const std::string &path, const TextureSettings &settings, ContainerImage &image, bool &loaded)
+    {
+        if (TextureCompression::isContainerFile(path))
+        {
+            loaded = readContainerFile(path, image);
+            return true;
+        }
+        // A baked panorama is 2D; cube maps are resampled from the source.
+        if (settings.cubemapFaceSize == 0 && readBakedFile(path, image))
+        {
+            loaded = true;
+            return true;
+        }
+        if (HdrImage::isHdrFile(path))
+        {
+            loaded = readHdrFile(path, settings.cubemapFaceSize, image);
+            return true;
+        }
+        return false;
+    }
 
+    bool Texture::loadFromFile(const std::string &path, const TextureSettings &settings)
+    {
+        ContainerImage container;
+        bool loaded = false;
+        if (readGpuReadyFile(path, settings, container, loaded))
+        {
+            if (!loaded || !upload(container, settings))
+            {
+                return false;
+            }
             LOG_INFO("Texture loaded successfully: {}", path);
             return true;
         }
-        else
+
+        ImageData image;
+        if (!readImageFile(path, image))
+        {
+            return false;
+        }
+
+        if (!allocate(image.width, image.height, image.channels, settings))
         {
-            LOG_ERROR("TEXTURE::LOAD_FAILED: Failed to load image at path: {}", path);
+            LOG_ERROR("TEXTURE::LOAD_FAILED: Cannot upload image '{}'", path);
             return false;
         }
+        uploadRows(0, image.height, image.pixels);
+        generateMipmaps();
+
+        LOG_INFO("Texture loaded successfully: {}", path);
+        return true;
     }
 
     void Texture::bind(GLuint textureUnit) const
     {
         glActiveTexture(GL_TEXTURE0 + textureUnit);
-        glBindTexture(GL_TEXTURE_2D, m_ID);
+        glBindTexture(m_Target, m_ID);
+        glBindSampler(textureUnit, m_Sampler);
     }
 
     void Texture::unbind(GLuint textureUnit) const
     {
         glActiveTexture(GL_TEXTURE0 + textureUnit);
-        glBindTexture(GL_TEXTURE_2D, 0);
+        glBindTexture(m_Target, 0);
+        glBindSampler(textureUnit, 0);
     }
 
 } // namespace Base
\ No newline at end of file
@@ -1,5 +1,8 @@
 #pragma once
+#include <cstddef>
 #include <string>
+#include "ImageDecoder.hpp"
+#include "TextureCompression.hpp"
 
 #if PLATFORM_DESKTOP
     #include <glad/gl.h>
@@ -12,29 +15,70 @@
 
 namespace Base {
 
+// Sampler state (and layout) baked into a texture when it is created.
+struct TextureSettings
+{
+    GLenum wrapS = GL_REPEAT;
+    GLenum wrapT = GL_REPEAT;
+    GLenum minFilter = GL_LINEAR_MIPMAP_LINEAR;
+    GLenum magFilter = GL_LINEAR;
+    // > 0: resample an equirectangular .hdr panorama into a cube map with faces of this size.
+    int cubemapFaceSize = 0;
+
+    bool operator==(const TextureSettings& other) const = default;
+};
+
 class Texture {
 public:
     Texture();
     ~Texture();
 
-    inline static std::string resolveAssetPath(const std::string& relativePath) {
-        #ifdef __ANDROID__
-            // On Android, paths are relative to the APK's assets root
-            return relativePath;
-        #else
-            // On desktop, prepend the "assets/" directory
-            return "assets/" + relativePath;
-        #endif
-    }
+    bool loadFromFile(const std::string& path, const TextureSettings& settings = {});
+
+    // Decoding half of loadFromFile. Touches no GL state, so it may run on worker threads.
+    static bool readImageFile(const std::string& path, ImageData& image);
+    // Same for .ktx2/.dds files (see TextureCompression).
+    static bool readContainerFile(const std::string& path, ContainerImage& image);
+    // Looks for the .ktx2 that tools/TextureBaker writes next to a source image ("images/uv.png"
+    // -> "images/uv.ktx2"). Returns false without logging when there is none.
+    static bool readBakedFile(const std::string& path, ContainerImage& image);
+    static std::string bakedPathFor(const std::string& path);
+    // Radiance .hdr to RGB16F, optionally as a cube map (see HdrImage).
+    static bool readHdrFile(const std::string& path, int cubemapFaceSize, ContainerImage& image);
+    // Everything that decodes straight to a ContainerImage: .ktx2/.dds, baked files, .hdr.
+    // Returns false when `path` is a plain image for readImageFile; otherwise `loaded` tells
+    // whether reading succeeded.
+    static bool readGpuReadyFile(const std::string& path, const TextureSettings& settings, ContainerImage& image, bool& loaded);
+    // Decoding halves of the above, for bytes read elsewhere (see Vfs::readAsync). GPU-ready
+    // files are the .ktx2/.dds containers and .hdr images.
+    static bool isGpuReadyFile(const std::string& path);
+    static bool decodeGpuReadyFile(const std::string& path, const uint8_t* data, size_t size, int cubemapFaceSize, ContainerImage& image);
+    static bool decodeBakedFile(const std::string& bakedPath, const uint8_t* data, size_t size, ContainerImage& image);
 
-    bool loadFromFile(const std::string& path);
+    // Upload half of loadFromFile, split so it can be spread over several frames:
+    // allocate the storage (immutable where the context has glTexStorage2D), fill level 0 in row
+    // ranges, then build the mip chain.
+    // With a GL_PIXEL_UNPACK_BUFFER bound, `pixels` is an offset into that buffer.
+    bool allocate(int width, int height, int channels, const TextureSettings& settings = {});
+    void uploadRows(int firstRow, int rowCount, const void* pixels);
+    void generateMipmaps();
+    // Uploads every level of a container image in one go (glCompressedTexSubImage2D for block formats).
+    // Images with layers become a GL_TEXTURE_2D_ARRAY, with 6 faces a GL_TEXTURE_CUBE_MAP.
+    bool upload(const ContainerImage& image, const TextureSettings& settings = {});
 
     void bind(GLuint textureUnit = 0) const;
     void unbind(GLuint textureUnit = 0) const;
 
     GLuint getID() const { return m_ID; }
+    // GL_TEXTURE_2D, or GL_TEXTURE_CUBE_MAP / GL_TEXTURE_2D_ARRAY as built by upload().
+    GLenum getTarget() const { return m_Target; }
+    int getLayerCount() const { return m_LayerCount; }
+    // Shared sampler object from SamplerCache; bind() attaches it to the texture unit.
+    GLuint getSampler() const { return m_Sampler; }
     int getWidth() const { return m_Width; }
     int getHeight() const { return m_Height; }
+    // GPU memory used by the texture, including its mip chain.
+    size_t getByteSize() const;
 
     // Non-copyable
     Texture(const Texture&) = delete;
@@ -42,9 +86,14 @@ public:
 
 private:
     GLuint m_ID = 0;
+    GLenum m_Target = GL_TEXTURE_2D;
+    GLuint m_Sampler = 0;
     int m_Width = 0;
     int m_Height = 0;
+    int m_LayerCount = 1;
     int m_NrChannels = 0;
+    GLenum m_Format = 0;
+    size_t m_ByteSize = 0;
 };
 
 } // namespace Base
\ No newline at end of file
@@ -0,0 +1,359 @@
+#include "TextureAtlas.hpp"
+#include "AssetFile.hpp"
+#include "Log.hpp"
+
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+
+namespace Base
+{
+    namespace
+    {
+        int roundUpTo4(int value)
+        {
+            return (value + 3) & ~3;
+        }
+
+        int nextPowerOfTwo(int value)
+        {
+            int size = 1;
+            while (size < value)
+            {
+                size *= 2;
+            }
+            return size;
+        }
+    } // namespace
+
+    const AtlasRegion *AtlasLayout::find(const std::string &name) const
+    {
+        const int index = indexOf(name);
+        return index < 0 ? nullptr : &regions[index];
+    }
+
+    int AtlasLayout::indexOf(const std::string &name) const
+    {
+        for (size_t i = 0; i < regions.size(); ++i)
+        {
+            if (regions[i].name == name)
+            {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    std::vector<glm::vec4> AtlasLayout::getUvTable() const
+    {
+        std::vector<glm::vec4> table;
+        table.reserve(regions.size() * 2);
+        for (const AtlasRegion &region : regions)
+        {
+            table.push_back(region.uvRect);
+            table.emplace_back(static_cast<float>(region.layer), 0.0f, 0.0f, 0.0f);
+        }
+        return table;
+    }
+
+    void TextureAtlasBuilder::add(const std::string &name, int width, int height, int channels, const uint8_t *pixels)
+    {
+        SourceImage image;
+        image.name = name;
+        image.width = width;
+        image.height = height;
+        image.rgba.resize(static_cast<size_t>(width) * height * 4);
+        for (size_t i = 0; i < static_cast<size_t>(width) * height; ++i)
+        {
+            // Same expansion GL applies when sampling GL_RED/GL_RG/GL_RGB textures.
+            const uint8_t *in = pixels + i * channels;
+            uint8_t *out = &image.rgba[i * 4];
+            out[0] = in[0];
+            out[1] = channels > 1 ? in[1] : 0;
+            out[2] = channels > 2 ? in[2] : 0;
+            out[3] = channels > 3 ? in[3] : 255;
+        }
+        m_Images.push_back(std::move(image));
+    }
+
+    void TextureAtlasBuilder::add(const std::string &name, const ImageData &image)
+    {
+        add(name, image.width, image.height, image.channels, image.pixels);
+    }
+
+    bool TextureAtlasBuilder::addFile(const std::string &path, const std::string &name)
+    {
+        ImageData image;
+        if (!Texture::readImageFile(path, image))
+        {
+            return false;
+        }
+        add(name.empty() ? path : name, image);
+        return true;
+    }
+
+    bool TextureAtlasBuilder::isUniform() const
+    {
+        return std::all_of(m_Images.begin(), m_Images.end(), [this](const SourceImage &image)
+                           { return image.width == m_Images.front().width && image.height == m_Images.front().height; });
+    }
+
+    bool TextureAtlasBuilder::packInto(int size, int maxLayers, AtlasLayout &layout) const
+    {
+        const int padding = roundUpTo4(m_Options.padding);
+
+        // Shelf packing, tallest first: each shelf is as tall as its first image.
+        std::vector<size_t> order(m_Images.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b)
+                         { return m_Images[a].height > m_Images[b].height; });
+
+        layout.width = size;
+        layout.height = size;
+        layout.layerCount = 1;
+        layout.regions.assign(m_Images.size(), {});
+        int x = 0;
+        int shelfY = 0;
+        int shelfHeight = 0;
+        for (size_t index : order)
+        {
+            const SourceImage &image = m_Images[index];
+            const int cellWidth = roundUpTo4(image.width) + 2 * padding;
+            const int cellHeight = roundUpTo4(image.height) + 2 * padding;
+            if (x + cellWidth > size)
+            {
+                x = 0;
+                shelfY += shelfHeight;
+                shelfHeight = 0;
+            }
+            if (shelfY + cellHeight > size)
+            {
+                if (++layout.layerCount > maxLayers)
+                {
+                    return false;
+                }
+                x = 0;
+                shelfY = 0;
+                shelfHeight = 0;
+            }
+
+            AtlasRegion &region = layout.regions[index];
+            region.name = image.name;
+            region.layer = layout.layerCount - 1;
+            region.x = x + padding;
+            region.y = shelfY + padding;
+            region.width = image.width;
+            region.height = image.height;
+            x += cellWidth;
+            shelfHeight = std::max(shelfHeight, cellHeight);
+        }
+        return true;
+    }
+
+    bool TextureAtlasBuilder::pack(AtlasLayout &layout) const
+    {
+        layout = AtlasLayout();
+        if (m_Images.empty())
+        {
+            LOG_ERROR("TextureAtlas: nothing to pack.");
+            return false;
+        }
+
+        // Images of one size map 1:1 onto layers, without gutters.
+        const SourceImage &first = m_Images.front();
+        if (isUniform())
+        {
+            layout.width = first.width;
+            layout.height = first.height;
+            layout.layerCount = static_cast<int>(m_Images.size());
+            for (size_t i = 0; i < m_Images.size(); ++i)
+            {
+                AtlasRegion region;
+                region.name = m_Images[i].name;
+                region.layer = static_cast<int>(i);
+                region.width = first.width;
+                region.height = first.height;
+                layout.regions.push_back(region);
+            }
+            return true;
+        }
+
+        const int padding = roundUpTo4(m_Options.padding);
+        size_t area = 0;
+        int largest = 0;
+        for (const SourceImage &image : m_Images)
+        {
+            const int cellWidth = roundUpTo4(image.width) + 2 * padding;
+            const int cellHeight = roundUpTo4(image.height) + 2 * padding;
+            area += static_cast<size_t>(cellWidth) * cellHeight;
+            largest = std::max({largest, cellWidth, cellHeight});
+        }
+        if (largest > m_Options.maxLayerSize)
+        {
+            LOG_ERROR("TextureAtlas: an image does not fit into a {0}x{0} layer.", m_Options.maxLayerSize);
+            return false;
+        }
+
+        // The smallest power-of-two layer that takes everything, else as many full-size layers as needed.
+        int size = nextPowerOfTwo(std::max(largest, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(area))))));
+        for (; size < m_Options.maxLayerSize; size *= 2)
+        {
+            if (packInto(size, 1, layout))
+            {
+                return true;
+            }
+        }
+        return packInto(m_Options.maxLayerSize, static_cast<int>(m_Images.size()), layout);
+    }
+
+    bool TextureAtlasBuilder::build(AtlasLayout &layout, std::vector<uint8_t> &layers) const
+    {
+        if (!pack(layout))
+        {
+            return false;
+        }
+
+        const size_t layerSize = static_cast<size_t>(layout.width) * layout.height * 4;
+        layers.assign(layerSize * layout.layerCount, 0);
+        const int padding = isUniform() ? 0 : roundUpTo4(m_Options.padding);
+        for (size_t i = 0; i < m_Images.size(); ++i)
+        {
+            const SourceImage &image = m_Images[i];
+            AtlasRegion &region = layout.regions[i];
+            uint8_t *layer = layers.data() + layerSize * region.layer;
+
+            // Fill the whole cell, clamping to the image: the gutter repeats its border texels.
+            const int cellWidth = padding == 0 ? image.width : roundUpTo4(image.width) + 2 * padding;
+            const int cellHeight = padding == 0 ? image.height : roundUpTo4(image.height) + 2 * padding;
+            for (int cellY = 0; cellY < cellHeight; ++cellY)
+            {
+                const int sourceY = std::clamp(cellY - padding, 0, image.height - 1);
+                uint8_t *out = layer + (static_cast<size_t>(region.y - padding + cellY) * layout.width + region.x - padding) * 4;
+                const uint8_t *row = image.rgba.data() + static_cast<size_t>(sourceY) * image.width * 4;
+                for (int cellX = 0; cellX < cellWidth; ++cellX, out += 4)
+                {
+                    std::copy_n(row + std::clamp(cellX - padding, 0, image.width - 1) * 4, 4, out);
+                }
+            }
+
+            region.uvRect = glm::vec4(static_cast<float>(region.x) / layout.width, static_cast<float>(region.y) / layout.height,
+                                      static_cast<float>(region.width) / layout.width, static_cast<float>(region.height) / layout.height);
+        }
+
+        LOG_INFO("TextureAtlas: packed {} images into {} layer(s) of {}x{}.", m_Images.size(), layout.layerCount, layout.width,
+                 layout.height);
+        return true;
+    }
+
+    bool TextureAtlasBuilder::build(AtlasLayout &layout, Texture &texture, const TextureSettings &settings) const
+    {
+        ContainerImage image;
+        if (!build(layout, image.data))
+        {
+            return false;
+        }
+        image.internalFormat = m_Options.srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+        image.srgb = m_Options.srgb;
+        image.width = layout.width;
+        image.height = layout.height;
+        image.layerCount = layout.layerCount;
+        image.generateMipmaps = true;
+        const size_t layerSize = static_cast<size_t>(layout.width) * layout.height * 4;
+        for (int layer = 0; layer < layout.layerCount; ++layer)
+        {
+            image.levels.push_back({layerSize * layer, layerSize, layout.width, layout.height});
+        }
+        return texture.upload(image, settings);
+    }
+
+    bool TextureAtlasBuilder::writeLayoutFile(const std::string &path, const AtlasLayout &layout)
+    {
+        std::ofstream stream(path, std::ios::trunc);
+        stream << "atlas " << layout.width << ' ' << layout.height << ' ' << layout.layerCount << ' ' << layout.texture << '\n';
+        for (const AtlasRegion &region : layout.regions)
+        {
+            stream << "region " << region.layer << ' ' << region.x << ' ' << region.y << ' ' << region.width << ' '
+                   << region.height << ' ' << region.name << '\n';
+        }
+        if (!stream)
+        {
+            LOG_ERROR("TextureAtlas: cannot write '{}'.", path);
+            return false;
+        }
+        return true;
+    }
+
+    bool TextureAtlasBuilder::parseLayout(const char *data, size_t size, const std::string &name, AtlasLayout &layout)
+    {
+        layout = AtlasLayout();
+        std::istringstream stream(std::string(data, size));
+        std::string line;
+        bool hasHeader = false;
+        for (int lineNumber = 1; std::getline(stream, line); ++lineNumber)
+        {
+            std::istringstream fields(line);
+            std::string keyword;
+            fields >> keyword;
+            if (keyword.empty() || keyword[0] == '#')
+            {
+                continue;
+            }
+
+            // The last field (texture or region name) runs to the end of the line.
+            bool valid = false;
+            if (keyword == "atlas")
+            {
+                valid = static_cast<bool>(fields >> layout.width >> layout.height >> layout.layerCount >> std::ws) &&
+                        std::getline(fields, layout.texture);
+                hasHeader = valid;
+            }
+            else if (keyword == "region" && hasHeader)
+            {
+                AtlasRegion region;
+                valid = static_cast<bool>(fields >> region.layer >> region.x >> region.y >> region.width >> region.height >> std::ws) &&
+                        std::getline(fields, region.name) && region.layer < layout.layerCount &&
+                        region.x + region.width <= layout.width && region.y + region.height <= layout.height;
+                if (valid)
+                {
+                    region.uvRect = glm::vec4(static_cast<float>(region.x) / layout.width, static_cast<float>(region.y) / layout.height,
+                                              static_cast<float>(region.width) / layout.width,
+                                              static_cast<float>(region.height) / layout.height);
+                    layout.regions.push_back(region);
+                }
+            }
+            if (!valid)
+            {
+                LOG_ERROR("TextureAtlas: '{}' line {} is malformed: {}", name, lineNumber, line);
+                return false;
+            }
+        }
+        if (!hasHeader)
+        {
+            LOG_ERROR("TextureAtlas: '{}' has no atlas line.", name);
+            return false;
+        }
+        return true;
+    }
+
+    bool TextureAtlasBuilder::readLayoutFile(const std::string &path, AtlasLayout &layout)
+    {
+        AssetFile file;
+        if (!file.open(path))
+        {
+            LOG_ERROR("TextureAtlas: could not open '{}'.", path);
+            return false;
+        }
+        const bool parsed = parseLayout(reinterpret_cast<const char *>(file.data()), file.size(), path, layout);
+
+        const size_t slash = path.find_last_of('/');
+        if (parsed && slash != std::string::npos)
+        {
+            layout.texture = path.substr(0, slash + 1) + layout.texture;
+        }
+        return parsed;
+    }
+
+} // namespace Base
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Texture.hpp"
+
+namespace Base
+{
+    // Where one source image ended up inside a texture array.
+    struct AtlasRegion
+    {
+        std::string name;
+        int layer = 0;
+        // Texels inside the layer; rows count from the bottom, like the uploaded images.
+        int x = 0;
+        int y = 0;
+        int width = 0;
+        int height = 0;
+        // Maps the source's UVs into the layer: uv * uvRect.zw + uvRect.xy.
+        glm::vec4 uvRect{0.0f, 0.0f, 1.0f, 1.0f};
+    };
+
+    // Result of packing a set of images into the layers of one GL_TEXTURE_2D_ARRAY, so everything
+    // drawn with them can share one bind and one draw call. Per instance, a renderer passes the
+    // region's layer and uvRect (or its index into getUvTable()) instead of switching textures.
+    struct AtlasLayout
+    {
+        int width = 0;
+        int height = 0;
+        int layerCount = 0;
+        std::string texture; // Asset path of the baked .ktx2 when read from a .atlas file
+        std::vector<AtlasRegion> regions;
+
+        const AtlasRegion *find(const std::string &name) const;
+        // -1 when there is no region called `name`.
+        int indexOf(const std::string &name) const;
+        // One (uvRect.xy, uvRect.zw) vec4 followed by one (layer, 0, 0, 0) vec4 per region, in region
+        // order: std140-compatible for a uniform block array or a per-instance attribute buffer.
+        std::vector<glm::vec4> getUvTable() const;
+    };
+
+    // Packs RGBA8 images into texture array layers. When every image has the same size each one
+    // gets its own layer (a plain texture array); otherwise they are shelf-packed into as few
+    // layers as fit, with their border texels repeated into a gutter so filtering and the first
+    // mip levels do not bleed between neighbours. Regions start on 4-texel boundaries, keeping
+    // BCn blocks within one image.
+    //
+    // Used at runtime (build() + Texture::upload) and by tools/TextureBaker --atlas, which writes
+    // the layers to a .ktx2 and the layout to a .atlas file next to it (see readLayoutFile).
+    class TextureAtlasBuilder
+    {
+    public:
+        struct Options
+        {
+            int maxLayerSize = 2048; // Packed layers never grow beyond this, more layers are added instead
+            int padding = 4;         // Gutter texels around each packed image
+            bool srgb = false;       // Upload as GL_SRGB8_ALPHA8; off because every other texture samples as UNORM
+        };
+
+        TextureAtlasBuilder() = default;
+        explicit TextureAtlasBuilder(const Options &options) : m_Options(options) {}
+
+        // Copies `pixels` (bottom row first, 1 to 4 channels) in under `name`.
+        void add(const std::string &name, int width, int height, int channels, const uint8_t *pixels);
+        void add(const std::string &name, const ImageData &image);
+        // Decodes an image asset via Texture::readImageFile; the name defaults to its path.
+        bool addFile(const std::string &path, const std::string &name = {});
+
+        size_t getImageCount() const { return m_Images.size(); }
+
+        // Places the images and composes the layers: layerCount RGBA8 images of width x height,
+        // one after the other in `layers`. Fails if an image is larger than maxLayerSize.
+        bool build(AtlasLayout &layout, std::vector<uint8_t> &layers) const;
+        // build() plus upload as a texture array with a generated mip chain.
+        bool build(AtlasLayout &layout, Texture &texture, const TextureSettings &settings = {}) const;
+
+        // Text layout files: a header line and one line per region, texture relative to the file.
+        static bool writeLayoutFile(const std::string &path, const AtlasLayout &layout);
+        static bool parseLayout(const char *data, size_t size, const std::string &name, AtlasLayout &layout);
+        // Reads an asset path ("images/props.atlas"); layout.texture becomes an asset path as well.
+        static bool readLayoutFile(const std::string &path, AtlasLayout &layout);
+
+    private:
+        struct SourceImage
+        {
+            std::string name;
+            int width = 0;
+            int height = 0;
+            std::vector<uint8_t> rgba;
+        };
+
+        bool isUniform() const;
+        bool pack(AtlasLayout &layout) const;
+        bool packInto(int size, int maxLayers, AtlasLayout &layout) const;
+
+        Options m_Options;
+        std::vector<SourceImage> m_Images;
+    };
+
+} // namespace Base
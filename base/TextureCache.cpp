@@ -0,0 +1,111 @@
+#include "TextureCache.hpp"
+#include "Log.hpp"
+#include "Vfs.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace Base
+{
+    TextureCache &TextureCache::Get()
+    {
+        static std::unique_ptr<TextureCache> s_Instance(new TextureCache());
+        return *s_Instance;
+    }
+
+    std::string TextureCache::makeKey(const std::string &path, const TextureSettings &settings)
+    {
+        return fmt::format("{}|{:X}|{:X}|{:X}|{:X}|{}", Vfs::normalizePath(path), settings.wrapS, settings.wrapT,
+                           settings.minFilter, settings.magFilter, settings.cubemapFaceSize);
+    }
+
+    bool TextureCache::isReferenced(const Entry &entry)
+    {
+        // The cache holds one reference; the loader holds more while the texture is in flight.
+        return entry.handle.m_Request.use_count() > 1;
+    }
+
+    TextureHandle TextureCache::acquire(const std::string &path, const TextureSettings &settings)
+    {
+        const std::string key = makeKey(path, settings);
+        auto it = m_Entries.find(key);
+        if (it != m_Entries.end() && !it->second.handle.isFailed())
+        {
+            m_Stats.hits++;
+            it->second.lastUsedFrame = m_Frame;
+            return it->second.handle;
+        }
+
+        m_Stats.misses++;
+        Entry &entry = m_Entries[key];
+        entry.handle = TextureLoader::Get().loadAsync(path, settings);
+        entry.lastUsedFrame = m_Frame;
+        return entry.handle;
+    }
+
+    void TextureCache::update()
+    {
+        m_Frame++;
+
+        size_t residentBytes = 0;
+        size_t idleBytes = 0;
+        std::vector<std::unordered_map<std::string, Entry>::iterator> idle;
+        for (auto it = m_Entries.begin(); it != m_Entries.end();)
+        {
+            Entry &entry = it->second;
+            if (isReferenced(entry))
+            {
+                entry.lastUsedFrame = m_Frame;
+            }
+            else if (entry.handle.isFailed())
+            {
+                it = m_Entries.erase(it); // Let the next acquire() try again
+                continue;
+            }
+
+            if (const Texture *texture = entry.handle.get())
+            {
+                residentBytes += texture->getByteSize();
+                if (!isReferenced(entry))
+                {
+                    idleBytes += texture->getByteSize();
+                    idle.push_back(it);
+                }
+            }
+            ++it;
+        }
+
+        if (idleBytes > m_IdleBudget)
+        {
+            std::sort(idle.begin(), idle.end(), [](const auto &a, const auto &b)
+                      { return a->second.lastUsedFrame < b->second.lastUsedFrame; });
+            for (auto it : idle)
+            {
+                if (idleBytes <= m_IdleBudget)
+                {
+                    break;
+                }
+                const size_t bytes = it->second.handle.get()->getByteSize();
+                LOG_DEBUG("TextureCache: evicting '{}' ({} bytes).", it->second.handle.getPath(), bytes);
+                idleBytes -= bytes;
+                residentBytes -= bytes;
+                m_Entries.erase(it);
+                m_Stats.evictions++;
+            }
+        }
+
+        m_Stats.entries = m_Entries.size();
+        m_Stats.residentBytes = residentBytes;
+        m_Stats.idleBytes = idleBytes;
+    }
+
+    void TextureCache::clear()
+    {
+        m_Entries.clear();
+        m_Stats.entries = 0;
+        m_Stats.residentBytes = 0;
+        m_Stats.idleBytes = 0;
+    }
+
+} // namespace Base
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "TextureLoader.hpp"
+
+namespace Base
+{
+    // Shares textures between everything that asks for the same file with the same sampler
+    // settings. Entries nobody references any more stay resident (so switching back to a chapter
+    // is free) until their combined size exceeds the idle budget; the least recently used go first.
+    class TextureCache
+    {
+    public:
+        struct Stats
+        {
+            size_t entries = 0;
+            size_t hits = 0;
+            size_t misses = 0;
+            size_t evictions = 0;
+            size_t residentBytes = 0; // All uploaded entries
+            size_t idleBytes = 0;     // Uploaded entries without outside references
+        };
+
+        static TextureCache &Get();
+
+        TextureCache() = default;
+        TextureCache(const TextureCache &) = delete;
+        TextureCache &operator=(const TextureCache &) = delete;
+
+        TextureHandle acquire(const std::string &path, const TextureSettings &settings = {});
+
+        // Called once per frame: refreshes the LRU stamps and evicts idle entries over budget.
+        void update();
+        // Drops every entry; handles still held elsewhere keep their texture alive.
+        void clear();
+
+        // 0 evicts an entry as soon as its last outside handle is released.
+        void setIdleBudget(size_t bytes) { m_IdleBudget = bytes; }
+        size_t getIdleBudget() const { return m_IdleBudget; }
+        const Stats &getStats() const { return m_Stats; }
+
+    private:
+        struct Entry
+        {
+            TextureHandle handle;
+            uint64_t lastUsedFrame = 0;
+        };
+
+        static std::string makeKey(const std::string &path, const TextureSettings &settings);
+        static bool isReferenced(const Entry &entry);
+
+        std::unordered_map<std::string, Entry> m_Entries;
+        size_t m_IdleBudget = 64 * 1024 * 1024;
+        uint64_t m_Frame = 0;
+        Stats m_Stats;
+    };
+
+} // namespace Base
@@ -0,0 +1,921 @@
+#include "TextureCompression.hpp"
+#include "Log.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <initializer_list>
+
+// Compressed formats that are extensions on some of the targets; the enums are fixed by the specs.
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#define GL_COMPRESSED_RGBA_S3TC_DXT3_EXT 0x83F2
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT 0x8C4C
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT 0x8C4D
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT 0x8C4E
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
+#ifndef GL_COMPRESSED_RED_RGTC1
+#define GL_COMPRESSED_RED_RGTC1 0x8DBB
+#define GL_COMPRESSED_SIGNED_RED_RGTC1 0x8DBC
+#define GL_COMPRESSED_RG_RGTC2 0x8DBD
+#define GL_COMPRESSED_SIGNED_RG_RGTC2 0x8DBE
+#endif
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+#define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#define GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM 0x8E8D
+#define GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT 0x8E8E
+#define GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT 0x8E8F
+#endif
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_R11_EAC 0x9270
+#define GL_COMPRESSED_SIGNED_R11_EAC 0x9271
+#define GL_COMPRESSED_RG11_EAC 0x9272
+#define GL_COMPRESSED_SIGNED_RG11_EAC 0x9273
+#define GL_COMPRESSED_RGB8_ETC2 0x9274
+#define GL_COMPRESSED_SRGB8_ETC2 0x9275
+#define GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2 0x9276
+#define GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2 0x9277
+#define GL_COMPRESSED_RGBA8_ETC2_EAC 0x9278
+#define GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC 0x9279
+#endif
+#ifndef GL_COMPRESSED_RGBA_ASTC_4x4_KHR
+#define GL_COMPRESSED_RGBA_ASTC_4x4_KHR 0x93B0
+#define GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR 0x93D0
+#endif
+
+namespace Base
+{
+    TextureCompression::Support TextureCompression::s_Support;
+
+    namespace
+    {
+        struct FormatDesc
+        {
+            TextureCodec codec = TextureCodec::None;
+            GLenum glFormat = 0;
+            bool srgb = false;
+            uint8_t blockWidth = 1;
+            uint8_t blockHeight = 1;
+            uint8_t blockBytes = 4;
+            GLenum pixelType = GL_UNSIGNED_BYTE;
+            GLenum pixelFormat = GL_RGBA;
+        };
+
+        constexpr FormatDesc kInvalidFormat{TextureCodec::None, 0, false, 0, 0, 0};
+
+        FormatDesc block4x4(TextureCodec codec, GLenum glFormat, bool srgb, uint8_t bytes)
+        {
+            return {codec, glFormat, srgb, 4, 4, bytes};
+        }
+
+        FormatDesc rgba8(bool srgb)
+        {
+            return {TextureCodec::None, static_cast<GLenum>(srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8), srgb, 1, 1, 4};
+        }
+
+        FormatDesc rgba16f()
+        {
+            return {TextureCodec::None, GL_RGBA16F, false, 1, 1, 8, GL_HALF_FLOAT, GL_RGBA};
+        }
+
+        FormatDesc rgb16f()
+        {
+            return {TextureCodec::None, GL_RGB16F, false, 1, 1, 6, GL_HALF_FLOAT, GL_RGB};
+        }
+
+        // ASTC block footprints in the order shared by VkFormat and the GL enums.
+        constexpr uint8_t kAstcBlocks[14][2] = {{4, 4}, {5, 4}, {5, 5}, {6, 5}, {6, 6}, {8, 5}, {8, 6},
+                                                {8, 8}, {10, 5}, {10, 6}, {10, 8}, {10, 10}, {12, 10}, {12, 12}};
+
+        FormatDesc fromVkFormat(uint32_t vkFormat)
+        {
+            switch (vkFormat)
+            {
+            case 37: return rgba8(false); // VK_FORMAT_R8G8B8A8_UNORM
+            case 43: return rgba8(true);  // VK_FORMAT_R8G8B8A8_SRGB
+            case 90: return rgb16f();     // VK_FORMAT_R16G16B16_SFLOAT
+            case 97: return rgba16f();    // VK_FORMAT_R16G16B16A16_SFLOAT
+            case 131: return block4x4(TextureCodec::BC1, GL_COMPRESSED_RGB_S3TC_DXT1_EXT, false, 8);
+            case 132: return block4x4(TextureCodec::BC1, GL_COMPRESSED_SRGB_S3TC_DXT1_EXT, true, 8);
+            case 133: return block4x4(TextureCodec::BC1, GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, false, 8);
+            case 134: return block4x4(TextureCodec::BC1, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT, true, 8);
+            case 135: return block4x4(TextureCodec::BC2, GL_COMPRESSED_RGBA_S3TC_DXT3_EXT, false, 16);
+            case 136: return block4x4(TextureCodec::BC2, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT, true, 16);
+            case 137: return block4x4(TextureCodec::BC3, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, false, 16);
+            case 138: return block4x4(TextureCodec::BC3, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT, true, 16);
+            case 139: return block4x4(TextureCodec::BC4, GL_COMPRESSED_RED_RGTC1, false, 8);
+            case 141: return block4x4(TextureCodec::BC5, GL_COMPRESSED_RG_RGTC2, false, 16);
+            case 143: return block4x4(TextureCodec::BC6H, GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT, false, 16);
+            case 144: return block4x4(TextureCodec::BC6H, GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT, false, 16);
+            case 145: return block4x4(TextureCodec::BC7, GL_COMPRESSED_RGBA_BPTC_UNORM, false, 16);
+            case 146: return block4x4(TextureCodec::BC7, GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM, true, 16);
+            case 147: return block4x4(TextureCodec::ETC2_RGB, GL_COMPRESSED_RGB8_ETC2, false, 8);
+            case 148: return block4x4(TextureCodec::ETC2_RGB, GL_COMPRESSED_SRGB8_ETC2, true, 8);
+            case 149: return block4x4(TextureCodec::ETC2_PunchThrough, GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2, false, 8);
+            case 150: return block4x4(TextureCodec::ETC2_PunchThrough, GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2, true, 8);
+            case 151: return block4x4(TextureCodec::ETC2_RGBA, GL_COMPRESSED_RGBA8_ETC2_EAC, false, 16);
+            case 152: return block4x4(TextureCodec::ETC2_RGBA, GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC, true, 16);
+            case 153: return block4x4(TextureCodec::EAC_R11, GL_COMPRESSED_R11_EAC, false, 8);
+            case 155: return block4x4(TextureCodec::EAC_RG11, GL_COMPRESSED_RG11_EAC, false, 16);
+            default:
+                break;
+            }
+            if (vkFormat >= 157 && vkFormat <= 184) // VK_FORMAT_ASTC_4x4_UNORM_BLOCK .. ASTC_12x12_SRGB_BLOCK
+            {
+                const uint32_t index = (vkFormat - 157) / 2;
+                const bool srgb = (vkFormat - 157) % 2 == 1;
+                const GLenum glFormat = (srgb ? GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR : GL_COMPRESSED_RGBA_ASTC_4x4_KHR) + index;
+                return {TextureCodec::ASTC, glFormat, srgb, kAstcBlocks[index][0], kAstcBlocks[index][1], 16};
+            }
+            return kInvalidFormat;
+        }
+
+        FormatDesc fromDxgiFormat(uint32_t dxgiFormat)
+        {
+            switch (dxgiFormat)
+            {
+            case 28: return rgba8(false); // DXGI_FORMAT_R8G8B8A8_UNORM
+            case 29: return rgba8(true);
+            case 10: return rgba16f(); // DXGI_FORMAT_R16G16B16A16_FLOAT
+            case 71: return block4x4(TextureCodec::BC1, GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, false, 8);
+            case 72: return block4x4(TextureCodec::BC1, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT, true, 8);
+            case 74: return block4x4(TextureCodec::BC2, GL_COMPRESSED_RGBA_S3TC_DXT3_EXT, false, 16);
+            case 75: return block4x4(TextureCodec::BC2, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT, true, 16);
+            case 77: return block4x4(TextureCodec::BC3, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, false, 16);
+            case 78: return block4x4(TextureCodec::BC3, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT, true, 16);
+            case 80: return block4x4(TextureCodec::BC4, GL_COMPRESSED_RED_RGTC1, false, 8);
+            case 83: return block4x4(TextureCodec::BC5, GL_COMPRESSED_RG_RGTC2, false, 16);
+            case 95: return block4x4(TextureCodec::BC6H, GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT, false, 16);
+            case 96: return block4x4(TextureCodec::BC6H, GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT, false, 16);
+            case 98: return block4x4(TextureCodec::BC7, GL_COMPRESSED_RGBA_BPTC_UNORM, false, 16);
+            case 99: return block4x4(TextureCodec::BC7, GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM, true, 16);
+            default: return kInvalidFormat;
+            }
+        }
+
+        constexpr uint32_t fourCC(const char (&code)[5])
+        {
+            return static_cast<uint32_t>(code[0]) | static_cast<uint32_t>(code[1]) << 8 |
+                   static_cast<uint32_t>(code[2]) << 16 | static_cast<uint32_t>(code[3]) << 24;
+        }
+
+        FormatDesc fromFourCC(uint32_t code)
+        {
+            switch (code)
+            {
+            case fourCC("DXT1"): return block4x4(TextureCodec::BC1, GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, false, 8);
+            case fourCC("DXT3"): return block4x4(TextureCodec::BC2, GL_COMPRESSED_RGBA_S3TC_DXT3_EXT, false, 16);
+            case fourCC("DXT5"): return block4x4(TextureCodec::BC3, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, false, 16);
+            case fourCC("ATI1"):
+            case fourCC("BC4U"): return block4x4(TextureCodec::BC4, GL_COMPRESSED_RED_RGTC1, false, 8);
+            case fourCC("ATI2"):
+            case fourCC("BC5U"): return block4x4(TextureCodec::BC5, GL_COMPRESSED_RG_RGTC2, false, 16);
+            default: return kInvalidFormat;
+            }
+        }
+
+        uint32_t readU32(const uint8_t *data, size_t offset)
+        {
+            uint32_t value;
+            std::memcpy(&value, data + offset, sizeof(value));
+            return value; // Both containers are little-endian, like every target platform
+        }
+
+        uint64_t readU64(const uint8_t *data, size_t offset)
+        {
+            uint64_t value;
+            std::memcpy(&value, data + offset, sizeof(value));
+            return value;
+        }
+
+        size_t levelByteSize(const FormatDesc &format, int width, int height)
+        {
+            const size_t blocksX = (static_cast<size_t>(width) + format.blockWidth - 1) / format.blockWidth;
+            const size_t blocksY = (static_cast<size_t>(height) + format.blockHeight - 1) / format.blockHeight;
+            return blocksX * blocksY * format.blockBytes;
+        }
+
+        // floor(log2(max(width, height))) + 1; a file claiming more levels is corrupt past the 1x1 one.
+        uint32_t maxLevelCount(uint32_t width, uint32_t height)
+        {
+            uint32_t levels = 1;
+            for (uint32_t size = std::max(width, height); size > 1; size /= 2)
+            {
+                levels++;
+            }
+            return levels;
+        }
+
+        void applyFormat(const FormatDesc &format, ContainerImage &image)
+        {
+            image.codec = format.codec;
+            image.internalFormat = format.glFormat;
+            image.pixelType = format.pixelType;
+            image.pixelFormat = format.pixelFormat;
+            image.srgb = format.srgb;
+        }
+
+        // Appends one mip level of `size` bytes read from `source`.
+        void appendLevel(ContainerImage &image, const uint8_t *source, size_t size, int width, int height)
+        {
+            ImageLevel level;
+            level.offset = image.data.size();
+            level.size = size;
+            level.width = width;
+            level.height = height;
+            image.data.insert(image.data.end(), source, source + size);
+            image.levels.push_back(level);
+        }
+
+#if !PLATFORM_DESKTOP
+        bool hasExtension(std::initializer_list<const char *> names)
+        {
+            GLint count = 0;
+            glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+            for (GLint i = 0; i < count; ++i)
+            {
+                const char *extension = reinterpret_cast<const char *>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+                for (const char *name : names)
+                {
+                    if (extension && std::strcmp(extension, name) == 0)
+                    {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+#endif
+
+        // --- CPU decoders, used when the driver cannot sample a format. Each writes a 4x4 RGBA8 block, row-major.
+
+        using Block = uint8_t[16][4];
+
+        void expand565(uint16_t color, uint8_t *out)
+        {
+            const uint8_t r = (color >> 11) & 31;
+            const uint8_t g = (color >> 5) & 63;
+            const uint8_t b = color & 31;
+            out[0] = static_cast<uint8_t>((r << 3) | (r >> 2));
+            out[1] = static_cast<uint8_t>((g << 2) | (g >> 4));
+            out[2] = static_cast<uint8_t>((b << 3) | (b >> 2));
+            out[3] = 255;
+        }
+
+        // BC1 colour block; BC2/BC3 embed it but always use the four-colour mode.
+        void decodeBc1Colors(const uint8_t *block, Block &out, bool allowPunchThrough)
+        {
+            const uint16_t c0 = static_cast<uint16_t>(block[0] | block[1] << 8);
+            const uint16_t c1 = static_cast<uint16_t>(block[2] | block[3] << 8);
+            uint8_t palette[4][4];
+            expand565(c0, palette[0]);
+            expand565(c1, palette[1]);
+            for (int c = 0; c < 3; ++c)
+            {
+                if (c0 > c1 || !allowPunchThrough)
+                {
+                    palette[2][c] = static_cast<uint8_t>((2 * palette[0][c] + palette[1][c]) / 3);
+                    palette[3][c] = static_cast<uint8_t>((palette[0][c] + 2 * palette[1][c]) / 3);
+                }
+                else
+                {
+                    palette[2][c] = static_cast<uint8_t>((palette[0][c] + palette[1][c]) / 2);
+                    palette[3][c] = 0;
+                }
+            }
+            palette[2][3] = 255;
+            palette[3][3] = (c0 > c1 || !allowPunchThrough) ? 255 : 0;
+
+            const uint32_t indices = readU32(block, 4);
+            for (int i = 0; i < 16; ++i)
+            {
+                std::memcpy(out[i], palette[(indices >> (2 * i)) & 3], 4);
+            }
+        }
+
+        // BC4 block (also the alpha of BC3 and each channel of BC5).
+        void decodeBc4Channel(const uint8_t *block, Block &out, int channel)
+        {
+            uint8_t palette[8] = {block[0], block[1]};
+            if (block[0] > block[1])
+            {
+                for (int i = 1; i < 7; ++i)
+                    palette[i + 1] = static_cast<uint8_t>(((7 - i) * block[0] + i * block[1]) / 7);
+            }
+            else
+            {
+                for (int i = 1; i < 5; ++i)
+                    palette[i + 1] = static_cast<uint8_t>(((5 - i) * block[0] + i * block[1]) / 5);
+                palette[6] = 0;
+                palette[7] = 255;
+            }
+            uint64_t bits = 0;
+            for (int i = 0; i < 6; ++i)
+            {
+                bits |= static_cast<uint64_t>(block[2 + i]) << (8 * i);
+            }
+            for (int i = 0; i < 16; ++i)
+            {
+                out[i][channel] = palette[(bits >> (3 * i)) & 7];
+            }
+        }
+
+        uint8_t clampByte(int value)
+        {
+            return static_cast<uint8_t>(std::clamp(value, 0, 255));
+        }
+
+        // ETC1/ETC2 RGB block. Pixel indices are stored column-major.
+        void decodeEtc2Rgb(const uint8_t *b, Block &out)
+        {
+            static const int kModifiers[8][4] = {{2, 8, -2, -8}, {5, 17, -5, -17}, {9, 29, -9, -29}, {13, 42, -13, -42},
+                                                 {18, 60, -18, -60}, {24, 80, -24, -80}, {33, 106, -33, -106}, {47, 183, -47, -183}};
+            static const int kDistances[8] = {3, 6, 11, 16, 23, 32, 41, 64};
+
+            const uint32_t msbs = static_cast<uint32_t>(b[4] << 8 | b[5]);
+            const uint32_t lsbs = static_cast<uint32_t>(b[6] << 8 | b[7]);
+            auto pixelIndex = [&](int x, int y)
+            {
+                const int p = x * 4 + y;
+                return static_cast<int>(((msbs >> p) & 1) << 1 | ((lsbs >> p) & 1));
+            };
+            auto extend4 = [](int v) { return v * 17; };
+            auto extend5 = [](int v) { return (v << 3) | (v >> 2); };
+            auto signed3 = [](int v) { return v >= 4 ? v - 8 : v; };
+
+            const bool differential = (b[3] & 2) != 0;
+            int base[2][3];
+            if (!differential)
+            {
+                for (int c = 0; c < 3; ++c)
+                {
+                    base[0][c] = extend4(b[c] >> 4);
+                    base[1][c] = extend4(b[c] & 0xF);
+                }
+            }
+            else
+            {
+                const int r = b[0] >> 3, g = b[1] >> 3, bl = b[2] >> 3;
+                const int r2 = r + signed3(b[0] & 7), g2 = g + signed3(b[1] & 7), b2 = bl + signed3(b[2] & 7);
+
+                if (r2 < 0 || r2 > 31)
+                {
+                    // T mode
+                    int c1[3] = {extend4(((b[0] >> 3) & 3) << 2 | (b[0] & 3)), extend4(b[1] >> 4), extend4(b[1] & 0xF)};
+                    int c2[3] = {extend4(b[2] >> 4), extend4(b[2] & 0xF), extend4(b[3] >> 4)};
+                    const int d = kDistances[((b[3] >> 2) & 3) << 1 | (b[3] & 1)];
+                    int paint[4][3];
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        paint[0][c] = c1[c];
+                        paint[1][c] = c2[c] + d;
+                        paint[2][c] = c2[c];
+                        paint[3][c] = c2[c] - d;
+                    }
+                    for (int y = 0; y < 4; ++y)
+                        for (int x = 0; x < 4; ++x)
+                        {
+                            const int *color = paint[pixelIndex(x, y)];
+                            out[y * 4 + x][0] = clampByte(color[0]);
+                            out[y * 4 + x][1] = clampByte(color[1]);
+                            out[y * 4 + x][2] = clampByte(color[2]);
+                        }
+                    return;
+                }
+                if (g2 < 0 || g2 > 31)
+                {
+                    // H mode
+                    const int r1 = (b[0] >> 3) & 0xF;
+                    const int g1 = ((b[0] & 7) << 1) | ((b[1] >> 4) & 1);
+                    const int b1 = (b[1] & 8) | ((b[1] & 3) << 1) | (b[2] >> 7);
+                    const int r2h = (b[2] >> 3) & 0xF;
+                    const int g2h = ((b[2] & 7) << 1) | (b[3] >> 7);
+                    const int b2h = (b[3] >> 3) & 0xF;
+                    const int order = ((r1 << 8) | (g1 << 4) | b1) >= ((r2h << 8) | (g2h << 4) | b2h) ? 1 : 0;
+                    const int d = kDistances[(b[3] & 4) | ((b[3] & 1) << 1) | order];
+                    int c1[3] = {extend4(r1), extend4(g1), extend4(b1)};
+                    int c2[3] = {extend4(r2h), extend4(g2h), extend4(b2h)};
+                    int paint[4][3];
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        paint[0][c] = c1[c] + d;
+                        paint[1][c] = c1[c] - d;
+                        paint[2][c] = c2[c] + d;
+                        paint[3][c] = c2[c] - d;
+                    }
+                    for (int y = 0; y < 4; ++y)
+                        for (int x = 0; x < 4; ++x)
+                        {
+                            const int *color = paint[pixelIndex(x, y)];
+                            out[y * 4 + x][0] = clampByte(color[0]);
+                            out[y * 4 + x][1] = clampByte(color[1]);
+                            out[y * 4 + x][2] = clampByte(color[2]);
+                        }
+                    return;
+                }
+                if (b2 < 0 || b2 > 31)
+                {
+                    // Planar mode: three colours, interpolated bilinearly over the block
+                    auto extend6 = [](int v) { return (v << 2) | (v >> 4); };
+                    auto extend7 = [](int v) { return (v << 1) | (v >> 6); };
+                    const int ro = extend6((b[0] >> 1) & 0x3F);
+                    const int go = extend7(((b[0] & 1) << 6) | ((b[1] >> 1) & 0x3F));
+                    const int bo = extend6(((b[1] & 1) << 5) | (((b[2] >> 3) & 3) << 3) | ((b[2] & 3) << 1) | (b[3] >> 7));
+                    const int rh = extend6((((b[3] >> 2) & 0x1F) << 1) | (b[3] & 1));
+                    const int gh = extend7(b[4] >> 1);
+                    const int bh = extend6(((b[4] & 1) << 5) | (b[5] >> 3));
+                    const int rv = extend6(((b[5] & 7) << 3) | (b[6] >> 5));
+                    const int gv = extend7(((b[6] & 0x1F) << 2) | (b[7] >> 6));
+                    const int bv = extend6(b[7] & 0x3F);
+                    for (int y = 0; y < 4; ++y)
+                        for (int x = 0; x < 4; ++x)
+                        {
+                            out[y * 4 + x][0] = clampByte((x * (rh - ro) + y * (rv - ro) + 4 * ro + 2) >> 2);
+                            out[y * 4 + x][1] = clampByte((x * (gh - go) + y * (gv - go) + 4 * go + 2) >> 2);
+                            out[y * 4 + x][2] = clampByte((x * (bh - bo) + y * (bv - bo) + 4 * bo + 2) >> 2);
+                        }
+                    return;
+                }
+                base[0][0] = extend5(r);
+                base[0][1] = extend5(g);
+                base[0][2] = extend5(bl);
+                base[1][0] = extend5(r2);
+                base[1][1] = extend5(g2);
+                base[1][2] = extend5(b2);
+            }
+
+            // Individual/differential mode: two sub-blocks, side by side or (flipped) stacked
+            const bool flip = (b[3] & 1) != 0;
+            const int tables[2] = {b[3] >> 5, (b[3] >> 2) & 7};
+            for (int y = 0; y < 4; ++y)
+                for (int x = 0; x < 4; ++x)
+                {
+                    const int sub = flip ? (y >= 2) : (x >= 2);
+                    const int modifier = kModifiers[tables[sub]][pixelIndex(x, y)];
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        out[y * 4 + x][c] = clampByte(base[sub][c] + modifier);
+                    }
+                }
+        }
+
+        // EAC block: the alpha of ETC2_RGBA (8-bit) and each channel of R11/RG11 (11-bit, reduced to 8).
+        void decodeEac(const uint8_t *b, Block &out, int channel, bool elevenBit)
+        {
+            static const int kTables[16][8] = {
+                {-3, -6, -9, -15, 2, 5, 8, 14}, {-3, -7, -10, -13, 2, 6, 9, 12}, {-2, -5, -8, -13, 1, 4, 7, 12},
+                {-2, -4, -6, -13, 1, 3, 5, 12}, {-3, -6, -8, -12, 2, 5, 7, 11}, {-3, -7, -9, -11, 2, 6, 8, 10},
+                {-4, -7, -8, -11, 3, 6, 7, 10}, {-3, -5, -8, -11, 2, 4, 7, 10}, {-2, -6, -8, -10, 1, 5, 7, 9},
+                {-2, -5, -8, -10, 1, 4, 7, 9}, {-2, -4, -8, -10, 1, 3, 7, 9}, {-2, -5, -7, -10, 1, 4, 6, 9},
+                {-3, -4, -7, -10, 2, 3, 6, 9}, {-1, -2, -3, -10, 0, 1, 2, 9}, {-4, -6, -8, -9, 3, 5, 7, 8},
+                {-3, -5, -7, -9, 2, 4, 6, 8}};
+
+            const int base = b[0];
+            const int multiplier = b[1] >> 4;
+            const int *table = kTables[b[1] & 0xF];
+            uint64_t bits = 0;
+            for (int i = 2; i < 8; ++i)
+            {
+                bits = (bits << 8) | b[i];
+            }
+            for (int p = 0; p < 16; ++p)
+            {
+                const int index = static_cast<int>((bits >> (45 - 3 * p)) & 7);
+                int value;
+                if (elevenBit)
+                {
+                    const int scale = multiplier != 0 ? multiplier * 8 : 1;
+                    value = std::clamp(base * 8 + 4 + table[index] * scale, 0, 2047) >> 3;
+                }
+                else
+                {
+                    value = base + table[index] * multiplier;
+                }
+                const int x = p / 4, y = p % 4; // Column-major
+                out[y * 4 + x][channel] = clampByte(value);
+            }
+        }
+
+        bool hasCpuDecoder(TextureCodec codec)
+        {
+            switch (codec)
+            {
+            case TextureCodec::BC1:
+            case TextureCodec::BC2:
+            case TextureCodec::BC3:
+            case TextureCodec::BC4:
+            case TextureCodec::BC5:
+            case TextureCodec::ETC2_RGB:
+            case TextureCodec::ETC2_RGBA:
+            case TextureCodec::EAC_R11:
+            case TextureCodec::EAC_RG11:
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        size_t blockBytesOf(TextureCodec codec)
+        {
+            switch (codec)
+            {
+            case TextureCodec::BC1:
+            case TextureCodec::BC4:
+            case TextureCodec::ETC2_RGB:
+            case TextureCodec::EAC_R11:
+                return 8;
+            default:
+                return 16;
+            }
+        }
+
+        void decodeBlock(TextureCodec codec, const uint8_t *block, Block &out)
+        {
+            for (auto &texel : out)
+            {
+                texel[0] = texel[1] = texel[2] = 0;
+                texel[3] = 255;
+            }
+            switch (codec)
+            {
+            case TextureCodec::BC1:
+                decodeBc1Colors(block, out, true);
+                break;
+            case TextureCodec::BC2:
+                decodeBc1Colors(block + 8, out, false);
+                for (int i = 0; i < 16; ++i)
+                {
+                    const int nibble = (block[i / 2] >> ((i % 2) * 4)) & 0xF;
+                    out[i][3] = static_cast<uint8_t>(nibble * 17);
+                }
+                break;
+            case TextureCodec::BC3:
+                decodeBc1Colors(block + 8, out, false);
+                decodeBc4Channel(block, out, 3);
+                break;
+            case TextureCodec::BC4:
+                decodeBc4Channel(block, out, 0);
+                break;
+            case TextureCodec::BC5:
+                decodeBc4Channel(block, out, 0);
+                decodeBc4Channel(block + 8, out, 1);
+                break;
+            case TextureCodec::ETC2_RGB:
+                decodeEtc2Rgb(block, out);
+                break;
+            case TextureCodec::ETC2_RGBA:
+                decodeEtc2Rgb(block + 8, out);
+                decodeEac(block, out, 3, false);
+                break;
+            case TextureCodec::EAC_R11:
+                decodeEac(block, out, 0, true);
+                break;
+            case TextureCodec::EAC_RG11:
+                decodeEac(block, out, 0, true);
+                decodeEac(block + 8, out, 1, true);
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    void TextureCompression::querySupport()
+    {
+#if PLATFORM_DESKTOP
+        s_Support.s3tc = GLAD_GL_EXT_texture_compression_s3tc != 0;
+        s_Support.rgtc = GLAD_GL_VERSION_3_0 != 0;
+        s_Support.bptc = GLAD_GL_VERSION_4_2 || GLAD_GL_ARB_texture_compression_bptc;
+        s_Support.etc2 = GLAD_GL_VERSION_4_3 || GLAD_GL_ARB_ES3_compatibility;
+        s_Support.astc = GLAD_GL_KHR_texture_compression_astc_ldr != 0;
+#else
+        s_Support.s3tc = hasExtension({"GL_EXT_texture_compression_s3tc", "GL_WEBGL_compressed_texture_s3tc"});
+        s_Support.rgtc = hasExtension({"GL_EXT_texture_compression_rgtc"});
+        s_Support.bptc = hasExtension({"GL_EXT_texture_compression_bptc"});
+#if PLATFORM_EMSCRIPTEN
+        // Unlike OpenGL ES 3.0, WebGL 2 does not require ETC2.
+        s_Support.etc2 = hasExtension({"GL_WEBGL_compressed_texture_etc"});
+#else
+        s_Support.etc2 = true;
+#endif
+        s_Support.astc = hasExtension({"GL_KHR_texture_compression_astc_ldr", "GL_WEBGL_compressed_texture_astc"});
+#endif
+        LOG_INFO("Texture compression support: S3TC {} RGTC {} BPTC {} ETC2 {} ASTC {}", s_Support.s3tc, s_Support.rgtc,
+                 s_Support.bptc, s_Support.etc2, s_Support.astc);
+    }
+
+    bool TextureCompression::isSupported(TextureCodec codec)
+    {
+        switch (codec)
+        {
+        case TextureCodec::None:
+            return true;
+        case TextureCodec::BC1:
+        case TextureCodec::BC2:
+        case TextureCodec::BC3:
+            return s_Support.s3tc;
+        case TextureCodec::BC4:
+        case TextureCodec::BC5:
+            return s_Support.rgtc;
+        case TextureCodec::BC6H:
+        case TextureCodec::BC7:
+            return s_Support.bptc;
+        case TextureCodec::ETC2_RGB:
+        case TextureCodec::ETC2_RGBA:
+        case TextureCodec::ETC2_PunchThrough:
+        case TextureCodec::EAC_R11:
+        case TextureCodec::EAC_RG11:
+            return s_Support.etc2;
+        case TextureCodec::ASTC:
+            return s_Support.astc;
+        }
+        return false;
+    }
+
+    bool TextureCompression::isContainerFile(const std::string &path)
+    {
+        auto endsWith = [&](const char *suffix)
+        {
+            const size_t length = std::strlen(suffix);
+            return path.size() >= length && path.compare(path.size() - length, length, suffix) == 0;
+        };
+        return endsWith(".ktx2") || endsWith(".dds");
+    }
+
+    bool TextureCompression::load(const void *fileData, size_t fileSize, const std::string &name, ContainerImage &image)
+    {
+        static const uint8_t kKtx2Identifier[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+        const uint8_t *data = static_cast<const uint8_t *>(fileData);
+        image = ContainerImage();
+
+        bool parsed = false;
+        if (fileSize >= sizeof(kKtx2Identifier) && std::memcmp(data, kKtx2Identifier, sizeof(kKtx2Identifier)) == 0)
+        {
+            parsed = parseKtx2(data, fileSize, name, image);
+        }
+        else if (fileSize >= 4 && std::memcmp(data, "DDS ", 4) == 0)
+        {
+            parsed = parseDds(data, fileSize, name, image);
+        }
+        else
+        {
+            LOG_ERROR("TEXTURE::LOAD_FAILED: '{}' is neither a KTX2 nor a DDS file.", name);
+        }
+        if (!parsed)
+        {
+            return false;
+        }
+
+        if (!isSupported(image.codec))
+        {
+            if (!hasCpuDecoder(image.codec))
+            {
+                LOG_ERROR("TEXTURE::LOAD_FAILED: '{}' uses a format this GPU cannot sample and that has no CPU decoder; "
+                          "bake it to a different format.", name);
+                return false;
+            }
+            return decompress(image, name);
+        }
+        return true;
+    }
+
+    bool TextureCompression::parseKtx2(const uint8_t *data, size_t size, const std::string &name, ContainerImage &image)
+    {
+        constexpr size_t kHeaderSize = 80;
+        constexpr size_t kLevelIndexEntry = 24;
+        if (size < kHeaderSize)
+        {
+            LOG_ERROR("TEXTURE::LOAD_FAILED: KTX2 file '{}' is truncated.", name);
+            return false;
+        }
+
+        const uint32_t vkFormat = readU32(data, 12);
+        const uint32_t width = readU32(data, 20);
+        const uint32_t height = readU32(data, 24);
+        const uint32_t depth = readU32(data, 28);
+        const uint32_t layers = readU32(data, 32);
+        const uint32_t faces = readU32(data, 36);
+        const uint32_t levelCount = readU32(data, 40);
+        const uint32_t supercompression = readU32(data, 44);
+
+        if (supercompression != 0)
+        {
+            LOG_ERROR("TEXTURE::LOAD_FAILED: '{}' uses KTX2 supercompression scheme {}, which is not supported.", name, supercompression);
+            return false;
+        }
+        if (depth > 1 || faces != 1 || width == 0 || height == 0)
+        {
+            LOG_ERROR("TEXTURE::LOAD_FAILED: '{}' is not a 2D texture or texture array ({}x{}x{}, {} layers, {} faces).",
+                      name, width, height, depth, layers, faces);
+            return false;
+        }
+
+        const FormatDesc format = fromVkFormat(vkFormat);
+        if (format.glFormat == 0)
+        {
+            LOG_ERROR("TEXTURE::LOAD_FAILED: '{}' has unsupported VkFormat {}.", name, vkFormat);
+            return false;
+        }
+        applyFormat(format, image);
+        image.width = static_cast<int>(width);
+        image.height = static_cast<int>(height);
+        image.layerCount = static_cast<int>(layers);
+
+        // A level count of 0 asks the loader to build the mip chain itself.
+        const uint32_t levels = std::min(std::max(levelCount, 1u), maxLevelCount(width, height));
+        image.generateMipmaps = levelCount == 0;
+        if (size < kHeaderSize + levels * kLevelIndexEntry)
+        {
+            LOG_ERROR("TEXTURE::LOAD_FAILED: KTX2 file '{}' is truncated.", name);
+            return false;
+        }
+
+        for (uint32_t level = 0; level < levels; ++level)
+        {
+            const uint64_t offset = readU64(data, kHeaderSize + level * kLevelIndexEntry);
+            const uint64_t length = readU64(data, kHeaderSize + level * kLevelIndexEntry + 8);
+            const int levelWidth = std::max(1, image.width >> level);
+            const int levelHeight = std::max(1, image.height >> level);
+            const size_t layerSize = levelByteSize(format, levelWidth, levelHeight);
+            const uint32_t layerCount = std::max(layers, 1u);
+            if (offset > size || length > size - offset || length / layerCount < layerSize)
+            {
+                LOG_ERROR("TEXTURE::LOAD_FAILED: KTX2 file '{}' has a corrupt level {}.", name, level);
+                return false;
+            }
+            // Array layers follow each other inside the level.
+            for (uint32_t layer = 0; layer < layerCount; ++layer)
+            {
+                appendLevel(image, data + offset + layer * layerSize, layerSize, levelWidth, levelHeight);
+            }
+        }
+        return true;
+    }
+
+    bool TextureCompression::parseDds(const uint8_t *data, size_t size, const std::string &name, ContainerImage &image)
+    {
+        constexpr size_t kHeaderSize = 128; // Magic + DDS_HEADER
+        constexpr size_t kDx10HeaderSize = 20;
+        constexpr uint32_t kPixelFormatFourCC = 0x4;
+        constexpr uint32_t kPixelFormatRgb = 0x40;
+        constexpr uint32_t kCaps2Cubemap = 0x200;
+        constexpr uint32_t kMiscTextureCube = 0x4;
+        if (size < kHeaderSize)
+        {
+            LOG_ERROR("TEXTURE::LOAD_FAILED: DDS file '{}' is truncated.", name);
+            return false;
+        }
+
+        const uint32_t height = readU32(data, 12);
+        const uint32_t width = readU32(data, 16);
+        const uint32_t mipCount = readU32(data, 28);
+        const uint32_t pixelFlags = readU32(data, 80);
+        const uint32_t code = readU32(data, 84);
+        const uint32_t caps2 = readU32(data, 112);
+
+        size_t offset = kHeaderSize;
+        FormatDesc format = kInvalidFormat;
+        if ((pixelFlags & kPixelFormatFourCC) && code == fourCC("DX10"))
+        {
+            if (size < kHeaderSize + kDx10HeaderSize)
+            {
+                LOG_ERROR("TEXTURE::LOAD_FAILED: DDS file '{}' is truncated.", name);
+                return false;
+            }
+            const uint32_t miscFlags = readU32(data, kHeaderSize + 8);
+            const uint32_t arraySize = readU32(data, kHeaderSize + 12);
+            if ((miscFlags & kMiscTextureCube) || arraySize > 1)
+            {
+                LOG_ERROR("TEXTURE::LOAD_FAILED: '{}' is a cubemap or array; only 2D DDS textures are supported.", name);
+                return false;
+            }
+            format = fromDxgiFormat(readU32(data, kHeaderSize));
+            offset += kDx10HeaderSize;
+        }
+        else if (pixelFlags & kPixelFormatFourCC)
+        {
+            format = fromFourCC(code);
+        }
+        else if ((pixelFlags & kPixelFormatRgb) && readU32(data, 88) == 32 && readU32(data, 92) == 0x000000FF &&
+                 readU32(data, 96) == 0x0000FF00 && readU32(data, 100) == 0x00FF0000)
+        {
+            format = rgba8(false);
+        }
+
+        if (caps2 & kCaps2Cubemap)
+        {
+            LOG_ERROR("TEXTURE::LOAD_FAILED: '{}' is a cubemap; only 2D DDS textures are supported.", name);
+            return false;
+        }
+        if (format.glFormat == 0 || width == 0 || height == 0)
+        {
+            LOG_ERROR("TEXTURE::LOAD_FAILED: '{}' has an unsupported DDS pixel format.", name);
+            return false;
+        }
+        applyFormat(format, image);
+        image.width = static_cast<int>(width);
+        image.height = static_cast<int>(height);
+
+        const uint32_t levels = std::min(std::max(mipCount, 1u), maxLevelCount(width, height));
+        image.generateMipmaps = levels == 1;
+        for (uint32_t level = 0; level < levels; ++level)
+        {
+            const int levelWidth = std::max(1, image.width >> level);
+            const int levelHeight = std::max(1, image.height >> level);
+            const size_t levelSize = levelByteSize(format, levelWidth, levelHeight);
+            if (offset > size || levelSize > size - offset)
+            {
+                LOG_ERROR("TEXTURE::LOAD_FAILED: DDS file '{}' is truncated at level {}.", name, level);
+                return false;
+            }
+            appendLevel(image, data + offset, levelSize, levelWidth, levelHeight);
+            offset += levelSize;
+        }
+        return true;
+    }
+
+    bool TextureCompression::decompress(ContainerImage &image, const std::string &name)
+    {
+        LOG_WARN("Texture '{}': format not supported by the GPU, decompressing on the CPU.", name);
+
+        const size_t blockBytes = blockBytesOf(image.codec);
+        ContainerImage decoded;
+        decoded.codec = TextureCodec::None;
+        decoded.srgb = image.srgb;
+        decoded.internalFormat = image.srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+        decoded.pixelType = GL_UNSIGNED_BYTE;
+        decoded.pixelFormat = GL_RGBA;
+        decoded.width = image.width;
+        decoded.height = image.height;
+        decoded.faceCount = image.faceCount;
+        decoded.layerCount = image.layerCount;
+        decoded.generateMipmaps = image.generateMipmaps;
+
+        for (const ImageLevel &level : image.levels)
+        {
+            ImageLevel out;
+            out.offset = decoded.data.size();
+            out.width = level.width;
+            out.height = level.height;
+            out.size = static_cast<size_t>(level.width) * level.height * 4;
+            decoded.data.resize(decoded.data.size() + out.size);
+            uint8_t *pixels = decoded.data.data() + out.offset;
+
+            const uint8_t *block = image.data.data() + level.offset;
+            Block texels;
+            for (int by = 0; by < level.height; by += 4)
+            {
+                for (int bx = 0; bx < level.width; bx += 4)
+                {
+                    decodeBlock(image.codec, block, texels);
+                    block += blockBytes;
+                    for (int y = 0; y < 4 && by + y < level.height; ++y)
+                    {
+                        for (int x = 0; x < 4 && bx + x < level.width; ++x)
+                        {
+                            std::memcpy(pixels + (static_cast<size_t>(by + y) * level.width + bx + x) * 4, texels[y * 4 + x], 4);
+                        }
+                    }
+                }
+            }
+            decoded.levels.push_back(out);
+        }
+
+        image = std::move(decoded);
+        return true;
+    }
+
+    void TextureCompression::useLinearFormat(ContainerImage &image)
+    {
+        if (!image.srgb)
+        {
+            return;
+        }
+        switch (image.internalFormat)
+        {
+        case GL_SRGB8_ALPHA8: image.internalFormat = GL_RGBA8; break;
+        case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT: image.internalFormat = GL_COMPRESSED_RGB_S3TC_DXT1_EXT; break;
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT: image.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT; break;
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT: image.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT; break;
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT: image.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT; break;
+        case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM: image.internalFormat = GL_COMPRESSED_RGBA_BPTC_UNORM; break;
+        case GL_COMPRESSED_SRGB8_ETC2: image.internalFormat = GL_COMPRESSED_RGB8_ETC2; break;
+        case GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2: image.internalFormat = GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2; break;
+        case GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC: image.internalFormat = GL_COMPRESSED_RGBA8_ETC2_EAC; break;
+        default:
+            if (image.internalFormat >= GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR &&
+                image.internalFormat <= GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR + 13)
+            {
+                image.internalFormat = image.internalFormat - GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR + GL_COMPRESSED_RGBA_ASTC_4x4_KHR;
+                break;
+            }
+            return;
+        }
+        image.srgb = false;
+    }
+
+} // namespace Base
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if PLATFORM_DESKTOP
+    #include <glad/gl.h>
+#elif PLATFORM_ANDROID
+    #include <glad/egl.h>
+    #include <glad/gles2.h>
+#elif PLATFORM_EMSCRIPTEN || PLATFORM_IOS
+    #include <glad/gles2.h>
+#endif
+
+namespace Base
+{
+    // Block compression families found in KTX2/DDS containers.
+    enum class TextureCodec : uint8_t
+    {
+        None, // Uncompressed RGBA8 or RGBA16F (see ContainerImage::pixelType)
+        BC1,
+        BC2,
+        BC3,
+        BC4,
+        BC5,
+        BC6H,
+        BC7,
+        ETC2_RGB,
+        ETC2_RGBA,
+        ETC2_PunchThrough,
+        EAC_R11,
+        EAC_RG11,
+        ASTC
+    };
+
+    // One mip level inside ContainerImage::data.
+    struct ImageLevel
+    {
+        size_t offset = 0;
+        size_t size = 0;
+        int width = 0;
+        int height = 0;
+    };
+
+    // Pixel data of a KTX2/DDS file (or a decoded .hdr, see HdrImage) with all its mip levels.
+    // Holds the GPU-compressed blocks when the driver can sample the format, RGBA8 otherwise
+    // (see TextureCompression::load).
+    struct ContainerImage
+    {
+        TextureCodec codec = TextureCodec::None; // Codec of `data`; None once decompressed on the CPU
+        GLenum internalFormat = 0;
+        GLenum pixelFormat = GL_RGBA;        // Layout of uncompressed data
+        GLenum pixelType = GL_UNSIGNED_BYTE; // Component type of uncompressed data
+        bool srgb = false;
+        int width = 0;
+        int height = 0;
+        int faceCount = 1;            // 6 for cube maps
+        int layerCount = 0;           // > 0 for a GL_TEXTURE_2D_ARRAY (KTX2 convention)
+        bool generateMipmaps = false; // The file only had level 0
+        // Per mip level, imagesPerLevel() entries: faces in GL order (+X, -X, +Y, -Y, +Z, -Z), or
+        // array layers. The layers of one level are contiguous in `data`.
+        std::vector<ImageLevel> levels;
+        std::vector<uint8_t> data;
+
+        int imagesPerLevel() const { return faceCount * (layerCount > 0 ? layerCount : 1); }
+    };
+
+    // Loading of pre-compressed textures. Rows are stored in the order the baker wrote them;
+    // assets are expected bottom row first, matching what Texture::loadFromFile produces.
+    class TextureCompression
+    {
+    public:
+        struct Support
+        {
+            bool s3tc = false; // BC1-3
+            bool rgtc = false; // BC4-5
+            bool bptc = false; // BC6H, BC7
+            bool etc2 = false; // ETC2/EAC
+            bool astc = false; // ASTC LDR
+        };
+
+        // Queries the driver once; must run on the GL thread before any load() on a worker.
+        static void querySupport();
+        static const Support &getSupport() { return s_Support; }
+        static bool isSupported(TextureCodec codec);
+
+        static bool isContainerFile(const std::string &path);
+
+        // Parses a .ktx2 or .dds file. Payloads the driver cannot sample are decompressed to RGBA8
+        // when a CPU decoder exists for them. Touches no GL state.
+        static bool load(const void *fileData, size_t fileSize, const std::string &name, ContainerImage &image);
+
+        // Switches an sRGB image to the matching UNORM format, so sampling returns the stored values
+        // unconverted; that is what an 8-bit PNG uploaded as GL_RGBA gives the same shaders.
+        static void useLinearFormat(ContainerImage &image);
+
+    private:
+        static bool parseKtx2(const uint8_t *data, size_t size, const std::string &name, ContainerImage &image);
+        static bool parseDds(const uint8_t *data, size_t size, const std::string &name, ContainerImage &image);
+        static bool decompress(ContainerImage &image, const std::string &name);
+
+        static Support s_Support;
+    };
+
+} // namespace Base
@@ -0,0 +1,362 @@
+#include "TextureLoader.hpp"
+#include "Log.hpp"
+#include "Vfs.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace Base
+{
+    // State shared by the handles, the worker decoding the file and the GL-thread upload.
+    struct TextureRequest
+    {
+        std::string path;
+        TextureSettings settings;
+        std::unique_ptr<Texture> texture;
+        ImageData image;
+        ContainerImage container; // Used instead of `image` for GPU-ready files (see Texture::readGpuReadyFile)
+        bool isContainer = false;
+        std::promise<void> decoded; // Fulfilled once the request has left the workers, loaded or not
+        std::future<void> decode = decoded.get_future();
+        std::atomic<TextureLoadState> state = TextureLoadState::Loading;
+        int uploadedRows = 0;
+        bool allocated = false;
+    };
+
+    TextureLoadState TextureHandle::getState() const
+    {
+        return m_Request ? m_Request->state.load() : TextureLoadState::Failed;
+    }
+
+    bool TextureHandle::wait() const
+    {
+        return m_Request && TextureLoader::Get().completeNow(m_Request);
+    }
+
+    void TextureHandle::bind(GLuint textureUnit) const
+    {
+        if (isReady())
+        {
+            m_Request->texture->bind(textureUnit);
+        }
+        else if (const Texture *placeholder = TextureLoader::Get().getPlaceholder())
+        {
+            placeholder->bind(textureUnit);
+        }
+    }
+
+    const Texture *TextureHandle::get() const
+    {
+        return isReady() ? m_Request->texture.get() : nullptr;
+    }
+
+    const std::string &TextureHandle::getPath() const
+    {
+        static const std::string s_Empty;
+        return m_Request ? m_Request->path : s_Empty;
+    }
+
+    TextureLoader &TextureLoader::Get()
+    {
+        static std::unique_ptr<TextureLoader> s_Instance(new TextureLoader());
+        return *s_Instance;
+    }
+
+    TextureLoader::~TextureLoader()
+    {
+        shutdown();
+    }
+
+    void TextureLoader::initialize(ThreadPool &workers)
+    {
+        if (m_Initialized)
+        {
+            return;
+        }
+
+        m_Workers.open(workers);
+        TextureCompression::querySupport();
+
+        // 2x2 magenta/black checker, shown wherever a texture is still on its way.
+        const unsigned char checker[] = {255, 0, 255, 255, 0, 0, 0, 255,
+                                         0, 0, 0, 255, 255, 0, 255, 255};
+        m_Placeholder = std::make_unique<Texture>();
+        TextureSettings nearest;
+        nearest.minFilter = GL_NEAREST;
+        nearest.magFilter = GL_NEAREST;
+        m_Placeholder->allocate(2, 2, 4, nearest);
+        m_Placeholder->uploadRows(0, 2, checker);
+
+#if !PLATFORM_EMSCRIPTEN
+        glGenBuffers(1, &m_UploadBuffer);
+#endif
+        m_Initialized = true;
+    }
+
+    void TextureLoader::shutdown()
+    {
+        if (!m_Initialized)
+        {
+            return;
+        }
+
+        // close() waits for the queued decodes, so no worker touches a request after this;
+        // reads still in flight find the group closed and fail their request.
+        m_Workers.close();
+
+        collectDecoded();
+        for (const std::shared_ptr<TextureRequest> &request : m_Uploads)
+        {
+            request->image = ImageData();
+            request->state = TextureLoadState::Failed;
+        }
+        m_Uploads.clear();
+        m_InFlight = 0;
+
+        if (m_UploadBuffer != 0)
+        {
+            glDeleteBuffers(1, &m_UploadBuffer);
+            m_UploadBuffer = 0;
+        }
+        m_Placeholder.reset();
+        m_Initialized = false;
+    }
+
+    TextureHandle TextureLoader::loadAsync(const std::string &path, const TextureSettings &settings)
+    {
+        auto request = std::make_shared<TextureRequest>();
+        request->path = path;
+        request->settings = settings;
+        if (!m_Initialized)
+        {
+            LOG_ERROR("TextureLoader: loadAsync('{}') called before initialize().", path);
+            request->state = TextureLoadState::Failed;
+            return TextureHandle(request);
+        }
+
+        // The GL object is created here, on the GL thread; workers only produce pixels.
+        request->texture = std::make_unique<Texture>();
+        m_InFlight++;
+        // GPU-ready files (.ktx2/.dds, .hdr) carry everything but the upload. Images may have a
+        // baked .ktx2 next to them, which even saves the glGenerateMipmap.
+        read(request, settings.cubemapFaceSize == 0 && !TextureCompression::isContainerFile(path));
+        return TextureHandle(request);
+    }
+
+    void TextureLoader::read(const std::shared_ptr<TextureRequest> &request, bool baked)
+    {
+        const std::string path = baked ? Texture::bakedPathFor(request->path) : request->path;
+        Vfs::readAsync(path, [this, request, baked](AssetFile &&file)
+                       {
+            if (baked && !file.isOpen())
+            {
+                // Not finding one is the normal case (web/mobile builds, no baker run).
+                read(request, false);
+                return;
+            }
+
+            try
+            {
+                m_Workers.Enqueue([this, request, baked, file = std::move(file)]()
+                                  { decode(request, file, baked); });
+                return;
+            }
+            catch (const std::runtime_error &)
+            {
+                // Closed by shutdown() in the meantime.
+            }
+            request->state = TextureLoadState::Failed;
+            request->decoded.set_value(); });
+    }
+
+    void TextureLoader::decode(const std::shared_ptr<TextureRequest> &request, const AssetFile &file, bool baked)
+    {
+        bool loaded = false;
+        if (baked)
+        {
+            if (!Texture::decodeBakedFile(Texture::bakedPathFor(request->path), file.data(), file.size(), request->container))
+            {
+                // Unreadable baked file: use the source instead.
+                request->container = ContainerImage();
+                read(request, false);
+                return;
+            }
+            request->isContainer = loaded = true;
+        }
+        else if (!file.isOpen())
+        {
+            LOG_ERROR("TEXTURE::LOAD_FAILED: could not open '{}'.", request->path);
+        }
+        else if (Texture::isGpuReadyFile(request->path))
+        {
+            request->isContainer = true;
+            loaded = Texture::decodeGpuReadyFile(request->path, file.data(), file.size(), request->settings.cubemapFaceSize,
+                                                 request->container);
+        }
+        else
+        {
+            // Decoders return the rows bottom first, as OpenGL expects.
+            loaded = ImageDecoder::decodeImage(file.data(), file.size(), request->path, request->image);
+        }
+
+        if (!loaded)
+        {
+            request->state = TextureLoadState::Failed;
+            m_InFlight--;
+        }
+        else
+        {
+            request->state = TextureLoadState::Uploading;
+            std::lock_guard<std::mutex> lock(m_DecodedMutex);
+            m_Decoded.push_back(request);
+        }
+        request->decoded.set_value();
+    }
+
+    size_t TextureLoader::getPendingCount() const
+    {
+        return m_InFlight.load();
+    }
+
+    void TextureLoader::collectDecoded()
+    {
+        std::lock_guard<std::mutex> lock(m_DecodedMutex);
+        for (std::shared_ptr<TextureRequest> &request : m_Decoded)
+        {
+            m_Uploads.push_back(std::move(request));
+        }
+        m_Decoded.clear();
+    }
+
+    void TextureLoader::update()
+    {
+        if (!m_Initialized)
+        {
+            return;
+        }
+
+        collectDecoded();
+
+        size_t uploaded = 0;
+        while (!m_Uploads.empty() && uploaded < m_UploadBudget)
+        {
+            std::shared_ptr<TextureRequest> request = m_Uploads.front();
+            uploaded += uploadRows(*request, m_UploadBudget - uploaded);
+            if (request->state == TextureLoadState::Failed)
+            {
+                m_Uploads.pop_front();
+            }
+            else if (request->isContainer || request->uploadedRows == request->image.height)
+            {
+                finish(*request);
+                m_Uploads.pop_front();
+            }
+        }
+        m_UploadedLastFrame = uploaded;
+    }
+
+    size_t TextureLoader::uploadRows(TextureRequest &request, size_t budget)
+    {
+        if (request.isContainer)
+        {
+            // Pre-built mip chains are small next to their decoded size; upload them whole.
+            const size_t bytes = request.container.data.size();
+            if (!request.texture->upload(request.container, request.settings))
+            {
+                request.container = ContainerImage();
+                request.state = TextureLoadState::Failed;
+                m_InFlight--;
+                return 0;
+            }
+            return bytes;
+        }
+
+        const ImageData &image = request.image;
+        if (!request.allocated)
+        {
+            if (!request.texture->allocate(image.width, image.height, image.channels, request.settings))
+            {
+                LOG_ERROR("TextureLoader: cannot upload '{}'.", request.path);
+                request.image = ImageData();
+                request.state = TextureLoadState::Failed;
+                m_InFlight--;
+                return 0;
+            }
+            request.allocated = true;
+        }
+
+        // Always make progress, even when a single row is larger than the budget.
+        const size_t rowSize = image.rowSize();
+        const size_t remainingRows = static_cast<size_t>(image.height - request.uploadedRows);
+        const size_t rows = std::clamp<size_t>(budget / rowSize, 1, remainingRows);
+        const size_t bytes = rows * rowSize;
+        const unsigned char *source = image.pixels + static_cast<size_t>(request.uploadedRows) * rowSize;
+
+#if PLATFORM_EMSCRIPTEN
+        // WebGL cannot map buffers, so a PBO would only add a copy.
+        request.texture->uploadRows(request.uploadedRows, static_cast<int>(rows), source);
+#else
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_UploadBuffer);
+        // Orphan the previous contents so mapping never waits for an upload still in flight.
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_DRAW);
+        void *mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(bytes),
+                                        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        if (mapped)
+        {
+            std::memcpy(mapped, source, bytes);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            request.texture->uploadRows(request.uploadedRows, static_cast<int>(rows), nullptr);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        }
+        else
+        {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            request.texture->uploadRows(request.uploadedRows, static_cast<int>(rows), source);
+        }
+#endif
+        request.uploadedRows += static_cast<int>(rows);
+        return bytes;
+    }
+
+    void TextureLoader::finish(TextureRequest &request)
+    {
+        if (!request.isContainer)
+        {
+            request.texture->generateMipmaps();
+        }
+        request.image = ImageData();
+        request.container = ContainerImage();
+        request.state = TextureLoadState::Ready;
+        m_InFlight--;
+        LOG_INFO("Texture loaded successfully: {}", request.path);
+    }
+
+    bool TextureLoader::completeNow(const std::shared_ptr<TextureRequest> &request)
+    {
+        if (request->state == TextureLoadState::Ready || request->state == TextureLoadState::Failed)
+        {
+            return request->state == TextureLoadState::Ready;
+        }
+
+        if (request->decode.valid())
+        {
+            request->decode.wait();
+        }
+        collectDecoded();
+
+        auto it = std::find(m_Uploads.begin(), m_Uploads.end(), request);
+        if (it == m_Uploads.end())
+        {
+            return request->state == TextureLoadState::Ready;
+        }
+        uploadRows(*request, std::numeric_limits<size_t>::max());
+        if (request->state != TextureLoadState::Failed)
+        {
+            finish(*request);
+        }
+        m_Uploads.erase(it);
+        return request->state == TextureLoadState::Ready;
+    }
+
+} // namespace Base
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "AssetFile.hpp"
+#include "Texture.hpp"
+#include "ThreadPool.hpp"
+
+namespace Base
+{
+    enum class TextureLoadState : uint8_t
+    {
+        Loading,   // Reading/decoding on a worker thread
+        Uploading, // Decoded, waiting for (or in the middle of) its GL upload
+        Ready,
+        Failed
+    };
+
+    struct TextureRequest;
+
+    // Shared reference to a texture that is being loaded by TextureLoader. Cheap to copy; the
+    // texture lives as long as any handle does.
+    class TextureHandle
+    {
+    public:
+        TextureHandle() = default;
+
+        bool isValid() const { return m_Request != nullptr; }
+        TextureLoadState getState() const;
+        bool isReady() const { return getState() == TextureLoadState::Ready; }
+        bool isFailed() const { return getState() == TextureLoadState::Failed; }
+
+        // Blocks until the texture is uploaded or has failed. GL thread only.
+        bool wait() const;
+
+        // Binds the texture, or the loader's placeholder while it is not ready yet.
+        void bind(GLuint textureUnit = 0) const;
+        // nullptr until the texture is ready.
+        const Texture *get() const;
+        const std::string &getPath() const;
+
+    private:
+        friend class TextureLoader;
+        friend class TextureCache;
+        explicit TextureHandle(std::shared_ptr<TextureRequest> request) : m_Request(std::move(request)) {}
+
+        std::shared_ptr<TextureRequest> m_Request;
+    };
+
+    // Loads textures without stalling the frame: files are read through Vfs::readAsync, so the
+    // reads of many textures overlap, and decoded on worker threads; update() streams the
+    // decoded pixels to the GPU through a pixel buffer object, at most getUploadBudget() bytes
+    // per frame.
+    class TextureLoader
+    {
+    public:
+        static TextureLoader &Get();
+
+        TextureLoader() = default;
+        ~TextureLoader();
+
+        TextureLoader(const TextureLoader &) = delete;
+        TextureLoader &operator=(const TextureLoader &) = delete;
+
+        // Decodes run on `workers`, shared with the rest of the application.
+        void initialize(ThreadPool &workers);
+        void shutdown();
+
+        TextureHandle loadAsync(const std::string &path, const TextureSettings &settings = {});
+
+        // Called once per frame on the GL thread, before the application's update/render.
+        void update();
+
+        void setUploadBudget(size_t bytesPerFrame) { m_UploadBudget = bytesPerFrame; }
+        size_t getUploadBudget() const { return m_UploadBudget; }
+        size_t getPendingCount() const;
+        size_t getUploadedLastFrame() const { return m_UploadedLastFrame; }
+
+        const Texture *getPlaceholder() const { return m_Placeholder.get(); }
+
+    private:
+        friend class TextureHandle;
+
+        // Reads the file, trying the baked .ktx2 first when `baked`, and queues its decode.
+        void read(const std::shared_ptr<TextureRequest> &request, bool baked);
+        void decode(const std::shared_ptr<TextureRequest> &request, const AssetFile &file, bool baked);
+        void collectDecoded();
+        // Uploads up to `budget` bytes of the request's remaining rows; returns the bytes uploaded.
+        size_t uploadRows(TextureRequest &request, size_t budget);
+        void finish(TextureRequest &request);
+        bool completeNow(const std::shared_ptr<TextureRequest> &request);
+
+        TaskGroup m_Workers; // Read completions queue their decode from the VFS IO thread
+        std::unique_ptr<Texture> m_Placeholder;
+        GLuint m_UploadBuffer = 0; // GL_PIXEL_UNPACK_BUFFER staging the rows of the current upload
+
+        std::mutex m_DecodedMutex;
+        std::vector<std::shared_ptr<TextureRequest>> m_Decoded; // Filled by workers
+        std::deque<std::shared_ptr<TextureRequest>> m_Uploads;  // GL thread only
+        std::atomic<size_t> m_InFlight = 0;
+
+        size_t m_UploadBudget = 4 * 1024 * 1024;
+        size_t m_UploadedLastFrame = 0;
+        bool m_Initialized = false;
+    };
+
+} // namespace Base
@@ -0,0 +1,544 @@
+#include "TextureStreamer.hpp"
+#include "Log.hpp"
+#include "TextureLoader.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Base
+{
+    // State shared by the handles, the worker reading levels and the GL-thread swap.
+    struct StreamedTextureState
+    {
+        std::string path;
+        TextureSettings settings;
+        std::unique_ptr<Texture> texture; // Levels [residentMip ..]
+        ContainerImage tail;              // Levels [tailMip ..], to evict without touching the disk
+
+        // Full-resolution layout, known once the first load finished.
+        int width = 0;
+        int height = 0;
+        int mipCount = 0;
+        int tailMip = 0;
+        int residentMip = 0;
+        int desiredMip = 0;
+        bool failed = false;
+        // A refinement to failedMip failed: it and finer levels are skipped until retryFrame.
+        int failedMip = -1;
+        uint64_t retryFrame = 0;
+        uint32_t failures = 0; // In a row
+
+        float footprint = 0.0f;     // Largest report this frame
+        float lastFootprint = 0.0f; // Largest report of the last frame with any
+        uint64_t lastUsedFrame = 0;
+
+        // Worker side of a load; read by the GL thread once the state is in m_Loaded.
+        bool loading = false;
+        int loadingMip = -1;
+        size_t reservedBytes = 0;
+        ContainerImage loaded;
+        bool loadSucceeded = false;
+        int loadedWidth = 0;
+        int loadedHeight = 0;
+        int loadedMipCount = 0;
+        bool loadedStreamable = false;
+    };
+
+    namespace
+    {
+        // Box-filtered RGBA8 chain of a decoded image, the CPU side of glGenerateMipmap.
+        void buildMipChain(const ImageData &decoded, ContainerImage &image)
+        {
+            image = ContainerImage();
+            image.internalFormat = GL_RGBA8;
+            image.width = decoded.width;
+            image.height = decoded.height;
+
+            size_t size = static_cast<size_t>(decoded.width) * decoded.height * 4;
+            image.data.resize(size);
+            image.levels.push_back({0, size, decoded.width, decoded.height});
+            for (size_t i = 0; i < static_cast<size_t>(decoded.width) * decoded.height; ++i)
+            {
+                // Same expansion GL applies when sampling GL_RED/GL_RGB textures.
+                const unsigned char *in = decoded.pixels + i * decoded.channels;
+                uint8_t *out = &image.data[i * 4];
+                out[0] = in[0];
+                out[1] = decoded.channels > 1 ? in[1] : 0;
+                out[2] = decoded.channels > 2 ? in[2] : 0;
+                out[3] = decoded.channels > 3 ? in[3] : 255;
+            }
+
+            while (image.levels.back().width > 1 || image.levels.back().height > 1)
+            {
+                const ImageLevel source = image.levels.back();
+                ImageLevel level;
+                level.width = std::max(1, source.width / 2);
+                level.height = std::max(1, source.height / 2);
+                level.offset = image.data.size();
+                level.size = static_cast<size_t>(level.width) * level.height * 4;
+                image.data.resize(image.data.size() + level.size);
+
+                const uint8_t *in = image.data.data() + source.offset;
+                uint8_t *out = image.data.data() + level.offset;
+                for (int y = 0; y < level.height; ++y)
+                {
+                    const int y0 = std::min(y * 2, source.height - 1);
+                    const int y1 = std::min(y * 2 + 1, source.height - 1);
+                    for (int x = 0; x < level.width; ++x, out += 4)
+                    {
+                        const int x0 = std::min(x * 2, source.width - 1);
+                        const int x1 = std::min(x * 2 + 1, source.width - 1);
+                        for (int c = 0; c < 4; ++c)
+                        {
+                            const int sum = in[(y0 * source.width + x0) * 4 + c] + in[(y0 * source.width + x1) * 4 + c] +
+                                            in[(y1 * source.width + x0) * 4 + c] + in[(y1 * source.width + x1) * 4 + c];
+                            out[c] = static_cast<uint8_t>((sum + 2) / 4);
+                        }
+                    }
+                }
+                image.levels.push_back(level);
+            }
+        }
+
+        // Drops levels finer than `firstMip`, so level 0 of `image` becomes that mip.
+        void dropFinerLevels(ContainerImage &image, int firstMip)
+        {
+            const size_t first = static_cast<size_t>(firstMip) * image.imagesPerLevel();
+            if (first == 0 || first >= image.levels.size())
+            {
+                return;
+            }
+            const size_t offset = image.levels[first].offset;
+            image.data.erase(image.data.begin(), image.data.begin() + static_cast<std::ptrdiff_t>(offset));
+            image.levels.erase(image.levels.begin(), image.levels.begin() + static_cast<std::ptrdiff_t>(first));
+            for (ImageLevel &level : image.levels)
+            {
+                level.offset -= offset;
+            }
+            image.width = image.levels.front().width;
+            image.height = image.levels.front().height;
+        }
+    } // namespace
+
+    void StreamedTexture::requestFootprint(float screenPixels) const
+    {
+        if (m_State)
+        {
+            m_State->footprint = std::max(m_State->footprint, screenPixels);
+            m_State->lastUsedFrame = TextureStreamer::Get().m_Frame;
+        }
+    }
+
+    void StreamedTexture::bind(GLuint textureUnit) const
+    {
+        if (m_State && m_State->texture)
+        {
+            m_State->texture->bind(textureUnit);
+        }
+        else if (const Texture *placeholder = TextureLoader::Get().getPlaceholder())
+        {
+            placeholder->bind(textureUnit);
+        }
+    }
+
+    const Texture *StreamedTexture::get() const
+    {
+        return m_State ? m_State->texture.get() : nullptr;
+    }
+
+    const std::string &StreamedTexture::getPath() const
+    {
+        static const std::string s_Empty;
+        return m_State ? m_State->path : s_Empty;
+    }
+
+    int StreamedTexture::getResidentMip() const
+    {
+        return m_State ? m_State->residentMip : 0;
+    }
+
+    int StreamedTexture::getDesiredMip() const
+    {
+        return m_State ? m_State->desiredMip : 0;
+    }
+
+    TextureStreamer &TextureStreamer::Get()
+    {
+        static std::unique_ptr<TextureStreamer> s_Instance(new TextureStreamer());
+        return *s_Instance;
+    }
+
+    TextureStreamer::~TextureStreamer()
+    {
+        shutdown();
+    }
+
+    void TextureStreamer::initialize(ThreadPool &workers)
+    {
+        if (m_Initialized)
+        {
+            return;
+        }
+        m_Workers.open(workers);
+        m_Initialized = true;
+    }
+
+    void TextureStreamer::shutdown()
+    {
+        if (!m_Initialized)
+        {
+            return;
+        }
+
+        // close() waits for the queued loads, so no worker touches a state after this.
+        m_Workers.close();
+
+        // Handles may outlive the GL context; release every texture now.
+        for (const std::shared_ptr<StreamedTextureState> &state : m_Textures)
+        {
+            state->texture.reset();
+            state->tail = ContainerImage();
+            state->loaded = ContainerImage();
+            state->loading = false;
+        }
+        m_Textures.clear();
+        m_Loaded.clear();
+        m_Uploads.clear();
+        m_Pending = 0;
+        m_ResidentBytes = 0;
+        m_ReservedBytes = 0;
+        m_Stats = Stats();
+        m_Initialized = false;
+    }
+
+    StreamedTexture TextureStreamer::load(const std::string &path, const TextureSettings &settings)
+    {
+        auto state = std::make_shared<StreamedTextureState>();
+        state->path = path;
+        state->settings = settings;
+        if (!m_Initialized)
+        {
+            LOG_ERROR("TextureStreamer: load('{}') called before initialize().", path);
+            state->failed = true;
+            return StreamedTexture(state);
+        }
+
+        state->lastUsedFrame = m_Frame;
+        m_Textures.push_back(state);
+        requestLevels(state, -1, 0);
+        return StreamedTexture(state);
+    }
+
+    void TextureStreamer::requestLevels(const std::shared_ptr<StreamedTextureState> &state, int firstMip, size_t reservedBytes)
+    {
+        state->loading = true;
+        state->loadingMip = firstMip;
+        state->reservedBytes = reservedBytes;
+        m_ReservedBytes += reservedBytes;
+        m_Pending++;
+        m_Workers.Enqueue([this, state, firstMip]()
+                           {
+            // The whole file is read each time; baked .ktx2 files keep that to the compressed chain.
+            ContainerImage image;
+            bool loaded = false;
+            if (!Texture::readGpuReadyFile(state->path, state->settings, image, loaded))
+            {
+                ImageData decoded;
+                loaded = Texture::readImageFile(state->path, decoded);
+                if (loaded)
+                {
+                    buildMipChain(decoded, image);
+                }
+            }
+
+            state->loadSucceeded = loaded;
+            if (loaded)
+            {
+                // Single-level files rely on glGenerateMipmap and can only be loaded whole.
+                const int mipCount = static_cast<int>(image.levels.size() / image.imagesPerLevel());
+                state->loadedWidth = image.width;
+                state->loadedHeight = image.height;
+                state->loadedMipCount = mipCount;
+                state->loadedStreamable = !image.generateMipmaps && mipCount > 1;
+                int mip = firstMip;
+                if (mip < 0)
+                {
+                    // First load: the tail, the finest level at most kTailSize texels across.
+                    mip = 0;
+                    while (state->loadedStreamable && mip + 1 < mipCount &&
+                           std::max(image.width >> mip, image.height >> mip) > kTailSize)
+                    {
+                        mip++;
+                    }
+                }
+                state->loadingMip = mip;
+                dropFinerLevels(image, std::min(mip, mipCount - 1));
+                state->loaded = std::move(image);
+            }
+            std::lock_guard<std::mutex> lock(m_LoadedMutex);
+            m_Loaded.push_back(state); });
+    }
+
+    int TextureStreamer::desiredMip(const StreamedTextureState &state) const
+    {
+        if (m_Frame - state.lastUsedFrame > kIdleFrames || state.lastFootprint <= 0.0f)
+        {
+            return state.tailMip;
+        }
+        // One texel per pixel: every halving of the footprint skips a level.
+        const float lod = std::log2(static_cast<float>(std::max(state.width, state.height)) / state.lastFootprint) - m_MipBias;
+        return std::clamp(static_cast<int>(std::floor(lod)), 0, state.tailMip);
+    }
+
+    size_t TextureStreamer::projectedBytes(const StreamedTextureState &state, int firstMip) const
+    {
+        // Each finer level quadruples the size of the chain below it.
+        size_t bytes = state.tail.data.size();
+        for (int mip = state.tailMip; mip > firstMip; --mip)
+        {
+            bytes *= 4;
+        }
+        return bytes;
+    }
+
+    bool TextureStreamer::makeRoom(size_t bytes, const StreamedTextureState &keep)
+    {
+        std::vector<StreamedTextureState *> idle;
+        size_t reclaimable = 0;
+        for (const std::shared_ptr<StreamedTextureState> &state : m_Textures)
+        {
+            if (state.get() != &keep && !state->loading && state->residentMip < state->tailMip &&
+                state->lastUsedFrame + 1 < m_Frame)
+            {
+                idle.push_back(state.get());
+                reclaimable += state->texture->getByteSize() - std::min(state->texture->getByteSize(), state->tail.data.size());
+            }
+        }
+        // Evicting is only worth it when it makes enough room.
+        if (m_ResidentBytes + m_ReservedBytes + bytes > m_Budget + reclaimable)
+        {
+            return false;
+        }
+        std::sort(idle.begin(), idle.end(), [](const StreamedTextureState *a, const StreamedTextureState *b)
+                  { return a->lastUsedFrame < b->lastUsedFrame; });
+
+        for (StreamedTextureState *state : idle)
+        {
+            if (m_ResidentBytes + m_ReservedBytes + bytes <= m_Budget)
+            {
+                break;
+            }
+            evictToTail(*state);
+        }
+        return m_ResidentBytes + m_ReservedBytes + bytes <= m_Budget;
+    }
+
+    bool TextureStreamer::swapIn(StreamedTextureState &state, const ContainerImage &image, int firstMip)
+    {
+        auto texture = std::make_unique<Texture>();
+        if (!texture->upload(image, state.settings))
+        {
+            LOG_ERROR("TextureStreamer: cannot upload mip {} of '{}'.", firstMip, state.path);
+            return false;
+        }
+        if (state.texture)
+        {
+            m_ResidentBytes -= state.texture->getByteSize();
+        }
+        m_ResidentBytes += texture->getByteSize();
+        state.texture = std::move(texture);
+        state.residentMip = firstMip;
+        return true;
+    }
+
+    void TextureStreamer::evictToTail(StreamedTextureState &state)
+    {
+        LOG_DEBUG("TextureStreamer: evicting mips {}-{} of '{}'.", state.residentMip, state.tailMip - 1, state.path);
+        if (swapIn(state, state.tail, state.tailMip))
+        {
+            m_Stats.evictions++;
+        }
+    }
+
+    void TextureStreamer::finishLoad(StreamedTextureState &state)
+    {
+        state.loading = false;
+        m_ReservedBytes -= state.reservedBytes;
+        state.reservedBytes = 0;
+        m_Pending--;
+
+        const bool firstLoad = state.mipCount == 0;
+        if (!state.loadSucceeded)
+        {
+            state.failed = firstLoad;
+            state.loaded = ContainerImage();
+            if (!firstLoad)
+            {
+                // The file may be gone (pak unmounted, file deleted); back off instead of re-reading it every frame.
+                state.failedMip = std::max(state.failedMip, state.loadingMip);
+                state.retryFrame = m_Frame + (kRetryFrames << std::min<uint32_t>(state.failures, 5));
+                state.failures++;
+                LOG_WARN("TextureStreamer: cannot stream mip {} of '{}'; retrying in {} frames.", state.loadingMip,
+                         state.path, state.retryFrame - m_Frame);
+            }
+            return;
+        }
+        state.failedMip = -1;
+        state.failures = 0;
+
+        if (firstLoad)
+        {
+            state.width = state.loadedWidth;
+            state.height = state.loadedHeight;
+            state.mipCount = state.loadedMipCount;
+            state.tailMip = state.loadingMip;
+            if (state.tailMip > 0)
+            {
+                state.tail = state.loaded;
+            }
+        }
+        else if (state.loadingMip < state.residentMip)
+        {
+            m_Stats.streamedIn++;
+        }
+        swapIn(state, state.loaded, state.loadingMip);
+        state.loaded = ContainerImage();
+    }
+
+    void TextureStreamer::update()
+    {
+        if (!m_Initialized)
+        {
+            return;
+        }
+        m_Frame++;
+
+        {
+            std::lock_guard<std::mutex> lock(m_LoadedMutex);
+            m_Uploads.insert(m_Uploads.end(), m_Loaded.begin(), m_Loaded.end());
+            m_Loaded.clear();
+        }
+
+        // Swap in finished loads, within the upload budget (but at least one per frame).
+        size_t uploaded = 0;
+        size_t finished = 0;
+        for (; finished < m_Uploads.size() && (finished == 0 || uploaded < m_UploadBudget); ++finished)
+        {
+            uploaded += m_Uploads[finished]->loaded.data.size();
+            finishLoad(*m_Uploads[finished]);
+        }
+        m_Uploads.erase(m_Uploads.begin(), m_Uploads.begin() + static_cast<std::ptrdiff_t>(finished));
+
+        // Forget textures without handles; the list holds one reference, a worker may hold another.
+        for (auto it = m_Textures.begin(); it != m_Textures.end();)
+        {
+            if (it->use_count() == 1 && !(*it)->loading)
+            {
+                if ((*it)->texture)
+                {
+                    m_ResidentBytes -= (*it)->texture->getByteSize();
+                }
+                it = m_Textures.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        // Retarget residency from last frame's footprints, most urgent (largest jump) first.
+        std::vector<std::shared_ptr<StreamedTextureState>> wanted;
+        for (const std::shared_ptr<StreamedTextureState> &state : m_Textures)
+        {
+            if (state->footprint > 0.0f)
+            {
+                state->lastFootprint = state->footprint;
+                state->footprint = 0.0f;
+            }
+            if (state->mipCount == 0 || state->failed)
+            {
+                continue;
+            }
+            state->desiredMip = desiredMip(*state);
+            if (state->failedMip >= 0 && m_Frame >= state->retryFrame)
+            {
+                state->failedMip = -1;
+            }
+            // Only what was drawn last frame streams in; makeRoom() would evict anything else again.
+            const bool drawn = state->lastUsedFrame + 1 >= m_Frame;
+            if (!state->loading && drawn && std::max(state->desiredMip, state->failedMip + 1) < state->residentMip)
+            {
+                wanted.push_back(state);
+            }
+            else if (!state->loading && state->desiredMip == state->tailMip && state->residentMip < state->tailMip &&
+                     m_ResidentBytes > m_Budget / 4 * 3)
+            {
+                // Nearly full: textures that went out of use fall back to their tail early.
+                evictToTail(*state);
+            }
+        }
+        std::sort(wanted.begin(), wanted.end(), [](const auto &a, const auto &b)
+                  { return a->residentMip - a->desiredMip > b->residentMip - b->desiredMip; });
+
+        bool overBudget = false;
+        for (const std::shared_ptr<StreamedTextureState> &state : wanted)
+        {
+            // Settle for a coarser level than desired when the finer one does not fit.
+            const size_t current = state->texture ? state->texture->getByteSize() : 0;
+            for (int mip = std::max(state->desiredMip, state->failedMip + 1); mip < state->residentMip; ++mip)
+            {
+                const size_t growth = projectedBytes(*state, mip) - std::min(current, projectedBytes(*state, mip));
+                if (makeRoom(growth, *state))
+                {
+                    requestLevels(state, mip, growth);
+                    break;
+                }
+                overBudget = true;
+            }
+        }
+
+        m_Stats.textures = m_Textures.size();
+        m_Stats.residentBytes = m_ResidentBytes;
+        m_Stats.pendingLoads = m_Pending.load();
+        m_Stats.uploadedLastFrame = uploaded;
+        m_Stats.overBudget += overBudget ? 1 : 0;
+    }
+
+    float TextureStreamer::screenFootprint(const glm::mat4 &view, const glm::mat4 &projection, const glm::vec3 &center,
+                                           float worldSize, float viewportHeight)
+    {
+        const float pixelsPerUnit = projection[1][1] * 0.5f * viewportHeight;
+        if (projection[3][3] == 1.0f)
+        {
+            return worldSize * pixelsPerUnit; // Orthographic: no perspective divide
+        }
+        const float depth = -(view * glm::vec4(center, 1.0f)).z;
+        if (depth <= 1e-3f)
+        {
+            return std::numeric_limits<float>::max(); // At or behind the eye: as sharp as it gets
+        }
+        return worldSize * pixelsPerUnit / depth;
+    }
+
+    std::vector<TextureStreamer::TextureInfo> TextureStreamer::getTextureInfo() const
+    {
+        std::vector<TextureInfo> infos;
+        infos.reserve(m_Textures.size());
+        for (const std::shared_ptr<StreamedTextureState> &state : m_Textures)
+        {
+            TextureInfo info;
+            info.path = state->path;
+            info.width = state->width;
+            info.height = state->height;
+            info.mipCount = state->mipCount;
+            info.residentMip = state->residentMip;
+            info.desiredMip = state->desiredMip;
+            info.bytes = state->texture ? state->texture->getByteSize() : 0;
+            info.loading = state->loading;
+            infos.push_back(std::move(info));
+        }
+        return infos;
+    }
+
+} // namespace Base
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Texture.hpp"
+#include "ThreadPool.hpp"
+
+namespace Base
+{
+    struct StreamedTextureState;
+
+    // Shared reference to a texture managed by TextureStreamer. Cheap to copy; the streamer drops
+    // the texture once no handle is left.
+    class StreamedTexture
+    {
+    public:
+        StreamedTexture() = default;
+
+        bool isValid() const { return m_State != nullptr; }
+
+        // Reports how many screen pixels the texture's width covers where it is drawn this frame
+        // (see TextureStreamer::screenFootprint). The largest report per frame picks the mip level
+        // the streamer aims for; textures nobody reports about are the first to be evicted.
+        void requestFootprint(float screenPixels) const;
+
+        // Binds the resident mip levels, or the loader's placeholder before the first ones arrived.
+        void bind(GLuint textureUnit = 0) const;
+        // The current GPU texture; replaced whenever the residency changes, so do not keep it
+        // across frames. nullptr until the first levels are resident.
+        const Texture *get() const;
+        const std::string &getPath() const;
+
+        int getResidentMip() const;
+        int getDesiredMip() const;
+
+    private:
+        friend class TextureStreamer;
+        explicit StreamedTexture(std::shared_ptr<StreamedTextureState> state) : m_State(std::move(state)) {}
+
+        std::shared_ptr<StreamedTextureState> m_State;
+    };
+
+    // Keeps large textures partially resident under a VRAM budget. Each texture starts with only
+    // its mip tail (levels up to getTailSize() texels across, kept in RAM as well). Every frame the
+    // finest level worth sampling is estimated from the reported screen footprints; finer levels
+    // are read from disk on worker threads and swapped in as a new texture holding
+    // [resident mip .. last level]. When the budget runs out, the least recently used textures
+    // fall back to their tail. GL has no portable sparse textures, hence the reallocation.
+    //
+    // Best fed with baked .ktx2 files, which carry the whole chain; plain images are decoded and
+    // mipmapped on the worker instead.
+    class TextureStreamer
+    {
+    public:
+        struct Stats
+        {
+            size_t textures = 0;
+            size_t residentBytes = 0;
+            size_t pendingLoads = 0;
+            size_t streamedIn = 0;   // Loads that made textures finer
+            size_t evictions = 0;    // Textures dropped back to their tail to stay within budget
+            size_t overBudget = 0;   // Frames where even evicting could not make room
+            size_t uploadedLastFrame = 0;
+        };
+
+        static TextureStreamer &Get();
+
+        TextureStreamer() = default;
+        ~TextureStreamer();
+
+        TextureStreamer(const TextureStreamer &) = delete;
+        TextureStreamer &operator=(const TextureStreamer &) = delete;
+
+        // Loads run on `workers`, shared with the rest of the application.
+        void initialize(ThreadPool &workers);
+        void shutdown();
+
+        StreamedTexture load(const std::string &path, const TextureSettings &settings = {});
+
+        // Called once per frame on the GL thread: retargets residency, starts and finishes loads.
+        void update();
+
+        // Pixels across the screen that `worldSize` world units at `center` span, for
+        // StreamedTexture::requestFootprint.
+        static float screenFootprint(const glm::mat4 &view, const glm::mat4 &projection, const glm::vec3 &center,
+                                     float worldSize, float viewportHeight);
+
+        void setBudget(size_t bytes) { m_Budget = bytes; }
+        size_t getBudget() const { return m_Budget; }
+        // > 0 streams in finer levels early (sharper, more memory), < 0 later.
+        void setMipBias(float bias) { m_MipBias = bias; }
+        float getMipBias() const { return m_MipBias; }
+        void setUploadBudget(size_t bytesPerFrame) { m_UploadBudget = bytesPerFrame; }
+        size_t getUploadBudget() const { return m_UploadBudget; }
+        int getTailSize() const { return kTailSize; }
+
+        // Residency of one texture, for the Debug Info panel.
+        struct TextureInfo
+        {
+            std::string path;
+            int width = 0;
+            int height = 0;
+            int mipCount = 0;
+            int residentMip = 0;
+            int desiredMip = 0;
+            size_t bytes = 0;
+            bool loading = false;
+        };
+
+        const Stats &getStats() const { return m_Stats; }
+        std::vector<TextureInfo> getTextureInfo() const;
+
+    private:
+        friend class StreamedTexture;
+
+        static constexpr int kTailSize = 64;
+        // Frames without a footprint report before a texture only wants its tail.
+        static constexpr uint64_t kIdleFrames = 60;
+        // Frames before levels whose load failed are tried again; doubles with each failure in a row.
+        static constexpr uint64_t kRetryFrames = 120;
+
+        int desiredMip(const StreamedTextureState &state) const;
+        // Starts a worker reading levels [firstMip ..]; -1 for the initial load of the tail.
+        void requestLevels(const std::shared_ptr<StreamedTextureState> &state, int firstMip, size_t reservedBytes);
+        size_t projectedBytes(const StreamedTextureState &state, int firstMip) const;
+        // Evicts textures that were not drawn last frame, least recently used first.
+        bool makeRoom(size_t bytes, const StreamedTextureState &keep);
+        void evictToTail(StreamedTextureState &state);
+        bool swapIn(StreamedTextureState &state, const ContainerImage &image, int firstMip);
+        void finishLoad(StreamedTextureState &state);
+
+        TaskGroup m_Workers;
+        std::vector<std::shared_ptr<StreamedTextureState>> m_Textures;
+
+        std::mutex m_LoadedMutex;
+        std::vector<std::shared_ptr<StreamedTextureState>> m_Loaded; // Filled by workers
+        std::vector<std::shared_ptr<StreamedTextureState>> m_Uploads; // GL thread only
+        std::atomic<size_t> m_Pending = 0;
+
+        size_t m_Budget = 256 * 1024 * 1024;
+        size_t m_UploadBudget = 8 * 1024 * 1024;
+        float m_MipBias = 0.0f;
+        uint64_t m_Frame = 0;
+        size_t m_ResidentBytes = 0;
+        size_t m_ReservedBytes = 0; // Expected growth of the loads in flight
+        Stats m_Stats;
+        bool m_Initialized = false;
+    };
+
+} // namespace Base
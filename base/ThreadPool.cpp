@@ -7,13 +7,9 @@
 namespace Base
 {
 #ifndef PLATFORM_EMSCRIPTEN
-    ThreadPool::ThreadPool(size_t numThreads)
+    ThreadPool::ThreadPool(size_t numThreads) : m_NumThreads(numThreads == 0 ? 1 : numThreads)
     {
-        if (numThreads == 0)
-        {
-            numThreads = 1;
-        }
-        LOG_INFO("ThreadPool Constructor with {} threads.", numThreads);
+        LOG_INFO("ThreadPool Constructor with {} threads.", m_NumThreads);
     }
 
     ThreadPool::~ThreadPool()
@@ -32,12 +28,7 @@ namespace Base
 
         LOG_INFO("Starting ThreadPool...");
         m_Stop = false;
-        size_t numThreads = m_Workers.capacity();
-        if (numThreads == 0)
-            numThreads = std::thread::hardware_concurrency();
-        if (numThreads == 0)
-            numThreads = 1;
-
+        const size_t numThreads = m_NumThreads;
         m_Workers.reserve(numThreads);
         for (size_t i = 0; i < numThreads; ++i)
         {
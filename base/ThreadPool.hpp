@@ -29,6 +29,7 @@ namespace Base
         void WorkerThread(size_t workerId);
 
         std::vector<std::thread> m_Workers;
+        size_t m_NumThreads = 1;
         std::queue<std::function<void()>> m_Tasks;
 
         std::mutex m_QueueMutex;
@@ -113,4 +114,87 @@ namespace Base
     };
 
 #endif
+
+    // The tasks one subsystem queues on a pool it shares with others. close() waits for just
+    // those, which is what stopping a pool of its own used to do on shutdown.
+    class TaskGroup
+    {
+    public:
+        TaskGroup() = default;
+        ~TaskGroup() { close(); }
+
+        TaskGroup(const TaskGroup &) = delete;
+        TaskGroup &operator=(const TaskGroup &) = delete;
+
+        void open(ThreadPool &pool)
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Pool = &pool;
+        }
+
+        // Throws like a stopped ThreadPool once closed.
+        template <class F, class... Args>
+        auto Enqueue(F &&f, Args &&...args)
+            -> std::future<typename std::invoke_result<F, Args...>::type>
+        {
+            ThreadPool *pool = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                if (!m_Pool)
+                {
+                    throw std::runtime_error("Enqueue on closed TaskGroup");
+                }
+                pool = m_Pool;
+                m_Pending++;
+            }
+            try
+            {
+                return pool->Enqueue([this, task = std::bind(std::forward<F>(f), std::forward<Args>(args)...)]() mutable
+                                     {
+                    FinishGuard guard{this};
+                    return task(); });
+            }
+            catch (...)
+            {
+                finishTask();
+                throw;
+            }
+        }
+
+        // Refuses new tasks and waits for the queued and running ones.
+        void close()
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Pool = nullptr;
+            m_Idle.wait(lock, [this]()
+                        { return m_Pending == 0; });
+        }
+
+        bool isOpen() const
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            return m_Pool != nullptr;
+        }
+
+    private:
+        struct FinishGuard
+        {
+            TaskGroup *group;
+            ~FinishGuard() { group->finishTask(); }
+        };
+
+        void finishTask()
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (--m_Pending == 0)
+            {
+                m_Idle.notify_all();
+            }
+        }
+
+        mutable std::mutex m_Mutex;
+        std::condition_variable m_Idle;
+        ThreadPool *m_Pool = nullptr;
+        size_t m_Pending = 0;
+    };
 }
\ No newline at end of file
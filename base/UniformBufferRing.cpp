@@ -0,0 +1,224 @@
+#include "UniformBufferRing.hpp"
+#include "Log.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Base
+{
+    namespace
+    {
+        size_t alignUp(size_t value, size_t alignment)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+    }
+
+    UniformBufferRing::~UniformBufferRing()
+    {
+        shutdown();
+    }
+
+    bool UniformBufferRing::init(size_t bytesPerFrame, uint32_t framesInFlight)
+    {
+        shutdown();
+
+        GLint alignment = 0;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        m_Alignment = alignment > 0 ? static_cast<size_t>(alignment) : 256;
+        m_FramesInFlight = std::max(1u, framesInFlight);
+        m_RegionSize = alignUp(bytesPerFrame, m_Alignment);
+        const size_t totalSize = m_RegionSize * m_FramesInFlight;
+
+        glGenBuffers(1, &m_BufferID);
+        glBindBuffer(GL_UNIFORM_BUFFER, m_BufferID);
+
+#if PLATFORM_DESKTOP
+        if (GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage)
+        {
+            const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glBufferStorage(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(totalSize), nullptr, flags);
+            m_Mapped = static_cast<uint8_t *>(glMapBufferRange(GL_UNIFORM_BUFFER, 0, static_cast<GLsizeiptr>(totalSize), flags));
+            if (!m_Mapped)
+            {
+                LOG_WARN("UniformBufferRing: persistent mapping failed, falling back to unsynchronized mapping.");
+                glDeleteBuffers(1, &m_BufferID);
+                glGenBuffers(1, &m_BufferID);
+                glBindBuffer(GL_UNIFORM_BUFFER, m_BufferID);
+            }
+        }
+#endif
+        if (!m_Mapped)
+        {
+            glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(totalSize), nullptr, GL_DYNAMIC_DRAW);
+        }
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+        m_Fences.assign(m_FramesInFlight, nullptr);
+        m_CurrentFrame = 0;
+        m_Cursor = 0;
+        m_AllocationCount = 0;
+        m_OverflowReported = false;
+        m_Stats = {};
+        m_Stats.bytesPerFrame = m_RegionSize;
+        m_Stats.persistentMapped = m_Mapped != nullptr;
+
+        LOG_INFO("UniformBufferRing: {} frames x {} bytes, alignment {}, {}.",
+                 m_FramesInFlight, m_RegionSize, m_Alignment, m_Mapped ? "persistent mapped" : "unsynchronized mapped");
+        return true;
+    }
+
+    void UniformBufferRing::shutdown()
+    {
+        if (m_BufferID == 0)
+        {
+            return;
+        }
+
+        for (GLsync &fence : m_Fences)
+        {
+            if (fence)
+            {
+                glDeleteSync(fence);
+                fence = nullptr;
+            }
+        }
+        m_Fences.clear();
+
+        if (m_Mapped)
+        {
+            glBindBuffer(GL_UNIFORM_BUFFER, m_BufferID);
+            glUnmapBuffer(GL_UNIFORM_BUFFER);
+            glBindBuffer(GL_UNIFORM_BUFFER, 0);
+            m_Mapped = nullptr;
+        }
+        glDeleteBuffers(1, &m_BufferID);
+        m_BufferID = 0;
+    }
+
+    void UniformBufferRing::beginFrame()
+    {
+        if (m_BufferID == 0)
+        {
+            return;
+        }
+
+        waitForRegion(m_CurrentFrame);
+        m_Cursor = 0;
+        m_AllocationCount = 0;
+    }
+
+    void UniformBufferRing::endFrame()
+    {
+        if (m_BufferID == 0)
+        {
+            return;
+        }
+
+        m_Stats.usedLastFrame = m_Cursor;
+        m_Stats.allocationsLastFrame = m_AllocationCount;
+        m_Stats.peakUsage = std::max(m_Stats.peakUsage, m_Cursor);
+
+#if !PLATFORM_EMSCRIPTEN
+        // WebGL only allows zero-timeout client waits, and its buffer uploads are copies anyway.
+        m_Fences[m_CurrentFrame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+#endif
+        m_CurrentFrame = (m_CurrentFrame + 1) % m_FramesInFlight;
+    }
+
+    void UniformBufferRing::waitForRegion(uint32_t frame)
+    {
+        GLsync &fence = m_Fences[frame];
+        if (!fence)
+        {
+            return;
+        }
+
+        GLbitfield waitFlags = 0;
+        GLuint64 timeout = 0;
+        for (;;)
+        {
+            GLenum result = glClientWaitSync(fence, waitFlags, timeout);
+            if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED)
+            {
+                break;
+            }
+            if (result == GL_WAIT_FAILED)
+            {
+                LOG_ERROR("UniformBufferRing: glClientWaitSync failed.");
+                break;
+            }
+            // Not done yet; make sure the fence is flushed and block for up to 1 ms per attempt.
+            waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+            timeout = 1000000;
+        }
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    UniformBufferRing::Allocation UniformBufferRing::upload(const void *data, size_t size)
+    {
+        if (m_BufferID == 0 || size == 0)
+        {
+            return {};
+        }
+
+        const size_t alignedSize = alignUp(size, m_Alignment);
+        if (m_Cursor + alignedSize > m_RegionSize)
+        {
+            if (!m_OverflowReported)
+            {
+                LOG_ERROR("UniformBufferRing: frame region exhausted ({} bytes). Increase bytesPerFrame.", m_RegionSize);
+                m_OverflowReported = true;
+            }
+            return {};
+        }
+
+        Allocation alloc;
+        alloc.buffer = m_BufferID;
+        alloc.offset = static_cast<GLintptr>(m_CurrentFrame * m_RegionSize + m_Cursor);
+        alloc.size = static_cast<GLsizeiptr>(size);
+        m_Cursor += alignedSize;
+
+        if (m_Mapped)
+        {
+            std::memcpy(m_Mapped + alloc.offset, data, size);
+        }
+        else
+        {
+            glBindBuffer(GL_UNIFORM_BUFFER, m_BufferID);
+#if PLATFORM_EMSCRIPTEN
+            glBufferSubData(GL_UNIFORM_BUFFER, alloc.offset, alloc.size, data);
+#else
+            // The fence in beginFrame() guarantees the GPU is done with this range, so skip the driver's sync.
+            void *dst = glMapBufferRange(GL_UNIFORM_BUFFER, alloc.offset, alloc.size,
+                                         GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+            if (dst)
+            {
+                std::memcpy(dst, data, size);
+                glUnmapBuffer(GL_UNIFORM_BUFFER);
+            }
+            else
+            {
+                glBufferSubData(GL_UNIFORM_BUFFER, alloc.offset, alloc.size, data);
+            }
+#endif
+            glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        }
+
+        m_AllocationCount++;
+        return alloc;
+    }
+
+    bool UniformBufferRing::bindBlock(GLuint binding, const void *data, size_t size)
+    {
+        Allocation alloc = upload(data, size);
+        if (alloc.buffer == 0)
+        {
+            return false;
+        }
+        glBindBufferRange(GL_UNIFORM_BUFFER, binding, alloc.buffer, alloc.offset, alloc.size);
+        return true;
+    }
+
+} // namespace Base
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if PLATFORM_DESKTOP
+#include <glad/gl.h>
+#elif PLATFORM_ANDROID || PLATFORM_IOS || PLATFORM_EMSCRIPTEN
+#include <glad/gles2.h>
+#endif
+
+namespace Base
+{
+    // One GL_UNIFORM_BUFFER split into a region per frame in flight. Each frame hands out
+    // aligned sub-allocations from its region and binds them with glBindBufferRange; a fence
+    // guards the region so it is only rewritten once the GPU has finished reading it.
+    class UniformBufferRing
+    {
+    public:
+        struct Allocation
+        {
+            GLuint buffer = 0;
+            GLintptr offset = 0;
+            GLsizeiptr size = 0;
+        };
+
+        struct Stats
+        {
+            size_t bytesPerFrame = 0;
+            size_t usedLastFrame = 0;
+            size_t peakUsage = 0;
+            uint32_t allocationsLastFrame = 0;
+            bool persistentMapped = false;
+        };
+
+        UniformBufferRing() = default;
+        ~UniformBufferRing();
+
+        UniformBufferRing(const UniformBufferRing &) = delete;
+        UniformBufferRing &operator=(const UniformBufferRing &) = delete;
+
+        bool init(size_t bytesPerFrame = 64 * 1024, uint32_t framesInFlight = 3);
+        void shutdown();
+
+        // Waits (if needed) for the GPU to release this frame's region and resets its cursor.
+        void beginFrame();
+        // Fences the region written this frame.
+        void endFrame();
+
+        // Copies 'size' bytes into the current frame's region. Returns an empty allocation if the region is full.
+        Allocation upload(const void *data, size_t size);
+
+        // Uploads and binds the data to a uniform block binding point.
+        bool bindBlock(GLuint binding, const void *data, size_t size);
+
+        template <typename T>
+        bool bindBlock(GLuint binding, const T &data)
+        {
+            return bindBlock(binding, &data, sizeof(T));
+        }
+
+        bool isInitialized() const { return m_BufferID != 0; }
+        const Stats &getStats() const { return m_Stats; }
+
+    private:
+        void waitForRegion(uint32_t frame);
+
+        GLuint m_BufferID = 0;
+        uint8_t *m_Mapped = nullptr; // non-null when the buffer is persistently mapped
+        size_t m_RegionSize = 0;
+        size_t m_Alignment = 256;
+        uint32_t m_FramesInFlight = 0;
+        uint32_t m_CurrentFrame = 0;
+        size_t m_Cursor = 0;
+        uint32_t m_AllocationCount = 0;
+        bool m_OverflowReported = false;
+        std::vector<GLsync> m_Fences;
+        Stats m_Stats;
+    };
+
+} // namespace Base
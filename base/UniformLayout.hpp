@@ -0,0 +1,200 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <glm/glm.hpp>
+#if PLATFORM_DESKTOP
+    #include <glad/gl.h>
+#elif PLATFORM_ANDROID
+    #include <glad/egl.h>
+    #include <glad/gles2.h>
+#elif PLATFORM_EMSCRIPTEN || PLATFORM_IOS
+    #include <glad/gles2.h>
+#endif
+
+// Compile-time description of C++ structs that are copied byte-for-byte into uniform/storage
+// blocks. Each described member is checked against the offset the std140/std430 rules give it,
+// so a layout mismatch is a build error instead of garbage on screen:
+//
+//     struct CameraMatrices { glm::mat4 view; glm::mat4 projection; };
+//     BASE_UNIFORM_BLOCK(CameraMatrices, Base::BlockLayout::Std140,
+//                        BASE_BLOCK_FIELD(CameraMatrices, view),
+//                        BASE_BLOCK_FIELD(CameraMatrices, projection));
+//
+// Shader::registerBlockLayout<CameraMatrices>("CameraUBO") then has every program linked afterwards
+// compare the same description with the offsets the driver reported for it; a program's
+// checkBlockLayout("CameraUBO") runs that comparison on demand.
+
+namespace Base {
+
+enum class BlockLayout : uint8_t
+{
+    Std140,
+    Std430
+};
+
+// GLSL-side properties of a C++ member type. Only types whose C++ size matches the GLSL size are
+// described; glm::mat3 (36 bytes vs. 48) and bool (1 byte vs. 4) are deliberately missing, use
+// glm::mat3x4 / uint32_t instead.
+template <typename T>
+struct GlslType;
+
+template <GLenum Type, size_t Size, size_t Align, size_t Columns = 1>
+struct GlslTypeInfo
+{
+    static constexpr GLenum glType = Type;
+    static constexpr size_t size = Size;       // Bytes occupied by one element
+    static constexpr size_t alignment = Align; // Base alignment under std430 (std140 rounds arrays/matrices up to 16)
+    static constexpr size_t columns = Columns; // Matrices are laid out as arrays of column vectors
+    static constexpr size_t arrayLength = 0;
+};
+
+template <> struct GlslType<float> : GlslTypeInfo<GL_FLOAT, 4, 4> {};
+template <> struct GlslType<int32_t> : GlslTypeInfo<GL_INT, 4, 4> {};
+template <> struct GlslType<uint32_t> : GlslTypeInfo<GL_UNSIGNED_INT, 4, 4> {};
+template <> struct GlslType<glm::vec2> : GlslTypeInfo<GL_FLOAT_VEC2, 8, 8> {};
+template <> struct GlslType<glm::vec3> : GlslTypeInfo<GL_FLOAT_VEC3, 12, 16> {};
+template <> struct GlslType<glm::vec4> : GlslTypeInfo<GL_FLOAT_VEC4, 16, 16> {};
+template <> struct GlslType<glm::ivec2> : GlslTypeInfo<GL_INT_VEC2, 8, 8> {};
+template <> struct GlslType<glm::ivec3> : GlslTypeInfo<GL_INT_VEC3, 12, 16> {};
+template <> struct GlslType<glm::ivec4> : GlslTypeInfo<GL_INT_VEC4, 16, 16> {};
+template <> struct GlslType<glm::uvec2> : GlslTypeInfo<GL_UNSIGNED_INT_VEC2, 8, 8> {};
+template <> struct GlslType<glm::uvec3> : GlslTypeInfo<GL_UNSIGNED_INT_VEC3, 12, 16> {};
+template <> struct GlslType<glm::uvec4> : GlslTypeInfo<GL_UNSIGNED_INT_VEC4, 16, 16> {};
+template <> struct GlslType<glm::mat2> : GlslTypeInfo<GL_FLOAT_MAT2, 16, 8, 2> {};
+template <> struct GlslType<glm::mat3x4> : GlslTypeInfo<GL_FLOAT_MAT3x4, 48, 16, 3> {};
+template <> struct GlslType<glm::mat4> : GlslTypeInfo<GL_FLOAT_MAT4, 64, 16, 4> {};
+
+template <typename T, size_t N>
+struct GlslType<T[N]> : GlslType<T>
+{
+    static constexpr size_t arrayLength = N;
+};
+
+namespace Detail {
+
+constexpr size_t alignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// std140 rounds the alignment of arrays and matrix columns up to a vec4; std430 does not.
+template <typename Info>
+constexpr size_t baseAlignment(BlockLayout layout, bool isArray)
+{
+    if (layout == BlockLayout::Std140 && (isArray || Info::columns > 1))
+    {
+        return alignUp(Info::alignment, 16);
+    }
+    return Info::alignment;
+}
+
+template <typename Info>
+constexpr size_t elementSize(BlockLayout layout)
+{
+    if (Info::columns > 1)
+    {
+        const size_t columnSize = Info::size / Info::columns;
+        const size_t columnStride = layout == BlockLayout::Std140 ? alignUp(columnSize, 16) : alignUp(columnSize, Info::alignment);
+        return columnStride * Info::columns;
+    }
+    return Info::size;
+}
+
+} // namespace Detail
+
+// One described member: its GLSL name (as reflected, e.g. "light.position") and its C++ placement.
+struct BlockField
+{
+    std::string_view name;
+    GLenum glType = 0;
+    size_t cppOffset = 0;
+    size_t cppSize = 0;
+    size_t offset = 0;      // Offset required by the layout rules
+    size_t size = 0;        // Bytes the member occupies in the block
+    size_t arrayStride = 0; // 0 for non-arrays
+};
+
+template <typename Member>
+struct BlockFieldDesc
+{
+    using Type = Member;
+    std::string_view name;
+    size_t cppOffset;
+};
+
+template <size_t N>
+struct BlockDescription
+{
+    BlockLayout layout = BlockLayout::Std140;
+    std::array<BlockField, N> fields{};
+    size_t dataSize = 0; // Minimum block size implied by the members
+
+    constexpr bool matchesCpp() const
+    {
+        for (const BlockField &field : fields)
+        {
+            if (field.cppOffset != field.offset || field.cppSize != field.size)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+template <typename... Members>
+constexpr auto describeBlock(BlockLayout layout, BlockFieldDesc<Members>... members)
+{
+    BlockDescription<sizeof...(Members)> description;
+    description.layout = layout;
+
+    size_t cursor = 0;
+    size_t index = 0;
+    auto place = [&](auto member) {
+        using Type = typename decltype(member)::Type;
+        using Info = GlslType<Type>;
+        const bool isArray = Info::arrayLength > 0;
+        const size_t align = Detail::baseAlignment<Info>(layout, isArray);
+        const size_t element = Detail::elementSize<Info>(layout);
+
+        BlockField &field = description.fields[index++];
+        field.name = member.name;
+        field.glType = Info::glType;
+        field.cppOffset = member.cppOffset;
+        field.cppSize = sizeof(Type);
+        field.offset = Detail::alignUp(cursor, align);
+        field.arrayStride = isArray ? Detail::alignUp(element, align) : 0;
+        field.size = isArray ? field.arrayStride * Info::arrayLength : element;
+        cursor = field.offset + field.size;
+    };
+    (place(members), ...);
+
+    description.dataSize = layout == BlockLayout::Std140 ? Detail::alignUp(cursor, 16) : cursor;
+    return description;
+}
+
+// Specialized through BASE_UNIFORM_BLOCK for every struct that is uploaded into a block.
+template <typename T>
+struct UniformBlockTraits;
+
+} // namespace Base
+
+#define BASE_BLOCK_FIELD(Struct, member) \
+    Base::BlockFieldDesc<decltype(Struct::member)>{#member, offsetof(Struct, member)}
+
+#define BASE_BLOCK_FIELD_AS(Struct, member, glslName) \
+    Base::BlockFieldDesc<decltype(Struct::member)>{glslName, offsetof(Struct, member)}
+
+#define BASE_UNIFORM_BLOCK(Struct, layoutRule, ...)                                                          \
+    template <>                                                                                              \
+    struct Base::UniformBlockTraits<Struct>                                                                  \
+    {                                                                                                        \
+        static constexpr auto description = Base::describeBlock(layoutRule, __VA_ARGS__);                    \
+    };                                                                                                       \
+    static_assert(Base::UniformBlockTraits<Struct>::description.matchesCpp(),                                \
+                  #Struct " does not match its " #layoutRule " layout (check member offsets and padding)"); \
+    static_assert(sizeof(Struct) >= Base::UniformBlockTraits<Struct>::description.dataSize,                  \
+                  #Struct " is smaller than its " #layoutRule " block size")
@@ -0,0 +1,628 @@
+#include "Vfs.hpp"
+#include "IoUring.hpp"
+#include "Log.hpp"
+#include "PathUtils.hpp"
+#include "ThreadPool.hpp"
+
+#include <SDL3/SDL.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+#if PLATFORM_LINUX
+    #include <fcntl.h>
+    #include <sys/eventfd.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #define VFS_IO_URING 1
+#endif
+
+namespace Base
+{
+    namespace
+    {
+        struct Mount
+        {
+            std::string mountPoint;
+            std::string directory;              // Native, empty or ending in a separator
+            std::shared_ptr<const PakFile> pak; // Set for archives
+            std::string source;
+        };
+
+        using MountTable = std::vector<Mount>;
+
+        std::mutex s_MountMutex;
+        std::shared_ptr<const MountTable> s_Mounts; // Replaced, never modified, so readers need no lock
+
+        std::atomic<size_t> s_AsyncReads = 0;
+        std::atomic<size_t> s_AsyncBytes = 0;
+        std::atomic<size_t> s_InFlight = 0;
+        std::atomic<ThreadPool *> s_ThreadPool = nullptr;
+
+        Mount assetDirectoryMount()
+        {
+            Mount mount;
+            mount.directory = Vfs::getAssetDirectory();
+            mount.source = mount.directory;
+            return mount;
+        }
+
+        std::shared_ptr<const MountTable> mountTable()
+        {
+            std::lock_guard<std::mutex> lock(s_MountMutex);
+            if (!s_Mounts)
+            {
+                s_Mounts = std::make_shared<const MountTable>(MountTable{assetDirectoryMount()});
+            }
+            return s_Mounts;
+        }
+
+        void addMount(Mount mount)
+        {
+            std::lock_guard<std::mutex> lock(s_MountMutex);
+            MountTable mounts = s_Mounts ? *s_Mounts : MountTable{assetDirectoryMount()};
+            mounts.push_back(std::move(mount));
+            s_Mounts = std::make_shared<const MountTable>(std::move(mounts));
+        }
+
+        std::string normalizeMountPoint(const std::string &mountPoint)
+        {
+            std::string normalized = Vfs::normalizePath(mountPoint);
+            if (!normalized.empty() && normalized.back() != '/')
+            {
+                normalized += '/';
+            }
+            return normalized;
+        }
+
+        // Calls visit(mount, path relative to the mount) for every mount that can hold the
+        // normalized `path`, most recent first, until it returns true.
+        template <typename Visit>
+        bool forEachMount(const std::string &path, Visit &&visit)
+        {
+            const std::shared_ptr<const MountTable> mounts = mountTable();
+            for (auto it = mounts->rbegin(); it != mounts->rend(); ++it)
+            {
+                if (path.compare(0, it->mountPoint.size(), it->mountPoint) == 0 &&
+                    visit(*it, std::string_view(path).substr(it->mountPoint.size())))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool openFromMount(const Mount &mount, std::string_view relativePath, AssetFile &file);
+
+        // One readAsync in progress.
+        struct ReadRequest
+        {
+            std::string path;
+            Vfs::ReadCallback callback;
+            std::vector<uint8_t> contents;
+            size_t bytesRead = 0;
+            int fd = -1;
+        };
+
+        // Services readAsync: one IO thread driving an io_uring where there is one, a pool of IO
+        // threads doing blocking opens otherwise, or once the ring has failed.
+        class AsyncReader
+        {
+        public:
+            static constexpr size_t kPoolThreads = 4;
+            // Bytes per read request; bigger files take several.
+            static constexpr size_t kMaxReadSize = 16 * 1024 * 1024;
+
+            AsyncReader()
+            {
+#if VFS_IO_URING
+                m_WakeFd = eventfd(0, EFD_CLOEXEC);
+                if (m_WakeFd >= 0 && m_Ring.initialize())
+                {
+                    m_Thread = std::thread(&AsyncReader::ringLoop, this);
+                    return;
+                }
+                m_Ring.shutdown();
+                if (m_WakeFd >= 0)
+                {
+                    close(m_WakeFd);
+                    m_WakeFd = -1;
+                }
+                LOG_INFO("Vfs: io_uring is not available, reading on a thread pool.");
+#endif
+                startPool();
+            }
+
+            ~AsyncReader()
+            {
+#if VFS_IO_URING
+                if (m_Thread.joinable())
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(m_Mutex);
+                        m_Stop = true;
+                    }
+                    wake();
+                    m_Thread.join();
+                    close(m_WakeFd);
+                }
+#endif
+                // Lets the queued reads finish.
+                m_PoolTasks.close();
+                if (m_OwnPool)
+                {
+                    m_OwnPool->Stop();
+                }
+            }
+
+            bool usesRing() const { return !m_PoolTasks.isOpen(); }
+
+            void read(std::unique_ptr<ReadRequest> request)
+            {
+                s_InFlight++;
+#if VFS_IO_URING
+                {
+                    // The pool is only ever started once, by the constructor or by the IO thread giving up the ring.
+                    std::lock_guard<std::mutex> lock(m_Mutex);
+                    if (!m_PoolTasks.isOpen())
+                    {
+                        m_Submitted.push_back(std::move(request));
+                        wake();
+                        return;
+                    }
+                }
+#endif
+                readOnPool(std::move(request));
+            }
+
+        private:
+            static void complete(ReadRequest &request, AssetFile &&file)
+            {
+                s_AsyncReads++;
+                s_AsyncBytes += file.size();
+                request.callback(std::move(file));
+                s_InFlight--;
+            }
+
+            void startPool()
+            {
+                ThreadPool *pool = s_ThreadPool;
+                if (!pool)
+                {
+                    m_OwnPool = std::make_unique<ThreadPool>(kPoolThreads);
+                    m_OwnPool->Start();
+                    pool = m_OwnPool.get();
+                }
+                m_PoolTasks.open(*pool);
+            }
+
+            void readOnPool(std::unique_ptr<ReadRequest> request)
+            {
+                std::shared_ptr<ReadRequest> shared(std::move(request));
+                m_PoolTasks.Enqueue([shared]()
+                                    {
+                    AssetFile file;
+                    Vfs::open(shared->path, file);
+                    complete(*shared, std::move(file)); });
+            }
+
+#if VFS_IO_URING
+            // User data of the read that waits on m_WakeFd; reads use their request's address.
+            static constexpr uint64_t kWakeTag = 0;
+
+            void wake()
+            {
+                const uint64_t one = 1;
+                (void)::write(m_WakeFd, &one, sizeof(one));
+            }
+
+            void ringLoop()
+            {
+                // An eventfd read is always pending, so a new request or stop() ends the wait.
+                bool wakeArmed = m_Ring.prepareRead(m_WakeFd, &m_WakeValue, sizeof(m_WakeValue), 0, kWakeTag);
+                for (;;)
+                {
+                    IoUring::Completion completion;
+                    while (m_Ring.popCompletion(completion))
+                    {
+                        if (completion.userData == kWakeTag)
+                        {
+                            if (completion.result < 0 && completion.result != -EINTR && completion.result != -EAGAIN)
+                            {
+                                // Re-arming would fail the same way at once and spin.
+                                LOG_ERROR("Vfs: io_uring cannot read the wake eventfd: {}", strerror(-completion.result));
+                                fallBackToPool();
+                                return;
+                            }
+                            wakeArmed = false;
+                            continue;
+                        }
+                        auto *request = reinterpret_cast<ReadRequest *>(completion.userData);
+                        m_InFlight.erase(request);
+                        onRead(std::unique_ptr<ReadRequest>(request), completion.result);
+                    }
+
+                    std::vector<std::unique_ptr<ReadRequest>> submitted;
+                    bool stop = false;
+                    {
+                        std::lock_guard<std::mutex> lock(m_Mutex);
+                        submitted.swap(m_Submitted);
+                        stop = m_Stop;
+                    }
+                    for (std::unique_ptr<ReadRequest> &request : submitted)
+                    {
+                        start(std::move(request));
+                    }
+
+                    // Reads that did not fit into the submission ring last time.
+                    while (!m_Waiting.empty() && queueRead(m_Waiting.front()))
+                    {
+                        m_Waiting.pop_front();
+                    }
+                    if (!wakeArmed)
+                    {
+                        wakeArmed = m_Ring.prepareRead(m_WakeFd, &m_WakeValue, sizeof(m_WakeValue), 0, kWakeTag);
+                    }
+
+                    if (stop && m_InFlight.empty() && m_Waiting.empty())
+                    {
+                        break;
+                    }
+                    if (!m_Ring.submit(1))
+                    {
+                        LOG_ERROR("Vfs: io_uring_enter failed: {}", strerror(errno));
+                        fallBackToPool();
+                        return;
+                    }
+                }
+                m_Ring.shutdown();
+            }
+
+            // Gives up the ring: every outstanding read completes without a file, and new ones go
+            // to a thread pool, so nothing waiting on a callback hangs.
+            void fallBackToPool()
+            {
+                LOG_WARN("Vfs: {} reads abandoned, reading on a thread pool from now on.", m_InFlight.size() + m_Waiting.size());
+                // The kernel may still write into the buffers of reads it was handed, so those
+                // requests are completed but never freed.
+                for (ReadRequest *request : m_InFlight)
+                {
+                    ::close(request->fd);
+                    complete(*request, AssetFile());
+                }
+                m_InFlight.clear();
+                for (ReadRequest *request : m_Waiting)
+                {
+                    finish(std::unique_ptr<ReadRequest>(request), false);
+                }
+                m_Waiting.clear();
+                m_Ring.shutdown();
+
+                std::vector<std::unique_ptr<ReadRequest>> submitted;
+                {
+                    std::lock_guard<std::mutex> lock(m_Mutex);
+                    startPool();
+                    submitted.swap(m_Submitted);
+                }
+                for (std::unique_ptr<ReadRequest> &request : submitted)
+                {
+                    readOnPool(std::move(request));
+                }
+            }
+
+            // Finds the file. Archive entries complete here; loose files get their first read queued.
+            void start(std::unique_ptr<ReadRequest> request)
+            {
+                const std::string path = Vfs::normalizePath(request->path);
+                AssetFile file;
+                int fd = -1;
+                size_t size = 0;
+                forEachMount(path, [&](const Mount &mount, std::string_view relativePath)
+                             {
+                    if (mount.pak)
+                    {
+                        return openFromMount(mount, relativePath, file);
+                    }
+                    const std::string nativePath = mount.directory + std::string(relativePath);
+                    fd = ::open(nativePath.c_str(), O_RDONLY | O_CLOEXEC);
+                    if (fd < 0)
+                    {
+                        return false;
+                    }
+                    struct stat info = {};
+                    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode))
+                    {
+                        ::close(fd);
+                        fd = -1;
+                        return false;
+                    }
+                    size = static_cast<size_t>(info.st_size);
+                    return true; });
+
+                if (fd < 0 || size == 0)
+                {
+                    if (fd >= 0)
+                    {
+                        ::close(fd);
+                        file.assign(std::vector<uint8_t>());
+                    }
+                    complete(*request, std::move(file));
+                    return;
+                }
+                request->fd = fd;
+                request->contents.resize(size);
+                ReadRequest *raw = request.release();
+                if (!queueRead(raw))
+                {
+                    m_Waiting.push_back(raw);
+                }
+            }
+
+            bool queueRead(ReadRequest *request)
+            {
+                const size_t remaining = request->contents.size() - request->bytesRead;
+                const uint32_t size = static_cast<uint32_t>(std::min(remaining, kMaxReadSize));
+                if (!m_Ring.prepareRead(request->fd, request->contents.data() + request->bytesRead, size, request->bytesRead,
+                                        reinterpret_cast<uint64_t>(request)))
+                {
+                    return false;
+                }
+                m_InFlight.insert(request);
+                return true;
+            }
+
+            void onRead(std::unique_ptr<ReadRequest> request, int32_t result)
+            {
+                if (result == -EINTR || result == -EAGAIN)
+                {
+                    result = 0; // Try the same range again
+                }
+                else if (result < 0)
+                {
+                    LOG_ERROR("Vfs: reading '{}' failed: {}", request->path, strerror(-result));
+                    finish(std::move(request), false);
+                    return;
+                }
+                else if (result == 0)
+                {
+                    // The file shrank since it was opened; hand out what is there.
+                    request->contents.resize(request->bytesRead);
+                }
+                request->bytesRead += static_cast<size_t>(result);
+
+                if (request->bytesRead >= request->contents.size())
+                {
+                    finish(std::move(request), true);
+                    return;
+                }
+                ReadRequest *raw = request.release();
+                if (!queueRead(raw))
+                {
+                    m_Waiting.push_back(raw);
+                }
+            }
+
+            void finish(std::unique_ptr<ReadRequest> request, bool succeeded)
+            {
+                ::close(request->fd);
+                AssetFile file;
+                if (succeeded)
+                {
+                    file.assign(std::move(request->contents));
+                }
+                complete(*request, std::move(file));
+            }
+
+            IoUring m_Ring;
+            int m_WakeFd = -1;
+            uint64_t m_WakeValue = 0;
+            std::thread m_Thread;
+            std::deque<ReadRequest *> m_Waiting;          // IO thread only, like m_InFlight
+            std::unordered_set<ReadRequest *> m_InFlight; // Handed to the ring, not yet completed
+
+            std::mutex m_Mutex;
+            std::vector<std::unique_ptr<ReadRequest>> m_Submitted;
+            bool m_Stop = false;
+#endif
+            std::unique_ptr<ThreadPool> m_OwnPool; // Only without a shared pool
+            TaskGroup m_PoolTasks;
+        };
+
+        std::mutex s_ReaderMutex;
+        std::unique_ptr<AsyncReader> s_Reader;
+
+        bool openFromMount(const Mount &mount, std::string_view relativePath, AssetFile &file)
+        {
+            if (mount.pak)
+            {
+                PakFile::Entry entry;
+                return mount.pak->find(relativePath, entry) && file.openEntry(mount.pak, entry);
+            }
+            return file.openNative(mount.directory + std::string(relativePath));
+        }
+    } // namespace
+
+    void Vfs::mountDirectory(const std::string &mountPoint, const std::string &directory)
+    {
+        Mount mount;
+        mount.mountPoint = normalizeMountPoint(mountPoint);
+        mount.directory = directory;
+        if (!mount.directory.empty() && mount.directory.back() != '/' && mount.directory.back() != '\\')
+        {
+            mount.directory += '/';
+        }
+        mount.source = directory;
+        addMount(std::move(mount));
+    }
+
+    bool Vfs::mountPak(const std::string &mountPoint, const std::string &path)
+    {
+        auto pak = std::make_shared<PakFile>();
+        if (!pak->open(path))
+        {
+            return false;
+        }
+        Mount mount;
+        mount.mountPoint = normalizeMountPoint(mountPoint);
+        mount.pak = std::move(pak);
+        mount.source = path;
+        addMount(std::move(mount));
+        return true;
+    }
+
+    bool Vfs::mountPrefPath(const std::string &mountPoint)
+    {
+        const std::string prefPath = getPrefPath();
+        if (prefPath.empty())
+        {
+            return false;
+        }
+        mountDirectory(mountPoint, prefPath);
+        return true;
+    }
+
+    bool Vfs::unmount(const std::string &mountPoint, const std::string &source)
+    {
+        const std::string normalized = normalizeMountPoint(mountPoint);
+        std::lock_guard<std::mutex> lock(s_MountMutex);
+        if (!s_Mounts)
+        {
+            return false;
+        }
+        MountTable mounts = *s_Mounts;
+        auto it = std::find_if(mounts.rbegin(), mounts.rend(), [&](const Mount &mount)
+                               { return mount.mountPoint == normalized && mount.source == source; });
+        if (it == mounts.rend())
+        {
+            return false;
+        }
+        mounts.erase(std::next(it).base());
+        s_Mounts = std::make_shared<const MountTable>(std::move(mounts));
+        return true;
+    }
+
+    void Vfs::reset()
+    {
+        std::lock_guard<std::mutex> lock(s_MountMutex);
+        s_Mounts.reset();
+    }
+
+    std::vector<Vfs::MountInfo> Vfs::getMounts()
+    {
+        std::vector<MountInfo> mounts;
+        for (const Mount &mount : *mountTable())
+        {
+            mounts.push_back({mount.mountPoint, mount.source, mount.pak ? MountType::Pak : MountType::Directory});
+        }
+        return mounts;
+    }
+
+    std::string Vfs::getAssetDirectory()
+    {
+#if PLATFORM_ANDROID
+        return "";
+#else
+        return "assets/";
+#endif
+    }
+
+    std::string Vfs::normalizePath(std::string_view path)
+    {
+        return PakFile::normalizePath(path);
+    }
+
+    std::string Vfs::resolvePath(const std::string &path)
+    {
+        const std::string normalized = normalizePath(path);
+        std::string fallback;
+        forEachMount(normalized, [&](const Mount &mount, std::string_view relativePath)
+                     {
+            if (mount.pak)
+            {
+                return false;
+            }
+            std::string nativePath = mount.directory + std::string(relativePath);
+            if (fallback.empty())
+            {
+                fallback = nativePath;
+            }
+            if (!SDL_GetPathInfo(nativePath.c_str(), nullptr))
+            {
+                return false;
+            }
+            fallback = std::move(nativePath);
+            return true; });
+        return fallback.empty() ? getAssetDirectory() + normalized : fallback;
+    }
+
+    bool Vfs::exists(const std::string &path)
+    {
+        return forEachMount(normalizePath(path), [](const Mount &mount, std::string_view relativePath)
+                            { return mount.pak ? mount.pak->contains(relativePath)
+                                               : SDL_GetPathInfo((mount.directory + std::string(relativePath)).c_str(), nullptr); });
+    }
+
+    bool Vfs::open(const std::string &path, AssetFile &file)
+    {
+        file.close();
+        return forEachMount(normalizePath(path), [&file](const Mount &mount, std::string_view relativePath)
+                            { return openFromMount(mount, relativePath, file); });
+    }
+
+    void Vfs::readAsync(const std::string &path, ReadCallback callback)
+    {
+        auto request = std::make_unique<ReadRequest>();
+        request->path = path;
+        request->callback = std::move(callback);
+
+        std::lock_guard<std::mutex> lock(s_ReaderMutex);
+        if (!s_Reader)
+        {
+            s_Reader = std::make_unique<AsyncReader>();
+        }
+        s_Reader->read(std::move(request));
+    }
+
+    void Vfs::shutdown()
+    {
+        std::unique_ptr<AsyncReader> reader;
+        {
+            std::lock_guard<std::mutex> lock(s_ReaderMutex);
+            reader = std::move(s_Reader);
+        }
+        // Joins outside the lock, so callbacks may still call readAsync.
+        reader.reset();
+    }
+
+    void Vfs::setThreadPool(ThreadPool *pool)
+    {
+        s_ThreadPool = pool;
+    }
+
+    const char *Vfs::getAsyncBackendName()
+    {
+        std::lock_guard<std::mutex> lock(s_ReaderMutex);
+        if (!s_Reader)
+        {
+            return "none";
+        }
+        return s_Reader->usesRing() ? "io_uring" : "thread pool";
+    }
+
+    Vfs::Stats Vfs::getStats()
+    {
+        Stats stats;
+        stats.asyncReads = s_AsyncReads.load();
+        stats.asyncBytes = s_AsyncBytes.load();
+        stats.inFlight = s_InFlight.load();
+        return stats;
+    }
+
+} // namespace Base
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "AssetFile.hpp"
+
+namespace Base
+{
+    class ThreadPool;
+
+    // Virtual filesystem every asset is read through. Paths are virtual ("shaders/mesh.vert") and
+    // resolved against a mount table: each mount maps a prefix, its mount point ("" matches every
+    // path, "pref/" the paths below it), onto a loose directory, a .pak archive or the user's
+    // pref path. The most recent mount that has the file wins, so an archive mounted over the
+    // assets directory shadows it while anything it lacks still comes from the directory.
+    //
+    // The table starts out with the assets directory alone, mounted at "".
+    class Vfs
+    {
+    public:
+        enum class MountType
+        {
+            Directory,
+            Pak
+        };
+
+        struct MountInfo
+        {
+            std::string mountPoint;
+            std::string source; // Directory or archive path
+            MountType type = MountType::Directory;
+        };
+
+        struct Stats
+        {
+            size_t asyncReads = 0; // Finished readAsync calls, found or not
+            size_t asyncBytes = 0;
+            size_t inFlight = 0;
+        };
+
+        // Gets the file, or a closed AssetFile when it exists nowhere.
+        using ReadCallback = std::function<void(AssetFile &&file)>;
+
+        // `directory` is a native path, used as is ("" is the working directory, or the APK's
+        // assets root on Android).
+        static void mountDirectory(const std::string &mountPoint, const std::string &directory);
+        // Quietly false when there is no archive at `path`.
+        static bool mountPak(const std::string &mountPoint, const std::string &path);
+        // SDL's per-user writable directory (see getPrefPath). False where there is none.
+        static bool mountPrefPath(const std::string &mountPoint);
+        static bool unmount(const std::string &mountPoint, const std::string &source);
+        // Back to the assets directory alone. Open files keep what they reference alive.
+        static void reset();
+        static std::vector<MountInfo> getMounts();
+
+        // Where the assets directory is relative to the working directory: "assets/", or "" on
+        // Android, where relative paths already point into the APK's assets.
+        static std::string getAssetDirectory();
+        // "./shaders\\a.vert" -> "shaders/a.vert"; the form mount points are matched against.
+        static std::string normalizePath(std::string_view path);
+        // Native path of the loose file behind `path`, for what needs a real file (file
+        // watchers). Falls back to where the assets directory would have it.
+        static std::string resolvePath(const std::string &path);
+        static bool exists(const std::string &path);
+
+        // Blocking open; AssetFile::open forwards here. Quietly false when nothing has the file.
+        static bool open(const std::string &path, AssetFile &file);
+
+        // Reads `path` without blocking the caller, so that many loads overlap. Loose files are
+        // read into memory through io_uring on Linux, serviced by one IO thread; elsewhere, where
+        // the kernel refuses io_uring, or once the ring fails, a small pool of IO threads opens
+        // them as open() does. Archive entries need no IO and complete right away.
+        // `callback` runs on that IO thread: keep it short and hand decoding to a worker.
+        static void readAsync(const std::string &path, ReadCallback callback);
+        // Finishes the outstanding reads and stops the IO threads; the next readAsync restarts them.
+        static void shutdown();
+        // Workers for the blocking reads, shared with the rest of the application; with none
+        // (the default) Vfs starts a small pool of its own. Takes effect with the next readAsync
+        // after a shutdown(); the pool must outlive it.
+        static void setThreadPool(ThreadPool *pool);
+        // "io_uring", "thread pool", or "none" before the first readAsync.
+        static const char *getAsyncBackendName();
+        static Stats getStats();
+    };
+
+} // namespace Base
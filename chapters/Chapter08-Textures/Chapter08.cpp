@@ -75,9 +75,9 @@ void Chapter08_Application::setup()
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0); // Unbinding the VAO is safe now.
 
-    // Load the texture
-    m_Texture = std::make_unique<Base::Texture>();
-    if (!m_Texture->loadFromFile("images/uv.png"))
+    // Load the texture (or reuse it, if another chapter already did)
+    m_Texture = Base::TextureCache::Get().acquire("images/uv.png");
+    if (!m_Texture.wait())
     {
         LOG_ERROR("Failed to load square texture!");
     }
@@ -92,7 +92,7 @@ void Chapter08_Application::shutdown()
     glDeleteBuffers(1, &m_VboID);
     glDeleteBuffers(1, &m_EboID); // <<< NEW: Delete the EBO
     m_Shader.reset();
-    m_Texture.reset();
+    m_Texture = {};
 }
 
 void Chapter08_Application::render()
@@ -104,7 +104,7 @@ void Chapter08_Application::render()
     m_Shader->use();
     m_Shader->setInt("u_Texture", 0);
     m_Shader->setVec4("u_CubeTintColor", glm::make_vec4(m_SquareTintColor));
-    m_Texture->bind(0);
+    m_Texture.bind(0);
 
     glBindVertexArray(m_VaoID);
 
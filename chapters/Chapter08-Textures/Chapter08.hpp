@@ -2,7 +2,7 @@
 
 #include "ChapterPreamble.hpp"
 #include "Shader.hpp"
-#include "Texture.hpp"
+#include "TextureCache.hpp"
 #include <memory>
 
 class Chapter08_Application : public ChapterBase
@@ -24,7 +24,7 @@ protected:
 
 private:
     std::unique_ptr<Base::Shader> m_Shader;
-    std::unique_ptr<Base::Texture> m_Texture;
+    Base::TextureHandle m_Texture;
     GLuint m_VaoID = 0;
     GLuint m_VboID = 0;
     GLuint m_EboID = 0;
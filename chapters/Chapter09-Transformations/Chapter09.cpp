@@ -52,8 +52,9 @@ void Chapter09_Application::setup()
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
 
-    m_Texture = std::make_unique<Base::Texture>();
-    if (!m_Texture->loadFromFile("images/uv.png"))
+    // Shared with every other chapter using uv.png
+    m_Texture = Base::TextureCache::Get().acquire("images/uv.png");
+    if (!m_Texture.wait())
     {
         LOG_ERROR("Failed to load texture!");
     }
@@ -106,7 +107,7 @@ void Chapter09_Application::shutdown()
     glDeleteBuffers(1, &m_GuideVboID);
     m_GuideShader.reset();
     m_Shader.reset();
-    m_Texture.reset();
+    m_Texture = {};
 }
 
 void Chapter09_Application::render()
@@ -128,7 +129,7 @@ void Chapter09_Application::render()
     m_Shader->setMat4("u_Transform", transform);
     m_Shader->setInt("u_Texture", 0);
     m_Shader->setVec4("u_SquareTintColor", glm::make_vec4(m_TintColor));
-    m_Texture->bind(0);
+    m_Texture.bind(0);
 
     glBindVertexArray(m_VaoID);
     glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
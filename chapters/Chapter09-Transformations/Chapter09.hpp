@@ -2,7 +2,7 @@
 
 #include "ChapterPreamble.hpp"
 #include "Shader.hpp"
-#include "Texture.hpp"
+#include "TextureCache.hpp"
 #include <memory>
 
 class Chapter09_Application : public ChapterBase
@@ -23,7 +23,7 @@ protected:
 
 private:
     std::unique_ptr<Base::Shader> m_Shader;
-    std::unique_ptr<Base::Texture> m_Texture;
+    Base::TextureHandle m_Texture;
 
     GLuint m_VaoID = 0, m_VboID = 0, m_EboID = 0;
 
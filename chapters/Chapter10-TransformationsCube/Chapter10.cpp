@@ -92,8 +92,8 @@ void Chapter10_Application::setup()
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
 
-    m_Texture = std::make_unique<Base::Texture>();
-    m_Texture->loadFromFile("images/uv.png");
+    // Shared with every other chapter using uv.png; decoded in the background on first use.
+    m_Texture = Base::TextureCache::Get().acquire("images/uv.png");
 
     // Setup for coordinate guide (unchanged)
     setupCoordinateGuide();
@@ -105,7 +105,7 @@ void Chapter10_Application::shutdown()
     glDeleteBuffers(1, &m_VboID);
     glDeleteBuffers(1, &m_EboID);
     m_Shader.reset();
-    m_Texture.reset();
+    m_Texture = {};
 
     glDeleteVertexArrays(1, &m_GuideVaoID);
     glDeleteBuffers(1, &m_GuideVboID);
@@ -128,7 +128,7 @@ void Chapter10_Application::render()
     m_Shader->setMat4("u_Transform", transform);
     m_Shader->setInt("u_Texture", 0);
     m_Shader->setVec4("u_CubeTintColor", glm::make_vec4(m_TintColor));
-    m_Texture->bind(0);
+    m_Texture.bind(0);
     glBindVertexArray(m_VaoID);
     // === 3. UPDATE DRAW CALL TO DRAW 36 INDICES ===
     glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
@@ -37,20 +37,14 @@ void Chapter11_Application::setup()
     setupCube();
     setupCoordinateGuide();
 
-    m_Texture = std::make_unique<Base::Texture>();
-    m_Texture->loadFromFile("images/uv.png");
+    // Shared with every other chapter using uv.png; decoded in the background on first use.
+    m_Texture = Base::TextureCache::Get().acquire("images/uv.png");
 
     auto &app = Base::Application::getInstance();
     m_Camera.setPosition({0.0f, 0.0f, 3.0f});
     m_Camera.lookAt({0.0f, 0.0f, 0.0f});
     m_Camera.setProjection(45.0f, app.getViewportAspectRatio(), 0.1f, 100.0f);
 
-    glGenBuffers(1, &m_CameraUboID);
-    glBindBuffer(GL_UNIFORM_BUFFER, m_CameraUboID);
-    glBufferData(GL_UNIFORM_BUFFER, sizeof(CameraMatrices), NULL, GL_DYNAMIC_DRAW);
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
-    glBindBufferBase(GL_UNIFORM_BUFFER, 0, m_CameraUboID);
-
     m_mouseButtonSub = app.getEventBus().subscribe<Base::MouseButtonPressedEvent>([this, &app](Base::MouseButtonPressedEvent &e)
                             {
             if (app.isViewportHovered() && e.button == SDL_BUTTON_RIGHT)
@@ -79,11 +73,10 @@ void Chapter11_Application::shutdown()
     glDeleteBuffers(1, &m_EboID);
     glDeleteVertexArrays(1, &m_GuideVaoID);
     glDeleteBuffers(1, &m_GuideVboID);
-    glDeleteBuffers(1, &m_CameraUboID);
-    glBindBufferBase(GL_UNIFORM_BUFFER, 0, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, Base::Shader::getBlockBinding("CameraUBO"), 0);
 
     m_Shader.reset();
-    m_Texture.reset();
+    m_Texture = {};
     m_GuideShader.reset();
 }
 
@@ -128,15 +121,13 @@ void Chapter11_Application::render()
     camMatrices.view = m_Camera.getViewMatrix();
     camMatrices.projection = m_Camera.getProjectionMatrix();
 
-    glBindBuffer(GL_UNIFORM_BUFFER, m_CameraUboID);
-    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(CameraMatrices), &camMatrices);
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    Base::Application::getInstance().getUniformRing().bindBlock(Base::Shader::getBlockBinding("CameraUBO"), camMatrices);
 
     m_Shader->use();
     m_Shader->setMat4("model", m_ModelMatrix);
     m_Shader->setInt("u_Texture", 0);
     m_Shader->setVec4("u_TintColor", glm::make_vec4(m_TintColor));
-    m_Texture->bind(0);
+    m_Texture.bind(0);
     glBindVertexArray(m_VaoID);
     glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
 
@@ -316,8 +307,6 @@ void Chapter11_Application::setupCoordinateGuide()
 {
     m_GuideShader = std::make_unique<Base::Shader>();
     m_GuideShader->loadFromFile("shaders/guideMVP.vert", "shaders/guide.frag");
-    unsigned int guide_UBO_Index = glGetUniformBlockIndex(m_GuideShader->getProgramID(), "CameraUBO");
-    glUniformBlockBinding(m_GuideShader->getProgramID(), guide_UBO_Index, 0);
     float guideVertices[] = {0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f};
     glGenVertexArrays(1, &m_GuideVaoID);
     glGenBuffers(1, &m_GuideVboID);
@@ -33,14 +33,12 @@ void Chapter12_Application::setup()
     m_Shader->loadFromFile(
         "shaders/chapter12.vert",
         "shaders/chapter12.frag");
-    unsigned int chapter12_UBO_Index = glGetUniformBlockIndex(m_Shader->getProgramID(), "CameraUBO");
-    glUniformBlockBinding(m_Shader->getProgramID(), chapter12_UBO_Index, 0);
 
     setupCube();
     setupCoordinateGuide();
 
-    m_Texture = std::make_unique<Base::Texture>();
-    m_Texture->loadFromFile("images/uv.png");
+    // Shared with every other chapter using uv.png; decoded in the background on first use.
+    m_Texture = Base::TextureCache::Get().acquire("images/uv.png");
 
     auto &app = Base::Application::getInstance();
 
@@ -48,12 +46,6 @@ void Chapter12_Application::setup()
     m_Camera.lookAt({0.0f, 0.0f, 0.0f});
     m_Camera.setProjection(45.0f, app.getViewportAspectRatio(), 0.1f, 100.0f);
 
-    glGenBuffers(1, &m_CameraUboID);
-    glBindBuffer(GL_UNIFORM_BUFFER, m_CameraUboID);
-    glBufferData(GL_UNIFORM_BUFFER, sizeof(CameraMatrices), NULL, GL_DYNAMIC_DRAW);
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
-    glBindBufferBase(GL_UNIFORM_BUFFER, 0, m_CameraUboID);
-
     m_keyPressSub = app.getEventBus().subscribe<Base::KeyPressedEvent>([this](Base::KeyPressedEvent &e)
     {
         if (e.key == SDLK_ESCAPE && !e.isRepeat) {
@@ -73,11 +65,10 @@ void Chapter12_Application::shutdown()
     glDeleteBuffers(1, &m_EboID);
     glDeleteVertexArrays(1, &m_GuideVaoID);
     glDeleteBuffers(1, &m_GuideVboID);
-    glDeleteBuffers(1, &m_CameraUboID);
-    glBindBufferBase(GL_UNIFORM_BUFFER, 0, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, Base::Shader::getBlockBinding("CameraUBO"), 0);
     
     m_Shader.reset();
-    m_Texture.reset();
+    m_Texture = {};
     m_GuideShader.reset();
     glDisable(GL_CULL_FACE);
     
@@ -137,16 +128,14 @@ void Chapter12_Application::render()
     camData.view = m_Camera.getViewMatrix();
     camData.projection = m_Camera.getProjectionMatrix();
 
-    glBindBuffer(GL_UNIFORM_BUFFER, m_CameraUboID);
-    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(CameraMatrices), &camData);
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    Base::Application::getInstance().getUniformRing().bindBlock(Base::Shader::getBlockBinding("CameraUBO"), camData);
 
     // --- Draw the Cube ---
     m_Shader->use();
     m_Shader->setMat4("model", m_ModelMatrix);
     m_Shader->setInt("u_Texture", 0);
     m_Shader->setVec4("u_TintColor", glm::make_vec4(m_TintColor));
-    m_Texture->bind(0);
+    m_Texture.bind(0);
     glBindVertexArray(m_VaoID);
     glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
 
@@ -348,8 +337,6 @@ void Chapter12_Application::setupCoordinateGuide()
 {
     m_GuideShader = std::make_unique<Base::Shader>();
     m_GuideShader->loadFromFile("shaders/guideMVP.vert", "shaders/guide.frag");
-    unsigned int guide_UBO_Index = glGetUniformBlockIndex(m_GuideShader->getProgramID(), "CameraUBO");
-    glUniformBlockBinding(m_GuideShader->getProgramID(), guide_UBO_Index, 0);
     float guideVertices[] = {0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f};
     glGenVertexArrays(1, &m_GuideVaoID);
     glGenBuffers(1, &m_GuideVboID);
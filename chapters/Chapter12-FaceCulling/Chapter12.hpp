@@ -2,7 +2,7 @@
 
 #include "ChapterPreamble.hpp"
 #include "Shader.hpp"
-#include "Texture.hpp"
+#include "TextureCache.hpp"
 #include "Camera.hpp"
 #include "EventBus.hpp"
 
@@ -32,7 +32,7 @@ private:
     
     // Cube Objects
     std::unique_ptr<Base::Shader> m_Shader;
-    std::unique_ptr<Base::Texture> m_Texture;
+    Base::TextureHandle m_Texture;
     GLuint m_VaoID = 0, m_VboID = 0, m_EboID = 0;
     glm::vec3 m_Position = glm::vec3(0.0f);
     glm::vec3 m_RotationEuler = glm::vec3(0.0f);
@@ -47,7 +47,6 @@ private:
 
     // Camera Objects
     Camera m_Camera;
-    GLuint m_CameraUboID;
 
     // Scene Objects
     float m_ClearColor[4] = {0.1f, 0.1f, 0.1f, 1.0f};
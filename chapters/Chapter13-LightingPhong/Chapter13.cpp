@@ -34,27 +34,22 @@ void Chapter13_Application::setup()
     m_Shader->loadFromFile(
         "shaders/chapter13.vert",
         "shaders/chapter13.frag");
-    unsigned int chapter13_UBO_Index = glGetUniformBlockIndex(m_Shader->getProgramID(), "CameraUBO");
-    glUniformBlockBinding(m_Shader->getProgramID(), chapter13_UBO_Index, 0);
+
+    // The light cube is drawn from the cube's range; its shader only reads the positions
+    m_LightCubeShader = std::make_unique<Base::Shader>();
+    m_LightCubeShader->loadFromFile("shaders/light_obj.vert", "shaders/light_obj.frag");
 
     setupCube();
-    setupLightCube();
     setupCoordinateGuide();
 
-    m_Texture = std::make_unique<Base::Texture>();
-    m_Texture->loadFromFile("images/uv.png");
+    // Shared with every other chapter using uv.png; decoded in the background on first use.
+    m_Texture = Base::TextureCache::Get().acquire("images/uv.png");
 
     auto& app = Base::Application::getInstance();
     m_Camera.setPosition({0.0f, 0.0f, 3.0f});
     m_Camera.lookAt({0.0f, 0.0f, 0.0f});
     m_Camera.setProjection(45.0f, app.getViewportAspectRatio(), 0.1f, 100.0f);
 
-    glGenBuffers(1, &m_CameraUboID);
-    glBindBuffer(GL_UNIFORM_BUFFER, m_CameraUboID);
-    glBufferData(GL_UNIFORM_BUFFER, sizeof(CameraMatrices), NULL, GL_DYNAMIC_DRAW);
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
-    glBindBufferBase(GL_UNIFORM_BUFFER, 0, m_CameraUboID);
-
     m_mouseButtonSub = app.getEventBus().subscribe<Base::MouseButtonPressedEvent>
     ([this, &app](Base::MouseButtonPressedEvent &e)
     {
@@ -80,17 +75,13 @@ void Chapter13_Application::shutdown()
     app.getEventBus().unsubscribe(m_mouseButtonSub);
     app.getEventBus().unsubscribe(m_keyPressSub);
 
-    glDeleteVertexArrays(1, &m_VaoID);
-    glDeleteBuffers(1, &m_VboID);
-    glDeleteBuffers(1, &m_EboID);
-    glDeleteVertexArrays(1, &m_GuideVaoID);
-    glDeleteBuffers(1, &m_GuideVboID);
-    glDeleteVertexArrays(1, &m_LightCubeVaoID);
-    glDeleteBuffers(1, &m_CameraUboID);
-    glBindBufferBase(GL_UNIFORM_BUFFER, 0, 0);
+    Base::GeometryBuffer &geometry = app.getGeometryBuffer();
+    geometry.free(m_CubeRange);
+    geometry.free(m_GuideRange);
+    glBindBufferBase(GL_UNIFORM_BUFFER, Base::Shader::getBlockBinding("CameraUBO"), 0);
 
     m_Shader.reset();
-    m_Texture.reset();
+    m_Texture = {};
     m_GuideShader.reset();
     m_LightCubeShader.reset();
     glDisable(GL_CULL_FACE);
@@ -150,9 +141,7 @@ void Chapter13_Application::render()
     camData.view = m_Camera.getViewMatrix();
     camData.projection = m_Camera.getProjectionMatrix();
 
-    glBindBuffer(GL_UNIFORM_BUFFER, m_CameraUboID);
-    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(CameraMatrices), &camData);
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    Base::Application::getInstance().getUniformRing().bindBlock(Base::Shader::getBlockBinding("CameraUBO"), camData);
 
     m_Shader->use();
     m_Shader->setMat4("model", m_ModelMatrix);
@@ -163,9 +152,11 @@ void Chapter13_Application::render()
     m_Shader->setVec4("u_LightColor", glm::make_vec4(m_LightColor));
     m_Shader->setInt("u_Texture", 0);
     m_Shader->setVec4("u_TintColor", glm::make_vec4(m_TintColor));
-    m_Texture->bind(0);
-    glBindVertexArray(m_VaoID);
-    glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+    m_Texture.bind(0);
+    // Everything below comes from the shared geometry buffer: one VAO for all three draws
+    const Base::GeometryBuffer &geometry = Base::Application::getInstance().getGeometryBuffer();
+    geometry.bind();
+    geometry.draw(m_CubeRange);
 
     m_LightCubeShader->use();
     glm::mat4 lightModel = glm::mat4(1.0f);
@@ -175,8 +166,7 @@ void Chapter13_Application::render()
     m_LightCubeShader->setMat4("model", lightModel);
     m_LightCubeShader->setVec4("u_ObjectColor", glm::make_vec4(m_LightColor));
 
-    glBindVertexArray(m_LightCubeVaoID);
-    glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+    geometry.draw(m_CubeRange);
 
 
     if (m_ShowCoordinateGuide)
@@ -184,8 +174,7 @@ void Chapter13_Application::render()
         m_GuideShader->use();
         m_GuideShader->setMat4("model", glm::mat4(1.0f));
         glLineWidth(2.5f); // deprecated in modern opengl (which version? 3.3?)
-        glBindVertexArray(m_GuideVaoID);
-        glDrawArrays(GL_LINES, 0, 6);
+        geometry.draw(m_GuideRange, GL_LINES);
         glLineWidth(1.0f);
     }
 
@@ -362,53 +351,8 @@ void Chapter13_Application::setupCube()
     //
     //clang-format on
 
-    glGenVertexArrays(1, &m_VaoID);
-    glGenBuffers(1, &m_VboID);
-    glGenBuffers(1, &m_EboID);
-
-    glBindVertexArray(m_VaoID);
-
-    glBindBuffer(GL_ARRAY_BUFFER, m_VboID);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EboID);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-    const GLsizei stride = 8 * sizeof(float);
-
-    // layout (location = 0) in vec3 aPos;
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void *)0);
-    glEnableVertexAttribArray(0);
-
-    // layout (location = 1) in vec3 aNormal;
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void *)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    // layout (location = 2) in vec2 aTexCoord;
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void *)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
-
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
-}
-
-void Chapter13_Application::setupLightCube()
-{
-    m_LightCubeShader = std::make_unique<Base::Shader>();
-    m_LightCubeShader->loadFromFile("shaders/light_obj.vert", "shaders/light_obj.frag");
-    
-    glGenVertexArrays(1, &m_LightCubeVaoID);
-    glBindVertexArray(m_LightCubeVaoID);
-
-    // Reuse the VBO and EBO from the main cube
-    glBindBuffer(GL_ARRAY_BUFFER, m_VboID);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EboID);
-
-    const GLsizei stride = 8 * sizeof(float);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
-    glEnableVertexAttribArray(0);
-
-    glBindVertexArray(0);
+    // Same layout as Base::MeshVertex, so the cube lives in the application's shared geometry buffer
+    m_CubeRange = Base::Application::getInstance().getGeometryBuffer().allocate(vertices, 24, indices, 36);
 }
 
 void Chapter13_Application::setupCoordinateGuide()
@@ -416,21 +360,16 @@ void Chapter13_Application::setupCoordinateGuide()
     m_GuideShader = std::make_unique<Base::Shader>();
     m_GuideShader->loadFromFile("shaders/guideMVP.vert", "shaders/guide.frag");
 
-    unsigned int guide_UBO_Index = glGetUniformBlockIndex(m_GuideShader->getProgramID(), "CameraUBO");
-    glUniformBlockBinding(m_GuideShader->getProgramID(), guide_UBO_Index, 0);
-
-    float guideVertices[] = {0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f};
-    glGenVertexArrays(1, &m_GuideVaoID);
-    glGenBuffers(1, &m_GuideVboID);
-    glBindVertexArray(m_GuideVaoID);
-    glBindBuffer(GL_ARRAY_BUFFER, m_GuideVboID);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(guideVertices), guideVertices, GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void *)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void *)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    // Position, color (read as location 1, the normal slot of the shared layout), unused texture coordinates
+    float guideVertices[] = {
+        0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+        1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+        0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f,
+        0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f,
+        0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f,
+        0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f};
+    unsigned int guideIndices[] = {0, 1, 2, 3, 4, 5};
+    m_GuideRange = Base::Application::getInstance().getGeometryBuffer().allocate(guideVertices, 6, guideIndices, 6);
 }
 
 void Chapter13_Application::drawMouseCapturePopup()
@@ -2,8 +2,9 @@
 
 #include "ChapterPreamble.hpp"
 #include "Shader.hpp"
-#include "Texture.hpp"
+#include "TextureCache.hpp"
 #include "Camera.hpp"
+#include "GeometryBuffer.hpp"
 #include "EventBus.hpp"
 
 #include <memory>
@@ -32,8 +33,8 @@ private:
     
     // Cube Objects
     std::unique_ptr<Base::Shader> m_Shader;
-    std::unique_ptr<Base::Texture> m_Texture;
-    GLuint m_VaoID = 0, m_VboID = 0, m_EboID = 0;
+    Base::TextureHandle m_Texture;
+    Base::GeometryRange m_CubeRange;
     glm::vec3 m_Position = glm::vec3(0.0f);
     glm::vec3 m_RotationEuler = glm::vec3(0.0f);
     glm::vec3 m_Scale = glm::vec3(1.0f);
@@ -42,16 +43,14 @@ private:
 
     // Guide Objects
     std::unique_ptr<Base::Shader> m_GuideShader;
-    GLuint m_GuideVaoID = 0, m_GuideVboID = 0;
+    Base::GeometryRange m_GuideRange;
     bool m_ShowCoordinateGuide = true;
 
     // Light Cube Objects
     std::unique_ptr<Base::Shader> m_LightCubeShader;
-    GLuint m_LightCubeVaoID = 0;
 
     // Camera Objects
     Camera m_Camera;
-    GLuint m_CameraUboID;
 
     // Scene Objects
     float m_ClearColor[4] = {0.1f, 0.1f, 0.1f, 1.0f};
@@ -65,7 +64,6 @@ private:
 
 
     void setupCube();
-    void setupLightCube(); 
     void setupCoordinateGuide();
     void drawMouseCapturePopup();
 };
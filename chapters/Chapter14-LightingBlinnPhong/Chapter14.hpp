@@ -2,8 +2,9 @@
 
 #include "ChapterPreamble.hpp"
 #include "Shader.hpp"
-#include "Texture.hpp"
+#include "TextureCache.hpp"
 #include "Camera.hpp"
+#include "GeometryBuffer.hpp"
 #include "EventBus.hpp"
 
 #include <memory>
@@ -35,9 +36,10 @@ private:
     Base::SubscriptionHandle m_keyPressSub;
     // Cube Objects
     std::unique_ptr<Base::Shader> m_Shader;
-    std::unique_ptr<Base::Texture> m_Texture;
+    bool m_BlinnPhong = true; // BLINN_PHONG specialization of chapter14.frag
+    Base::TextureHandle m_Texture;
     bool m_UseTexture = true;
-    GLuint m_VaoID = 0, m_VboID = 0, m_EboID = 0;
+    Base::GeometryRange m_CubeRange;
     glm::vec3 m_Position = glm::vec3(0.0f);
     glm::vec3 m_RotationEuler = glm::vec3(0.0f);
     glm::vec3 m_Scale = glm::vec3(1.0f);
@@ -46,16 +48,14 @@ private:
 
     // Guide Objects
     std::unique_ptr<Base::Shader> m_GuideShader;
-    GLuint m_GuideVaoID = 0, m_GuideVboID = 0;
+    Base::GeometryRange m_GuideRange;
     bool m_ShowCoordinateGuide = true;
 
     // Light Cube Objects
     std::unique_ptr<Base::Shader> m_LightCubeShader;
-    GLuint m_LightCubeVaoID = 0;
 
     // Camera Objects
     Camera m_Camera;
-    GLuint m_CameraUboID;
 
     // Scene Objects
     float m_ClearColor[4] = {0.1f, 0.1f, 0.1f, 1.0f};
@@ -68,12 +68,12 @@ private:
     int m_WindingOrderMode = 0; // 0 for GL_CCW, 1 for GL_CW
 
     void setupShaders();
+    void setupLightingShader();
     void setupGeometry();
     void setupCamera();
     void setupEventListeners();
     void setupCube();
     void setupCoordinateGuide();
-    void setupLightCube();
     void drawMouseCapturePopup();
     void drawSceneSettingsUI();
     void drawLightSettingsUI();
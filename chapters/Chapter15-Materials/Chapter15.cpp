@@ -2,6 +2,8 @@
 #include "Log.hpp"
 #include "Input.hpp"
 #include "Application.hpp"
+#include "MeshQuantizer.hpp"
+#include "ObjLoader.hpp"
 
 #include <imgui.h>
 #include <imgui_internal.h>
@@ -19,6 +21,27 @@ struct CameraMatrices
     glm::mat4 view;
     glm::mat4 projection;
 };
+BASE_UNIFORM_BLOCK(CameraMatrices, Base::BlockLayout::Std140,
+                   BASE_BLOCK_FIELD(CameraMatrices, view),
+                   BASE_BLOCK_FIELD(CameraMatrices, projection));
+
+// std140 aligns every vec3 to 16 bytes, hence the explicit padding
+struct LightBlock
+{
+    glm::vec3 position;
+    float pad0;
+    glm::vec3 ambient;
+    float pad1;
+    glm::vec3 diffuse;
+    float pad2;
+    glm::vec3 specular;
+    float pad3;
+};
+BASE_UNIFORM_BLOCK(LightBlock, Base::BlockLayout::Std140,
+                   BASE_BLOCK_FIELD_AS(LightBlock, position, "light.position"),
+                   BASE_BLOCK_FIELD_AS(LightBlock, ambient, "light.ambient"),
+                   BASE_BLOCK_FIELD_AS(LightBlock, diffuse, "light.diffuse"),
+                   BASE_BLOCK_FIELD_AS(LightBlock, specular, "light.specular"));
 
 #ifdef BUILD_STANDALONE
 Chapter15_Application::Chapter15_Application(std::string title, int width, int height)
@@ -46,33 +69,23 @@ void Chapter15_Application::setup()
 
 void Chapter15_Application::setupShaders()
 {
-    // Main object shader
-    m_Shader = std::make_unique<Base::Shader>();
-    m_Shader->loadFromFile("shaders/chapter15.vert", "shaders/chapter15.frag");
-    unsigned int mainShader_UBO_Index = glGetUniformBlockIndex(m_Shader->getProgramID(), "CameraUBO");
-    glUniformBlockBinding(m_Shader->getProgramID(), mainShader_UBO_Index, 0);
-
-    // Light cube shader
-    m_LightCubeShader = std::make_unique<Base::Shader>();
-    m_LightCubeShader->loadFromFile("shaders/light_obj.vert", "shaders/light_obj.frag");
-    unsigned int lightCube_UBO_Index = glGetUniformBlockIndex(m_LightCubeShader->getProgramID(), "CameraUBO");
-    glUniformBlockBinding(m_LightCubeShader->getProgramID(), lightCube_UBO_Index, 0);
-
-    // Coordinate guide shader
-    m_GuideShader = std::make_unique<Base::Shader>();
-    m_GuideShader->loadFromFile("shaders/guideMVP.vert", "shaders/guide.frag");
-    unsigned int guide_UBO_Index = glGetUniformBlockIndex(m_GuideShader->getProgramID(), "CameraUBO");
-    glUniformBlockBinding(m_GuideShader->getProgramID(), guide_UBO_Index, 0);
+    // Register the C++ side of each block first so every program below is checked against it at link time
+    Base::Shader::registerBlockLayout<CameraMatrices>("CameraUBO");
+    Base::Shader::registerBlockLayout<LightBlock>("LightUBO");
+
+    // Everything loads in the background; render() draws each object once its assets are ready
+    auto &assets = Base::AssetManager::Get();
+    m_Material = assets.loadMaterial("materials/chapter15.mat");
+    m_UniformsValidated = false;
+    m_LightCubeShader = assets.loadShader("shaders/light_obj.vert", "shaders/light_obj.frag");
+    m_GuideShader = assets.loadShader("shaders/guideMVP.vert", "shaders/guide.frag");
 }
 
 void Chapter15_Application::setupGeometry()
 {
     setupCube();
-    setupLightCube();
+    setupModel();
     setupCoordinateGuide();
-
-    m_Texture = std::make_unique<Base::Texture>();
-    m_Texture->loadFromFile("images/uv.png");
 }
 
 void Chapter15_Application::setupCamera()
@@ -82,15 +95,6 @@ void Chapter15_Application::setupCamera()
     m_Camera.setPosition({0.0f, 0.0f, 3.0f});
     m_Camera.lookAt({0.0f, 0.0f, 0.0f});
     m_Camera.setProjection(45.0f, app.getViewportAspectRatio(), 0.1f, 100.0f);
-
-    // Create and configure the Uniform Buffer Object
-    glGenBuffers(1, &m_CameraUboID);
-    glBindBuffer(GL_UNIFORM_BUFFER, m_CameraUboID);
-    glBufferData(GL_UNIFORM_BUFFER, sizeof(CameraMatrices), NULL, GL_DYNAMIC_DRAW);
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
-
-    // Bind the UBO to the global binding point 0
-    glBindBufferBase(GL_UNIFORM_BUFFER, 0, m_CameraUboID);
 }
 
 void Chapter15_Application::setupEventListeners()
@@ -119,21 +123,17 @@ void Chapter15_Application::shutdown()
     app.getEventBus().unsubscribe(m_mouseButtonSub);
     app.getEventBus().unsubscribe(m_keyPressSub);
 
-    glDeleteVertexArrays(1, &m_VaoID);
-    glDeleteBuffers(1, &m_VboID);
-    glDeleteBuffers(1, &m_EboID);
-    glDeleteVertexArrays(1, &m_GuideVaoID);
-    glDeleteBuffers(1, &m_GuideVboID);
-    glDeleteVertexArrays(1, &m_LightCubeVaoID);
+    app.getGeometryBuffer().free(m_CubeRange);
+    app.getGeometryBuffer().free(m_GuideRange);
+    m_Model.release();
     
-    // Clean up the UBO and its binding
-    glDeleteBuffers(1, &m_CameraUboID);
-    glBindBufferBase(GL_UNIFORM_BUFFER, 0, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, Base::Shader::getBlockBinding("CameraUBO"), 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, Base::Shader::getBlockBinding("LightUBO"), 0);
 
-    m_Shader.reset();
-    m_Texture.reset();
-    m_GuideShader.reset();
-    m_LightCubeShader.reset();
+    m_Material = {};
+    m_GuideShader = {};
+    m_LightCubeShader = {};
+    m_ModelShader = {};
 
     // Reset lingering OpenGL state
     glDisable(GL_CULL_FACE);
@@ -182,55 +182,87 @@ void Chapter15_Application::render()
     glClearColor(m_ClearColor[0], m_ClearColor[1], m_ClearColor[2], m_ClearColor[3]);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    // === 1. Update the UBO with the latest camera data ONCE per frame ===
+    // === 1. Stream this frame's camera and light data through the shared uniform ring ===
     CameraMatrices camData;
     camData.view = m_Camera.getViewMatrix();
     camData.projection = m_Camera.getProjectionMatrix();
-    glBindBuffer(GL_UNIFORM_BUFFER, m_CameraUboID);
-    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(CameraMatrices), &camData);
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
-
-    m_Shader->use();
-
-    m_Shader->setMat4("model", m_ModelMatrix);
-    m_Shader->setMat3("u_NormalMatrix", glm::transpose(glm::inverse(glm::mat3(m_ModelMatrix))));
-    m_Shader->setVec3("u_ViewPos", m_Camera.getPosition());
-    m_Shader->setInt("u_Texture", 0);
-    m_Shader->setBool("u_UseTexture", m_UseTexture);
-    m_Shader->setVec4("u_TintColor", glm::make_vec4(m_TintColor));
-
-    m_Shader->setVec3("light.position", m_Light.Position);
-    m_Shader->setVec3("light.ambient", m_Light.Ambient);
-    m_Shader->setVec3("light.diffuse", m_Light.Diffuse);
-    m_Shader->setVec3("light.specular", m_Light.Specular);
-
-    const auto &currentMaterial = m_MaterialPresets[m_CurrentMaterialIndex];
-    m_Shader->setVec3("material.ambient", currentMaterial.Ambient);
-    m_Shader->setVec3("material.diffuse", currentMaterial.Diffuse);
-    m_Shader->setVec3("material.specular", currentMaterial.Specular);
-    m_Shader->setFloat("material.shininess", currentMaterial.Shininess);
-
-    m_Texture->bind(0);
-    glBindVertexArray(m_VaoID);
-    glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-
-    m_LightCubeShader->use();
-    glm::mat4 lightModel = glm::mat4(1.0f);
-    lightModel = glm::translate(lightModel, m_Light.Position);
-    lightModel = glm::scale(lightModel, glm::vec3(0.2f));
-
-    m_LightCubeShader->setMat4("model", lightModel);
-    m_LightCubeShader->setVec4("u_ObjectColor", glm::vec4(m_Light.Diffuse, 1.0f));
-
-    glBindVertexArray(m_LightCubeVaoID);
-    glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-
-    if (m_ShowCoordinateGuide)
+    LightBlock lightData{};
+    lightData.position = m_Light.Position;
+    lightData.ambient = m_Light.Ambient;
+    lightData.diffuse = m_Light.Diffuse;
+    lightData.specular = m_Light.Specular;
+
+    auto &uniformRing = Base::Application::getInstance().getUniformRing();
+    uniformRing.bindBlock(Base::Shader::getBlockBinding("CameraUBO"), camData);
+    uniformRing.bindBlock(Base::Shader::getBlockBinding("LightUBO"), lightData);
+
+    const Base::GeometryBuffer &geometry = Base::Application::getInstance().getGeometryBuffer();
+    geometry.bind();
+
+    if (const Base::Material *material = m_Material.get())
     {
-        m_GuideShader->use();
-        m_GuideShader->setMat4("model", glm::mat4(1.0f));
-        glBindVertexArray(m_GuideVaoID);
-        glDrawArrays(GL_LINES, 0, 6);
+        const Base::Shader *shader = material->getShader().get();
+        if (!m_UniformsValidated)
+        {
+            shader->validateUniforms({"model", "u_NormalMatrix", "u_ViewPos", "u_Texture", "u_UseTexture", "u_TintColor",
+                                      "light.position", "light.ambient", "light.diffuse", "light.specular",
+                                      "material.ambient", "material.diffuse", "material.specular", "material.shininess"});
+            m_UniformsValidated = true;
+        }
+
+        material->apply();
+        shader->setMat4("model", m_ModelMatrix);
+        shader->setMat3("u_NormalMatrix", glm::transpose(glm::inverse(glm::mat3(m_ModelMatrix))));
+        shader->setVec3("u_ViewPos", m_Camera.getPosition());
+        shader->setBool("u_UseTexture", m_UseTexture);
+        shader->setVec4("u_TintColor", glm::make_vec4(m_TintColor));
+
+        const auto &currentMaterial = m_MaterialPresets[m_CurrentMaterialIndex];
+        shader->setVec3("material.ambient", currentMaterial.Ambient);
+        shader->setVec3("material.diffuse", currentMaterial.Diffuse);
+        shader->setVec3("material.specular", currentMaterial.Specular);
+        shader->setFloat("material.shininess", currentMaterial.Shininess);
+
+        geometry.draw(m_CubeRange);
+    }
+
+    if (const Base::Shader *lightCubeShader = m_LightCubeShader.get())
+    {
+        lightCubeShader->use();
+        glm::mat4 lightModel = glm::mat4(1.0f);
+        lightModel = glm::translate(lightModel, m_Light.Position);
+        lightModel = glm::scale(lightModel, glm::vec3(0.2f));
+
+        lightCubeShader->setMat4("model", lightModel);
+        lightCubeShader->setVec4("u_ObjectColor", glm::vec4(m_Light.Diffuse, 1.0f));
+
+        geometry.draw(m_CubeRange);
+    }
+
+    const Base::Shader *guideShader = m_GuideShader.get();
+    if (m_ShowCoordinateGuide && guideShader)
+    {
+        guideShader->use();
+        guideShader->setMat4("model", glm::mat4(1.0f));
+        geometry.draw(m_GuideRange, GL_LINES);
+    }
+
+    // The model has its own VAO, so it comes after everything drawn from the shared geometry buffer
+    const Base::Shader *modelShader = m_ModelShader.get();
+    if (m_ShowModel && modelShader && m_Model.getIndexCount() > 0)
+    {
+        const glm::vec3 modelPosition(-1.5f, 0.0f, 0.0f);
+        const glm::mat4 modelMatrix = glm::scale(glm::translate(glm::mat4(1.0f), modelPosition), glm::vec3(0.5f));
+
+        modelShader->use();
+        modelShader->setMat4("model", modelMatrix);
+        modelShader->setMat3("u_NormalMatrix", glm::transpose(glm::inverse(glm::mat3(modelMatrix))));
+        modelShader->setVec3("u_PositionScale", m_ModelPositionScale);
+        modelShader->setVec3("u_PositionOffset", m_ModelPositionOffset);
+        modelShader->setVec3("u_Color", m_MaterialPresets[m_CurrentMaterialIndex].Diffuse);
+        modelShader->setVec3("u_LightDirection", m_Light.Position - modelPosition);
+        modelShader->setVec3("u_ViewPos", m_Camera.getPosition());
+        m_Model.draw();
     }
 
     glBindVertexArray(0);
@@ -244,6 +276,7 @@ void Chapter15_Application::renderChapterUI()
     {
         ImGui::ColorEdit3("Background Color", m_ClearColor);
         ImGui::Checkbox("Show Coordinate Guide", &m_ShowCoordinateGuide);
+        ImGui::Checkbox("Show Model", &m_ShowModel);
     }
 
     if (ImGui::CollapsingHeader("Light Settings", ImGuiTreeNodeFlags_DefaultOpen))
@@ -394,58 +427,45 @@ void Chapter15_Application::setupCube()
         12, 13, 14, 14, 15, 12, 16, 17, 18, 18, 19, 16, 20, 21, 22, 22, 23, 20
     };
 
-    glGenVertexArrays(1, &m_VaoID);
-    glGenBuffers(1, &m_VboID);
-    glGenBuffers(1, &m_EboID);
-
-    glBindVertexArray(m_VaoID);
-
-    glBindBuffer(GL_ARRAY_BUFFER, m_VboID);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EboID);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-    const GLsizei stride = sizeof(Vertex);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(Vertex, position));
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(Vertex, normal));
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(Vertex, texCoord));
-    glEnableVertexAttribArray(2);
-
-    glBindVertexArray(0);
+    static_assert(sizeof(Vertex) == sizeof(Base::MeshVertex), "Vertex must match the shared geometry layout");
+    m_CubeRange = Base::Application::getInstance().getGeometryBuffer().allocate(vertices, 24, indices, 36);
 }
 
-void Chapter15_Application::setupLightCube()
+// Quantized to half the bytes per vertex; the shader is specialized for the resulting layout
+void Chapter15_Application::setupModel()
 {
-    glGenVertexArrays(1, &m_LightCubeVaoID);
-    glBindVertexArray(m_LightCubeVaoID);
-    glBindBuffer(GL_ARRAY_BUFFER, m_VboID);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EboID);
-    const GLsizei stride = sizeof(Vertex);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(Vertex, position));
-    glEnableVertexAttribArray(0);
-    glBindVertexArray(0);
+    Base::MeshData mesh;
+    if (!Base::ObjLoader::load("models/suzanne.obj", mesh))
+    {
+        LOG_ERROR("Failed to load models/suzanne.obj!");
+        return;
+    }
+
+    Base::QuantizedMesh quantized;
+    Base::MeshQuantizer::quantize(mesh, Base::VertexFormat(), quantized);
+    const Base::MeshView view = quantized.view();
+    if (!m_Model.upload(view))
+    {
+        return;
+    }
+    Base::MeshQuantizer::getPositionDecode(view, m_ModelPositionScale, m_ModelPositionOffset);
+    m_ModelShader = Base::AssetManager::Get().loadShader("shaders/mesh.vert", "shaders/mesh.frag",
+                                                         Base::MeshQuantizer::getShaderSpecializations(view.layout));
 }
 
 void Chapter15_Application::setupCoordinateGuide()
 {
-    float guideVertices[] = {
-        0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f,
-        0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f,
-        0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f
+    // Axis lines in the shared layout; the guide shader reads each line's colour from the normal slot.
+    Vertex guideVertices[] = {
+        {{0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f}},
+        {{1.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f}},
+        {{0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f}},
+        {{0.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f}},
+        {{0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f}},
+        {{0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f}}
     };
-    glGenVertexArrays(1, &m_GuideVaoID);
-    glGenBuffers(1, &m_GuideVboID);
-    glBindVertexArray(m_GuideVaoID);
-    glBindBuffer(GL_ARRAY_BUFFER, m_GuideVboID);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(guideVertices), guideVertices, GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    glBindVertexArray(0);
+    unsigned int guideIndices[] = {0, 1, 2, 3, 4, 5};
+    m_GuideRange = Base::Application::getInstance().getGeometryBuffer().allocate(guideVertices, 6, guideIndices, 6);
 }
 
 void Chapter15_Application::drawMouseCapturePopup()
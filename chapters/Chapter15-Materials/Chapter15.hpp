@@ -1,9 +1,9 @@
 #pragma once
 
 #include "ChapterPreamble.hpp"
-#include "Shader.hpp"
-#include "Texture.hpp"
+#include "AssetManager.hpp"
 #include "Camera.hpp"
+#include "GeometryBuffer.hpp"
 #include "MaterialPresets.hpp" 
 #include "EventBus.hpp"
 
@@ -46,9 +46,10 @@ private:
     Base::SubscriptionHandle m_keyPressSub;
 
     // Cube Objects
-    std::unique_ptr<Base::Shader> m_Shader;
-    std::unique_ptr<Base::Texture> m_Texture;
-    GLuint m_VaoID = 0, m_VboID = 0, m_EboID = 0;
+    // Shader and texture come from materials/chapter15.mat; the presets override its material.* values
+    Base::MaterialHandle m_Material;
+    bool m_UniformsValidated = false;
+    Base::GeometryRange m_CubeRange;
     glm::vec3 m_Position = glm::vec3(0.0f);
     glm::vec3 m_RotationEuler = glm::vec3(0.0f);
     glm::vec3 m_Scale = glm::vec3(1.0f);
@@ -57,17 +58,23 @@ private:
     bool m_UseTexture = true;
 
     // Guide Objects
-    std::unique_ptr<Base::Shader> m_GuideShader;
-    GLuint m_GuideVaoID = 0, m_GuideVboID = 0;
+    Base::ShaderHandle m_GuideShader;
+    Base::GeometryRange m_GuideRange;
     bool m_ShowCoordinateGuide = true;
 
     // Light Cube Objects
-    std::unique_ptr<Base::Shader> m_LightCubeShader;
-    GLuint m_LightCubeVaoID = 0;
+    Base::ShaderHandle m_LightCubeShader;
+
+    // Model Objects
+    // suzanne.obj in the default compact Base::VertexFormat, drawn by mesh.vert specialized for its layout
+    Base::Mesh m_Model;
+    Base::ShaderHandle m_ModelShader;
+    glm::vec3 m_ModelPositionScale = glm::vec3(1.0f);
+    glm::vec3 m_ModelPositionOffset = glm::vec3(0.0f);
+    bool m_ShowModel = true;
 
     // Camera Objects
     Camera m_Camera;
-    GLuint m_CameraUboID = 0;
 
     // Scene Objects
     float m_ClearColor[4] = {0.1f, 0.1f, 0.1f, 1.0f};
@@ -93,8 +100,8 @@ private:
     void setupCamera();
     void setupEventListeners();
     void setupCube();
+    void setupModel();
     void setupCoordinateGuide();
-    void setupLightCube();
     void drawMouseCapturePopup();
     void drawSceneSettingsUI();
     void drawLightSettingsUI();
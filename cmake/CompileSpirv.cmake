@@ -0,0 +1,27 @@
+# Compiles one GLSL shader from assets/shaders into an OpenGL SPIR-V module (GL_ARB_gl_spirv).
+# Invoked by the CompileShadersSpirv target as:
+#   cmake -DGLSLANG=<glslangValidator> -DINPUT=<shader> -DOUTPUT=<module.spv> -P CompileSpirv.cmake
+#
+# The shaders in assets/ have no #version line (Shader.cpp prepends one at runtime), so a
+# temporary copy with a 4.50 header is compiled instead. A shader glslang rejects only produces a
+# warning and an empty module; Shader::loadFromFile then falls back to compiling the GLSL source.
+
+get_filename_component(EXTENSION "${INPUT}" LAST_EXT)
+string(SUBSTRING "${EXTENSION}" 1 -1 STAGE)
+
+file(READ "${INPUT}" SOURCE)
+set(TEMP_SOURCE "${OUTPUT}.${STAGE}")
+file(WRITE "${TEMP_SOURCE}" "#version 450 core\n${SOURCE}")
+
+execute_process(
+    COMMAND "${GLSLANG}" -G -S ${STAGE} --auto-map-locations --auto-map-bindings -o "${OUTPUT}" "${TEMP_SOURCE}"
+    RESULT_VARIABLE RESULT
+    OUTPUT_VARIABLE LOG
+    ERROR_VARIABLE LOG
+)
+file(REMOVE "${TEMP_SOURCE}")
+
+if(NOT RESULT EQUAL 0)
+    message(WARNING "SPIR-V compilation of ${INPUT} failed, the GLSL source will be used at runtime:\n${LOG}")
+    file(WRITE "${OUTPUT}" "")
+endif()
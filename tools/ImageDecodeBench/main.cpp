@@ -0,0 +1,183 @@
+// Compares the registered image decoders on the same files.
+//
+//   ImageDecodeBench [-n <iterations>] [--qoi] <file or directory>...
+//
+// Every decoder whose canDecode() accepts a file decodes it <iterations> times; the report lists
+// the best time, throughput in decoded megabytes per second and the peak of the decoder heap
+// (pixels plus scratch, see Base::ImageDecoder::getMemoryStats). PNG files are also re-encoded to
+// QOI in memory so that the QOI decoder can be compared against them; --qoi additionally writes
+// those files next to the inputs.
+
+#include "ImageDecoder.hpp"
+#include "Log.hpp"
+#include "QoiDecoder.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct BenchOptions
+    {
+        int iterations = 20;
+        bool writeQoi = false;
+    };
+
+    void printUsage()
+    {
+        LOG_INFO("Usage: ImageDecodeBench [options] <file or directory>...\n"
+                 "  -n <iterations>  Decodes per file and decoder (default: 20)\n"
+                 "      --qoi        Write a .qoi next to every decoded PNG");
+    }
+
+    bool parseArguments(int argc, char *argv[], BenchOptions &options, std::vector<std::filesystem::path> &inputs)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string argument = argv[i];
+            if (argument == "-n" && i + 1 < argc)
+            {
+                options.iterations = std::max(1, std::atoi(argv[++i]));
+            }
+            else if (argument == "--qoi")
+            {
+                options.writeQoi = true;
+            }
+            else if (!argument.empty() && argument[0] == '-')
+            {
+                LOG_ERROR("ImageDecodeBench: unknown option '{}'.", argument);
+                return false;
+            }
+            else if (std::filesystem::is_directory(argument))
+            {
+                for (const auto &entry : std::filesystem::directory_iterator(argument))
+                {
+                    std::string extension = entry.path().extension().string();
+                    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c)
+                                   { return static_cast<char>(std::tolower(c)); });
+                    if (entry.is_regular_file() && (extension == ".png" || extension == ".qoi"))
+                    {
+                        inputs.push_back(entry.path());
+                    }
+                }
+            }
+            else
+            {
+                inputs.emplace_back(argument);
+            }
+        }
+        std::sort(inputs.begin(), inputs.end());
+        return !inputs.empty();
+    }
+
+    bool readFile(const std::filesystem::path &path, std::vector<uint8_t> &data)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            return false;
+        }
+        data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return true;
+    }
+
+    // Best of `iterations` decodes; false if the decoder rejected the data.
+    bool bench(const Base::ImageDecoder &decoder, const std::vector<uint8_t> &data, const std::string &label,
+               const BenchOptions &options, Base::ImageData *keep = nullptr)
+    {
+        double best = 0.0;
+        size_t peak = 0;
+        size_t decodedBytes = 0;
+        for (int i = 0; i < options.iterations; ++i)
+        {
+            const size_t baseline = Base::ImageDecoder::getMemoryStats().currentBytes;
+            Base::ImageDecoder::resetPeakMemory();
+            const auto start = std::chrono::steady_clock::now();
+            Base::ImageData image;
+            if (!decoder.decode(data.data(), data.size(), image))
+            {
+                LOG_ERROR("ImageDecodeBench: {} failed on {}.", decoder.getName(), label);
+                return false;
+            }
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            best = i == 0 ? seconds : std::min(best, seconds);
+            peak = std::max(peak, Base::ImageDecoder::getMemoryStats().peakBytes - baseline);
+            decodedBytes = image.byteSize();
+            if (keep && i + 1 == options.iterations)
+            {
+                *keep = std::move(image);
+            }
+        }
+
+        LOG_INFO("  {:<10} {:>9.3f} ms {:>9.1f} MB/s  peak {:>8} KB", decoder.getName(), best * 1000.0,
+                 decodedBytes / (1024.0 * 1024.0) / best, peak / 1024);
+        return true;
+    }
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    LoggerConfig config;
+    config.loggerName = "ImageDecodeBench";
+    config.logPattern = "%v";
+    config.enableFileLogging = false;
+    Logger::getInstance().initialize(config);
+
+    BenchOptions options;
+    std::vector<std::filesystem::path> inputs;
+    if (!parseArguments(argc, argv, options, inputs))
+    {
+        printUsage();
+        return 1;
+    }
+
+    const Base::ImageDecoder *qoi = Base::ImageDecoder::findDecoder("qoi");
+    int failures = 0;
+    for (const std::filesystem::path &input : inputs)
+    {
+        std::vector<uint8_t> data;
+        if (!readFile(input, data))
+        {
+            LOG_ERROR("ImageDecodeBench: cannot read '{}'.", input.string());
+            ++failures;
+            continue;
+        }
+
+        LOG_INFO("{} ({} KB)", input.filename().string(), data.size() / 1024);
+        Base::ImageData decoded;
+        for (const Base::ImageDecoder *decoder : Base::ImageDecoder::getDecoders())
+        {
+            if (decoder->canDecode(data.data(), data.size()) &&
+                !bench(*decoder, data, input.filename().string(), options, decoded.pixels ? nullptr : &decoded))
+            {
+                ++failures;
+            }
+        }
+
+        // The same pixels as QOI, for a like-for-like comparison.
+        std::vector<uint8_t> encoded;
+        if (qoi && !qoi->canDecode(data.data(), data.size()) &&
+            Base::QoiDecoder::encode(decoded.pixels, decoded.width, decoded.height, decoded.channels, encoded))
+        {
+            LOG_INFO("  as QOI ({} KB):", encoded.size() / 1024);
+            if (!bench(*qoi, encoded, input.filename().string() + " (qoi)", options))
+            {
+                ++failures;
+            }
+            if (options.writeQoi)
+            {
+                std::filesystem::path output = input;
+                output.replace_extension(".qoi");
+                std::ofstream(output, std::ios::binary).write(reinterpret_cast<const char *>(encoded.data()),
+                                                              static_cast<std::streamsize>(encoded.size()));
+            }
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,267 @@
+// Compares mesh loaders on the same files.
+//
+//   MeshBench [-n <iterations>] <file or directory>...
+//
+// Every .obj is loaded <iterations> times by Base::ObjLoader on one thread, by Base::ObjLoader
+// with a ThreadPool, and by assimp with the post-processing that produces the same result
+// (triangulation, welding, smooth normals where missing), then read back from Base::MeshCache
+// (hash + map of the cached .mesh, in a temporary cache directory). The report lists the best
+// wall time of each, including reading the file, and the resulting vertex and triangle counts,
+// followed by the post-transform cache efficiency (ACMR/ATVR) before and after Base::MeshOptimizer
+// and the memory and per-draw bandwidth saved by the default compact Base::VertexFormat, the
+// meshlets of Base::MeshletBuilder with what Base::ClusterCuller rejects from eight views around
+// the model, and the LOD chain built by Base::MeshSimplifier.
+
+#include "ClusterCuller.hpp"
+#include "Log.hpp"
+#include "MappedFile.hpp"
+#include "MeshCache.hpp"
+#include "MeshOptimizer.hpp"
+#include "MeshQuantizer.hpp"
+#include "MeshSimplifier.hpp"
+#include "MeshletBuilder.hpp"
+#include "ObjLoader.hpp"
+#include "ThreadPool.hpp"
+
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct Result
+    {
+        double bestMs = 0.0;
+        size_t vertices = 0;
+        size_t triangles = 0;
+    };
+
+    bool parseArguments(int argc, char *argv[], int &iterations, std::vector<std::filesystem::path> &inputs)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string argument = argv[i];
+            if (argument == "-n" && i + 1 < argc)
+            {
+                iterations = std::max(1, std::atoi(argv[++i]));
+            }
+            else if (!argument.empty() && argument[0] == '-')
+            {
+                LOG_ERROR("MeshBench: unknown option '{}'.", argument);
+                return false;
+            }
+            else if (std::filesystem::is_directory(argument))
+            {
+                for (const auto &entry : std::filesystem::directory_iterator(argument))
+                {
+                    std::string extension = entry.path().extension().string();
+                    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c)
+                                   { return static_cast<char>(std::tolower(c)); });
+                    if (entry.is_regular_file() && extension == ".obj")
+                    {
+                        inputs.push_back(entry.path());
+                    }
+                }
+            }
+            else
+            {
+                inputs.emplace_back(argument);
+            }
+        }
+        std::sort(inputs.begin(), inputs.end());
+        return !inputs.empty();
+    }
+
+    // Best of `iterations` runs of `load`, which fills in the counts and returns false on failure.
+    bool bench(const char *label, int iterations, const std::function<bool(Result &)> &load)
+    {
+        Result result;
+        for (int i = 0; i < iterations; ++i)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            if (!load(result))
+            {
+                LOG_ERROR("  {:<14} failed", label);
+                return false;
+            }
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            result.bestMs = i == 0 ? ms : std::min(result.bestMs, ms);
+        }
+        LOG_INFO("  {:<14} {:>9.2f} ms  {:>8} vertices {:>8} triangles", label, result.bestMs, result.vertices,
+                 result.triangles);
+        return true;
+    }
+
+    bool loadWithObjLoader(const std::filesystem::path &path, Base::ThreadPool *pool, Result &result)
+    {
+        Base::MappedFile file;
+        Base::MeshData mesh;
+        if (!file.open(path.string()) ||
+            !Base::ObjLoader::parse(reinterpret_cast<const char *>(file.data()), file.size(), path.string(), mesh, pool))
+        {
+            return false;
+        }
+        result.vertices = mesh.vertices.size();
+        result.triangles = mesh.getTriangleCount();
+        return true;
+    }
+
+    bool loadFromCache(const std::filesystem::path &path, Result &result)
+    {
+        Base::MeshFile file;
+        if (!Base::MeshCache::Get().loadFile(path.string(), file))
+        {
+            return false;
+        }
+        result.vertices = file.getView().vertexCount;
+        const Base::MeshView &view = file.getView();
+        result.triangles = (view.lods.empty() ? view.indexCount : view.lods[0].indexCount) / 3;
+        return true;
+    }
+
+    // Culls the meshlets from eight cameras around the model, looking at its center.
+    void reportCulling(const Base::MeshData &mesh, Base::ThreadPool *pool)
+    {
+        Base::ClusterCuller culler(mesh.meshlets);
+        const glm::vec3 center = (mesh.boundsMin + mesh.boundsMax) * 0.5f;
+        const float distance = glm::length(mesh.boundsMax - mesh.boundsMin) * 1.2f;
+        const glm::mat4 projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, distance * 0.01f, distance * 4.0f);
+        std::vector<Base::DrawRange> ranges;
+        Base::ClusterCuller::Stats total;
+        double bestMs = 0.0;
+        constexpr int kViews = 8;
+        for (int view = 0; view < kViews; ++view)
+        {
+            const float angle = glm::radians(360.0f * static_cast<float>(view) / kViews);
+            const glm::vec3 eye = center + glm::vec3(std::sin(angle), 0.3f, std::cos(angle)) * distance;
+            const glm::mat4 viewProjection = projection * glm::lookAt(eye, center, glm::vec3(0.0f, 1.0f, 0.0f));
+            const Base::ClusterCuller::Stats stats = culler.cull(viewProjection, glm::mat4(1.0f), eye, ranges, pool);
+            total.frustumCulled += stats.frustumCulled;
+            total.backfaceCulled += stats.backfaceCulled;
+            total.ranges += stats.ranges;
+            total.indexCount += stats.indexCount;
+            bestMs = view == 0 ? stats.milliseconds : std::min(bestMs, stats.milliseconds);
+        }
+        const double clusters = static_cast<double>(std::max<size_t>(culler.getClusterCount(), 1)) * kViews;
+        LOG_INFO("  {:<14} {:>9.3f} ms  {:.1f}% outside, {:.1f}% backfacing, {} of {} triangles in {} ranges per view",
+                 "ClusterCuller", bestMs, 100.0 * total.frustumCulled / clusters, 100.0 * total.backfaceCulled / clusters,
+                 total.indexCount / 3 / kViews, mesh.getTriangleCount(), total.ranges / kViews);
+    }
+
+    bool reportProcessing(const std::filesystem::path &path, Base::ThreadPool *pool)
+    {
+        Base::MappedFile file;
+        Base::MeshData mesh;
+        if (!file.open(path.string()) ||
+            !Base::ObjLoader::parse(reinterpret_cast<const char *>(file.data()), file.size(), path.string(), mesh, pool))
+        {
+            return false;
+        }
+        const Base::MeshOptimizer::Report report = Base::MeshOptimizer::optimize(mesh);
+        LOG_INFO("  {:<14} {:>9.2f} ms  ACMR {:.3f} -> {:.3f}  ATVR {:.3f} -> {:.3f}", "MeshOptimizer", report.milliseconds,
+                 report.before.acmr, report.after.acmr, report.before.atvr, report.after.atvr);
+
+        auto start = std::chrono::steady_clock::now();
+        Base::MeshletBuilder::build(mesh);
+        const double meshletMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        const Base::MeshOptimizer::CacheStats meshletCache =
+            Base::MeshOptimizer::analyzeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size());
+        LOG_INFO("  {:<14} {:>9.2f} ms  {} meshlets, ACMR {:.3f}", "MeshletBuilder", meshletMs, mesh.meshlets.size(),
+                 meshletCache.acmr);
+        reportCulling(mesh, pool);
+
+        const Base::VertexFormat format;
+        Base::QuantizedMesh quantized;
+        Base::MeshQuantizer::Report savings;
+        Base::MeshQuantizer::quantize(mesh, format, quantized, &savings);
+        LOG_INFO("  {:<14} {}: {} -> {} B/vertex, {} -> {} B/index, {} -> {} KB, {} -> {} KB per draw", "MeshQuantizer",
+                 format.getName(), savings.sourceStride, savings.stride, sizeof(uint32_t), savings.indexSize,
+                 savings.sourceBytes / 1024, savings.bytes / 1024, savings.sourceDrawBytes / 1024, savings.drawBytes / 1024);
+        LOG_INFO("  {:<14} max error {:.6f} (position), {:.3f} deg (normal)", "", savings.maxPositionError,
+                 savings.maxNormalError);
+
+        start = std::chrono::steady_clock::now();
+        Base::MeshSimplifier::generateLods(mesh);
+        const double lodMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        LOG_INFO("  {:<14} {:>9.2f} ms  {} LODs", "MeshSimplifier", lodMs, std::max<size_t>(mesh.lods.size(), 1));
+        for (size_t i = 0; i < mesh.lods.size(); ++i)
+        {
+            LOG_INFO("  {:<14} LOD {}: {:>8} triangles, error {:.4f}", "", i, mesh.lods[i].indexCount / 3, mesh.lods[i].error);
+        }
+        return true;
+    }
+
+    bool loadWithAssimp(const std::filesystem::path &path, Result &result)
+    {
+        Assimp::Importer importer;
+        const aiScene *scene = importer.ReadFile(path.string(), aiProcess_Triangulate | aiProcess_JoinIdenticalVertices |
+                                                                    aiProcess_GenSmoothNormals);
+        if (!scene)
+        {
+            LOG_ERROR("MeshBench: assimp: {}", importer.GetErrorString());
+            return false;
+        }
+        result.vertices = 0;
+        result.triangles = 0;
+        for (unsigned i = 0; i < scene->mNumMeshes; ++i)
+        {
+            result.vertices += scene->mMeshes[i]->mNumVertices;
+            result.triangles += scene->mMeshes[i]->mNumFaces;
+        }
+        return true;
+    }
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    LoggerConfig config;
+    config.loggerName = "MeshBench";
+    config.logPattern = "%v";
+    config.enableFileLogging = false;
+    Logger::getInstance().initialize(config);
+
+    int iterations = 10;
+    std::vector<std::filesystem::path> inputs;
+    if (!parseArguments(argc, argv, iterations, inputs))
+    {
+        LOG_INFO("Usage: MeshBench [-n <iterations>] <file or directory>...");
+        return 1;
+    }
+
+    const std::filesystem::path cacheDirectory = std::filesystem::temp_directory_path() / "MeshBench";
+    Base::MeshCache::Get().setDirectory(cacheDirectory.string());
+
+    Base::ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+    pool.Start();
+    int failures = 0;
+    for (const std::filesystem::path &input : inputs)
+    {
+        LOG_INFO("{} ({} KB)", input.filename().string(), std::filesystem::file_size(input) / 1024);
+        failures += !bench("ObjLoader", iterations, [&](Result &result) { return loadWithObjLoader(input, nullptr, result); });
+        failures += !bench("ObjLoader (MT)", iterations, [&](Result &result) { return loadWithObjLoader(input, &pool, result); });
+        failures += !bench("assimp", iterations, [&](Result &result) { return loadWithAssimp(input, result); });
+
+        failures += !reportProcessing(input, &pool);
+
+        Base::MeshFile warmUp;
+        Base::MeshCache::Get().loadFile(input.string(), warmUp, &pool);
+        failures += !bench("MeshCache hit", iterations, [&](Result &result) { return loadFromCache(input, result); });
+    }
+    pool.Stop();
+    std::error_code error;
+    std::filesystem::remove_all(cacheDirectory, error);
+    return failures == 0 ? 0 : 1;
+}
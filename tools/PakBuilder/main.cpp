@@ -0,0 +1,59 @@
+// Packs an asset tree into one .pak archive (see Base::PakFile), which the application mounts
+// over the loose assets directory (see Base::Vfs).
+//
+//   PakBuilder [--no-lz4] <asset directory> <output.pak>
+//
+// The CopyAssets target runs it over the copied assets directory, so the archive also holds the
+// baked textures and SPIR-V modules.
+
+#include "Log.hpp"
+#include "PakFile.hpp"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+int main(int argc, char *argv[])
+{
+    LoggerConfig config;
+    config.loggerName = "PakBuilder";
+    config.logPattern = "[%^%l%$] %v";
+    config.enableFileLogging = false;
+    Logger::getInstance().initialize(config);
+
+    Base::PakFile::BuildOptions options;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string argument = argv[i];
+        if (argument == "--no-lz4")
+        {
+            options.compress = false;
+        }
+        else if (!argument.empty() && argument[0] == '-')
+        {
+            LOG_ERROR("PakBuilder: unknown option '{}'.", argument);
+            return 1;
+        }
+        else
+        {
+            paths.push_back(argument);
+        }
+    }
+    if (paths.size() != 2)
+    {
+        LOG_INFO("Usage: PakBuilder [--no-lz4] <asset directory> <output.pak>");
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    Base::PakFile::BuildReport report;
+    if (!Base::PakFile::build(paths[0], paths[1], options, &report))
+    {
+        return 1;
+    }
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    LOG_INFO("PakBuilder: {} files ({} LZ4) into '{}', {} -> {} KB in {:.1f} ms.", report.files, report.compressed,
+             paths[1], report.sourceBytes / 1024, report.bytes / 1024, ms);
+    return 0;
+}
@@ -0,0 +1,365 @@
+#include "BlockEncoder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace TextureBaker
+{
+    namespace
+    {
+        // Dominant direction of the texel cloud (first `channels` components) by power iteration
+        // on the covariance matrix. Returns false for a flat block.
+        template <int Channels>
+        bool principalAxis(const BlockTexels &texels, float mean[Channels], float axis[Channels])
+        {
+            for (int c = 0; c < Channels; ++c)
+            {
+                mean[c] = 0.0f;
+                for (int i = 0; i < 16; ++i)
+                {
+                    mean[c] += texels[i][c];
+                }
+                mean[c] /= 16.0f;
+            }
+
+            float covariance[Channels][Channels] = {};
+            for (int i = 0; i < 16; ++i)
+            {
+                float d[Channels];
+                for (int c = 0; c < Channels; ++c)
+                {
+                    d[c] = texels[i][c] - mean[c];
+                }
+                for (int a = 0; a < Channels; ++a)
+                {
+                    for (int b = 0; b < Channels; ++b)
+                    {
+                        covariance[a][b] += d[a] * d[b];
+                    }
+                }
+            }
+
+            for (int c = 0; c < Channels; ++c)
+            {
+                axis[c] = 1.0f;
+            }
+            for (int iteration = 0; iteration < 8; ++iteration)
+            {
+                float next[Channels] = {};
+                float length = 0.0f;
+                for (int a = 0; a < Channels; ++a)
+                {
+                    for (int b = 0; b < Channels; ++b)
+                    {
+                        next[a] += covariance[a][b] * axis[b];
+                    }
+                    length = std::max(length, std::fabs(next[a]));
+                }
+                if (length < 1e-6f)
+                {
+                    return false;
+                }
+                for (int c = 0; c < Channels; ++c)
+                {
+                    axis[c] = next[c] / length;
+                }
+            }
+            return true;
+        }
+
+        // Ends of the texel cloud projected on its principal axis.
+        template <int Channels>
+        void lineEndpoints(const BlockTexels &texels, float low[Channels], float high[Channels])
+        {
+            float mean[Channels];
+            float axis[Channels];
+            if (!principalAxis<Channels>(texels, mean, axis))
+            {
+                for (int c = 0; c < Channels; ++c)
+                {
+                    low[c] = high[c] = mean[c];
+                }
+                return;
+            }
+
+            float minT = std::numeric_limits<float>::max();
+            float maxT = std::numeric_limits<float>::lowest();
+            for (int i = 0; i < 16; ++i)
+            {
+                float t = 0.0f;
+                for (int c = 0; c < Channels; ++c)
+                {
+                    t += (texels[i][c] - mean[c]) * axis[c];
+                }
+                minT = std::min(minT, t);
+                maxT = std::max(maxT, t);
+            }
+
+            float lengthSq = 0.0f;
+            for (int c = 0; c < Channels; ++c)
+            {
+                lengthSq += axis[c] * axis[c];
+            }
+            for (int c = 0; c < Channels; ++c)
+            {
+                low[c] = std::clamp(mean[c] + axis[c] * minT / lengthSq, 0.0f, 255.0f);
+                high[c] = std::clamp(mean[c] + axis[c] * maxT / lengthSq, 0.0f, 255.0f);
+            }
+        }
+
+        int squaredDistance(const uint8_t *a, const int *b, int channels)
+        {
+            int sum = 0;
+            for (int c = 0; c < channels; ++c)
+            {
+                const int d = a[c] - b[c];
+                sum += d * d;
+            }
+            return sum;
+        }
+
+        uint16_t packRgb565(const float color[3])
+        {
+            const int r = static_cast<int>(std::lround(color[0] * 31.0f / 255.0f));
+            const int g = static_cast<int>(std::lround(color[1] * 63.0f / 255.0f));
+            const int b = static_cast<int>(std::lround(color[2] * 31.0f / 255.0f));
+            return static_cast<uint16_t>(r << 11 | g << 5 | b);
+        }
+
+        void unpackRgb565(uint16_t packed, int color[3])
+        {
+            const int r = packed >> 11 & 31;
+            const int g = packed >> 5 & 63;
+            const int b = packed & 31;
+            color[0] = r << 3 | r >> 2;
+            color[1] = g << 2 | g >> 4;
+            color[2] = b << 3 | b >> 2;
+        }
+
+        void writeU16(uint8_t *out, uint16_t value)
+        {
+            out[0] = static_cast<uint8_t>(value);
+            out[1] = static_cast<uint8_t>(value >> 8);
+        }
+
+        // LSB-first bit packing used by BC7.
+        struct BitWriter
+        {
+            uint8_t *bytes;
+            int position = 0;
+
+            void write(uint32_t value, int count)
+            {
+                for (int i = 0; i < count; ++i, ++position)
+                {
+                    if (value >> i & 1u)
+                    {
+                        bytes[position >> 3] |= static_cast<uint8_t>(1u << (position & 7));
+                    }
+                }
+            }
+        };
+
+        constexpr int kBc7Weights4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+    } // namespace
+
+    void encodeBc1(const BlockTexels &texels, uint8_t *out)
+    {
+        float low[3];
+        float high[3];
+        lineEndpoints<3>(texels, low, high);
+
+        // Pull the ends in by 1/16 of the range; the extremes are rarely worth a palette entry.
+        for (int c = 0; c < 3; ++c)
+        {
+            const float inset = (high[c] - low[c]) / 16.0f;
+            low[c] += inset;
+            high[c] -= inset;
+        }
+
+        uint16_t color0 = packRgb565(high);
+        uint16_t color1 = packRgb565(low);
+        if (color0 < color1)
+        {
+            std::swap(color0, color1);
+        }
+        writeU16(out, color0);
+        writeU16(out + 2, color1);
+
+        uint32_t indices = 0;
+        if (color0 != color1) // Equal endpoints would select the 3-color mode; index 0 covers the block
+        {
+            int palette[4][3];
+            unpackRgb565(color0, palette[0]);
+            unpackRgb565(color1, palette[1]);
+            for (int c = 0; c < 3; ++c)
+            {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+            for (int i = 0; i < 16; ++i)
+            {
+                int best = 0;
+                int bestError = std::numeric_limits<int>::max();
+                for (int p = 0; p < 4; ++p)
+                {
+                    const int error = squaredDistance(texels[i], palette[p], 3);
+                    if (error < bestError)
+                    {
+                        bestError = error;
+                        best = p;
+                    }
+                }
+                indices |= static_cast<uint32_t>(best) << (2 * i);
+            }
+        }
+        std::memcpy(out + 4, &indices, sizeof(indices)); // Little-endian, like every target platform
+    }
+
+    void encodeBc4(const BlockTexels &texels, int channel, uint8_t *out)
+    {
+        int low = 255;
+        int high = 0;
+        for (int i = 0; i < 16; ++i)
+        {
+            low = std::min<int>(low, texels[i][channel]);
+            high = std::max<int>(high, texels[i][channel]);
+        }
+        out[0] = static_cast<uint8_t>(high);
+        out[1] = static_cast<uint8_t>(low);
+
+        uint64_t indices = 0;
+        if (high != low) // high > low selects the 8-value mode
+        {
+            int palette[8] = {high, low};
+            for (int p = 1; p < 7; ++p)
+            {
+                palette[p + 1] = ((7 - p) * high + p * low) / 7;
+            }
+            for (int i = 0; i < 16; ++i)
+            {
+                int best = 0;
+                int bestError = std::numeric_limits<int>::max();
+                for (int p = 0; p < 8; ++p)
+                {
+                    const int error = std::abs(texels[i][channel] - palette[p]);
+                    if (error < bestError)
+                    {
+                        bestError = error;
+                        best = p;
+                    }
+                }
+                indices |= static_cast<uint64_t>(best) << (3 * i);
+            }
+        }
+        for (int b = 0; b < 6; ++b)
+        {
+            out[2 + b] = static_cast<uint8_t>(indices >> (8 * b));
+        }
+    }
+
+    void encodeBc3(const BlockTexels &texels, uint8_t *out)
+    {
+        encodeBc4(texels, 3, out);
+        encodeBc1(texels, out + 8);
+    }
+
+    void encodeBc5(const BlockTexels &texels, uint8_t *out)
+    {
+        encodeBc4(texels, 0, out);
+        encodeBc4(texels, 1, out + 8);
+    }
+
+    void encodeBc7(const BlockTexels &texels, uint8_t *out)
+    {
+        float low[4];
+        float high[4];
+        lineEndpoints<4>(texels, low, high);
+
+        // Endpoints are 7 bits plus a shared low bit; try the four p-bit combinations.
+        int bestEndpoints[2][4] = {};
+        int bestPBits[2] = {};
+        int bestIndices[16] = {};
+        int bestError = std::numeric_limits<int>::max();
+        for (int pBits = 0; pBits < 4; ++pBits)
+        {
+            const int p[2] = {pBits & 1, pBits >> 1};
+            int endpoints[2][4];
+            for (int c = 0; c < 4; ++c)
+            {
+                endpoints[0][c] = std::clamp(static_cast<int>(std::lround((low[c] - p[0]) / 2.0f)), 0, 127) * 2 + p[0];
+                endpoints[1][c] = std::clamp(static_cast<int>(std::lround((high[c] - p[1]) / 2.0f)), 0, 127) * 2 + p[1];
+            }
+
+            int palette[16][4];
+            for (int w = 0; w < 16; ++w)
+            {
+                for (int c = 0; c < 4; ++c)
+                {
+                    palette[w][c] = ((64 - kBc7Weights4[w]) * endpoints[0][c] + kBc7Weights4[w] * endpoints[1][c] + 32) >> 6;
+                }
+            }
+
+            int indices[16];
+            int error = 0;
+            for (int i = 0; i < 16; ++i)
+            {
+                int best = 0;
+                int bestTexelError = std::numeric_limits<int>::max();
+                for (int w = 0; w < 16; ++w)
+                {
+                    const int texelError = squaredDistance(texels[i], palette[w], 4);
+                    if (texelError < bestTexelError)
+                    {
+                        bestTexelError = texelError;
+                        best = w;
+                    }
+                }
+                indices[i] = best;
+                error += bestTexelError;
+            }
+
+            if (error < bestError)
+            {
+                bestError = error;
+                std::memcpy(bestEndpoints, endpoints, sizeof(endpoints));
+                std::memcpy(bestIndices, indices, sizeof(indices));
+                bestPBits[0] = p[0];
+                bestPBits[1] = p[1];
+            }
+        }
+
+        // The first index is stored without its top bit, so it has to be below 8.
+        if (bestIndices[0] >= 8)
+        {
+            for (int c = 0; c < 4; ++c)
+            {
+                std::swap(bestEndpoints[0][c], bestEndpoints[1][c]);
+            }
+            std::swap(bestPBits[0], bestPBits[1]);
+            for (int &index : bestIndices)
+            {
+                index = 15 - index;
+            }
+        }
+
+        std::memset(out, 0, 16);
+        BitWriter writer{out};
+        writer.write(1u << 6, 7); // Mode 6
+        for (int c = 0; c < 4; ++c)
+        {
+            writer.write(static_cast<uint32_t>(bestEndpoints[0][c] >> 1), 7);
+            writer.write(static_cast<uint32_t>(bestEndpoints[1][c] >> 1), 7);
+        }
+        writer.write(static_cast<uint32_t>(bestPBits[0]), 1);
+        writer.write(static_cast<uint32_t>(bestPBits[1]), 1);
+        writer.write(static_cast<uint32_t>(bestIndices[0]), 3);
+        for (int i = 1; i < 16; ++i)
+        {
+            writer.write(static_cast<uint32_t>(bestIndices[i]), 4);
+        }
+    }
+
+} // namespace TextureBaker
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace TextureBaker
+{
+    // 4x4 RGBA8 texels, row-major.
+    using BlockTexels = uint8_t[16][4];
+
+    // Opaque BC1 (4-color mode only). 8 bytes.
+    void encodeBc1(const BlockTexels &texels, uint8_t *out);
+    // BC4 of one channel. 8 bytes.
+    void encodeBc4(const BlockTexels &texels, int channel, uint8_t *out);
+    // BC4 alpha followed by BC1 color. 16 bytes.
+    void encodeBc3(const BlockTexels &texels, uint8_t *out);
+    // BC4 red followed by BC4 green, for two-channel data such as normal maps. 16 bytes.
+    void encodeBc5(const BlockTexels &texels, uint8_t *out);
+    // BC7 mode 6: one RGBA line with 7.7.7.7 endpoints, a p-bit each and 4-bit indices. 16 bytes.
+    void encodeBc7(const BlockTexels &texels, uint8_t *out);
+
+} // namespace TextureBaker
@@ -0,0 +1,236 @@
+#include "Ktx2Writer.hpp"
+#include "Log.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+
+namespace TextureBaker
+{
+    namespace
+    {
+        constexpr uint8_t kIdentifier[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+        // Khronos Data Format enums used by the descriptor.
+        constexpr uint8_t kModelRgbsda = 1;
+        constexpr uint8_t kModelBc1 = 128;
+        constexpr uint8_t kModelBc3 = 130;
+        constexpr uint8_t kModelBc5 = 132;
+        constexpr uint8_t kModelBc7 = 134;
+        constexpr uint8_t kPrimariesBt709 = 1;
+        constexpr uint8_t kTransferLinear = 1;
+        constexpr uint8_t kTransferSrgb = 2;
+        constexpr uint8_t kChannelAlpha = 15;
+        constexpr uint8_t kQualifierLinear = 0x10;
+        constexpr uint8_t kQualifierSigned = 0x40;
+        constexpr uint8_t kQualifierFloat = 0x80;
+
+        struct Sample
+        {
+            uint16_t bitOffset;
+            uint8_t bitLength; // Minus one
+            uint8_t channelType;
+            uint32_t lower;
+            uint32_t upper;
+        };
+
+        uint32_t vkFormatOf(BakeFormat format, bool srgb)
+        {
+            switch (format)
+            {
+            case BakeFormat::RGBA8: return srgb ? 43 : 37;
+            case BakeFormat::RGB16F: return 90;
+            case BakeFormat::BC1: return srgb ? 132 : 131; // BC1_RGB: the encoder only writes opaque blocks
+            case BakeFormat::BC3: return srgb ? 138 : 137;
+            case BakeFormat::BC5: return 141;
+            case BakeFormat::BC7: return srgb ? 146 : 145;
+            }
+            return 0;
+        }
+
+        void append(std::vector<uint8_t> &out, const void *data, size_t size)
+        {
+            const uint8_t *bytes = static_cast<const uint8_t *>(data);
+            out.insert(out.end(), bytes, bytes + size);
+        }
+
+        void appendU32(std::vector<uint8_t> &out, uint32_t value) { append(out, &value, sizeof(value)); }
+        void appendU64(std::vector<uint8_t> &out, uint64_t value) { append(out, &value, sizeof(value)); }
+
+        void alignTo(std::vector<uint8_t> &out, size_t alignment)
+        {
+            out.resize((out.size() + alignment - 1) / alignment * alignment, 0);
+        }
+
+        std::vector<uint8_t> buildDataFormatDescriptor(BakeFormat format, bool srgb)
+        {
+            const uint8_t alphaType = kChannelAlpha | (srgb ? kQualifierLinear : 0);
+            uint8_t model = kModelRgbsda;
+            std::vector<Sample> samples;
+            switch (format)
+            {
+            case BakeFormat::RGBA8:
+                for (uint8_t c = 0; c < 3; ++c)
+                {
+                    samples.push_back({static_cast<uint16_t>(c * 8), 7, c, 0, 255});
+                }
+                samples.push_back({24, 7, alphaType, 0, 255});
+                break;
+            case BakeFormat::RGB16F:
+                for (uint8_t c = 0; c < 3; ++c)
+                {
+                    samples.push_back({static_cast<uint16_t>(c * 16), 15,
+                                       static_cast<uint8_t>(c | kQualifierFloat | kQualifierSigned),
+                                       0xBF800000u, 0x3F800000u}); // -1.0f, 1.0f
+                }
+                break;
+            case BakeFormat::BC1:
+                model = kModelBc1;
+                samples.push_back({0, 63, 0, 0, 0xFFFFFFFFu});
+                break;
+            case BakeFormat::BC3:
+                model = kModelBc3;
+                samples.push_back({0, 63, alphaType, 0, 0xFFFFFFFFu});
+                samples.push_back({64, 63, 0, 0, 0xFFFFFFFFu});
+                break;
+            case BakeFormat::BC5:
+                model = kModelBc5;
+                samples.push_back({0, 63, 0, 0, 0xFFFFFFFFu});
+                samples.push_back({64, 63, 1, 0, 0xFFFFFFFFu});
+                break;
+            case BakeFormat::BC7:
+                model = kModelBc7;
+                samples.push_back({0, 127, 0, 0, 0xFFFFFFFFu});
+                break;
+            }
+
+            const bool blocks = isBlockCompressed(format);
+            const uint32_t blockSize = 24 + 16 * static_cast<uint32_t>(samples.size());
+            std::vector<uint8_t> dfd;
+            appendU32(dfd, 4 + blockSize); // dfdTotalSize
+            appendU32(dfd, 0);             // vendorId = Khronos, descriptorType = basic
+            appendU32(dfd, 2u | blockSize << 16);
+            const uint8_t header[16] = {model, kPrimariesBt709, srgb ? kTransferSrgb : kTransferLinear, 0,
+                                        static_cast<uint8_t>(blocks ? 3 : 0), static_cast<uint8_t>(blocks ? 3 : 0), 0, 0,
+                                        static_cast<uint8_t>(formatUnitBytes(format)), 0, 0, 0, 0, 0, 0, 0};
+            append(dfd, header, sizeof(header));
+            for (const Sample &sample : samples)
+            {
+                append(dfd, &sample.bitOffset, 2);
+                dfd.push_back(sample.bitLength);
+                dfd.push_back(sample.channelType);
+                appendU32(dfd, 0); // samplePosition
+                appendU32(dfd, sample.lower);
+                appendU32(dfd, sample.upper);
+            }
+            return dfd;
+        }
+
+        void appendKeyValue(std::vector<uint8_t> &out, const std::string &key, const std::string &value)
+        {
+            appendU32(out, static_cast<uint32_t>(key.size() + value.size() + 2));
+            append(out, key.c_str(), key.size() + 1);
+            append(out, value.c_str(), value.size() + 1);
+            alignTo(out, 4);
+        }
+    } // namespace
+
+    const char *formatName(BakeFormat format)
+    {
+        switch (format)
+        {
+        case BakeFormat::RGBA8: return "RGBA8";
+        case BakeFormat::RGB16F: return "RGB16F";
+        case BakeFormat::BC1: return "BC1";
+        case BakeFormat::BC3: return "BC3";
+        case BakeFormat::BC5: return "BC5";
+        case BakeFormat::BC7: return "BC7";
+        }
+        return "?";
+    }
+
+    bool isBlockCompressed(BakeFormat format)
+    {
+        return format != BakeFormat::RGBA8 && format != BakeFormat::RGB16F;
+    }
+
+    size_t formatUnitBytes(BakeFormat format)
+    {
+        switch (format)
+        {
+        case BakeFormat::RGBA8: return 4;
+        case BakeFormat::RGB16F: return 6;
+        case BakeFormat::BC1: return 8;
+        default: return 16;
+        }
+    }
+
+    size_t levelByteSize(BakeFormat format, int width, int height)
+    {
+        if (!isBlockCompressed(format))
+        {
+            return static_cast<size_t>(width) * height * formatUnitBytes(format);
+        }
+        return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * formatUnitBytes(format);
+    }
+
+    bool writeKtx2(const std::string &path, const Ktx2Image &image)
+    {
+        constexpr size_t kHeaderSize = 80;
+        constexpr size_t kLevelIndexEntry = 24;
+        const uint32_t levelCount = static_cast<uint32_t>(image.levels.size());
+
+        std::vector<uint8_t> file;
+        append(file, kIdentifier, sizeof(kIdentifier));
+        appendU32(file, vkFormatOf(image.format, image.srgb));
+        appendU32(file, image.format == BakeFormat::RGB16F ? 2 : 1); // typeSize
+        appendU32(file, static_cast<uint32_t>(image.width));
+        appendU32(file, static_cast<uint32_t>(image.height));
+        appendU32(file, 0); // pixelDepth
+        appendU32(file, static_cast<uint32_t>(image.layerCount));
+        appendU32(file, 1); // faceCount
+        appendU32(file, levelCount);
+        appendU32(file, 0); // supercompressionScheme
+
+        const std::vector<uint8_t> dfd = buildDataFormatDescriptor(image.format, image.srgb);
+        std::vector<uint8_t> kvd;
+        appendKeyValue(kvd, "KTXorientation", "ru");
+        appendKeyValue(kvd, "KTXwriter", "CGCourse TextureBaker");
+
+        const size_t dfdOffset = kHeaderSize + levelCount * kLevelIndexEntry;
+        const size_t kvdOffset = dfdOffset + dfd.size();
+        appendU32(file, static_cast<uint32_t>(dfdOffset));
+        appendU32(file, static_cast<uint32_t>(dfd.size()));
+        appendU32(file, static_cast<uint32_t>(kvdOffset));
+        appendU32(file, static_cast<uint32_t>(kvd.size()));
+        appendU64(file, 0); // sgdByteOffset
+        appendU64(file, 0); // sgdByteLength
+
+        // Level index first, patched once the data offsets are known.
+        const size_t levelIndexOffset = file.size();
+        file.resize(file.size() + levelCount * kLevelIndexEntry, 0);
+        append(file, dfd.data(), dfd.size());
+        append(file, kvd.data(), kvd.size());
+
+        // The spec stores the smallest level first, each aligned to lcm(texel block size, 4).
+        const size_t alignment = std::lcm<size_t>(formatUnitBytes(image.format), 4);
+        for (uint32_t level = levelCount; level-- > 0;)
+        {
+            alignTo(file, alignment);
+            const std::vector<uint8_t> &data = image.levels[level];
+            const uint64_t entry[3] = {file.size(), data.size(), data.size()};
+            std::memcpy(file.data() + levelIndexOffset + level * kLevelIndexEntry, entry, sizeof(entry));
+            append(file, data.data(), data.size());
+        }
+
+        std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+        if (!stream.write(reinterpret_cast<const char *>(file.data()), static_cast<std::streamsize>(file.size())))
+        {
+            LOG_ERROR("TextureBaker: cannot write '{}'.", path);
+            return false;
+        }
+        return true;
+    }
+
+} // namespace TextureBaker
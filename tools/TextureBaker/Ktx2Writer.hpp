@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace TextureBaker
+{
+    enum class BakeFormat
+    {
+        RGBA8,
+        RGB16F,
+        BC1,
+        BC3,
+        BC5,
+        BC7
+    };
+
+    const char *formatName(BakeFormat format);
+    bool isBlockCompressed(BakeFormat format);
+    // Bytes per 4x4 block, or per texel for the uncompressed formats.
+    size_t formatUnitBytes(BakeFormat format);
+    size_t levelByteSize(BakeFormat format, int width, int height);
+
+    // A 2D texture (or texture array) with its levels, largest first, as written to a .ktx2 file.
+    struct Ktx2Image
+    {
+        BakeFormat format = BakeFormat::RGBA8;
+        bool srgb = false;
+        int width = 0;
+        int height = 0;
+        int layerCount = 0; // > 0 for arrays; each level then holds its layers back to back
+        std::vector<std::vector<uint8_t>> levels;
+    };
+
+    // Writes a KTX 2.0 file without supercompression: header, level index, a Basic data format
+    // descriptor and KTXorientation "ru" (rows bottom-up, as the runtime uploads them).
+    bool writeKtx2(const std::string &path, const Ktx2Image &image);
+
+} // namespace TextureBaker
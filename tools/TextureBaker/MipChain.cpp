@@ -0,0 +1,190 @@
+#include "MipChain.hpp"
+#include "HalfFloat.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define MIP_CHAIN_SSE2 1
+#elif defined(__ARM_NEON)
+    #include <arm_neon.h>
+    #define MIP_CHAIN_NEON 1
+#endif
+
+namespace TextureBaker
+{
+    namespace
+    {
+        constexpr float kMaxHalf = 65504.0f;
+
+        float srgbToLinear(float value)
+        {
+            return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+        }
+
+        float linearToSrgb(float value)
+        {
+            return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+        }
+
+        const std::array<float, 256> &srgbTable()
+        {
+            static const std::array<float, 256> s_Table = []()
+            {
+                std::array<float, 256> table{};
+                for (int i = 0; i < 256; ++i)
+                {
+                    table[i] = srgbToLinear(static_cast<float>(i) / 255.0f);
+                }
+                return table;
+            }();
+            return s_Table;
+        }
+
+        uint8_t toUnorm8(float value)
+        {
+            return static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+        }
+
+        // Averages four RGBA pixels into `out`.
+        inline void average4(const float *a, const float *b, const float *c, const float *d, float *out)
+        {
+#if MIP_CHAIN_SSE2
+            const __m128 sum = _mm_add_ps(_mm_add_ps(_mm_loadu_ps(a), _mm_loadu_ps(b)),
+                                          _mm_add_ps(_mm_loadu_ps(c), _mm_loadu_ps(d)));
+            _mm_storeu_ps(out, _mm_mul_ps(sum, _mm_set1_ps(0.25f)));
+#elif MIP_CHAIN_NEON
+            const float32x4_t sum = vaddq_f32(vaddq_f32(vld1q_f32(a), vld1q_f32(b)), vaddq_f32(vld1q_f32(c), vld1q_f32(d)));
+            vst1q_f32(out, vmulq_n_f32(sum, 0.25f));
+#else
+            for (int i = 0; i < 4; ++i)
+            {
+                out[i] = (a[i] + b[i] + c[i] + d[i]) * 0.25f;
+            }
+#endif
+        }
+
+        // Undoes the premultiplication of one pixel.
+        inline void unpremultiply(const float *pixel, float out[4])
+        {
+            const float alpha = pixel[3];
+            const float scale = alpha > 0.0f ? 1.0f / alpha : 0.0f;
+            out[0] = pixel[0] * scale;
+            out[1] = pixel[1] * scale;
+            out[2] = pixel[2] * scale;
+            out[3] = alpha;
+        }
+    } // namespace
+
+    FloatImage fromRgba8(const uint8_t *pixels, int width, int height, bool srgb)
+    {
+        const std::array<float, 256> &table = srgbTable();
+        FloatImage image;
+        image.width = width;
+        image.height = height;
+        image.pixels.resize(static_cast<size_t>(width) * height * 4);
+        for (size_t i = 0; i < image.pixels.size(); i += 4)
+        {
+            const float alpha = static_cast<float>(pixels[i + 3]) / 255.0f;
+            for (size_t c = 0; c < 3; ++c)
+            {
+                const float value = srgb ? table[pixels[i + c]] : static_cast<float>(pixels[i + c]) / 255.0f;
+                image.pixels[i + c] = value * alpha;
+            }
+            image.pixels[i + 3] = alpha;
+        }
+        return image;
+    }
+
+    FloatImage fromRgba32f(const float *pixels, int width, int height)
+    {
+        FloatImage image;
+        image.width = width;
+        image.height = height;
+        image.pixels.assign(pixels, pixels + static_cast<size_t>(width) * height * 4);
+        for (size_t i = 0; i < image.pixels.size(); i += 4)
+        {
+            const float alpha = image.pixels[i + 3];
+            image.pixels[i] *= alpha;
+            image.pixels[i + 1] *= alpha;
+            image.pixels[i + 2] *= alpha;
+        }
+        return image;
+    }
+
+    FloatImage downsample(const FloatImage &source)
+    {
+        FloatImage target;
+        target.width = std::max(1, source.width / 2);
+        target.height = std::max(1, source.height / 2);
+        target.pixels.resize(static_cast<size_t>(target.width) * target.height * 4);
+
+        // Odd sizes drop their last row/column, a 1-pixel dimension repeats itself.
+        for (int y = 0; y < target.height; ++y)
+        {
+            const float *row0 = source.row(std::min(2 * y, source.height - 1));
+            const float *row1 = source.row(std::min(2 * y + 1, source.height - 1));
+            float *out = target.row(y);
+            for (int x = 0; x < target.width; ++x)
+            {
+                const size_t x0 = static_cast<size_t>(std::min(2 * x, source.width - 1)) * 4;
+                const size_t x1 = static_cast<size_t>(std::min(2 * x + 1, source.width - 1)) * 4;
+                average4(row0 + x0, row0 + x1, row1 + x0, row1 + x1, out + static_cast<size_t>(x) * 4);
+            }
+        }
+        return target;
+    }
+
+    std::vector<FloatImage> buildMipChain(FloatImage base)
+    {
+        std::vector<FloatImage> levels;
+        levels.push_back(std::move(base));
+        while (levels.back().width > 1 || levels.back().height > 1)
+        {
+            levels.push_back(downsample(levels.back()));
+        }
+        return levels;
+    }
+
+    void toRgba8(const FloatImage &image, int firstRow, int rowCount, bool srgb, uint8_t *out)
+    {
+        float pixel[4];
+        for (int y = 0; y < rowCount; ++y)
+        {
+            const float *row = image.row(std::min(firstRow + y, image.height - 1));
+            for (int x = 0; x < image.width; ++x, out += 4)
+            {
+                unpremultiply(row + static_cast<size_t>(x) * 4, pixel);
+                for (int c = 0; c < 3; ++c)
+                {
+                    out[c] = toUnorm8(srgb ? linearToSrgb(std::clamp(pixel[c], 0.0f, 1.0f)) : pixel[c]);
+                }
+                out[3] = toUnorm8(pixel[3]);
+            }
+        }
+    }
+
+    void toRgb16f(const FloatImage &image, int firstRow, int rowCount, uint16_t *out)
+    {
+        std::vector<float> straight(static_cast<size_t>(image.width) * 3);
+        float pixel[4];
+        for (int y = 0; y < rowCount; ++y)
+        {
+            const float *row = image.row(std::min(firstRow + y, image.height - 1));
+            for (int x = 0; x < image.width; ++x)
+            {
+                unpremultiply(row + static_cast<size_t>(x) * 4, pixel);
+                // Keep the brightest texels finite; one infinity would poison every filtered lookup.
+                for (int c = 0; c < 3; ++c)
+                {
+                    straight[static_cast<size_t>(x) * 3 + c] = std::min(pixel[c], kMaxHalf);
+                }
+            }
+            Base::floatToHalf(straight.data(), out, straight.size());
+            out += straight.size();
+        }
+    }
+
+} // namespace TextureBaker
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace TextureBaker
+{
+    // RGBA image in linear light with premultiplied alpha, the space where box filtering is correct.
+    struct FloatImage
+    {
+        int width = 0;
+        int height = 0;
+        std::vector<float> pixels; // 4 floats per pixel, bottom row first
+
+        const float *row(int y) const { return pixels.data() + static_cast<size_t>(y) * width * 4; }
+        float *row(int y) { return pixels.data() + static_cast<size_t>(y) * width * 4; }
+    };
+
+    // 8-bit RGBA to FloatImage. With `srgb` the color channels are decoded from sRGB first.
+    FloatImage fromRgba8(const uint8_t *pixels, int width, int height, bool srgb);
+    // 32-bit float RGBA (stbi_loadf) to FloatImage.
+    FloatImage fromRgba32f(const float *pixels, int width, int height);
+
+    // Halves each dimension (down to 1) with a 2x2 box filter.
+    FloatImage downsample(const FloatImage &source);
+    // Level 0 followed by every smaller level down to 1x1.
+    std::vector<FloatImage> buildMipChain(FloatImage base);
+
+    // Rows [firstRow, firstRow + rowCount) back to straight-alpha RGBA, edge pixels repeated.
+    void toRgba8(const FloatImage &image, int firstRow, int rowCount, bool srgb, uint8_t *out);
+    // Same as half floats without alpha, for HDR sources.
+    void toRgb16f(const FloatImage &image, int firstRow, int rowCount, uint16_t *out);
+
+} // namespace TextureBaker
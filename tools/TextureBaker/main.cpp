@@ -0,0 +1,449 @@
+// Offline texture baker: turns PNG/QOI/HDR sources into .ktx2 files holding the complete mip chain,
+// optionally block-compressed, so the runtime only has to upload them.
+//
+//   TextureBaker [options] <input>...
+//   TextureBaker [options] --atlas <name> <input>...
+//
+// The BakeTextures target runs it over assets/images and assets/HDRi during the build. With
+// --atlas, all inputs go into one texture array instead (see Base::TextureAtlasBuilder).
+
+#include "BlockEncoder.hpp"
+#include "Ktx2Writer.hpp"
+#include "MipChain.hpp"
+
+#include "ImageDecoder.hpp"
+#include "Log.hpp"
+#include "TextureAtlas.hpp"
+#include "ThreadPool.hpp"
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace TextureBaker;
+
+namespace
+{
+    struct BakeOptions
+    {
+        std::string outputDirectory;     // Empty: next to each input
+        std::optional<BakeFormat> format; // Empty: BC1 for opaque, BC3 for translucent images
+        bool linear = false;
+        bool mips = true;
+        std::string atlasName; // Non-empty: pack all inputs into <name>.ktx2 + <name>.atlas
+        Base::TextureAtlasBuilder::Options atlas;
+        unsigned jobs = std::max(1u, std::thread::hardware_concurrency());
+    };
+
+    // Rows (block rows for BCn) encoded per ThreadPool task.
+    constexpr int kRowsPerTask = 16;
+
+    void printUsage()
+    {
+        LOG_INFO("Usage: TextureBaker [options] <input>...\n"
+                 "  -o, --output <dir>   Directory for the .ktx2 files (default: next to each input)\n"
+                 "  -f, --format <name>  auto, rgba8, bc1, bc3, bc5 or bc7 (default: auto)\n"
+                 "      --linear         Color data is not sRGB (normal maps, masks)\n"
+                 "      --no-mips        Only write level 0\n"
+                 "  -j, --jobs <count>   Encoder threads (default: all cores)\n"
+                 "      --atlas <name>   Pack all inputs into the layers of one texture array\n"
+                 "      --atlas-size <n> Largest atlas layer (default: 2048)\n"
+                 "      --padding <n>    Gutter texels around packed images (default: 4)\n"
+                 ".hdr inputs are always written as RGB16F and cannot go into an atlas.");
+    }
+
+    std::optional<BakeFormat> parseFormat(const std::string &name, bool &valid)
+    {
+        valid = true;
+        if (name == "rgba8") return BakeFormat::RGBA8;
+        if (name == "bc1") return BakeFormat::BC1;
+        if (name == "bc3") return BakeFormat::BC3;
+        if (name == "bc5") return BakeFormat::BC5;
+        if (name == "bc7") return BakeFormat::BC7;
+        valid = name == "auto";
+        return std::nullopt;
+    }
+
+    bool parseArguments(int argc, char *argv[], BakeOptions &options, std::vector<std::string> &inputs)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string argument = argv[i];
+            const bool hasValue = i + 1 < argc;
+            if ((argument == "-o" || argument == "--output") && hasValue)
+            {
+                options.outputDirectory = argv[++i];
+            }
+            else if ((argument == "-f" || argument == "--format") && hasValue)
+            {
+                bool valid = false;
+                options.format = parseFormat(argv[++i], valid);
+                if (!valid)
+                {
+                    LOG_ERROR("TextureBaker: unknown format '{}'.", argv[i]);
+                    return false;
+                }
+            }
+            else if ((argument == "-j" || argument == "--jobs") && hasValue)
+            {
+                options.jobs = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+            }
+            else if (argument == "--atlas" && hasValue)
+            {
+                options.atlasName = argv[++i];
+            }
+            else if (argument == "--atlas-size" && hasValue)
+            {
+                options.atlas.maxLayerSize = std::max(4, std::atoi(argv[++i]));
+            }
+            else if (argument == "--padding" && hasValue)
+            {
+                options.atlas.padding = std::max(0, std::atoi(argv[++i]));
+            }
+            else if (argument == "--linear")
+            {
+                options.linear = true;
+            }
+            else if (argument == "--no-mips")
+            {
+                options.mips = false;
+            }
+            else if (!argument.empty() && argument[0] == '-')
+            {
+                LOG_ERROR("TextureBaker: unknown option '{}'.", argument);
+                return false;
+            }
+            else
+            {
+                inputs.push_back(argument);
+            }
+        }
+        return !inputs.empty();
+    }
+
+    bool hasTranslucency(const uint8_t *pixels, size_t pixelCount)
+    {
+        for (size_t i = 0; i < pixelCount; ++i)
+        {
+            if (pixels[i * 4 + 3] != 255)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Encodes rows [firstRow, firstRow + rowCount) of `image`, in units of block rows for BCn.
+    void encodeRows(const FloatImage &image, BakeFormat format, bool srgb, int firstRow, int rowCount, uint8_t *out)
+    {
+        if (format == BakeFormat::RGB16F)
+        {
+            toRgb16f(image, firstRow, rowCount, reinterpret_cast<uint16_t *>(out));
+            return;
+        }
+        if (format == BakeFormat::RGBA8)
+        {
+            toRgba8(image, firstRow, rowCount, srgb, out);
+            return;
+        }
+
+        const int blocksX = (image.width + 3) / 4;
+        const size_t blockBytes = formatUnitBytes(format);
+        std::vector<uint8_t> rgba(static_cast<size_t>(image.width) * 4 * 4);
+        for (int blockRow = firstRow; blockRow < firstRow + rowCount; ++blockRow)
+        {
+            // Rows past the bottom edge repeat the last one, columns past the right edge likewise.
+            toRgba8(image, blockRow * 4, 4, srgb, rgba.data());
+            for (int blockX = 0; blockX < blocksX; ++blockX, out += blockBytes)
+            {
+                BlockTexels texels;
+                for (int y = 0; y < 4; ++y)
+                {
+                    for (int x = 0; x < 4; ++x)
+                    {
+                        const int sourceX = std::min(blockX * 4 + x, image.width - 1);
+                        std::copy_n(&rgba[(static_cast<size_t>(y) * image.width + sourceX) * 4], 4, texels[y * 4 + x]);
+                    }
+                }
+                switch (format)
+                {
+                case BakeFormat::BC1: encodeBc1(texels, out); break;
+                case BakeFormat::BC3: encodeBc3(texels, out); break;
+                case BakeFormat::BC5: encodeBc5(texels, out); break;
+                case BakeFormat::BC7: encodeBc7(texels, out); break;
+                default: break;
+                }
+            }
+        }
+    }
+
+    std::vector<uint8_t> encodeLevel(Base::ThreadPool &pool, const FloatImage &image, BakeFormat format, bool srgb)
+    {
+        const bool blocks = isBlockCompressed(format);
+        const int rows = blocks ? (image.height + 3) / 4 : image.height;
+        const size_t rowBytes = levelByteSize(format, image.width, blocks ? 4 : 1);
+
+        std::vector<uint8_t> data(levelByteSize(format, image.width, image.height));
+        std::vector<std::future<void>> tasks;
+        for (int firstRow = 0; firstRow < rows; firstRow += kRowsPerTask)
+        {
+            const int rowCount = std::min(kRowsPerTask, rows - firstRow);
+            uint8_t *out = data.data() + static_cast<size_t>(firstRow) * rowBytes;
+            tasks.push_back(pool.Enqueue([&image, format, srgb, firstRow, rowCount, out]()
+                                         { encodeRows(image, format, srgb, firstRow, rowCount, out); }));
+        }
+        for (std::future<void> &task : tasks)
+        {
+            task.get();
+        }
+        return data;
+    }
+
+    std::vector<std::vector<uint8_t>> encodeMipChain(Base::ThreadPool &pool, FloatImage base, BakeFormat format, bool srgb, bool mips)
+    {
+        std::vector<FloatImage> levels;
+        if (mips)
+        {
+            levels = buildMipChain(std::move(base));
+        }
+        else
+        {
+            levels.push_back(std::move(base));
+        }
+
+        std::vector<std::vector<uint8_t>> encoded;
+        for (const FloatImage &level : levels)
+        {
+            encoded.push_back(encodeLevel(pool, level, format, srgb));
+        }
+        return encoded;
+    }
+
+    // `fileName` in --output, or next to `input`.
+    std::string outputPathFor(const BakeOptions &options, const std::filesystem::path &input, const std::string &fileName)
+    {
+        const std::filesystem::path directory = options.outputDirectory.empty()
+                                                    ? input.parent_path()
+                                                    : std::filesystem::path(options.outputDirectory);
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        return (directory / fileName).string();
+    }
+
+    // Decodes an LDR input through the runtime's decoder registry (so .qoi works too) and expands
+    // it to RGBA8, bottom row first.
+    bool loadRgba8(const std::string &input, std::vector<uint8_t> &pixels, int &width, int &height)
+    {
+        std::ifstream file(input, std::ios::binary);
+        if (!file)
+        {
+            LOG_ERROR("TextureBaker: cannot open '{}'.", input);
+            return false;
+        }
+        const std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        Base::ImageData image;
+        if (!Base::ImageDecoder::decodeImage(data.data(), data.size(), input, image))
+        {
+            return false;
+        }
+        width = image.width;
+        height = image.height;
+        const size_t pixelCount = static_cast<size_t>(width) * height;
+        pixels.resize(pixelCount * 4);
+        for (size_t i = 0; i < pixelCount; ++i)
+        {
+            const uint8_t *in = image.pixels + i * image.channels;
+            uint8_t *out = pixels.data() + i * 4;
+            const bool gray = image.channels < 3;
+            out[0] = in[0];
+            out[1] = gray ? in[0] : in[1];
+            out[2] = gray ? in[0] : in[2];
+            out[3] = image.channels == 2 ? in[1] : image.channels == 4 ? in[3] : 255;
+        }
+        return true;
+    }
+
+    bool bakeFile(Base::ThreadPool &pool, const std::string &input, const BakeOptions &options)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const std::filesystem::path inputPath(input);
+        std::string extension = inputPath.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c)
+                       { return static_cast<char>(std::tolower(c)); });
+        const bool hdr = extension == ".hdr";
+
+        Ktx2Image image;
+        FloatImage base;
+        int width = 0;
+        int height = 0;
+        int channels = 0;
+        if (hdr)
+        {
+            float *pixels = stbi_loadf(input.c_str(), &width, &height, &channels, 4);
+            if (!pixels)
+            {
+                LOG_ERROR("TextureBaker: cannot load '{}': {}", input, stbi_failure_reason());
+                return false;
+            }
+            base = fromRgba32f(pixels, width, height);
+            stbi_image_free(pixels);
+
+            if (options.format)
+            {
+                LOG_WARN("TextureBaker: '{}' is HDR, writing RGB16F instead of {}.", input, formatName(*options.format));
+            }
+            image.format = BakeFormat::RGB16F;
+        }
+        else
+        {
+            std::vector<uint8_t> pixels;
+            if (!loadRgba8(input, pixels, width, height))
+            {
+                return false;
+            }
+            image.format = options.format.value_or(
+                hasTranslucency(pixels.data(), static_cast<size_t>(width) * height) ? BakeFormat::BC3 : BakeFormat::BC1);
+            // BC5 holds two linear channels; everything else follows --linear.
+            image.srgb = !options.linear && image.format != BakeFormat::BC5;
+            base = fromRgba8(pixels.data(), width, height, image.srgb);
+        }
+        image.width = width;
+        image.height = height;
+
+        size_t totalBytes = 0;
+        for (std::vector<uint8_t> &level : encodeMipChain(pool, std::move(base), image.format, image.srgb, options.mips))
+        {
+            totalBytes += level.size();
+            image.levels.push_back(std::move(level));
+        }
+
+        const std::string output = outputPathFor(options, inputPath, inputPath.stem().string() + ".ktx2");
+        if (!writeKtx2(output, image))
+        {
+            return false;
+        }
+
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        LOG_INFO("Baked '{}' -> '{}' ({}{}, {}x{}, {} levels, {} KB) in {} ms", input, output, formatName(image.format),
+                 image.srgb ? " sRGB" : "", width, height, image.levels.size(), totalBytes / 1024, elapsed.count());
+        return true;
+    }
+
+    // Packs every input into the layers of one texture array: <name>.ktx2 with the pixels and
+    // <name>.atlas with the regions, keyed by file stem.
+    bool bakeAtlas(Base::ThreadPool &pool, const std::vector<std::string> &inputs, const BakeOptions &options)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        Base::TextureAtlasBuilder builder(options.atlas);
+        for (const std::string &input : inputs)
+        {
+            if (stbi_is_hdr(input.c_str()))
+            {
+                LOG_ERROR("TextureBaker: cannot add '{}' to an atlas: HDR images are not supported", input);
+                return false;
+            }
+            int width = 0;
+            int height = 0;
+            std::vector<uint8_t> pixels;
+            if (!loadRgba8(input, pixels, width, height))
+            {
+                return false;
+            }
+            builder.add(std::filesystem::path(input).stem().string(), width, height, 4, pixels.data());
+        }
+
+        Base::AtlasLayout layout;
+        std::vector<uint8_t> layers;
+        if (!builder.build(layout, layers))
+        {
+            return false;
+        }
+        layout.texture = options.atlasName + ".ktx2";
+
+        Ktx2Image image;
+        image.format = options.format.value_or(hasTranslucency(layers.data(), layers.size() / 4) ? BakeFormat::BC3 : BakeFormat::BC1);
+        // Mips are still filtered in linear light, but the file is tagged UNORM: the runtime loads
+        // it as is, and it has to sample like the same image baked or loaded on its own.
+        const bool srgbSource = !options.linear && image.format != BakeFormat::BC5;
+        image.width = layout.width;
+        image.height = layout.height;
+        image.layerCount = layout.layerCount;
+        const size_t layerSize = static_cast<size_t>(layout.width) * layout.height * 4;
+        for (int layer = 0; layer < layout.layerCount; ++layer)
+        {
+            FloatImage base = fromRgba8(layers.data() + layerSize * layer, layout.width, layout.height, srgbSource);
+            std::vector<std::vector<uint8_t>> levels = encodeMipChain(pool, std::move(base), image.format, srgbSource, options.mips);
+            image.levels.resize(levels.size());
+            for (size_t level = 0; level < levels.size(); ++level)
+            {
+                image.levels[level].insert(image.levels[level].end(), levels[level].begin(), levels[level].end());
+            }
+        }
+
+        const std::filesystem::path firstInput(inputs.front());
+        const std::string output = outputPathFor(options, firstInput, layout.texture);
+        if (!writeKtx2(output, image) ||
+            !Base::TextureAtlasBuilder::writeLayoutFile(outputPathFor(options, firstInput, options.atlasName + ".atlas"), layout))
+        {
+            return false;
+        }
+
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        LOG_INFO("Baked atlas '{}' ({}{}, {} images in {} layer(s) of {}x{}, {} levels) in {} ms", output, formatName(image.format),
+                 image.srgb ? " sRGB" : "", inputs.size(), layout.layerCount, layout.width, layout.height, image.levels.size(),
+                 elapsed.count());
+        return true;
+    }
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    LoggerConfig config;
+    config.loggerName = "TextureBaker";
+    config.logPattern = "[%^%l%$] %v";
+    config.enableFileLogging = false;
+    Logger::getInstance().initialize(config);
+
+    BakeOptions options;
+    std::vector<std::string> inputs;
+    if (!parseArguments(argc, argv, options, inputs))
+    {
+        printUsage();
+        return 1;
+    }
+
+    // Same orientation as Texture::readImageFile (HDR inputs; the rest go through loadRgba8).
+    stbi_set_flip_vertically_on_load(true);
+
+    Base::ThreadPool pool(options.jobs);
+    pool.Start();
+    int failures = 0;
+    if (!options.atlasName.empty())
+    {
+        failures = bakeAtlas(pool, inputs, options) ? 0 : 1;
+    }
+    else
+    {
+        for (const std::string &input : inputs)
+        {
+            if (!bakeFile(pool, input, options))
+            {
+                failures++;
+            }
+        }
+    }
+    pool.Stop();
+
+    Logger::shutdown();
+    return failures == 0 ? 0 : 1;
+}